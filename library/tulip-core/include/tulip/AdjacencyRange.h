@@ -0,0 +1,171 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef TULIP_ADJACENCYRANGE_H
+#define TULIP_ADJACENCYRANGE_H
+
+#include <algorithm>
+#include <vector>
+
+#include <tulip/Node.h>
+#include <tulip/Edge.h>
+#include <tulip/IdManager.h>
+
+namespace tlp {
+
+enum EDGE_TYPE { UNDIRECTED = 0, INV_DIRECTED = 1, DIRECTED = 2 };
+#define IN_EDGE INV_DIRECTED
+#define OUT_EDGE DIRECTED
+#define INOUT_EDGE UNDIRECTED
+
+/**
+ * @brief The data needed to walk through the adjacency of a node of a graph,
+ * as returned by Graph::getAdjacency().
+ */
+struct AdjacencyData {
+  // the node whose adjacency is walked through
+  node n;
+  // the adjacent edges of n in the root graph
+  const std::vector<edge> *edges;
+  // the ends of the edges of the root graph
+  const std::vector<std::pair<node, node>> *ends;
+  // the edges of the graph if it is not the root graph
+  const SGraphIdContainer<edge> *graphEdges;
+};
+
+/**
+ * @ingroup Iterators
+ * @brief A lightweight view on the adjacent nodes (ELT = node) or edges (ELT = edge)
+ * of a node, to be used in a range-based for loop.
+ *
+ * Unlike the Iterator returned by Graph::getInOutNodes() and the likes, it needs no
+ * allocation and no virtual call per element: it only walks through the adjacency
+ * of the node in the root graph, skipping the edges not in the graph.
+ * As with these iterators, a loop appears once in the in or out adjacency
+ * and twice in the in/out one.
+ *
+ * @warning The graph must not be modified while the range is walked through.
+ *
+ * @code
+ * for (auto m : graph->outNodes(n)) {
+ *   ...
+ * }
+ * @endcode
+ */
+template <typename ELT>
+class AdjacencyRange {
+public:
+  class iterator {
+  public:
+    iterator(const AdjacencyRange *range, const edge *cur) : range(range), cur(cur) {
+      skip();
+    }
+
+    inline ELT operator*() const {
+      return range->value(*cur, static_cast<ELT *>(nullptr));
+    }
+
+    inline iterator &operator++() {
+      ++cur;
+      skip();
+      return *this;
+    }
+
+    inline bool operator!=(const iterator &it) const {
+      return cur != it.cur;
+    }
+
+    inline bool operator==(const iterator &it) const {
+      return cur == it.cur;
+    }
+
+  private:
+    inline void skip() {
+      while (cur != range->last && !range->accept(cur))
+        ++cur;
+    }
+
+    const AdjacencyRange *range;
+    const edge *cur;
+  };
+
+  AdjacencyRange(const AdjacencyData &data, EDGE_TYPE direction)
+      : n(data.n), first(data.edges->data()), last(first + data.edges->size()),
+        ends(data.ends->data()), graphEdges(data.graphEdges), direction(direction) {}
+
+  inline iterator begin() const {
+    return iterator(this, first);
+  }
+
+  inline iterator end() const {
+    return iterator(this, last);
+  }
+
+  inline bool empty() const {
+    return begin() == end();
+  }
+
+private:
+  inline bool accept(const edge *cur) const {
+    edge e = *cur;
+
+    if (direction != UNDIRECTED) {
+      const std::pair<node, node> &eEnds = ends[e.id];
+
+      if ((direction == DIRECTED ? eEnds.first : eEnds.second) != n)
+        return false;
+
+      // a loop appears twice in the adjacency of n,
+      // only its first occurrence is kept
+      if (eEnds.first == eEnds.second && std::find(first, cur, e) != cur)
+        return false;
+    }
+
+    return graphEdges == nullptr || graphEdges->isElement(e);
+  }
+
+  inline edge value(edge e, edge *) const {
+    return e;
+  }
+
+  inline node value(edge e, node *) const {
+    const std::pair<node, node> &eEnds = ends[e.id];
+
+    switch (direction) {
+    case DIRECTED:
+      return eEnds.second;
+
+    case INV_DIRECTED:
+      return eEnds.first;
+
+    case UNDIRECTED:
+    default:
+      return eEnds.first == n ? eEnds.second : eEnds.first;
+    }
+  }
+
+  node n;
+  const edge *first, *last;
+  const std::pair<node, node> *ends;
+  const SGraphIdContainer<edge> *graphEdges;
+  EDGE_TYPE direction;
+};
+} // namespace tlp
+
+#endif // TULIP_ADJACENCYRANGE_H
@@ -72,6 +72,8 @@ public:
    * @param graph The graph on which to compute connected components.
    * @param components The components that were found. It is passed as a reference to avoid copying
    *the data when returning.
+   * The components are ordered as their first node in graph->nodes(), and the nodes of a component
+   *as in a breadth first traversal from its first node.
    * @return void
    * @note The components parameter can be returned with c++11 thanks to move constructors without
    *performance loss, change this function once c++11 compilers are used.
@@ -47,39 +47,32 @@ public:
   bool searchPath(node n, BooleanProperty *result);
   //=============================================================
   bool ancestors(std::unordered_map<node, std::list<node>> &result);
+  //=============================================================
+  // computes the distances from src to the nodes of the graph with
+  // the parallel delta-stepping algorithm, which is faster than the
+  // constructor above on large graphs when only the distances are needed;
+  // the distances of the unreachable nodes are set to DBL_MAX / 2 + 10
+  // as in the constructor. The edges weights must be positive or null,
+  // delta is the width of the buckets, by default the average edge weight
+  // (at least 1E-6).
+  static void computeDistances(const Graph *const graph, node src,
+                               const EdgeStaticProperty<double> &weights,
+                               NodeStaticProperty<double> &nodeDistance, EDGE_TYPE direction,
+                               double delta = 0);
+  //=============================================================
+  // selects one shortest path from src to tgt, using a bidirectional
+  // search which stops as soon as the two searches meet;
+  // returns false and unselects all the elements if there is no path
+  static bool searchPath(const Graph *const graph, node src, node tgt,
+                         const EdgeStaticProperty<double> &weights, EDGE_TYPE direction,
+                         BooleanProperty *result);
 
 private:
   void internalSearchPaths(node n, BooleanProperty *result);
-  //=========================================================
-  struct DijkstraElement {
-    DijkstraElement(const double dist = DBL_MAX, const node previous = node(),
-                    const node n = node())
-        : dist(dist), previous(previous), n(n) {}
-    bool operator==(const DijkstraElement &b) const {
-      return n == b.n;
-    }
-    bool operator!=(const DijkstraElement &b) const {
-      return n != b.n;
-    }
-    double dist;
-    node previous;
-    node n;
-    std::vector<edge> usedEdge;
-  };
-
-  struct LessDijkstraElement {
-    bool operator()(const DijkstraElement *const a, const DijkstraElement *const b) const {
-      if (fabs(a->dist - b->dist) > 1.E-9) {
-        return (a->dist < b->dist);
-      } else {
-        return (a->n.id < b->n.id);
-      }
-    }
-  };
 
   Graph const *graph;
   node src;
-  MutableContainer<bool> usedEdges;
+  EdgeStaticProperty<bool> usedEdges;
   NodeStaticProperty<double> &nodeDistance;
   std::stack<node> *queueNodes;
   MutableContainer<int> *numberOfPaths;
@@ -33,6 +33,8 @@
 #include <tulip/Node.h>
 #include <tulip/Edge.h>
 #include <tulip/Observable.h>
+#include <tulip/AdjacencyRange.h>
+#include <tulip/PropertyKey.h>
 
 namespace tlp {
 
@@ -240,7 +242,7 @@ class TLP_SCOPE Graph : public Observable {
   friend class PropertyInterface;
 
 public:
-  Graph() : id(0) {}
+  Graph() : id(0), topologyVersion(0) {}
   ~Graph() override {}
 
   /**
@@ -1042,6 +1044,87 @@ public:
    */
   virtual const std::vector<edge> &allEdges(const node n) const = 0;
 
+  /**
+   * @brief Gets the data used by the adjacency ranges of a node.
+   * @param n The node whose adjacency is walked through.
+   * @see AdjacencyRange
+   */
+  virtual AdjacencyData getAdjacency(const node n) const = 0;
+
+  /**
+   * @brief Gets a range over the adjacent nodes of a node in the given direction.
+   * It needs no allocation and no virtual call per node
+   * thus it is faster than the equivalent Iterator.
+   * @param n The node to get the adjacent nodes from.
+   * @param direction DIRECTED for the out nodes, INV_DIRECTED for the in nodes
+   * and UNDIRECTED for the in/out nodes.
+   * @see getInOutNodes()
+   */
+  inline AdjacencyRange<node> adjacentNodes(const node n, EDGE_TYPE direction = UNDIRECTED) const {
+    return AdjacencyRange<node>(getAdjacency(n), direction);
+  }
+
+  /**
+   * @brief Gets a range over the adjacent edges of a node in the given direction.
+   * It needs no allocation and no virtual call per edge
+   * thus it is faster than the equivalent Iterator.
+   * @param n The node to get the adjacent edges from.
+   * @param direction DIRECTED for the out edges, INV_DIRECTED for the in edges
+   * and UNDIRECTED for the in/out edges.
+   * @see getInOutEdges()
+   */
+  inline AdjacencyRange<edge> adjacentEdges(const node n, EDGE_TYPE direction = UNDIRECTED) const {
+    return AdjacencyRange<edge>(getAdjacency(n), direction);
+  }
+
+  /**
+   * @brief Gets a range over the source nodes of the input edges of a node.
+   * @see adjacentNodes()
+   */
+  inline AdjacencyRange<node> inNodes(const node n) const {
+    return adjacentNodes(n, INV_DIRECTED);
+  }
+
+  /**
+   * @brief Gets a range over the target nodes of the output edges of a node.
+   * @see adjacentNodes()
+   */
+  inline AdjacencyRange<node> outNodes(const node n) const {
+    return adjacentNodes(n, DIRECTED);
+  }
+
+  /**
+   * @brief Gets a range over the neighbours of a node.
+   * @see adjacentNodes()
+   */
+  inline AdjacencyRange<node> inOutNodes(const node n) const {
+    return adjacentNodes(n, UNDIRECTED);
+  }
+
+  /**
+   * @brief Gets a range over the input edges of a node.
+   * @see adjacentEdges()
+   */
+  inline AdjacencyRange<edge> inEdges(const node n) const {
+    return adjacentEdges(n, INV_DIRECTED);
+  }
+
+  /**
+   * @brief Gets a range over the output edges of a node.
+   * @see adjacentEdges()
+   */
+  inline AdjacencyRange<edge> outEdges(const node n) const {
+    return adjacentEdges(n, DIRECTED);
+  }
+
+  /**
+   * @brief Gets a range over the input and output edges of a node.
+   * @see adjacentEdges()
+   */
+  inline AdjacencyRange<edge> inOutEdges(const node n) const {
+    return adjacentEdges(n, UNDIRECTED);
+  }
+
   /**
    * @brief Gets an iterator over the edges composing a meta edge.
    * @param metaEdge The metaEdge to get the real edges of.
@@ -1090,6 +1173,16 @@ public:
    */
   virtual unsigned int numberOfEdges() const = 0;
 
+  /**
+   * @brief Gets a number which is incremented each time the topology of this graph changes
+   * (addition, deletion, reversal or change of the ends of an element, sortElts()).
+   * It can be used to check if the data computed from the topology are up to date.
+   * @return The current version of the topology of this graph.
+   */
+  unsigned int getTopologyVersion() const {
+    return topologyVersion;
+  }
+
   /**
    * @param n The node to get the degree of.
    * @return The degree of the given node.
@@ -1183,13 +1276,13 @@ public:
    * @param source The source of the hypothetical edges.
    * @param target The target of the hypothetical edges.
    * @param directed When set to false edges from target to source are also considered
-   * @return a vector of existing edges
+   * @return a vector of existing edges, ordered by id
    */
   virtual std::vector<edge> getEdges(const node source, const node target,
                                      bool directed = true) const = 0;
 
   /**
-   * @brief Returns the first edge found between the two given nodes.
+   * @brief Returns the edge with the lowest id between the two given nodes.
    * @warning This function always returns an edge,
    * you need to check if this edge is valid with edge::isValid().
    * @param source The source of the hypothetical edge.
@@ -1200,6 +1293,18 @@ public:
    */
   virtual edge existEdge(const node source, const node target, bool directed = true) const = 0;
 
+  /**
+   * @brief Returns the edge with the lowest id between the nodes of each given pair,
+   * the pairs being processed in parallel.
+   * @param ends The pairs of source and target nodes of the hypothetical edges.
+   * @param directed When set to false
+   * an edge from target to source may also be returned
+   * @return A vector whose ith element is the edge found for the ith pair,
+   * or an invalid edge if there is none.
+   */
+  std::vector<edge> existEdges(const std::vector<std::pair<node, node>> &ends,
+                               bool directed = true) const;
+
   //================================================================================
   // Access to the graph attributes and to the node/edge property.
   //================================================================================
@@ -1327,6 +1432,28 @@ public:
   template <typename PropertyType>
   PropertyType *getProperty(const std::string &name);
 
+  /**
+   * @brief Gets an existing property on this graph or one of its ancestors.
+   * Unlike getProperty(const std::string &), the lookup does not depend on the length
+   * of the name nor on the number of properties, which makes it suitable for the loops
+   * needing properties.
+   *
+   * @param key The interned name of the property.
+   * @return The property, or nullptr if none exists with the given name.
+   */
+  virtual PropertyInterface *findProperty(const PropertyKey &key) const = 0;
+
+  /**
+   * @brief Gets a property on this graph or one of its ancestors.
+   * This is the same as getProperty(const std::string &) using an interned name.
+   * @warning using the wrong template parameter will cause a segmentation fault.
+   * @param key The interned name of the property.
+   * @return An existing property, or a new one if none exists with the given name.
+   * @see findProperty().
+   */
+  template <typename PropertyType>
+  PropertyType *getProperty(const PropertyKey &key);
+
   /**
    * @brief Gets a property on this graph, and this graph only.
    * This forwards the call to the template version of getLocalProperty(), with the correct template
@@ -1670,6 +1797,8 @@ protected:
   void notifyAddEdge(Graph *, const edge e) {
     notifyAddEdge(e);
   }
+  void notifyAddNodes(unsigned int nbNodes);
+  void notifyAddEdges(unsigned int nbEdges);
   void notifyBeforeSetEnds(const edge e);
   void notifyBeforeSetEnds(Graph *, const edge e) {
     notifyBeforeSetEnds(e);
@@ -1740,6 +1869,8 @@ protected:
   }
 
   unsigned int id;
+  // incremented by the notifications of the topology changes and by sortElts()
+  unsigned int topologyVersion;
   std::unordered_map<std::string, tlp::PropertyInterface *> circularCalls;
   ///@endcond
 };
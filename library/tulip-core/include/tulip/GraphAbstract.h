@@ -107,6 +107,7 @@ public:
   Iterator<PropertyInterface *> *getInheritedObjectProperties() const override;
   Iterator<PropertyInterface *> *getObjectProperties() const override;
   PropertyInterface *getProperty(const std::string &) const override;
+  PropertyInterface *findProperty(const PropertyKey &key) const override;
 
   // to get viewMetaGraph property
   GraphProperty *getMetaGraphProperty();
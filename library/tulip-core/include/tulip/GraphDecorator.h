@@ -131,12 +131,14 @@ public:
   Iterator<edge> *getInOutEdges(const node n) const override;
   Iterator<edge> *getInEdges(const node n) const override;
   const std::vector<edge> &allEdges(const node n) const override;
+  AdjacencyData getAdjacency(const node n) const override;
   Iterator<edge> *getEdgeMetaInfo(const edge) const override;
   void sortElts() override;
   //============================================================
   template <typename PropertyType>
   PropertyType *getProperty(const std::string &name);
   PropertyInterface *getProperty(const std::string &name) const override;
+  PropertyInterface *findProperty(const PropertyKey &key) const override;
   bool existProperty(const std::string &name) const override;
   bool existLocalProperty(const std::string &name) const override;
   void delLocalProperty(const std::string &name) override;
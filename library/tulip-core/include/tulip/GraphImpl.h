@@ -102,6 +102,9 @@ public:
   inline const std::vector<edge> &allEdges(const node n) const override {
     return storage.adj(n);
   }
+  inline AdjacencyData getAdjacency(const node n) const override {
+    return storage.adjacency(n);
+  }
   //========================================================================
   inline unsigned int deg(const node n) const override {
     assert(isElement(n));
@@ -150,6 +153,7 @@ public:
   }
   inline void sortElts() override {
     storage.sortElts();
+    ++topologyVersion;
   }
   //=======================================================================
   // updates management
@@ -0,0 +1,135 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef TULIP_GRAPHSNAPSHOT_H
+#define TULIP_GRAPHSNAPSHOT_H
+
+#include <memory>
+
+#include <tulip/Graph.h>
+#include <tulip/vectorgraph.h>
+
+namespace tlp {
+
+/**
+ * @ingroup Graph
+ * @brief A copy of the topology of a graph in a VectorGraph, for the algorithms
+ * which only read the topology of their graph.
+ *
+ * The snapshot of a graph is built once and kept in a cache until the topology of the graph
+ * changes (see Graph::getTopologyVersion()), so the next runs of algorithms on an unchanged
+ * graph skip the conversion. The cache only keeps the last used snapshots
+ * (see setCacheSize()).
+ *
+ * The i-th node (resp. edge) of the VectorGraph is the i-th element of graph->nodes()
+ * (resp. graph->edges()). So the values computed on the VectorGraph can be stored
+ * in a NodeStaticProperty (resp. EdgeStaticProperty) of the graph, using the ids of the
+ * VectorGraph elements as indices, then copied at once in a property
+ * with NodeStaticProperty::copyToProperty().
+ *
+ * @code
+ * std::shared_ptr<const GraphSnapshot> snapshot = GraphSnapshot::get(graph);
+ * const VectorGraph &vGraph = snapshot->getVectorGraph();
+ * NodeStaticProperty<double> values(graph);
+ *
+ * for (node n : vGraph.nodes())
+ *   values[n.id] = vGraph.deg(n);
+ *
+ * values.copyToProperty(result);
+ * @endcode
+ *
+ * @warning The snapshot must not be used once the topology of its graph has changed.
+ * The cache is not thread safe.
+ */
+class TLP_SCOPE GraphSnapshot {
+public:
+  /**
+   * @brief Returns the up to date snapshot of a graph, it is built if needed.
+   * The returned snapshot is not deleted while it is referenced,
+   * even if it is removed from the cache.
+   */
+  static std::shared_ptr<const GraphSnapshot> get(const Graph *graph);
+
+  /**
+   * @brief Removes the snapshot of a graph from the cache if any.
+   */
+  static void invalidate(const Graph *graph);
+
+  /**
+   * @brief Sets the maximum number of snapshots kept in the cache (4 by default),
+   * the least recently used ones are removed first. 0 disables the cache.
+   */
+  static void setCacheSize(unsigned int nbSnapshots);
+
+  static unsigned int getCacheSize();
+
+  /**
+   * @brief Returns the number of snapshots built since the start of the program.
+   */
+  static unsigned int getNumberOfBuilds();
+
+  const Graph *getGraph() const {
+    return graph;
+  }
+
+  const VectorGraph &getVectorGraph() const {
+    return vGraph;
+  }
+
+  /**
+   * @brief Returns the node of the graph corresponding to a node of the VectorGraph.
+   */
+  node getGraphNode(const node n) const {
+    return graph->nodes()[n.id];
+  }
+
+  /**
+   * @brief Returns the edge of the graph corresponding to an edge of the VectorGraph.
+   */
+  edge getGraphEdge(const edge e) const {
+    return graph->edges()[e.id];
+  }
+
+  /**
+   * @brief Returns the node of the VectorGraph corresponding to a node of the graph.
+   */
+  node getNode(const node n) const {
+    return node(graph->nodePos(n));
+  }
+
+  /**
+   * @brief Returns the edge of the VectorGraph corresponding to an edge of the graph.
+   */
+  edge getEdge(const edge e) const {
+    return edge(graph->edgePos(e));
+  }
+
+private:
+  GraphSnapshot(const Graph *graph);
+
+  const Graph *graph;
+  // the topology version of the graph when the snapshot was built
+  unsigned int topologyVersion;
+  VectorGraph vGraph;
+
+  friend class GraphSnapshotListener;
+};
+} // namespace tlp
+
+#endif // TULIP_GRAPHSNAPSHOT_H
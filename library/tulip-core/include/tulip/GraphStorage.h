@@ -22,11 +22,13 @@
 #define GRAPHSTORAGE_H
 #include <cstring>
 #include <cassert>
+#include <atomic>
 #include <vector>
 
 #include <tulip/Node.h>
 #include <tulip/Edge.h>
 #include <tulip/IdManager.h>
+#include <tulip/AdjacencyRange.h>
 
 namespace tlp {
 
@@ -122,6 +124,15 @@ public:
     return nodeData[n.id].edges;
   }
   //=======================================================
+  /**
+   * @brief return the data needed to walk through the adjacency of a given node
+   */
+  inline AdjacencyData adjacency(const node n) const {
+    assert(isElement(n));
+    AdjacencyData data = {n, &nodeData[n.id].edges, &edgeEnds, nullptr};
+    return data;
+  }
+  //=======================================================
   /**
    * @brief Return the first node of graph
    */
@@ -179,6 +190,11 @@ public:
   //=======================================================
   /**
    * @brief Return if edges exist between two nodes
+   * The adjacency of the end with the lowest degree is scanned, unless its degree
+   * is at least EDGES_INDEX_MIN_DEGREE; then its edges are indexed by opposite node
+   * in a hash table, built at the first call and kept up to date.
+   * In both cases, the edges found are ordered by id.
+   * It can be called concurrently.
    * @param src The source of the hypothetical edges.
    * @param tgt The target of the hypothetical edges.
    * @param directed When set to false edges from target to source are also considered
@@ -450,13 +466,28 @@ public:
     edgeIds.sort();
   }
   //=======================================================
+  /**
+   * @brief the minimum degree of the nodes whose edges are indexed
+   * by opposite node when looking for the edges between two nodes
+   */
+  static const unsigned int EDGES_INDEX_MIN_DEGREE = 256;
+  //=======================================================
 private:
   // specific types
+  struct EdgesIndex;
+
   struct NodeData {
     std::vector<edge> edges;
     unsigned int outDegree;
+    // the index of the edges by opposite node,
+    // lazily built by getEdges for the high degree nodes
+    std::atomic<EdgesIndex *> edgesIndex;
 
-    NodeData() : outDegree(0) {}
+    NodeData() : outDegree(0), edgesIndex(nullptr) {}
+    NodeData(NodeData &&nd) noexcept
+        : edges(std::move(nd.edges)), outDegree(nd.outDegree),
+          edgesIndex(nd.edgesIndex.exchange(nullptr)) {}
+    ~NodeData();
   };
 
   // data members
@@ -483,6 +514,27 @@ private:
    * and thus invalidates all iterators on it.
    */
   void removeFromEdges(const edge e, node end = node());
+  //=======================================================
+  /**
+   * @brief return the index of the edges of n, built if needed
+   */
+  const EdgesIndex &getEdgesIndex(const node n) const;
+  //=======================================================
+  /**
+   * @brief add e in the existing indexes of its ends
+   */
+  void indexEdge(const edge e);
+  //=======================================================
+  /**
+   * @brief remove e from the existing indexes of its ends
+   * except for the end node in argument if it is valid
+   */
+  void unindexEdge(const edge e, node end = node());
+  //=======================================================
+  /**
+   * @brief delete the index of the edges of n if any
+   */
+  static void deleteEdgesIndex(NodeData &nData);
 };
 } // namespace tlp
 #endif // GRAPHSTORAGE_H
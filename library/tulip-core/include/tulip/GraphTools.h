@@ -33,6 +33,7 @@
 #include <tulip/MutableContainer.h>
 #include <tulip/StaticProperty.h>
 #include <tulip/Iterator.h>
+#include <tulip/AdjacencyRange.h>
 
 namespace tlp {
 class BooleanProperty;
@@ -43,11 +44,6 @@ class NumericProperty;
 class PlanarConMap;
 class PluginProgress;
 
-enum EDGE_TYPE { UNDIRECTED = 0, INV_DIRECTED = 1, DIRECTED = 2 };
-#define IN_EDGE INV_DIRECTED
-#define OUT_EDGE DIRECTED
-#define INOUT_EDGE UNDIRECTED
-
 typedef Iterator<node> *(*NodesIteratorFn)(const tlp::Graph *, const tlp::node);
 typedef Iterator<edge> *(*EdgesIteratorFn)(const tlp::Graph *, const tlp::node);
 
@@ -236,6 +232,19 @@ TLP_SCOPE void computeDijkstra(const Graph *const graph, node src,
                                std::unordered_map<node, std::list<node>> &ancestors,
                                std::stack<node> *queueNodes = nullptr,
                                MutableContainer<int> *numberOfPaths = nullptr);
+
+/*
+ * compute the distances from src to all the nodes of the graph
+ * using the parallel delta-stepping algorithm, it is faster than
+ * computeDijkstra on large graphs when only the distances are needed.
+ * The distance of an unreachable node is DBL_MAX / 2 + 10.
+ * The weights must be positive or null, delta is the width of the distance buckets
+ * (the average weight if it is not positive, at least 1E-6)
+ */
+TLP_SCOPE void computeDeltaSteppingDistances(const Graph *const graph, node src,
+                                             const EdgeStaticProperty<double> &weights,
+                                             NodeStaticProperty<double> &nodeDistance,
+                                             EDGE_TYPE direction, double delta = 0);
 } // namespace tlp
 #endif
 ///@endcond
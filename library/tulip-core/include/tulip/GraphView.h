@@ -162,9 +162,11 @@ public:
   inline const std::vector<edge> &allEdges(const node n) const override {
     return getRootImpl()->allEdges(n);
   }
+  AdjacencyData getAdjacency(const node n) const override;
   inline void sortElts() override {
     _nodes.sort();
     _edges.sort();
+    ++topologyVersion;
   }
   inline Graph *getRoot() const override {
     // handle root destruction (see GraphAbstract destructor)
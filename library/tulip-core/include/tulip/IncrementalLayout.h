@@ -0,0 +1,137 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef TULIP_INCREMENTALLAYOUT_H
+#define TULIP_INCREMENTALLAYOUT_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <tulip/Observable.h>
+#include <tulip/Node.h>
+#include <tulip/Coord.h>
+
+namespace tlp {
+
+class Graph;
+class LayoutProperty;
+
+/**
+ * @ingroup Graph
+ * @brief Maintains a force directed layout of a graph while nodes and edges are added to it.
+ *
+ * An IncrementalLayout listens to the events of a graph and of one of its layout properties.
+ * Each call to update() places the nodes added since the previous call near their already placed
+ * neighbors, then runs a bounded number of force directed relaxation iterations, but only on the
+ * nodes lying in the neighborhood of the added elements.
+ * The repulsive forces are computed with a uniform grid indexing the node positions,
+ * so the cost of an update is proportional to the size of the change and not to the size of the
+ * graph.
+ *
+ * @code
+ * tlp::IncrementalLayout incLayout(graph, graph->getProperty<tlp::LayoutProperty>("viewLayout"));
+ * tlp::node n = graph->addNode();
+ * graph->addEdge(n, graph->getOneNode());
+ * incLayout.update();
+ * @endcode
+ *
+ * @since Tulip 5.4
+ */
+class TLP_SCOPE IncrementalLayout : public Observable {
+public:
+  /**
+   * @brief Creates an incremental layout of graph stored in layout.
+   *
+   * @param graph The graph to lay out.
+   * @param layout The layout property of the graph to update.
+   * @param edgeLength The ideal length of the edges.
+   **/
+  IncrementalLayout(Graph *graph, LayoutProperty *layout, float edgeLength = 1.0f);
+  ~IncrementalLayout() override;
+
+  /**
+   * @brief Sets the number of relaxation iterations run by each update (10 by default).
+   **/
+  void setMaxIterations(unsigned int nbIterations) {
+    maxIterations = nbIterations;
+  }
+
+  unsigned int getMaxIterations() const {
+    return maxIterations;
+  }
+
+  /**
+   * @brief Sets the graph distance, from the added elements,
+   * of the nodes moved by the relaxation (1 by default).
+   **/
+  void setNeighborhoodDepth(unsigned int depth) {
+    neighborhoodDepth = depth;
+  }
+
+  unsigned int getNeighborhoodDepth() const {
+    return neighborhoodDepth;
+  }
+
+  /**
+   * @brief Returns true if the graph has been modified since the last update.
+   **/
+  bool hasPendingUpdates() const {
+    return !addedNodes.empty() || !changedNodes.empty();
+  }
+
+  /**
+   * @brief Places the nodes added since the previous update
+   * and relaxes the layout around the added elements.
+   **/
+  void update();
+
+protected:
+  void treatEvent(const Event &) override;
+
+private:
+  typedef unsigned long long CellKey;
+
+  CellKey cellKey(const Coord &c) const;
+  void buildGrid();
+  void addToGrid(node n, const Coord &c);
+  void removeFromGrid(node n);
+  void moveInGrid(node n, const Coord &c);
+  void placeAddedNodes();
+  void relax(const std::vector<node> &region);
+
+  Graph *graph;
+  LayoutProperty *layout;
+  float edgeLength;
+  unsigned int maxIterations;
+  unsigned int neighborhoodDepth;
+  bool updating;
+  bool gridBuilt;
+
+  // the uniform grid indexing the positions of the placed nodes
+  std::unordered_map<CellKey, std::vector<node>> grid;
+  std::unordered_map<node, CellKey> nodeCells;
+
+  // the elements modified since the last update
+  std::vector<node> addedNodes;
+  std::unordered_set<node> changedNodes;
+};
+} // namespace tlp
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef TULIP_LANDMARKSINDEX_H
+#define TULIP_LANDMARKSINDEX_H
+
+#include <vector>
+
+#include <tulip/Graph.h>
+#include <tulip/StaticProperty.h>
+
+namespace tlp {
+
+class BooleanProperty;
+class DoubleProperty;
+
+/**
+ * @ingroup Graph
+ * @brief An index speeding up the repeated searches of a shortest path
+ * between two nodes of a graph.
+ *
+ * The index stores the distances between a few landmark nodes, chosen far apart,
+ * and all the nodes of the graph. Thanks to the triangle inequality, these distances give
+ * a lower bound of the distance between any two nodes, which guides an A* search
+ * towards the target (the ALT algorithm): only a small part of the graph is usually
+ * explored by a search, while a Dijkstra search explores all the nodes nearer
+ * to the source than the target.
+ *
+ * The index of a graph for given weights and direction is built once, the distance
+ * tables of the landmarks being computed in parallel, and kept until the topology
+ * of the graph or the weights change. It can also be stored in an attribute of the graph
+ * (see store()), so it is saved with the graph in the tlp/tlpb files
+ * and restored when the graph is loaded again.
+ *
+ * As in selectShortestPaths(), a null weight (or no weights) is considered as
+ * a very small one, and the weights must be positive.
+ *
+ * @code
+ * const LandmarksIndex &index = LandmarksIndex::get(graph, weights, false);
+ *
+ * for (const pair<node, node> &query : queries) {
+ *   selection->setAllNodeValue(false);
+ *   selection->setAllEdgeValue(false);
+ *   index.searchPath(query.first, query.second, selection);
+ * }
+ * @endcode
+ *
+ * @warning The index must not be used once the graph or the weights have changed.
+ */
+class TLP_SCOPE LandmarksIndex {
+public:
+  /**
+   * @brief Returns the up to date index of a graph for the given weights.
+   * If needed, it is restored from the attribute of the graph or built with nbLandmarks
+   * landmarks (more landmarks give better lower bounds but use more memory).
+   * @param weights the weights of the edges, nullptr if all the edges have the same weight
+   * @param directed indicates if the edges are followed from their source to their target;
+   * a path following the reversed edges is the reverse of a directed path from tgt to src
+   */
+  static const LandmarksIndex &get(const Graph *graph, const DoubleProperty *weights,
+                                   bool directed, unsigned int nbLandmarks = 16);
+
+  /**
+   * @brief Deletes the indices of a graph if any.
+   */
+  static void invalidate(const Graph *graph);
+
+  /**
+   * @brief Returns the number of indices built (not restored) since the start of the program.
+   */
+  static unsigned int getNumberOfBuilds();
+
+  /**
+   * @brief Selects one shortest path from src to tgt in result,
+   * returns false and unselects all the elements if there is no path.
+   * The elements not in the path are left unchanged.
+   */
+  bool searchPath(node src, node tgt, BooleanProperty *result) const;
+
+  /**
+   * @brief Returns the number of nodes treated by the last search,
+   * to compare with the number of nodes of the graph.
+   */
+  unsigned int getNumberOfTreatedNodes() const {
+    return nbTreatedNodes;
+  }
+
+  /**
+   * @brief Stores the index in the "landmarks index" attribute of its graph,
+   * replacing the one stored for other weights or direction.
+   * It is restored by get() as long as the graph and the weights are unchanged.
+   */
+  void store() const;
+
+  const Graph *getGraph() const {
+    return graph;
+  }
+
+  /**
+   * @brief Returns the landmarks of the index.
+   */
+  std::vector<node> getLandmarks() const;
+
+private:
+  LandmarksIndex(const Graph *graph, const DoubleProperty *weights, bool directed);
+
+  void build(unsigned int nbLandmarks);
+  bool restore();
+  unsigned long long checksum() const;
+  double lowerBound(unsigned int pos, unsigned int tgtPos) const;
+
+  const Graph *graph;
+  const DoubleProperty *weights;
+  bool directed;
+  unsigned int topologyVersion;
+  EdgeStaticProperty<double> edgeWeights;
+  // the positions of the landmarks in graph->nodes()
+  std::vector<unsigned int> landmarks;
+  // the distances from (resp. to, when the edges are directed) the landmarks,
+  // the ones of the node at position pos begin at index pos * landmarks.size()
+  std::vector<double> fromLandmarks, toLandmarks;
+  mutable unsigned int nbTreatedNodes;
+
+  friend class LandmarksIndexListener;
+};
+} // namespace tlp
+
+#endif // TULIP_LANDMARKSINDEX_H
@@ -20,6 +20,8 @@
 #ifndef TULIP_LAYOUT_H
 #define TULIP_LAYOUT_H
 
+#include <functional>
+
 #include <tulip/PropertyTypes.h>
 #include <tulip/Observable.h>
 #include <tulip/AbstractProperty.h>
@@ -306,7 +308,11 @@ protected:
 
 private:
   void resetBoundingBox();
-  void rotate(const double &alpha, int rot, Iterator<node> *, Iterator<edge> *);
+  void rotate(const double &alpha, int rot, const std::vector<node> &, const std::vector<edge> &);
+  // apply kernel(x, y, z, n) to a structure of arrays copy
+  // of the coordinates of the nodes and of the edges bends
+  void transform(const std::function<void(float *, float *, float *, size_t)> &kernel,
+                 const std::vector<node> &nodes, const std::vector<edge> &edges);
   // override Observable::treatEvent
   void treatEvent(const Event &) override;
 
@@ -26,7 +26,9 @@
 #include <cassert>
 #include <climits>
 #include <cstring>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <tulip/tulipconf.h>
 #include <tulip/StoredType.h>
 #include <tulip/DataSet.h>
@@ -45,7 +47,124 @@ public:
   ~IteratorValue() override {}
   virtual unsigned int nextValue(DataMem &) = 0;
 };
+//===================================================================
+// the pool of the distinct values shared by the elements
+// of a MutableContainer whose values are interned;
+// it is only implemented for std::string values (see below)
+template <typename TYPE>
+class ValuesPool {
+public:
+  enum { supported = 0 };
+
+  typename StoredType<TYPE>::Value intern(typename StoredType<TYPE>::ReturnedConstValue value) {
+    return StoredType<TYPE>::clone(value);
+  }
+
+  void release(typename StoredType<TYPE>::Value value) {
+    StoredType<TYPE>::destroy(value);
+  }
+
+  typename StoredType<TYPE>::Value find(typename StoredType<TYPE>::ReturnedConstValue) const {
+    return typename StoredType<TYPE>::Value();
+  }
+
+  unsigned int size() const {
+    return 0;
+  }
+
+  void clear() {}
+
+  // count the distinct values up to a given maximum
+  class DistinctCounter {
+  public:
+    DistinctCounter(unsigned int) {}
+
+    bool add(typename StoredType<TYPE>::Value) {
+      return false;
+    }
+  };
+};
+
+template <>
+class ValuesPool<std::string> {
+public:
+  enum { supported = 1 };
+
+  // return the shared copy of value
+  std::string *intern(const std::string &value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = values.find(value);
+
+    if (it == values.end())
+      it = values.emplace(value, 0).first;
+
+    ++(it->second);
+    return const_cast<std::string *>(&(it->first));
+  }
+
+  // release a shared copy returned by intern
+  void release(std::string *value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = values.find(*value);
+    assert(it != values.end() && &(it->first) == value);
+
+    if (--(it->second) == 0)
+      values.erase(it);
+  }
+
+  // return the shared copy of value or nullptr if there is none
+  std::string *find(const std::string &value) const {
+    auto it = values.find(value);
+    return it == values.end() ? nullptr : const_cast<std::string *>(&(it->first));
+  }
+
+  unsigned int size() const {
+    return values.size();
+  }
+
+  void clear() {
+    values.clear();
+  }
+
+  class DistinctCounter {
+  public:
+    DistinctCounter(unsigned int maxDistinct) : maxDistinct(maxDistinct) {}
+
+    // return false when there are more than maxDistinct values
+    bool add(const std::string *value) {
+      distinct.insert(value);
+      return distinct.size() <= maxDistinct;
+    }
+
+  private:
+    struct Hash {
+      size_t operator()(const std::string *value) const {
+        return std::hash<std::string>()(*value);
+      }
+    };
+
+    struct Equal {
+      bool operator()(const std::string *value1, const std::string *value2) const {
+        return *value1 == *value2;
+      }
+    };
+
+    unsigned int maxDistinct;
+    std::unordered_set<const std::string *, Hash, Equal> distinct;
+  };
+
+private:
+  // the values with their number of references
+  std::unordered_map<std::string, unsigned int> values;
+  std::mutex mutex;
+};
 ///@endcond
+
+/**
+ * the ways the values of a MutableContainer can be interned,
+ * i.e. stored once in a pool shared by all the elements having them
+ */
+enum InterningMode { NEVER_INTERNED = 0, ALWAYS_INTERNED = 1, AUTO_INTERNED = 2 };
 //===================================================================
 template <typename TYPE>
 class MutableContainer {
@@ -113,6 +232,33 @@ public:
    * invert the boolean value set to i (do nothing for non boolean value)
    */
   void invertBooleanValue(const unsigned int i);
+  /**
+   * set the way the values are interned. When they are interned,
+   * the elements having the same value share a single copy of it
+   * and the search of the elements having a given value (findAll)
+   * only compares pointers. In the AUTO_INTERNED mode, the values
+   * are interned until the number of distinct ones is high compared
+   * to the number of non default values. This is only checked when calling
+   * this method and setAll (for the values set afterwards), set never changes
+   * the way the values are stored.
+   * Only the std::string values can be interned.
+   * @warning the value returned by get(i, isNotDefault) must not be modified
+   * when the values are interned, and is invalidated when this method
+   * changes the way the values are stored.
+   */
+  void setInterningMode(InterningMode mode);
+  /**
+   * return the way the values are interned
+   */
+  InterningMode getInterningMode() const {
+    return interningMode;
+  }
+  /**
+   * return whether the values are currently interned
+   */
+  bool isInterned() const {
+    return pool != nullptr;
+  }
 
 private:
   MutableContainer(const MutableContainer<TYPE> &) {}
@@ -124,6 +270,18 @@ private:
   inline void vectset(const unsigned int i, typename StoredType<TYPE>::Value value);
   IteratorValue *findAllValues(typename StoredType<TYPE>::ReturnedConstValue value,
                                bool equal = true) const;
+  inline typename StoredType<TYPE>::Value
+  cloneValue(typename StoredType<TYPE>::ReturnedConstValue value) {
+    return pool ? pool->intern(value) : StoredType<TYPE>::clone(value);
+  }
+  inline void destroyValue(typename StoredType<TYPE>::Value value) {
+    if (pool)
+      pool->release(value);
+    else
+      StoredType<TYPE>::destroy(value);
+  }
+  void internValues(bool interned);
+  bool fewDistinctValues() const;
 
 private:
   std::deque<typename StoredType<TYPE>::Value> *vData;
@@ -131,10 +289,17 @@ private:
   unsigned int minIndex, maxIndex;
   typename StoredType<TYPE>::Value defaultValue;
   enum State { VECT = 0, HASH = 1 };
+  // in AUTO_INTERNED mode, the values are interned while there are less than
+  // INTERNING_MIN_VALUES non default ones, then they are interned when there is
+  // at most one distinct value for INTERNING_RATIO ones, and are no longer
+  // interned when there is more than two for INTERNING_RATIO ones
+  enum { INTERNING_MIN_VALUES = 1024, INTERNING_RATIO = 4 };
   State state;
   unsigned int elementInserted;
   double ratio;
   bool compressing;
+  ValuesPool<TYPE> *pool;
+  InterningMode interningMode;
 };
 
 //===================================================================
@@ -145,9 +310,11 @@ template <typename TYPE>
 class IteratorVect : public tlp::IteratorValue {
 public:
   IteratorVect(const TYPE &value, bool equal, std::deque<typename StoredType<TYPE>::Value> *vData,
-               unsigned int minIndex)
-      : _value(value), _equal(equal), _pos(minIndex), vData(vData), it(vData->begin()) {
-    while (it != (*vData).end() && StoredType<TYPE>::equal((*it), _value) != _equal) {
+               unsigned int minIndex, const ValuesPool<TYPE> *pool = nullptr)
+      : _value(value), _equal(equal), _pos(minIndex), vData(vData), it(vData->begin()),
+        _interned(pool ? pool->find(value) : typename StoredType<TYPE>::Value()),
+        _isInterned(pool != nullptr) {
+    while (it != (*vData).end() && match(*it) != _equal) {
       ++it;
       ++_pos;
     }
@@ -161,7 +328,7 @@ public:
     do {
       ++it;
       ++_pos;
-    } while (it != (*vData).end() && StoredType<TYPE>::equal((*it), _value) != _equal);
+    } while (it != (*vData).end() && match(*it) != _equal);
 
     return tmp;
   }
@@ -172,17 +339,24 @@ public:
     do {
       ++it;
       ++_pos;
-    } while (it != (*vData).end() && StoredType<TYPE>::equal((*it), _value) != _equal);
+    } while (it != (*vData).end() && match(*it) != _equal);
 
     return pos;
   }
 
 private:
+  // the interned values are compared by address
+  inline bool match(typename StoredType<TYPE>::Value value) const {
+    return _isInterned ? value == _interned : StoredType<TYPE>::equal(value, _value);
+  }
+
   const TYPE _value;
   bool _equal;
   unsigned int _pos;
   std::deque<typename StoredType<TYPE>::Value> *vData;
   typename std::deque<typename StoredType<TYPE>::Value>::const_iterator it;
+  typename StoredType<TYPE>::Value _interned;
+  bool _isInterned;
 };
 
 ///@cond DOXYGEN_HIDDEN
@@ -191,11 +365,14 @@ template <typename TYPE>
 class IteratorHash : public IteratorValue {
 public:
   IteratorHash(const TYPE &value, bool equal,
-               std::unordered_map<unsigned int, typename StoredType<TYPE>::Value> *hData)
-      : _value(value), _equal(equal), hData(hData) {
+               std::unordered_map<unsigned int, typename StoredType<TYPE>::Value> *hData,
+               const ValuesPool<TYPE> *pool = nullptr)
+      : _value(value), _equal(equal), hData(hData),
+        _interned(pool ? pool->find(value) : typename StoredType<TYPE>::Value()),
+        _isInterned(pool != nullptr) {
     it = (*hData).begin();
 
-    while (it != (*hData).end() && StoredType<TYPE>::equal((*it).second, _value) != _equal)
+    while (it != (*hData).end() && match((*it).second) != _equal)
       ++it;
   }
   bool hasNext() override {
@@ -206,7 +383,7 @@ public:
 
     do {
       ++it;
-    } while (it != (*hData).end() && StoredType<TYPE>::equal((*it).second, _value) != _equal);
+    } while (it != (*hData).end() && match((*it).second) != _equal);
 
     return tmp;
   }
@@ -216,16 +393,23 @@ public:
 
     do {
       ++it;
-    } while (it != (*hData).end() && StoredType<TYPE>::equal((*it).second, _value) != _equal);
+    } while (it != (*hData).end() && match((*it).second) != _equal);
 
     return pos;
   }
 
 private:
+  // the interned values are compared by address
+  inline bool match(typename StoredType<TYPE>::Value value) const {
+    return _isInterned ? value == _interned : StoredType<TYPE>::equal(value, _value);
+  }
+
   const TYPE _value;
   bool _equal;
   std::unordered_map<unsigned int, typename StoredType<TYPE>::Value> *hData;
   typename std::unordered_map<unsigned int, typename StoredType<TYPE>::Value>::const_iterator it;
+  typename StoredType<TYPE>::Value _interned;
+  bool _isInterned;
 };
 ///@endcond
 } // namespace tlp
@@ -0,0 +1,400 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+///@cond DOXYGEN_HIDDEN
+
+#ifndef TULIP_PACKEDRTREE_H
+#define TULIP_PACKEDRTREE_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <tulip/Rectangle.h>
+#include <tulip/ParallelTools.h>
+
+namespace tlp {
+
+/** \brief Static R-tree template class, bulk loaded in parallel
+ *
+ * Unlike QuadTreeNode, whose elements are inserted one at a time,
+ * all the elements of a PackedRTree are given at once to build().
+ * They are sorted along a Morton (Z-order) curve according to the center of their boxes,
+ * then packed by groups of nodeCapacity to form the leaves of the tree,
+ * and recursively to form its upper levels. The sorting and the computation
+ * of the levels, as well as the queries of large trees, are performed concurrently;
+ * the order of the returned elements does not depend on the number of threads.
+ *
+ * The box of an element can be updated afterwards, only the boxes of its ancestors
+ * are then refitted. As this degrades the efficiency of the queries when elements
+ * move far away, the tree should be rebuilt after large modifications.
+ */
+template <class TYPE>
+class PackedRTree {
+
+public:
+  /**
+   * Constructor, nodeCapacity is the maximum number of children of a node of the tree
+   */
+  PackedRTree(unsigned int nodeCapacity = 16) : capacity(std::max(nodeCapacity, 2u)) {}
+
+  /**
+   * Builds the tree with the elements of elements;
+   * boxes[i] must be the bounding box of elements[i].
+   * The element of index i can then be updated with update(i, box)
+   */
+  void build(const std::vector<tlp::Rectangle<float>> &boxes, const std::vector<TYPE> &elements) {
+    assert(boxes.size() == elements.size());
+    unsigned int nbElements = elements.size();
+    levels.clear();
+    elts.clear();
+    eltPos.clear();
+
+    if (nbElements == 0)
+      return;
+
+    // compute the bounding box of the centers of the elements
+    std::vector<tlp::Rectangle<float>> threadBoxes(ThreadManager::getNumberOfThreads());
+    // not a vector<bool>: its elements are set concurrently by the threads
+    std::vector<unsigned char> threadBoxesOK(threadBoxes.size(), false);
+    TLP_PARALLEL_MAP_INDICES(nbElements, [&](unsigned int i) {
+      unsigned int ti = ThreadManager::getThreadNumber();
+      const tlp::Rectangle<float> &box = boxes[i];
+      float x = (box[0][0] + box[1][0]) / 2.f;
+      float y = (box[0][1] + box[1][1]) / 2.f;
+      tlp::Rectangle<float> &tBox = threadBoxes[ti];
+
+      if (!threadBoxesOK[ti]) {
+        tBox[0][0] = tBox[1][0] = x;
+        tBox[0][1] = tBox[1][1] = y;
+        threadBoxesOK[ti] = true;
+      } else {
+        tBox[0][0] = std::min(tBox[0][0], x);
+        tBox[1][0] = std::max(tBox[1][0], x);
+        tBox[0][1] = std::min(tBox[0][1], y);
+        tBox[1][1] = std::max(tBox[1][1], y);
+      }
+    });
+    tlp::Rectangle<float> centersBox;
+    bool centersBoxOK = false;
+
+    for (unsigned int i = 0; i < threadBoxes.size(); ++i) {
+      if (threadBoxesOK[i]) {
+        if (centersBoxOK) {
+          unite(centersBox, threadBoxes[i]);
+        } else {
+          centersBox = threadBoxes[i];
+          centersBoxOK = true;
+        }
+      }
+    }
+
+    // sort the elements according to the Morton code of their centers
+    float xScale = centersBox[1][0] > centersBox[0][0]
+                       ? 65535.f / (centersBox[1][0] - centersBox[0][0])
+                       : 0.f;
+    float yScale = centersBox[1][1] > centersBox[0][1]
+                       ? 65535.f / (centersBox[1][1] - centersBox[0][1])
+                       : 0.f;
+    std::vector<std::pair<unsigned int, unsigned int>> codes(nbElements);
+    TLP_PARALLEL_MAP_INDICES(nbElements, [&](unsigned int i) {
+      const tlp::Rectangle<float> &box = boxes[i];
+      float x = (box[0][0] + box[1][0]) / 2.f;
+      float y = (box[0][1] + box[1][1]) / 2.f;
+      codes[i] = std::make_pair(
+          mortonCode(static_cast<unsigned int>((x - centersBox[0][0]) * xScale),
+                     static_cast<unsigned int>((y - centersBox[0][1]) * yScale)),
+          i);
+    });
+    parallelSort(codes);
+
+    // build the leaves level
+    elts.resize(nbElements);
+    eltPos.resize(nbElements);
+    levels.emplace_back(nbElements);
+    TLP_PARALLEL_MAP_INDICES(nbElements, [&](unsigned int i) {
+      unsigned int index = codes[i].second;
+      elts[i] = elements[index];
+      eltPos[index] = i;
+      levels[0][i] = boxes[index];
+    });
+
+    // then the upper levels until the root
+    while (levels.back().size() > 1) {
+      std::vector<tlp::Rectangle<float>> parents((levels.back().size() + capacity - 1) / capacity);
+      const std::vector<tlp::Rectangle<float>> &children = levels.back();
+      TLP_PARALLEL_MAP_INDICES(parents.size(), [&](unsigned int i) {
+        parents[i] = unionOfChildren(children, i);
+      });
+      levels.push_back(std::move(parents));
+    }
+  }
+
+  /**
+   * Returns the number of elements of the tree
+   */
+  unsigned int size() const {
+    return elts.size();
+  }
+
+  /**
+   * Returns true if the tree has no element
+   */
+  bool empty() const {
+    return elts.empty();
+  }
+
+  /**
+   * Returns the bounding box of all the elements of the tree
+   * \warning the tree must not be empty
+   */
+  const tlp::Rectangle<float> &getBoundingBox() const {
+    assert(!empty());
+    return levels.back()[0];
+  }
+
+  /**
+   * Changes the bounding box of the element of index i in the vectors given to build()
+   */
+  void update(unsigned int i, const tlp::Rectangle<float> &box) {
+    assert(i < eltPos.size());
+    unsigned int pos = eltPos[i];
+    levels[0][pos] = box;
+
+    for (unsigned int l = 1; l < levels.size(); ++l) {
+      pos /= capacity;
+      levels[l][pos] = unionOfChildren(levels[l - 1], pos);
+    }
+  }
+
+  /**
+   * Returns all the elements whose bounding box intersects box
+   */
+  void getElements(const tlp::Rectangle<float> &box, std::vector<TYPE> &result) const {
+    query(result, [&](unsigned int l, unsigned int i, std::vector<TYPE> &res) {
+      getElements(box, l, i, res);
+    });
+  }
+
+  /**
+   * Returns all the elements of the tree
+   */
+  void getElements(std::vector<TYPE> &result) const {
+    result.insert(result.end(), elts.begin(), elts.end());
+  }
+
+  /**
+   * Same as getElements(box, result) except that when a subtree
+   * is smaller than box / ratio, only one of its elements is returned
+   */
+  void getElementsWithRatio(const tlp::Rectangle<float> &box, std::vector<TYPE> &result,
+                            float ratio = 1000.) const {
+    query(result, [&](unsigned int l, unsigned int i, std::vector<TYPE> &res) {
+      getElementsWithRatio(box, ratio, l, i, res);
+    });
+  }
+
+private:
+  // under that number of elements, queries are not worth being parallelized
+  static const unsigned int MIN_PARALLEL_QUERY_SIZE = 4096;
+
+  static void unite(tlp::Rectangle<float> &box, const tlp::Rectangle<float> &other) {
+    box[0][0] = std::min(box[0][0], other[0][0]);
+    box[0][1] = std::min(box[0][1], other[0][1]);
+    box[1][0] = std::max(box[1][0], other[1][0]);
+    box[1][1] = std::max(box[1][1], other[1][1]);
+  }
+
+  // interleave the 16 lower bits of x and y
+  static unsigned int mortonCode(unsigned int x, unsigned int y) {
+    auto spread = [](unsigned int v) {
+      v &= 0xFFFF;
+      v = (v | (v << 8)) & 0x00FF00FF;
+      v = (v | (v << 4)) & 0x0F0F0F0F;
+      v = (v | (v << 2)) & 0x33333333;
+      v = (v | (v << 1)) & 0x55555555;
+      return v;
+    };
+    return spread(x) | (spread(y) << 1);
+  }
+
+  // sort concurrently some chunks of v, then merge them
+  static void parallelSort(std::vector<std::pair<unsigned int, unsigned int>> &v) {
+    unsigned int nbChunks = ThreadManager::getNumberOfThreads();
+    size_t nb = v.size();
+
+    if (nbChunks < 2 || nb < 2 * MIN_PARALLEL_QUERY_SIZE) {
+      std::sort(v.begin(), v.end());
+      return;
+    }
+
+    size_t chunkSize = (nb + nbChunks - 1) / nbChunks;
+    TLP_PARALLEL_MAP_INDICES(nbChunks, [&](unsigned int i) {
+      std::sort(v.begin() + std::min(i * chunkSize, nb),
+                v.begin() + std::min((i + 1) * chunkSize, nb));
+    });
+
+    for (size_t width = chunkSize; width < nb; width *= 2) {
+      TLP_PARALLEL_MAP_INDICES((nb + 2 * width - 1) / (2 * width), [&](unsigned int i) {
+        size_t first = i * 2 * width;
+        size_t middle = std::min(first + width, nb);
+        size_t last = std::min(first + 2 * width, nb);
+
+        if (middle < last)
+          std::inplace_merge(v.begin() + first, v.begin() + middle, v.begin() + last);
+      });
+    }
+  }
+
+  // compute the box of the node i of a level from the boxes of its children
+  tlp::Rectangle<float> unionOfChildren(const std::vector<tlp::Rectangle<float>> &children,
+                                        unsigned int i) const {
+    unsigned int first = i * capacity;
+    unsigned int last = std::min(first + capacity, static_cast<unsigned int>(children.size()));
+    tlp::Rectangle<float> box = children[first];
+
+    for (unsigned int j = first + 1; j < last; ++j)
+      unite(box, children[j]);
+
+    return box;
+  }
+
+  // the range of the children of the node i of the level l
+  std::pair<unsigned int, unsigned int> childrenOf(unsigned int l, unsigned int i) const {
+    unsigned int first = i * capacity;
+    return std::make_pair(
+        first, std::min(first + capacity, static_cast<unsigned int>(levels[l - 1].size())));
+  }
+
+  // run the query fn on the whole tree; for large trees the nodes of a level
+  // are split into consecutive ranges processed concurrently whose results are
+  // appended in order
+  template <typename QUERY>
+  void query(std::vector<TYPE> &result, const QUERY &fn) const {
+    if (levels.empty())
+      return;
+
+    unsigned int nbThreads = ThreadManager::getNumberOfThreads();
+
+    if (nbThreads < 2 || elts.size() < MIN_PARALLEL_QUERY_SIZE) {
+      fn(levels.size() - 1, 0, result);
+      return;
+    }
+
+    // find the highest level with enough nodes to feed the threads
+    unsigned int l = levels.size() - 1;
+
+    while (l > 0 && levels[l].size() < 4 * nbThreads)
+      --l;
+
+    unsigned int nbNodes = levels[l].size();
+    unsigned int nbRanges = std::min(nbNodes, 4 * nbThreads);
+    std::vector<std::vector<TYPE>> results(nbRanges);
+    TLP_PARALLEL_MAP_INDICES(nbRanges, [&](unsigned int r) {
+      unsigned int last = (size_t(r) + 1) * nbNodes / nbRanges;
+
+      for (unsigned int i = size_t(r) * nbNodes / nbRanges; i < last; ++i)
+        fn(l, i, results[r]);
+    });
+    size_t nbResults = result.size();
+
+    for (const auto &res : results)
+      nbResults += res.size();
+
+    result.reserve(nbResults);
+
+    for (const auto &res : results)
+      result.insert(result.end(), res.begin(), res.end());
+  }
+
+  void getElements(const tlp::Rectangle<float> &box, unsigned int l, unsigned int i,
+                   std::vector<TYPE> &result) const {
+    if (!levels[l][i].intersect(box))
+      return;
+
+    if (l == 0) {
+      result.push_back(elts[i]);
+      return;
+    }
+
+    auto children = childrenOf(l, i);
+
+    for (unsigned int j = children.first; j < children.second; ++j)
+      getElements(box, l - 1, j, result);
+  }
+
+  void getElementsWithRatio(const tlp::Rectangle<float> &box, float ratio, unsigned int l,
+                            unsigned int i, std::vector<TYPE> &result) const {
+    const tlp::Rectangle<float> &nodeBox = levels[l][i];
+
+    if (!nodeBox.intersect(box))
+      return;
+
+    if (l == 0) {
+      result.push_back(elts[i]);
+      return;
+    }
+
+    float xRatio = (box[1][0] - box[0][0]) / (nodeBox[1][0] - nodeBox[0][0]);
+    float yRatio = (box[1][1] - box[0][1]) / (nodeBox[1][1] - nodeBox[0][1]);
+    auto children = childrenOf(l, i);
+
+    if (xRatio < ratio || yRatio < ratio) {
+      for (unsigned int j = children.first; j < children.second; ++j)
+        getElementsWithRatio(box, ratio, l - 1, j, result);
+    } else {
+      // the elements of this subtree are too small to be distinguished,
+      // only the first one intersecting box is returned
+      getOneElement(box, l, i, result);
+    }
+  }
+
+  bool getOneElement(const tlp::Rectangle<float> &box, unsigned int l, unsigned int i,
+                     std::vector<TYPE> &result) const {
+    if (!levels[l][i].intersect(box))
+      return false;
+
+    if (l == 0) {
+      result.push_back(elts[i]);
+      return true;
+    }
+
+    auto children = childrenOf(l, i);
+
+    for (unsigned int j = children.first; j < children.second; ++j) {
+      if (getOneElement(box, l - 1, j, result))
+        return true;
+    }
+
+    return false;
+  }
+
+  unsigned int capacity;
+  // the elements sorted along the Morton curve
+  std::vector<TYPE> elts;
+  // the position in elts of each element given to build()
+  std::vector<unsigned int> eltPos;
+  // levels[0][i] is the box of elts[i], levels[l][i] is the union
+  // of levels[l - 1][i * capacity] to levels[l - 1][(i + 1) * capacity - 1],
+  // the last level holds the box of the root
+  std::vector<std::vector<tlp::Rectangle<float>>> levels;
+};
+} // namespace tlp
+
+#endif // TULIP_PACKEDRTREE_H
+///@endcond
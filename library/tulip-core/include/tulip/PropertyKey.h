@@ -0,0 +1,81 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef TULIP_PROPERTYKEY_H
+#define TULIP_PROPERTYKEY_H
+
+#include <string>
+
+#include <tulip/tulipconf.h>
+
+namespace tlp {
+
+/**
+ * @ingroup Graph
+ * @brief An interned property name, to look up a property of a graph
+ * without comparing or hashing its name.
+ *
+ * Each distinct name is registered once for the whole process and identified
+ * by a small integer id. A graph keeps its properties indexed by these ids,
+ * so Graph::findProperty() and Graph::getProperty<PropertyType>(const PropertyKey&)
+ * only cost an array access, even for an inherited property.
+ * The keys are intended to be built once, e.g. as static variables,
+ * and used in the loops needing the properties.
+ *
+ * @code
+ * static const PropertyKey viewLayoutKey("viewLayout");
+ * LayoutProperty *layout = graph->getProperty<LayoutProperty>(viewLayoutKey);
+ * @endcode
+ */
+class TLP_SCOPE PropertyKey {
+public:
+  explicit PropertyKey(const std::string &name);
+  explicit PropertyKey(const char *name) : PropertyKey(std::string(name)) {}
+
+  /**
+   * @brief Returns the id of the key, the ids are consecutive from 0.
+   */
+  unsigned int getId() const {
+    return id;
+  }
+
+  /**
+   * @brief Returns the property name.
+   */
+  const std::string &getName() const;
+
+  bool operator==(const PropertyKey &key) const {
+    return id == key.id;
+  }
+
+  bool operator!=(const PropertyKey &key) const {
+    return id != key.id;
+  }
+
+  /**
+   * @brief Returns the number of registered keys.
+   */
+  static unsigned int getNumberOfKeys();
+
+private:
+  unsigned int id;
+};
+} // namespace tlp
+
+#endif // TULIP_PROPERTYKEY_H
@@ -21,8 +21,9 @@
 #ifndef TLP_PROPERTYMANAGER_H
 #define TLP_PROPERTYMANAGER_H
 
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace tlp {
 
@@ -30,13 +31,19 @@ template <class itType>
 struct Iterator;
 
 class PropertyInterface;
+class PropertyKey;
 class Graph;
 
 class PropertyManager {
 
 private:
-  std::map<std::string, PropertyInterface *> localProperties;
-  std::map<std::string, PropertyInterface *> inheritedProperties;
+  std::unordered_map<std::string, PropertyInterface *> localProperties;
+  std::unordered_map<std::string, PropertyInterface *> inheritedProperties;
+  // the local or inherited properties indexed by the id of the PropertyKey
+  // of their names; the entries are updated when the properties change
+  std::vector<PropertyInterface *> keyProperties;
+
+  void updateKeyProperty(const std::string &);
 
 public:
   Graph *graph;
@@ -51,6 +58,7 @@ public:
   PropertyInterface *getProperty(const std::string &) const;
   PropertyInterface *getLocalProperty(const std::string &) const;
   PropertyInterface *getInheritedProperty(const std::string &) const;
+  PropertyInterface *findProperty(const PropertyKey &key) const;
   void delLocalProperty(const std::string &);
   void notifyBeforeDelInheritedProperty(const std::string &);
   void erase(const node);
@@ -52,6 +52,37 @@ public:
   }
   int compare(const node n1, const node n2) const override;
   int compare(const edge e1, const edge e2) const override;
+
+  /**
+   * @brief Sets how the values of the nodes and edges are stored.
+   * When they are interned, each distinct value is stored once in a pool
+   * shared by the elements having it, which saves memory and speeds up
+   * the search of the elements having a given value when there are few
+   * distinct values (categories, types, ...).
+   * By default (AUTO_INTERNED), the values are first interned, then
+   * they are interned or not depending on their ratio of distinct values.
+   * It is only checked when calling this method and when setting all the values
+   * (for the values set afterwards) so that the references returned by getNodeValue()
+   * or getEdgeValue() are not invalidated when setting the values of other elements.
+   */
+  void setInterningMode(InterningMode mode) {
+    nodeProperties.setInterningMode(mode);
+    edgeProperties.setInterningMode(mode);
+  }
+
+  /**
+   * @brief Returns whether the values of the nodes are currently interned.
+   */
+  bool nodeValuesInterned() const {
+    return nodeProperties.isInterned();
+  }
+
+  /**
+   * @brief Returns whether the values of the edges are currently interned.
+   */
+  bool edgeValuesInterned() const {
+    return edgeProperties.isInterned();
+  }
 };
 
 /**
@@ -21,9 +21,12 @@
 #ifndef TLPPARSER_H
 #define TLPPARSER_H
 
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <sstream>
 #include <string>
-#include <list>
+#include <vector>
 
 namespace tlp {
 
@@ -60,221 +63,438 @@ enum TLPToken {
   RANGETOKEN
 };
 //=====================================================================================
-struct TLPTokenParser {
-  int curLine;
+// The input stream is read by blocks in this buffer, which is also the one of
+// the stream given to the builders reading their input by themselves (see TLPBuilder::read).
+// The tokens are located in place in the buffer, instead of being read char by char.
+class TLPInputBuffer : public std::streambuf {
   std::istream &is;
-  TLPTokenParser(std::istream &i) : curLine(0), is(i) {}
+  std::vector<char> buffer;
+  // the number of chars of the input before the ones in the buffer
+  size_t offset;
+
+  static const size_t BLOCK_SIZE = 1 << 20;
+  // the number of chars kept before the current one,
+  // to allow the builders reading their input to unget a few ones
+  static const size_t PUTBACK_SIZE = 16;
+
+public:
+  TLPInputBuffer(std::istream &is) : is(is), buffer(BLOCK_SIZE + 1, '\0'), offset(0) {
+    setg(buffer.data(), buffer.data(), buffer.data());
+  }
+
+  const char *current() const {
+    return gptr();
+  }
 
-  bool newLine(char ch, int &curPos) {
-    if (ch != '\n') {
-      is.get(ch);
+  const char *end() const {
+    return egptr();
+  }
 
-      if (ch != '\n') {
-        is.unget();
-        return false;
-      }
+  // pos must be in [current(), end()]
+  void moveTo(const char *pos) {
+    gbump(int(pos - gptr()));
+  }
+
+  // the number of chars of the input already consumed
+  size_t position() const {
+    return offset + (gptr() - eback());
+  }
+
+  // reads the next block of the input when all the buffered chars have been consumed;
+  // the chars from keep (which cannot be after current()) are kept at the beginning of
+  // the buffer, keep is updated accordingly.
+  // Returns false if there is nothing more to read.
+  bool fill(const char *&keep) {
+    size_t keepPos = keep - eback();
+    size_t putback = keepPos < PUTBACK_SIZE ? keepPos : PUTBACK_SIZE;
+    size_t from = keepPos - putback;
+    size_t nbKept = (egptr() - eback()) - from;
+    size_t curPos = (gptr() - eback()) - from;
+
+    if (nbKept)
+      memmove(buffer.data(), buffer.data() + from, nbKept);
+
+    offset += from;
+
+    // the buffer grows with the tokens longer than a block
+    if (buffer.size() < nbKept + BLOCK_SIZE + 1)
+      buffer.resize(nbKept + BLOCK_SIZE + 1);
+
+    is.read(buffer.data() + nbKept, BLOCK_SIZE);
+    size_t nbRead = is.gcount();
+    buffer[nbKept + nbRead] = '\0';
+    setg(buffer.data(), buffer.data() + curPos, buffer.data() + nbKept + nbRead);
+    keep = buffer.data() + putback;
+    return nbRead != 0;
+  }
+
+protected:
+  // only the chars still in the buffer can be reached
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    off_type bufferPos = off_type(pos) - off_type(offset);
+
+    if (!(which & std::ios_base::in) || bufferPos < 0 || bufferPos > egptr() - eback())
+      return pos_type(off_type(-1));
+
+    setg(eback(), eback() + bufferPos, egptr());
+    return pos;
+  }
 
-      ++curPos;
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override {
+    if (dir != std::ios_base::cur)
+      return pos_type(off_type(-1));
+
+    return seekpos(pos_type(off_type(position()) + off), which);
+  }
+
+  int_type underflow() override {
+    if (gptr() == egptr()) {
+      const char *keep = gptr();
+
+      if (!fill(keep))
+        return traits_type::eof();
     }
 
-    ++curLine;
-    return true;
+    return traits_type::to_int_type(*gptr());
+  }
+};
+//=====================================================================================
+struct TLPTokenParser {
+  int curLine;
+  TLPInputBuffer &buffer;
+  // the end of the chars available in the buffer
+  const char *end;
+
+  TLPTokenParser(TLPInputBuffer &buffer) : curLine(0), buffer(buffer), end(buffer.end()) {}
+
+  // makes sure *p is available, the chars from keep being kept in the buffer
+  // when a new block is read; returns false at the end of the input
+  inline bool available(const char *&p, const char *&keep) {
+    if (p != end)
+      return true;
+
+    buffer.moveTo(p);
+    buffer.fill(keep);
+    p = buffer.current();
+    end = buffer.end();
+    return p != end;
+  }
+
+  inline void consume(const char *p, int &curPos) {
+    buffer.moveTo(p);
+    curPos = int(buffer.position());
   }
 
   TLPToken nextToken(TLPValue &val, int &curPos) {
     val.str.erase();
-    bool endOfStream = false, strGet = false, slashMode = false, started = false, stop = false,
-         strComment = false;
-    char ch;
+    // the buffer may have been read by a builder since the last token
+    const char *p = buffer.current();
+    end = buffer.end();
+
+    // skip the separators
+    for (;;) {
+      if (!available(p, p)) {
+        consume(p, curPos);
+        return ENDOFSTREAM;
+      }
 
-    while ((!stop) && (endOfStream = !(is.get(ch).fail()))) {
-      ++curPos;
+      char ch = *p;
 
-      if (strGet)
-        switch (ch) {
-        case 13:
-        case '\n':
-          if (!newLine(ch, curPos))
-            break;
+      if (ch == ' ' || ch == '\t')
+        ++p;
+      else if (ch == '\n') {
+        ++p;
+        ++curLine;
+      } else if (ch == 13) {
+        ++p;
 
-          val.str += ch;
-          break;
+        // "\r\n" is a new line, a single '\r' is ignored
+        if (available(p, p) && *p == '\n') {
+          ++p;
+          ++curLine;
+        }
+      } else
+        break;
+    }
 
-        case '\t':
-          val.str += "    ";
-          break;
+    switch (*p) {
+    case '(':
+      consume(p + 1, curPos);
+      return OPENTOKEN;
 
-        case '\\':
+    case ')':
+      consume(p + 1, curPos);
+      return CLOSETOKEN;
 
-          if (!slashMode) {
-            slashMode = true;
-          } else {
-            val.str += ch;
-            slashMode = false;
-          }
+    case '"':
+      return nextString(val, p + 1, curPos);
 
-          break;
+    case ';':
+      return nextComment(val, p + 1, curPos);
 
-        case '"':
+    default:
+      break;
+    }
 
-          if (!slashMode) {
-            return STRINGTOKEN;
-          } else {
-            val.str += ch;
-            slashMode = false;
-          }
+    // the token ends with a separator, a parenthesis, a double quote or a semicolon
+    const char *start = p;
 
-          break;
+    for (;;) {
+      if (!available(p, start)) {
+        val.str.append(start, p - start);
+        break;
+      }
 
-        case 'n':
-          if (slashMode) {
-            val.str += '\n';
-            slashMode = false;
-            break;
-          }
+      char ch = *p;
 
-        default:
-          if (!slashMode)
-            val.str += ch;
+      if (ch == ' ' || ch == '\t' || ch == '\n') {
+        val.str.append(start, p - start);
+        ++p;
 
-          slashMode = false;
+        if (ch == '\n')
+          ++curLine;
+
+        break;
+      }
+
+      if (ch == '(' || ch == ')' || ch == '"' || ch == ';') {
+        val.str.append(start, p - start);
+        break;
+      }
+
+      if (ch == 13) {
+        val.str.append(start, p - start);
+        ++p;
+
+        if (available(p, p) && *p == '\n') {
+          ++p;
+          ++curLine;
           break;
         }
-      else if (strComment)
-        switch (ch) {
-        case 13:
-        case '\n':
-          if (!newLine(ch, curPos))
-            break;
-
-          stop = true;
-          return COMMENTTOKEN;
-          break;
 
-        default:
+        // a single '\r' is ignored
+        start = p;
+        continue;
+      }
+
+      ++p;
+    }
+
+    consume(p, curPos);
+    return valueToken(val);
+  }
+
+  // p follows the opening double quote
+  TLPToken nextString(TLPValue &val, const char *p, int &curPos) {
+    const char *start = p;
+
+    // the chars up to the first one needing a conversion are copied at once
+    for (;;) {
+      if (!available(p, start)) {
+        // no closing double quote
+        val.str.append(start, p - start);
+        consume(p, curPos);
+        return valueToken(val);
+      }
+
+      char ch = *p;
+
+      if (ch == '"') {
+        val.str.append(start, p - start);
+        consume(p + 1, curPos);
+        return STRINGTOKEN;
+      }
+
+      if (ch == '\\' || ch == '\t' || ch == '\n' || ch == 13)
+        break;
+
+      ++p;
+    }
+
+    val.str.append(start, p - start);
+    bool slashMode = false;
+
+    while (available(p, p)) {
+      char ch = *p++;
+
+      switch (ch) {
+      case 13:
+
+        // "\r\n" gives '\r', a single '\r' is ignored
+        if (available(p, p) && *p == '\n') {
+          ++p;
+          ++curLine;
           val.str += ch;
-          break;
         }
-      else
-        switch (ch) {
-        case ' ':
-        case '\t':
-          if (started)
-            stop = true;
 
-          break;
+        break;
 
-        case 13:
-        case '\n':
-          if (!newLine(ch, curPos))
-            break;
+      case '\n':
+        ++curLine;
+        val.str += ch;
+        break;
 
-          if (started)
-            stop = true;
+      case '\t':
+        val.str += "    ";
+        break;
 
-          break;
+      case '\\':
 
-        case '(':
-          if (!started)
-            return OPENTOKEN;
-          else {
-            --curPos;
-            is.unget();
-            stop = true;
-          }
+        if (!slashMode) {
+          slashMode = true;
+        } else {
+          val.str += ch;
+          slashMode = false;
+        }
 
-          break;
+        break;
+
+      case '"':
+
+        if (!slashMode) {
+          consume(p, curPos);
+          return STRINGTOKEN;
+        } else {
+          val.str += ch;
+          slashMode = false;
+        }
 
-        case ')':
-          if (!started)
-            return CLOSETOKEN;
-          else {
-            --curPos;
-            is.unget();
-            stop = true;
-          }
+        break;
 
+      case 'n':
+        if (slashMode) {
+          val.str += '\n';
+          slashMode = false;
           break;
+        }
 
-        case '"':
-          strGet = true;
+      default:
+        if (!slashMode)
+          val.str += ch;
 
-          if (started) {
-            --curPos;
-            is.unget();
-            stop = true;
-          } else
-            started = true;
+        slashMode = false;
+        break;
+      }
+    }
 
-          break;
+    // no closing double quote
+    consume(p, curPos);
+    return valueToken(val);
+  }
 
-        case ';':
-          strComment = true;
+  // p follows the semicolon
+  TLPToken nextComment(TLPValue &val, const char *p, int &curPos) {
+    const char *start = p;
 
-          if (started) {
-            --curPos;
-            is.unget();
-            stop = true;
-          } else
-            started = true;
+    while (available(p, start)) {
+      char ch = *p;
 
-          break;
+      if (ch == '\n') {
+        val.str.append(start, p - start);
+        ++curLine;
+        consume(p + 1, curPos);
+        return COMMENTTOKEN;
+      }
 
-        default:
-          val.str += ch;
-          started = true;
-          break;
+      if (ch == 13) {
+        val.str.append(start, p - start);
+        ++p;
+
+        if (available(p, p) && *p == '\n') {
+          ++curLine;
+          consume(p + 1, curPos);
+          return COMMENTTOKEN;
         }
+
+        // a single '\r' is ignored
+        start = p;
+        continue;
+      }
+
+      ++p;
     }
 
-    if (!started && !endOfStream)
-      return ENDOFSTREAM;
+    // no end of line
+    val.str.append(start, p - start);
+    consume(p, curPos);
+    return valueToken(val);
+  }
+
+  // parses the decimal integer at the beginning of str as strtol does
+  // (str contains no space), returns the end of the integer or str if there is none
+  static const char *parseLong(const char *str, long &result, bool &overflow) {
+    const char *p = str;
+    bool negative = false;
+
+    if (*p == '-' || *p == '+')
+      negative = (*p++ == '-');
 
-    char *endPtr = nullptr;
+    if (*p < '0' || *p > '9')
+      return str;
+
+    unsigned long max = negative ? static_cast<unsigned long>(LONG_MAX) + 1 : LONG_MAX;
+    unsigned long value = 0;
+    overflow = false;
+
+    for (; *p >= '0' && *p <= '9'; ++p) {
+      unsigned int digit = *p - '0';
+
+      if (value > (max - digit) / 10)
+        overflow = true;
+      else
+        value = value * 10 + digit;
+    }
+
+    result = negative ? static_cast<long>(0 - value) : static_cast<long>(value);
+    return p;
+  }
+
+  // returns the type of the token in val.str
+  TLPToken valueToken(TLPValue &val) {
     const char *cstr = val.str.c_str();
+    const char *strEnd = cstr + val.str.length();
+    long resultl = 0;
+    bool overflow = false;
     errno = 0;
-    long resultl = strtol(cstr, &endPtr, 10);
+    const char *endPtr = parseLong(cstr, resultl, overflow);
 
-    if (errno == ERANGE)
+    if (overflow) {
+      errno = ERANGE;
       return ERRORINFILE;
+    }
 
-    unsigned long strlength = val.str.length();
-
-    if (endPtr == (cstr + strlength)) {
+    if (endPtr == strEnd) {
       val.integer = resultl;
       return INTTOKEN;
     }
 
     // check for a range
-    if (endPtr > cstr && (cstr + strlength) > (endPtr + 2)) {
+    if (endPtr > cstr && strEnd > (endPtr + 2) && endPtr[0] == '.' && endPtr[1] == '.') {
       val.range.first = resultl;
+      endPtr = parseLong(endPtr + 2, resultl, overflow);
 
-      if ((endPtr[0] == '.') && (endPtr[1] == '.')) {
-        char *beginPtr = endPtr + 2;
-        errno = 0;
-        resultl = strtol(beginPtr, &endPtr, 10);
+      if (overflow) {
+        errno = ERANGE;
+        return ERRORINFILE;
+      }
 
-        if (errno == ERANGE)
+      if (endPtr == strEnd) {
+        if (resultl < val.range.first)
           return ERRORINFILE;
 
-        if (endPtr == (cstr + strlength)) {
-          if (resultl < val.range.first)
-            return ERRORINFILE;
-
-          val.range.second = resultl;
-          return RANGETOKEN;
-        }
+        val.range.second = resultl;
+        return RANGETOKEN;
       }
     }
 
-    endPtr = nullptr;
-
-    double resultd = strtod(cstr, &endPtr);
+    char *dEndPtr = nullptr;
+    double resultd = strtod(cstr, &dEndPtr);
 
     if (errno == ERANGE)
       return ERRORINFILE;
 
-    if (endPtr == (cstr + strlength)) {
+    if (dEndPtr == strEnd) {
       val.real = resultd;
       return DOUBLETOKEN;
     }
@@ -289,10 +509,7 @@ struct TLPTokenParser {
       return BOOLTOKEN;
     }
 
-    if (started)
-      return STRINGTOKEN;
-
-    return ERRORINFILE;
+    return STRINGTOKEN;
   }
 };
 //=====================================================================================
@@ -366,35 +583,43 @@ struct TLPFalse : public TLPBuilder {
 };
 //=====================================================================================
 struct TLPParser {
-  std::list<TLPBuilder *> builderStack;
-  std::istream &inputStream;
+  std::vector<TLPBuilder *> builderStack;
+  TLPInputBuffer inputBuffer;
+  // the stream given to the builders reading their input by themselves
+  std::istream inputStream;
   TLPTokenParser *tokenParser;
   PluginProgress *pluginProgress;
   std::string errorMsg;
+  // the line of the error when it is not the current one (values converted by batches)
+  int errorLine;
   int fileSize, curPos;
   bool displayComment;
 
+  // the number of chars read between two progress notifications
+  static const int PROGRESS_STEP = 1 << 16;
+
   TLPParser(std::istream &inputStream, TLPBuilder *builder, PluginProgress *pluginProgress,
             int size, bool dispComment = false)
-      : inputStream(inputStream), pluginProgress(pluginProgress), fileSize(size), curPos(0),
-        displayComment(dispComment) {
-    builderStack.push_front(builder);
+      : inputBuffer(inputStream), inputStream(&inputBuffer), pluginProgress(pluginProgress),
+        errorLine(-1), fileSize(size), curPos(0), displayComment(dispComment) {
+    builderStack.push_back(builder);
     builder->parser = this;
   }
 
   ~TLPParser() {
     while (!builderStack.empty()) {
-      TLPBuilder *builder = builderStack.front();
-      builderStack.pop_front();
+      TLPBuilder *builder = builderStack.back();
+      builderStack.pop_back();
 
-      if (builderStack.empty() || builder != builderStack.front())
+      if (builderStack.empty() || builder != builderStack.back())
         delete builder;
     }
   }
 
   bool formatError(const std::string &value) {
     std::stringstream ess;
-    ess << "Error when parsing '" << value.c_str() << "' at line " << tokenParser->curLine + 1;
+    ess << "Error when parsing '" << value.c_str() << "' at line "
+        << (errorLine < 0 ? tokenParser->curLine : errorLine) + 1;
 
     if (errno)
       ess << std::endl << strerror(errno);
@@ -406,15 +631,19 @@ struct TLPParser {
   }
 
   bool parse() {
-    TLPTokenParser tParser(inputStream);
+    TLPTokenParser tParser(inputBuffer);
     tokenParser = &tParser;
     TLPToken currentToken;
     TLPValue currentValue;
+    int nextProgress = PROGRESS_STEP;
 
     while ((currentToken = tokenParser->nextToken(currentValue, curPos)) != ENDOFSTREAM) {
-      if (curPos % 2000 == 1)
+      if (curPos >= nextProgress) {
+        nextProgress = curPos < INT_MAX - PROGRESS_STEP ? curPos + PROGRESS_STEP : INT_MAX;
+
         if (pluginProgress->progress(curPos, fileSize) != TLP_CONTINUE)
           return pluginProgress->state() != TLP_CANCEL;
+      }
 
       switch (currentToken) {
       case OPENTOKEN:
@@ -425,9 +654,9 @@ struct TLPParser {
 
         TLPBuilder *newBuilder;
 
-        if (builderStack.front()->addStruct(currentValue.str, newBuilder)) {
+        if (builderStack.back()->addStruct(currentValue.str, newBuilder)) {
           newBuilder->parser = this;
-          builderStack.push_front(newBuilder);
+          builderStack.push_back(newBuilder);
 
           if (newBuilder->canRead())
             if (!newBuilder->read(inputStream))
@@ -439,46 +668,46 @@ struct TLPParser {
 
       case BOOLTOKEN:
 
-        if (!builderStack.front()->addBool(currentValue.boolean))
+        if (!builderStack.back()->addBool(currentValue.boolean))
           return formatError(currentValue.str);
 
         break;
 
       case INTTOKEN:
 
-        if (!builderStack.front()->addInt(currentValue.integer))
+        if (!builderStack.back()->addInt(currentValue.integer))
           return formatError(currentValue.str);
 
         break;
 
       case RANGETOKEN:
 
-        if (!builderStack.front()->addRange(currentValue.range.first, currentValue.range.second))
+        if (!builderStack.back()->addRange(currentValue.range.first, currentValue.range.second))
           return formatError(currentValue.str);
 
         break;
 
       case DOUBLETOKEN:
 
-        if (!builderStack.front()->addDouble(currentValue.real))
+        if (!builderStack.back()->addDouble(currentValue.real))
           return formatError(currentValue.str);
 
         break;
 
       case STRINGTOKEN:
 
-        if (!builderStack.front()->addString(currentValue.str))
+        if (!builderStack.back()->addString(currentValue.str))
           return formatError(currentValue.str);
 
         break;
 
       case CLOSETOKEN:
 
-        if (builderStack.front()->close()) {
-          TLPBuilder *builder = builderStack.front();
-          builderStack.pop_front();
+        if (builderStack.size() > 1 && builderStack.back()->close()) {
+          TLPBuilder *builder = builderStack.back();
+          builderStack.pop_back();
 
-          if (builder != builderStack.front())
+          if (builder != builderStack.back())
             delete builder;
         } else
           return formatError(currentValue.str);
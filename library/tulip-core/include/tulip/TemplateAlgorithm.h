@@ -22,6 +22,7 @@
 
 #include <tulip/Algorithm.h>
 #include <tulip/Graph.h>
+#include <tulip/GraphSnapshot.h>
 
 #include <sstream>
 
@@ -40,6 +41,18 @@ public:
   std::string category() const override {
     return PROPERTY_ALGORITHM_CATEGORY;
   }
+
+protected:
+  /**
+   * @brief Returns a read-only snapshot of the topology of the graph,
+   * kept in cache while the graph is not modified.
+   * It is only intended to the algorithms which do not modify the topology of the graph,
+   * they should release it at the end of their run.
+   * @see tlp::GraphSnapshot
+   */
+  std::shared_ptr<const GraphSnapshot> graphSnapshot() const {
+    return GraphSnapshot::get(graph);
+  }
 };
 
 /**
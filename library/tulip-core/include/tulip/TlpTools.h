@@ -135,6 +135,7 @@ TLP_SCOPE unsigned int getSeedOfRandomSequence();
  * @brief Initializes a random sequence with the seed previously set
  * Further calls to rand() or random() will return the elements of
  * that sequence
+ * @note Each thread has its own random sequence, which has to be initialized in that thread.
  */
 TLP_SCOPE void initRandomSequence();
 
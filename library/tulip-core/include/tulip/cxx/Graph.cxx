@@ -56,3 +56,15 @@ PropertyType *tlp::Graph::getProperty(const std::string &name) {
     return getLocalProperty<PropertyType>(name);
   }
 }
+//====================================================================================
+template <typename PropertyType>
+PropertyType *tlp::Graph::getProperty(const PropertyKey &key) {
+  tlp::PropertyInterface *prop = findProperty(key);
+
+  if (prop != nullptr) {
+    assert(dynamic_cast<PropertyType *>(prop) != nullptr);
+    return static_cast<PropertyType *>(prop);
+  }
+
+  return getLocalProperty<PropertyType>(key.getName());
+}
@@ -24,14 +24,14 @@ tlp::MutableContainer<TYPE>::MutableContainer()
       elementInserted(0),
       ratio(double(sizeof(typename tlp::StoredType<TYPE>::Value)) /
             (3.0 * double(sizeof(void *)) + double(sizeof(typename tlp::StoredType<TYPE>::Value)))),
-      compressing(false) {}
+      compressing(false), pool(nullptr), interningMode(NEVER_INTERNED) {}
 //===================================================================
 template <typename TYPE>
 tlp::MutableContainer<TYPE>::~MutableContainer() {
   switch (state) {
   case VECT:
 
-    if (StoredType<TYPE>::isPointer) {
+    if (StoredType<TYPE>::isPointer && pool == nullptr) {
       // delete stored values
       typename std::deque<typename StoredType<TYPE>::Value>::const_iterator it = vData->begin();
 
@@ -49,7 +49,7 @@ tlp::MutableContainer<TYPE>::~MutableContainer() {
 
   case HASH:
 
-    if (StoredType<TYPE>::isPointer) {
+    if (StoredType<TYPE>::isPointer && pool == nullptr) {
       // delete stored values
       typename std::unordered_map<unsigned int, typename StoredType<TYPE>::Value>::const_iterator
           it = hData->begin();
@@ -70,6 +70,8 @@ tlp::MutableContainer<TYPE>::~MutableContainer() {
     break;
   }
 
+  // the interned values are deleted with their pool
+  delete pool;
   StoredType<TYPE>::destroy(defaultValue);
 }
 //===================================================================
@@ -81,10 +83,17 @@ void tlp::MutableContainer<TYPE>::setDefault(typename StoredType<TYPE>::Returned
 //===================================================================
 template <typename TYPE>
 void tlp::MutableContainer<TYPE>::setAll(typename StoredType<TYPE>::ReturnedConstValue value) {
+  // in AUTO_INTERNED mode, the new values will be stored
+  // as the ones they replace should have been
+  bool interned = pool != nullptr;
+
+  if (interningMode == AUTO_INTERNED)
+    interned = elementInserted < INTERNING_MIN_VALUES || fewDistinctValues();
+
   switch (state) {
   case VECT:
 
-    if (StoredType<TYPE>::isPointer) {
+    if (StoredType<TYPE>::isPointer && pool == nullptr) {
       // delete stored values
       typename std::deque<typename StoredType<TYPE>::Value>::const_iterator it = vData->begin();
 
@@ -101,7 +110,7 @@ void tlp::MutableContainer<TYPE>::setAll(typename StoredType<TYPE>::ReturnedCons
 
   case HASH:
 
-    if (StoredType<TYPE>::isPointer) {
+    if (StoredType<TYPE>::isPointer && pool == nullptr) {
       // delete stored values
       typename std::unordered_map<unsigned int, typename StoredType<TYPE>::Value>::const_iterator
           it = hData->begin();
@@ -123,6 +132,14 @@ void tlp::MutableContainer<TYPE>::setAll(typename StoredType<TYPE>::ReturnedCons
     break;
   }
 
+  if (!interned) {
+    delete pool;
+    pool = nullptr;
+  } else if (pool)
+    pool->clear();
+  else
+    pool = new ValuesPool<TYPE>();
+
   StoredType<TYPE>::destroy(defaultValue);
   defaultValue = StoredType<TYPE>::clone(value);
   state = VECT;
@@ -141,13 +158,19 @@ tlp::MutableContainer<TYPE>::findAllValues(typename StoredType<TYPE>::ReturnedCo
     // error
     return nullptr;
   else {
+    // the interned values can be compared by address
+    // unless the searched one is the default value
+    // which is not interned
+    const ValuesPool<TYPE> *interned =
+        StoredType<TYPE>::equal(defaultValue, value) ? nullptr : pool;
+
     switch (state) {
     case VECT:
-      return new IteratorVect<TYPE>(value, equal, vData, minIndex);
+      return new IteratorVect<TYPE>(value, equal, vData, minIndex, interned);
       break;
 
     case HASH:
-      return new IteratorHash<TYPE>(value, equal, hData);
+      return new IteratorHash<TYPE>(value, equal, hData, interned);
       break;
 
     default:
@@ -201,7 +224,7 @@ void tlp::MutableContainer<TYPE>::vectset(const unsigned int i,
     (*vData)[i - minIndex] = value;
 
     if (val != defaultValue)
-      StoredType<TYPE>::destroy(val);
+      destroyValue(val);
     else
       ++elementInserted;
   }
@@ -228,7 +251,7 @@ void tlp::MutableContainer<TYPE>::set(const unsigned int i,
 
         if (val != defaultValue) {
           (*vData)[i - minIndex] = defaultValue;
-          StoredType<TYPE>::destroy(val);
+          destroyValue(val);
           --elementInserted;
         } else if (forceDefaultValueRemoval)
           --elementInserted;
@@ -241,7 +264,7 @@ void tlp::MutableContainer<TYPE>::set(const unsigned int i,
           hData->find(i);
 
       if (it != hData->end()) {
-        StoredType<TYPE>::destroy(it->second);
+        destroyValue(it->second);
         hData->erase(it);
         --elementInserted;
       }
@@ -255,7 +278,7 @@ void tlp::MutableContainer<TYPE>::set(const unsigned int i,
       break;
     }
   } else {
-    typename StoredType<TYPE>::Value newVal = StoredType<TYPE>::clone(value);
+    typename StoredType<TYPE>::Value newVal = cloneValue(value);
 
     switch (state) {
     case VECT:
@@ -269,7 +292,7 @@ void tlp::MutableContainer<TYPE>::set(const unsigned int i,
           hData->find(i);
 
       if (it != hData->end()) {
-        StoredType<TYPE>::destroy(it->second);
+        destroyValue(it->second);
         it->second = newVal;
       } else {
         ++elementInserted;
@@ -575,3 +598,99 @@ typename tlp::StoredType<TYPE>::ReturnedConstValue tlp::MutableContainer<TYPE>::
 operator[](const unsigned int i) const {
   return get(i);
 }
+//===================================================================
+template <typename TYPE>
+void tlp::MutableContainer<TYPE>::setInterningMode(InterningMode mode) {
+  if (!ValuesPool<TYPE>::supported)
+    return;
+
+  interningMode = mode;
+
+  if (mode == AUTO_INTERNED)
+    internValues(elementInserted < INTERNING_MIN_VALUES || fewDistinctValues());
+  else
+    internValues(mode == ALWAYS_INTERNED);
+}
+//===================================================================
+template <typename TYPE>
+void tlp::MutableContainer<TYPE>::internValues(bool interned) {
+  if (interned == (pool != nullptr))
+    return;
+
+  ValuesPool<TYPE> *newPool = interned ? new ValuesPool<TYPE>() : nullptr;
+  // replace a stored value by its copy in the new storage
+  auto move = [&](typename StoredType<TYPE>::Value &val) {
+    typename StoredType<TYPE>::Value newVal = newPool
+                                                  ? newPool->intern(StoredType<TYPE>::get(val))
+                                                  : StoredType<TYPE>::clone(StoredType<TYPE>::get(val));
+
+    // the interned values are deleted with their pool
+    if (pool == nullptr)
+      StoredType<TYPE>::destroy(val);
+
+    val = newVal;
+  };
+
+  switch (state) {
+  case VECT:
+
+    for (auto &val : *vData) {
+      if (val != defaultValue)
+        move(val);
+    }
+
+    break;
+
+  case HASH:
+
+    for (auto &it : *hData)
+      move(it.second);
+
+    break;
+
+  default:
+    assert(false);
+    tlp::error() << __PRETTY_FUNCTION__ << "unexpected state value (serious bug)" << std::endl;
+    break;
+  }
+
+  delete pool;
+  pool = newPool;
+}
+//===================================================================
+template <typename TYPE>
+bool tlp::MutableContainer<TYPE>::fewDistinctValues() const {
+  // the interned values stay interned until there are
+  // twice as many distinct values as needed to intern them
+  if (pool)
+    return pool->size() <= 2 * (elementInserted / INTERNING_RATIO);
+
+  // count the distinct values up to the limit
+  typename ValuesPool<TYPE>::DistinctCounter counter(elementInserted / INTERNING_RATIO);
+  bool few = true;
+
+  switch (state) {
+  case VECT:
+
+    for (auto it = vData->begin(); few && it != vData->end(); ++it) {
+      if (*it != defaultValue)
+        few = counter.add(*it);
+    }
+
+    break;
+
+  case HASH:
+
+    for (auto it = hData->begin(); few && it != hData->end(); ++it)
+      few = counter.add(it->second);
+
+    break;
+
+  default:
+    assert(false);
+    tlp::error() << __PRETTY_FUNCTION__ << "unexpected state value (serious bug)" << std::endl;
+    break;
+  }
+
+  return few;
+}
@@ -20,28 +20,93 @@
 
 #ifndef MEMORYPOOL_H
 #define MEMORYPOOL_H
-#include <vector>
-#include <iostream>
-#include <cstdlib>
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
-#include <tulip/ParallelTools.h>
+#include <tulip/tulipconf.h>
 
+// the number of objects allocated at once, and moved at once
+// between a thread cache and the global depot of a MemoryPool
 static const size_t BUFFOBJ = 20;
 
 namespace tlp {
+
+/**
+ * @brief The memory held by a MemoryPool
+ */
+struct TLP_SCOPE MemoryPoolStatistics {
+  // the name of the pooled type, as given by typeid
+  // (it is demangled by MemoryPools::getStatistics())
+  std::string typeName;
+  size_t objectSize;
+  // the number of allocated objects currently in use
+  size_t nbObjectsInUse;
+  // the number of free objects kept for reuse
+  // in the thread caches and in the global depot
+  size_t nbObjectsHeld;
+
+  size_t bytesHeld() const {
+    return nbObjectsHeld * objectSize;
+  }
+};
+
+/**
+ * @brief Gives access to all the instantiated MemoryPool
+ */
+class TLP_SCOPE MemoryPools {
+public:
+  /**
+   * @brief Returns the statistics of all the instantiated MemoryPool
+   */
+  static std::vector<MemoryPoolStatistics> getStatistics();
+
+  /**
+   * @brief Frees the objects held by all the instantiated MemoryPool
+   * in the global depots and in the cache of the calling thread.
+   * @return the number of freed bytes
+   */
+  static size_t trim();
+
+  // the registration of a MemoryPool, for internal use only
+  class Pool {
+  public:
+    virtual ~Pool() {}
+    virtual MemoryPoolStatistics getStatistics() const = 0;
+    virtual size_t trim() = 0;
+  };
+
+  static void registerPool(Pool *pool);
+  static void unregisterPool(Pool *pool);
+};
+
 /**
  * @class MemoryPool
  * \brief That class enables to easily create a memory pool for an a class
  *
- * It allocates chunk of BUFFOBJ size of contiguous memory to allocate
- * instance of the class. After a delete the memory is not free, and
- * will be reused at the next new of the class.
+ * It allocates a chunk of BUFFOBJ instances of the class at once. After a delete the memory
+ * is not freed, and will be reused at the next new of the class.
+ *
+ * Each thread allocates from and frees to its own cache, without synchronization.
+ * When a cache holds too many free objects, for instance because the thread
+ * deletes objects created by another one, BUFFOBJ of them are moved at once
+ * to a lock-free global depot, where the other threads take them before allocating
+ * new ones. The cache of a thread is moved to the depot when the thread ends.
+ * When the depot holds more than getMaxDepotSize() objects, the chunks whose objects
+ * are all in the depot are freed; the depot may keep more objects when their chunks
+ * are partly used. trim() frees the chunks whose objects are all in the depot
+ * or in the cache of the calling thread.
  *
  * @warning it is not recommended to inherit from an object that inherit of that class
  *
- * The following  code only calls malloc one time even if NBTRY object are created
- * in that example, the speedup is about 23, without MemoryPool malloc is called NBTRY times
+ * The following code only calls malloc once even if NBTRY objects are created,
+ * without MemoryPool malloc is called NBTRY times
  * @code
  * class A : public MemoryPool<A> {
  * public:
@@ -71,57 +136,385 @@ public:
   inline void *operator new(size_t) {
 #endif
     assert(sizeof(TYPE) == sizeofObj); // to prevent inheritance with different size of object
-    TYPE *t;
-    t = _memoryChunkManager.getObject();
-    return t;
+    return _memoryChunkManager.getObject();
   }
 
   inline void operator delete(void *p) {
     _memoryChunkManager.releaseObject(p);
   }
 
+  /**
+   * @brief Frees the chunks whose objects are all held by the global depot
+   * or by the cache of the calling thread.
+   * @return the number of freed bytes
+   */
+  static size_t trim() {
+    return _memoryChunkManager.trim();
+  }
+
+  /**
+   * @brief Moves the objects held by the cache of the calling thread to the global depot,
+   * where the other threads can reuse them, and frees the chunks whose objects
+   * are all in the depot.
+   */
+  static void releaseThreadCache() {
+    _memoryChunkManager.releaseThreadCache();
+  }
+
+  static MemoryPoolStatistics getStatistics() {
+    return _memoryChunkManager.getStatistics();
+  }
+
+  /**
+   * @brief Sets the number of free objects held by the global depot
+   * above which its unused chunks are freed (BUFFOBJ * 64 by default).
+   */
+  static void setMaxDepotSize(size_t nbObjects) {
+    _memoryChunkManager.maxDepotBatches = (nbObjects + BUFFOBJ - 1) / BUFFOBJ;
+    _memoryChunkManager.reclaimDepotBatches = _memoryChunkManager.maxDepotBatches;
+  }
+
+  static size_t getMaxDepotSize() {
+    return _memoryChunkManager.maxDepotBatches * BUFFOBJ;
+  }
+
 private:
-  class MemoryChunkManager {
+  class MemoryChunkManager : public MemoryPools::Pool {
+    // a free object, its memory is used to link it with the others
+    struct FreeObject {
+      FreeObject *next;
+      // in the depot, the first object of a batch links it with the next batch
+      FreeObject *nextBatch;
+    };
+
+    // the free objects of a thread
+    struct ThreadCache {
+      FreeObject *objects;
+      // it is only modified by its thread
+      // but may be read by the others
+      std::atomic<size_t> nbObjects;
+
+      ThreadCache() : objects(nullptr), nbObjects(0) {
+        if (alive)
+          _memoryChunkManager.registerCache(this);
+      }
+
+      ~ThreadCache() {
+        // the manager may already be destroyed
+        // if the thread ends after the static objects
+        // (its objects are then not freed)
+        if (alive) {
+          _memoryChunkManager.releaseThreadCache(*this);
+          _memoryChunkManager.unregisterCache(this);
+        }
+      }
+    };
+
   public:
-    ~MemoryChunkManager() {
-      for (unsigned int i = 0; i < TLP_MAX_NB_THREADS; ++i) {
-        for (size_t j = 0; j < _allocatedChunks[i].size(); ++j) {
-          free(_allocatedChunks[i][j]);
+    // the atomic members are not explicitly initialized: as _memoryChunkManager
+    // is static they are zero-initialized before any dynamic initialization,
+    // so the objects allocated by the static objects of other compilation units
+    // constructed before it are correctly counted
+    std::atomic<FreeObject *> depot;
+    std::atomic<size_t> depotBatches;
+    size_t maxDepotBatches;
+    // the number of batches of the depot above which its unused chunks are freed
+    std::atomic<size_t> reclaimDepotBatches;
+    // the number of objects allocated and not freed
+    std::atomic<size_t> nbAllocated;
+    mutable std::mutex cachesMutex;
+    std::vector<ThreadCache *> caches;
+    // the allocated chunks of BUFFOBJ objects, ordered by address
+    std::set<char *> chunks;
+    // the free objects which are not enough to make a batch of the depot
+    FreeObject *partial;
+    size_t nbPartial;
+    // protects chunks and partial
+    mutable std::mutex chunksMutex;
+    // indicates if _memoryChunkManager can be used
+    static bool alive;
+
+    MemoryChunkManager() : maxDepotBatches(64), partial(nullptr), nbPartial(0) {
+      static_assert(sizeof(TYPE) >= sizeof(FreeObject), "too small type for a MemoryPool");
+      reclaimDepotBatches = maxDepotBatches;
+      alive = true;
+      MemoryPools::registerPool(this);
+    }
+
+    ~MemoryChunkManager() override {
+      MemoryPools::unregisterPool(this);
+      // the chunks of the objects still in use are not freed
+      reclaimDepot(nullptr);
+      alive = false;
+    }
+
+    static ThreadCache &threadCache() {
+      static thread_local ThreadCache cache;
+      return cache;
+    }
+
+    inline TYPE *getObject() {
+      ThreadCache &cache = threadCache();
+
+      if (cache.objects == nullptr)
+        refill(cache);
+
+      FreeObject *object = cache.objects;
+      cache.objects = object->next;
+      cache.nbObjects.store(cache.nbObjects.load(std::memory_order_relaxed) - 1,
+                            std::memory_order_relaxed);
+      return reinterpret_cast<TYPE *>(object);
+    }
+
+    inline void releaseObject(void *p) {
+      ThreadCache &cache = threadCache();
+      FreeObject *object = static_cast<FreeObject *>(p);
+      object->next = cache.objects;
+      cache.objects = object;
+      size_t nbObjects = cache.nbObjects.load(std::memory_order_relaxed) + 1;
+      cache.nbObjects.store(nbObjects, std::memory_order_relaxed);
+
+      // keep at most 2 * BUFFOBJ objects
+      if (nbObjects >= 2 * BUFFOBJ)
+        pushBatch(cache);
+    }
+
+    size_t trim() override {
+      return releaseThreadCache(threadCache()) * sizeof(TYPE);
+    }
+
+    void releaseThreadCache() {
+      releaseThreadCache(threadCache());
+    }
+
+    MemoryPoolStatistics getStatistics() const override {
+      size_t nbHeld = depotBatches.load() * BUFFOBJ;
+      {
+        std::lock_guard<std::mutex> lock(cachesMutex);
+
+        for (ThreadCache *cache : caches)
+          nbHeld += cache->nbObjects.load(std::memory_order_relaxed);
+      }
+      {
+        std::lock_guard<std::mutex> lock(chunksMutex);
+        nbHeld += nbPartial;
+      }
+      size_t nbAlloc = nbAllocated.load();
+      // the counts are not read at once
+      nbHeld = std::min(nbHeld, nbAlloc);
+      return {typeid(TYPE).name(), sizeof(TYPE), nbAlloc - nbHeld, nbHeld};
+    }
+
+  private:
+    void registerCache(ThreadCache *cache) {
+      std::lock_guard<std::mutex> lock(cachesMutex);
+      caches.push_back(cache);
+    }
+
+    void unregisterCache(ThreadCache *cache) {
+      std::lock_guard<std::mutex> lock(cachesMutex);
+
+      for (size_t i = 0; i < caches.size(); ++i) {
+        if (caches[i] == cache) {
+          caches[i] = caches.back();
+          caches.pop_back();
+          break;
         }
       }
     }
 
-    TYPE *getObject() {
-      unsigned int threadId = tlp::ThreadManager::getThreadNumber();
-      TYPE *result = nullptr;
+    void refill(ThreadCache &cache) {
+      // first try to reuse a batch of the depot
+      // all the batches are taken at once to avoid the ABA problem
+      // of a lock-free stack, the unused ones are given back
+      FreeObject *batches = depot.exchange(nullptr);
+
+      if (batches != nullptr) {
+        --depotBatches;
+        FreeObject *others = batches->nextBatch;
+
+        if (others != nullptr) {
+          FreeObject *last = others;
 
-      if (_freeObject[threadId].empty()) {
-        void *chunk = malloc(BUFFOBJ * sizeof(TYPE));
-        TYPE *p = static_cast<TYPE *>(chunk);
-        _allocatedChunks[threadId].push_back(chunk);
+          while (last->nextBatch)
+            last = last->nextBatch;
 
-        for (size_t j = 0; j < BUFFOBJ - 1; ++j) {
-          _freeObject[threadId].push_back(static_cast<void *>(p));
-          p += 1;
+          pushBatches(others, last);
         }
 
-        result = p;
+        cache.objects = batches;
       } else {
-        result = static_cast<TYPE *>(_freeObject[threadId].back());
-        _freeObject[threadId].pop_back();
+        // allocate a new chunk of objects
+        char *chunk = static_cast<char *>(malloc(BUFFOBJ * sizeof(TYPE)));
+
+        for (size_t i = 0; i < BUFFOBJ; ++i) {
+          FreeObject *object = reinterpret_cast<FreeObject *>(chunk + i * sizeof(TYPE));
+          object->next = cache.objects;
+          cache.objects = object;
+        }
+
+        // the chunks allocated before the construction of _memoryChunkManager
+        // are never freed
+        if (alive) {
+          std::lock_guard<std::mutex> lock(chunksMutex);
+          chunks.insert(chunk);
+        }
+
+        nbAllocated += BUFFOBJ;
       }
 
-      return result;
+      cache.nbObjects.store(BUFFOBJ, std::memory_order_relaxed);
+    }
+
+    // move BUFFOBJ objects of the cache to the depot
+    void pushBatch(ThreadCache &cache) {
+      FreeObject *batch = cache.objects;
+      FreeObject *last = batch;
+
+      for (size_t i = 1; i < BUFFOBJ; ++i)
+        last = last->next;
+
+      cache.objects = last->next;
+      last->next = nullptr;
+      cache.nbObjects.store(cache.nbObjects.load(std::memory_order_relaxed) - BUFFOBJ,
+                            std::memory_order_relaxed);
+
+      ++depotBatches;
+      pushBatches(batch, batch);
+
+      // the depot is full
+      if (alive && depotBatches.load(std::memory_order_relaxed) > reclaimDepotBatches.load())
+        reclaimDepot(nullptr);
     }
 
-    void releaseObject(void *p) {
-      unsigned int threadId = tlp::ThreadManager::getThreadNumber();
-      _freeObject[threadId].push_back(p);
+    // push the batches linked from first to last on the depot
+    void pushBatches(FreeObject *first, FreeObject *last) {
+      last->nextBatch = depot.load();
+
+      while (!depot.compare_exchange_weak(last->nextBatch, first)) {
+      }
     }
 
-  private:
-    std::vector<void *> _allocatedChunks[TLP_MAX_NB_THREADS];
-    std::vector<void *> _freeObject[TLP_MAX_NB_THREADS];
+    // move the objects of the cache to the depot and free the unused chunks,
+    // return the number of freed objects
+    size_t releaseThreadCache(ThreadCache &cache) {
+      size_t nbFreed = reclaimDepot(cache.objects);
+      cache.objects = nullptr;
+      cache.nbObjects.store(0, std::memory_order_relaxed);
+      return nbFreed;
+    }
+
+    // free the chunks whose objects are all in the depot or in the given list,
+    // the other objects of the list are moved to the depot;
+    // return the number of freed objects
+    size_t reclaimDepot(FreeObject *objects) {
+      std::lock_guard<std::mutex> lock(chunksMutex);
+      // link all the free objects
+      FreeObject *batches = depot.exchange(nullptr);
+
+      while (batches) {
+        FreeObject *next = batches->nextBatch;
+        objects = linkObjects(batches, objects);
+        --depotBatches;
+        batches = next;
+      }
+
+      objects = linkObjects(partial, objects);
+      partial = nullptr;
+      nbPartial = 0;
+      size_t nbFreed = freeUnusedChunks(objects);
+
+      // put the remaining ones back in the depot
+      while (objects) {
+        FreeObject *first = objects;
+        FreeObject *last = first;
+        size_t nbObjects = 1;
+
+        for (; nbObjects < BUFFOBJ && last->next; ++nbObjects)
+          last = last->next;
+
+        objects = last->next;
+
+        if (nbObjects < BUFFOBJ) {
+          partial = first;
+          nbPartial = nbObjects;
+        } else {
+          last->next = nullptr;
+          ++depotBatches;
+          pushBatches(first, first);
+        }
+      }
+
+      // the depot may keep the objects of the chunks which are partly used,
+      // so the number of batches needed for the next reclaim is doubled
+      // to amortize its cost
+      reclaimDepotBatches = std::max(maxDepotBatches, 2 * depotBatches.load());
+      return nbFreed;
+    }
+
+    // link the objects to the first ones, return the new first object
+    static FreeObject *linkObjects(FreeObject *objects, FreeObject *first) {
+      if (objects == nullptr)
+        return first;
+
+      FreeObject *last = objects;
+
+      while (last->next)
+        last = last->next;
+
+      last->next = first;
+      return objects;
+    }
+
+    // return the chunk of a free object
+    char *chunkOf(FreeObject *object) const {
+      char *p = reinterpret_cast<char *>(object);
+      auto it = chunks.upper_bound(p);
+
+      if (it == chunks.begin())
+        return nullptr;
+
+      --it;
+      return p < *it + BUFFOBJ * sizeof(TYPE) ? *it : nullptr;
+    }
+
+    // free the chunks whose objects are all in the list and remove them from it,
+    // return the number of freed objects
+    size_t freeUnusedChunks(FreeObject *&objects) {
+      std::unordered_map<char *, size_t> nbFreeObjects;
+
+      for (FreeObject *object = objects; object; object = object->next) {
+        char *chunk = chunkOf(object);
+
+        if (chunk)
+          ++nbFreeObjects[chunk];
+      }
+
+      // remove the objects of the unused chunks from the list
+      FreeObject **link = &objects;
+
+      while (*link) {
+        char *chunk = chunkOf(*link);
+
+        if (chunk && nbFreeObjects[chunk] == BUFFOBJ)
+          *link = (*link)->next;
+        else
+          link = &((*link)->next);
+      }
+
+      size_t nbFreed = 0;
+
+      for (const auto &it : nbFreeObjects) {
+        if (it.second == BUFFOBJ) {
+          chunks.erase(it.first);
+          free(it.first);
+          nbFreed += BUFFOBJ;
+        }
+      }
+
+      nbAllocated -= nbFreed;
+      return nbFreed;
+    }
   };
 
   static MemoryChunkManager _memoryChunkManager;
@@ -129,6 +522,8 @@ private:
 
 template <typename TYPE>
 typename MemoryPool<TYPE>::MemoryChunkManager MemoryPool<TYPE>::_memoryChunkManager;
+template <typename TYPE>
+bool MemoryPool<TYPE>::MemoryChunkManager::alive = false;
 } // namespace tlp
 #endif // MEMORYPOOL_H
 ///@endcond
@@ -25,6 +25,7 @@
 #include <tulip/Graph.h>
 #include <tulip/MutableContainer.h>
 #include <tulip/StableIterator.h>
+#include <tulip/StaticProperty.h>
 
 using namespace std;
 using namespace tlp;
@@ -131,50 +132,67 @@ static void makeBiconnectedDFS(Graph *graph, vector<edge> &addedEdges) {
 }
 
 //=================================================================
-bool biconnectedTest(const Graph *graph, node v, MutableContainer<unsigned int> &low,
-                     MutableContainer<unsigned int> &dfsNumber, MutableContainer<node> &supergraph,
-                     unsigned int &count) {
-  unsigned int vDfs = count++;
-  dfsNumber.set(v.id, vDfs);
-  low.set(v.id, vDfs);
-
-  for (auto w : graph->getInOutNodes(v)) {
-
-    if (dfsNumber.get(w.id) == UINT_MAX) {
-      if (vDfs == 1) {
-        if (count != 2) {
-          return false;
-        }
-      }
+// structure below is used to implement the dfs loop of the test
+struct dfsBiconnectedTestStruct {
+  unsigned int pos;
+  AdjacencyRange<node> inOutNodes;
+  AdjacencyRange<node>::iterator itN;
+
+  dfsBiconnectedTestStruct(const Graph *graph, node n, unsigned int pos)
+      : pos(pos), inOutNodes(graph->inOutNodes(n)), itN(inOutNodes.begin()) {}
+};
+
+static bool biconnectedTest(const Graph *graph) {
+  unsigned int nbNodes = graph->numberOfNodes();
+  NodeStaticProperty<unsigned int> low(graph);
+  NodeStaticProperty<unsigned int> dfsNumber(graph);
+  dfsNumber.setAll(UINT_MAX);
+  // the positions of the fathers of the nodes in the dfs tree
+  NodeStaticProperty<unsigned int> supergraph(graph);
+  supergraph.setAll(UINT_MAX);
+  unsigned int count = 1;
 
-      supergraph.set(w.id, v);
+  // as its capacity is the maximum depth of the dfs,
+  // the levels are never moved and their iterators remain valid
+  vector<dfsBiconnectedTestStruct> dfsLevels;
+  dfsLevels.reserve(nbNodes);
+  dfsNumber[0] = low[0] = count++;
+  dfsLevels.emplace_back(graph, graph->nodes()[0], 0);
 
-      if (!biconnectedTest(graph, w, low, dfsNumber, supergraph, count)) {
-        return false;
-      }
+  while (!dfsLevels.empty()) {
+    dfsBiconnectedTestStruct &dfsParams = dfsLevels.back();
+    unsigned int v = dfsParams.pos;
+
+    if (dfsParams.itN != dfsParams.inOutNodes.end()) {
+      node wNode = *dfsParams.itN;
+      ++dfsParams.itN;
+      unsigned int w = graph->nodePos(wNode);
 
-      if (vDfs != 1) {
-        if (low.get(w.id) >= dfsNumber.get(v.id)) {
+      if (dfsNumber[w] == UINT_MAX) {
+        // the root must have only one son
+        if (dfsNumber[v] == 1 && count != 2)
           return false;
-        } else
-          low.set(v.id, std::min(low.get(v.id), low.get(w.id)));
+
+        supergraph[w] = v;
+        dfsNumber[w] = low[w] = count++;
+        dfsLevels.emplace_back(graph, wNode, w);
+      } else if (supergraph[v] != w)
+        low[v] = std::min(low[v], dfsNumber[w]);
+    } else {
+      dfsLevels.pop_back();
+      unsigned int u = supergraph[v];
+
+      if (u != UINT_MAX && dfsNumber[u] != 1) {
+        // u is an articulation point
+        if (low[v] >= dfsNumber[u])
+          return false;
+
+        low[u] = std::min(low[u], low[v]);
       }
-    } else if (supergraph.get(v.id) != w) {
-      low.set(v.id, std::min(low.get(v.id), dfsNumber.get(w.id)));
     }
   }
 
-  return true;
-}
-//=================================================================
-static bool biconnectedTest(const Graph *graph) {
-  MutableContainer<unsigned int> low;
-  MutableContainer<unsigned int> dfsNumber;
-  dfsNumber.setAll(UINT_MAX);
-  MutableContainer<node> supergraph;
-  unsigned int count = 1;
-  return (biconnectedTest(graph, graph->nodes()[0], low, dfsNumber, supergraph, count) &&
-          (count == graph->numberOfNodes() + 1));
+  return count == nbNodes + 1;
 }
 //=================================================================
 bool BiconnectedTest::isBiconnected(const tlp::Graph *graph) {
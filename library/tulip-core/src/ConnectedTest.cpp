@@ -16,56 +16,86 @@
  * See the GNU General Public License for more details.
  *
  */
-#include <list>
+#include <atomic>
+
 #include <tulip/ConnectedTest.h>
 #include <tulip/ConnectedTestListener.h>
 #include <tulip/Graph.h>
-#include <tulip/MutableContainer.h>
-#include <tulip/StaticProperty.h>
+#include <tulip/ParallelTools.h>
 
 using namespace std;
 using namespace tlp;
 //=================================================================
 static ConnectedTestListener instance;
 //=================================================================
-static unsigned int connectedTest(const Graph *const graph, node n,
-                                  NodeStaticProperty<bool> &visited) {
-  list<node> nodesToVisit;
-  visited[n] = true;
-  nodesToVisit.push_front(n);
-  unsigned int count = 1;
-
-  while (!nodesToVisit.empty()) {
-    node r = nodesToVisit.front();
-    nodesToVisit.pop_front();
-    // loop on all neighbours
-    for (auto neighbour : graph->getInOutNodes(r)) {
-      unsigned int neighPos = graph->nodePos(neighbour);
-      // check if neighbour has been visited
-      if (!visited[neighPos]) {
-        // mark neighbour as already visited
-        visited[neighPos] = true;
-        // push it for further deeper exploration
-        nodesToVisit.push_back(neighbour);
-        ++count;
-      }
-    }
+// lock-free union-find of the positions of the nodes,
+// the root of a set is always its smallest position
+static unsigned int findRoot(vector<atomic<unsigned int>> &parent, unsigned int i) {
+  for (;;) {
+    unsigned int p = parent[i].load(memory_order_relaxed);
+
+    if (p == i)
+      return i;
+
+    unsigned int gp = parent[p].load(memory_order_relaxed);
+
+    // path halving, it does not matter if another thread
+    // has already changed the parent of i
+    if (gp != p)
+      parent[i].compare_exchange_weak(p, gp, memory_order_relaxed);
+
+    i = gp;
   }
+}
 
-  return count;
+static void unite(vector<atomic<unsigned int>> &parent, unsigned int i, unsigned int j) {
+  for (;;) {
+    i = findRoot(parent, i);
+    j = findRoot(parent, j);
+
+    if (i == j)
+      return;
+
+    if (i < j)
+      std::swap(i, j);
+
+    // link the root having the greatest position to the other one,
+    // unless another thread has linked it meanwhile
+    unsigned int expected = i;
+
+    if (parent[i].compare_exchange_strong(expected, j, memory_order_relaxed))
+      return;
+  }
 }
 //=================================================================
-#ifndef NDEBUG
-static bool connectedTest(const Graph *const graph) {
-  if (graph->isEmpty())
-    return true;
+// computes for each node position the smallest position
+// of the nodes of its connected component
+static void computeRoots(const Graph *graph, vector<unsigned int> &roots) {
+  const vector<edge> &edges = graph->edges();
+  unsigned int nbNodes = graph->numberOfNodes();
+  vector<atomic<unsigned int>> parent(nbNodes);
+  TLP_PARALLEL_MAP_INDICES(
+      nbNodes, [&](unsigned int i) { parent[i].store(i, memory_order_relaxed); });
+  TLP_PARALLEL_MAP_INDICES(edges.size(), [&](unsigned int i) {
+    const pair<node, node> &eEnds = graph->ends(edges[i]);
+    unite(parent, graph->nodePos(eEnds.first), graph->nodePos(eEnds.second));
+  });
+  roots.resize(nbNodes);
+  TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int i) { roots[i] = findRoot(parent, i); });
+}
+//=================================================================
+static unsigned int numberOfComponents(const Graph *graph) {
+  vector<unsigned int> roots;
+  computeRoots(graph, roots);
+  unsigned int count = 0;
+
+  for (unsigned int i = 0; i < roots.size(); ++i) {
+    if (roots[i] == i)
+      ++count;
+  }
 
-  NodeStaticProperty<bool> visited(graph);
-  visited.setAll(false);
-  unsigned int count = connectedTest(graph, graph->getOneNode(), visited);
-  return (count == graph->numberOfNodes());
+  return count;
 }
-#endif
 //=================================================================
 bool ConnectedTest::isConnected(const tlp::Graph *const graph) {
   if (instance.resultsBuffer.find(graph) != instance.resultsBuffer.end())
@@ -74,10 +104,7 @@ bool ConnectedTest::isConnected(const tlp::Graph *const graph) {
   if (graph->isEmpty())
     return true;
 
-  NodeStaticProperty<bool> visited(graph);
-  visited.setAll(false);
-  unsigned int count = connectedTest(graph, graph->getOneNode(), visited);
-  bool result = (count == graph->numberOfNodes());
+  bool result = (numberOfComponents(graph) == 1);
   graph->addListener(instance);
   return instance.resultsBuffer[graph] = result;
 }
@@ -91,7 +118,7 @@ void ConnectedTest::makeConnected(Graph *graph, vector<edge> &addedEdges) {
   for (unsigned int i = 1; i < toLink.size(); ++i)
     addedEdges.push_back(graph->addEdge(toLink[i - 1], toLink[i]));
 
-  assert(connectedTest(graph));
+  assert(graph->isEmpty() || numberOfComponents(graph) == 1);
 }
 //=================================================================
 unsigned int ConnectedTest::numberOfConnectedComponents(const tlp::Graph *const graph) {
@@ -115,38 +142,38 @@ unsigned int ConnectedTest::numberOfConnectedComponents(const tlp::Graph *const
 //======================================================================
 void ConnectedTest::computeConnectedComponents(const tlp::Graph *graph,
                                                vector<vector<node>> &components) {
-  NodeStaticProperty<bool> visited(graph);
-  visited.setAll(false);
-  // do a bfs traversal for each node
-  TLP_MAP_NODES_AND_INDICES(graph, [&](node n, unsigned int i) {
-    // check if curNode has been already visited
-    if (!visited[i]) {
-      // add a new component
-      components.emplace_back();
-      std::vector<node> &component = components.back();
-      // and initialize it with current node
-      component.push_back(n);
-      // do a bfs traversal this node
-      list<node> nodesToVisit;
-      visited[i] = true;
-      nodesToVisit.push_front(n);
-
-      while (!nodesToVisit.empty()) {
-        n = nodesToVisit.front();
-        nodesToVisit.pop_front();
-
-        // loop on all neighbours
-        for (auto neighbour : graph->getInOutNodes(n)) {
-          unsigned int neighPos = graph->nodePos(neighbour);
-          // check if neighbour has been visited
-          if (!visited[neighPos]) {
-            // mark neighbour as already visited
-            visited[neighPos] = true;
-            // insert it in current component
-            component.push_back(neighbour);
-            // push it for further deeper exploration
-            nodesToVisit.push_back(neighbour);
-          }
+  const vector<node> &nodes = graph->nodes();
+  vector<unsigned int> roots;
+  computeRoots(graph, roots);
+
+  // the components are ordered as their first node
+  unsigned int firstComponent = components.size();
+  vector<unsigned int> firsts;
+
+  for (unsigned int i = 0; i < roots.size(); ++i) {
+    if (roots[i] == i)
+      firsts.push_back(i);
+  }
+
+  components.resize(firstComponent + firsts.size());
+
+  // the nodes of each component are ordered as in a bfs traversal
+  // from its first node; the traversals of the components are independent
+  vector<unsigned char> visited(nodes.size(), 0);
+  TLP_PARALLEL_MAP_INDICES(firsts.size(), [&](unsigned int i) {
+    // the component is also the queue of the traversal
+    vector<node> &component = components[firstComponent + i];
+    visited[firsts[i]] = 1;
+    component.push_back(nodes[firsts[i]]);
+
+    for (unsigned int j = 0; j < component.size(); ++j) {
+      // loop on all neighbours
+      for (auto neighbour : graph->inOutNodes(component[j])) {
+        unsigned int neighPos = graph->nodePos(neighbour);
+
+        if (!visited[neighPos]) {
+          visited[neighPos] = 1;
+          component.push_back(neighbour);
         }
       }
     }
@@ -163,13 +190,13 @@ void ConnectedTest::connect(const tlp::Graph *const graph, vector<node> &toLink)
   if (graph->isEmpty())
     return;
 
-  NodeStaticProperty<bool> visited(graph);
-  visited.setAll(false);
+  // the first node of each component
+  const vector<node> &nodes = graph->nodes();
+  vector<unsigned int> roots;
+  computeRoots(graph, roots);
 
-  TLP_MAP_NODES_AND_INDICES(graph, [&](node n, unsigned int i) {
-    if (!visited[i]) {
-      toLink.push_back(n);
-      connectedTest(graph, n, visited);
-    }
-  });
+  for (unsigned int i = 0; i < roots.size(); ++i) {
+    if (roots[i] == i)
+      toLink.push_back(nodes[i]);
+  }
 }
@@ -16,25 +16,134 @@
  * See the GNU General Public License for more details.
  *
  */
-#include <set>
+#include <algorithm>
+#include <map>
 
 #include <tulip/Dijkstra.h>
+#include <tulip/ParallelTools.h>
 
 using namespace tlp;
 using namespace std;
 
+// the distance of the nodes not reachable from the source
+static const double INFINITE_DISTANCE = DBL_MAX / 2. + 10.;
+// the smallest width of the buckets of the delta-stepping algorithm
+static const double SMALLEST_DELTA = 1.E-6;
+// the greatest index of these buckets
+static const unsigned long long MAX_BUCKET = 1ULL << 62;
+
+//============================================================
+// a binary heap of node positions supporting the decrease of their distances;
+// the nodes are ordered by distance, the nodes whose distances differ by less
+// than 1E-9 are ordered by id
+class DijkstraHeap {
+public:
+  DijkstraHeap(const vector<double> &dist, const vector<node> &nodes)
+      : dist(dist), nodes(nodes), heapPos(nodes.size(), UINT_MAX) {}
+
+  bool empty() const {
+    return heap.empty();
+  }
+
+  bool contains(unsigned int pos) const {
+    return heapPos[pos] != UINT_MAX;
+  }
+
+  unsigned int top() const {
+    return heap.front();
+  }
+
+  void push(unsigned int pos) {
+    heap.push_back(pos);
+    moveUp(heap.size() - 1);
+  }
+
+  // must be called when the distance of pos has decreased
+  void decrease(unsigned int pos) {
+    moveUp(heapPos[pos]);
+  }
+
+  unsigned int pop() {
+    unsigned int pos = heap.front();
+    heapPos[pos] = UINT_MAX;
+    unsigned int last = heap.back();
+    heap.pop_back();
+
+    if (!heap.empty())
+      moveDown(last);
+
+    return pos;
+  }
+
+private:
+  bool less(unsigned int a, unsigned int b) const {
+    if (fabs(dist[a] - dist[b]) > 1.E-9)
+      return dist[a] < dist[b];
+
+    return nodes[a].id < nodes[b].id;
+  }
+
+  void place(unsigned int pos, unsigned int i) {
+    heap[i] = pos;
+    heapPos[pos] = i;
+  }
+
+  void moveUp(unsigned int i) {
+    unsigned int pos = heap[i];
+
+    while (i > 0) {
+      unsigned int parent = (i - 1) / 2;
+
+      if (!less(pos, heap[parent]))
+        break;
+
+      place(heap[parent], i);
+      i = parent;
+    }
+
+    place(pos, i);
+  }
+
+  // moves the last element from the root to its place
+  void moveDown(unsigned int pos) {
+    unsigned int i = 0;
+    unsigned int size = heap.size();
+
+    for (;;) {
+      unsigned int child = 2 * i + 1;
+
+      if (child >= size)
+        break;
+
+      if (child + 1 < size && less(heap[child + 1], heap[child]))
+        ++child;
+
+      if (!less(heap[child], pos))
+        break;
+
+      place(heap[child], i);
+      i = child;
+    }
+
+    place(pos, i);
+  }
+
+  const vector<double> &dist;
+  const vector<node> &nodes;
+  vector<unsigned int> heap;
+  // the index of each node in heap, UINT_MAX if it is not in heap
+  vector<unsigned int> heapPos;
+};
 //============================================================
 Dijkstra::Dijkstra(const Graph *const graph, node src, const EdgeStaticProperty<double> &weights,
                    NodeStaticProperty<double> &nd, EDGE_TYPE direction, std::stack<node> *qN,
                    MutableContainer<int> *nP)
-    : nodeDistance(nd), queueNodes(qN), numberOfPaths(nP) {
+    : graph(graph), src(src), usedEdges(graph), nodeDistance(nd), queueNodes(qN),
+      numberOfPaths(nP) {
   assert(src.isValid());
-  this->graph = graph;
-  usedEdges.setAll(false);
-  this->src = src;
-  set<DijkstraElement *, LessDijkstraElement> dijkstraTable;
-  NodeStaticProperty<DijkstraElement *> mapDik(graph);
-  mapDik.setAll(nullptr);
+  const vector<node> &nodes = graph->nodes();
+  unsigned int nbNodes = nodes.size();
+
   if (queueNodes)
     while (!queueNodes->empty())
       queueNodes->pop();
@@ -43,68 +152,80 @@ Dijkstra::Dijkstra(const Graph *const graph, node src, const EdgeStaticProperty<
     numberOfPaths->set(this->src.id, 1);
   }
 
-  unsigned int i = 0;
-  for (auto n : graph->nodes()) {
-    DijkstraElement *tmp;
-    if (n != src)
-      // init all nodes to +inf
-      tmp = new DijkstraElement(DBL_MAX / 2. + 10., node(), n);
-    else
-      // init starting node to 0
-      tmp = new DijkstraElement(0, n, n);
+  // init all nodes to +inf and the starting node to 0
+  nodeDistance.setAll(INFINITE_DISTANCE);
+  unsigned int srcPos = graph->nodePos(src);
+  nodeDistance[srcPos] = 0;
+  DijkstraHeap dijkstraHeap(nodeDistance, nodes);
+  dijkstraHeap.push(srcPos);
+  NodeStaticProperty<bool> treated(graph);
+  treated.setAll(false);
 
-    dijkstraTable.insert(tmp);
+  // the edges of the shortest paths found so far to each node, stored in linked lists
+  // whose elements are the edge and the index of the next element
+  vector<pair<edge, unsigned int>> usedEdgeLists;
+  NodeStaticProperty<unsigned int> usedEdgeList(graph);
+  usedEdgeList.setAll(UINT_MAX);
 
-    mapDik[i++] = tmp;
-  }
+  auto treatNode = [&](unsigned int uPos) {
+    node u = nodes[uPos];
+    double uDist = nodeDistance[uPos];
+    treated[uPos] = true;
 
-  auto getEdges = getEdgesIterator(direction);
-
-  while (!dijkstraTable.empty()) {
-    // select the first element in the list the one with min value
-    set<DijkstraElement *, LessDijkstraElement>::iterator it = dijkstraTable.begin();
-    DijkstraElement &u = *(*it);
-    dijkstraTable.erase(it);
     if (queueNodes)
-      queueNodes->push(u.n);
+      queueNodes->push(u);
 
-    for (auto e : getEdges(graph, u.n)) {
-      node v = graph->opposite(e, u.n);
-      auto dEle = mapDik[v];
+    for (auto e : graph->adjacentEdges(u, direction)) {
+      node v = graph->opposite(e, u);
+      unsigned int vPos = graph->nodePos(v);
       double eWeight = weights.getEdgeValue(e);
       assert(eWeight > 0);
 
-      if (fabs((u.dist + eWeight) - dEle->dist) < 1E-9) { // path of the same length
-        dEle->usedEdge.push_back(e);
+      if (fabs((uDist + eWeight) - nodeDistance[vPos]) < 1E-9) { // path of the same length
+        usedEdgeLists.emplace_back(e, usedEdgeList[vPos]);
+        usedEdgeList[vPos] = usedEdgeLists.size() - 1;
         if (numberOfPaths)
-          numberOfPaths->set(v.id, numberOfPaths->get(v.id) + numberOfPaths->get(u.n.id));
-      } else if ((u.dist + eWeight) < dEle->dist) {
+          numberOfPaths->set(v.id, numberOfPaths->get(v.id) + numberOfPaths->get(u.id));
+      } else if ((uDist + eWeight) < nodeDistance[vPos]) {
         // we find a node closer with that path
-        dEle->usedEdge.clear();
-        //**********************************************
-        dijkstraTable.erase(dEle);
-
-        dEle->dist = u.dist + eWeight;
-        dEle->previous = u.n;
-        dEle->usedEdge.push_back(e);
-        dijkstraTable.insert(dEle);
+        nodeDistance[vPos] = uDist + eWeight;
+        usedEdgeLists.emplace_back(e, UINT_MAX);
+        usedEdgeList[vPos] = usedEdgeLists.size() - 1;
+
+        if (dijkstraHeap.contains(vPos))
+          dijkstraHeap.decrease(vPos);
+        else
+          dijkstraHeap.push(vPos);
+
         if (numberOfPaths)
-          numberOfPaths->set(v.id, numberOfPaths->get(u.n.id));
+          numberOfPaths->set(v.id, numberOfPaths->get(u.id));
       }
     }
+  };
+
+  while (!dijkstraHeap.empty())
+    // select the node with min distance
+    treatNode(dijkstraHeap.pop());
+
+  // the unreachable nodes are treated at last, ordered by id
+  vector<unsigned int> unreachables;
+
+  for (unsigned int i = 0; i < nbNodes; ++i) {
+    if (!treated[i])
+      unreachables.push_back(i);
   }
 
-  usedEdges.setAll(false);
-  i = 0;
-  for (auto n : graph->nodes()) {
-    DijkstraElement *dEle = mapDik[i++];
-    nodeDistance[n] = dEle->dist;
+  sort(unreachables.begin(), unreachables.end(),
+       [&](unsigned int a, unsigned int b) { return nodes[a].id < nodes[b].id; });
 
-    for (auto e : dEle->usedEdge) {
-      usedEdges.set(e.id, true);
-    }
+  for (auto pos : unreachables)
+    treatNode(pos);
+
+  usedEdges.setAll(false);
 
-    delete dEle;
+  for (unsigned int i = 0; i < nbNodes; ++i) {
+    for (unsigned int j = usedEdgeList[i]; j != UINT_MAX; j = usedEdgeLists[j].second)
+      usedEdges.setEdgeValue(usedEdgeLists[j].first, true);
   }
 }
 //=============================================================================
@@ -114,10 +235,8 @@ bool Dijkstra::searchPath(node n, BooleanProperty *result) {
   while (ok) {
     result->setNodeValue(n, true);
     ok = false;
-    Iterator<edge> *it = graph->getInOutEdges(n);
-    while (it->hasNext()) {
-      edge e = it->next();
-      if (!usedEdges.get(e.id))
+    for (auto e : graph->inOutEdges(n)) {
+      if (!usedEdges.getEdgeValue(e))
         continue; // edge does not belong to the shortest path
 
       if (result->getEdgeValue(e))
@@ -133,7 +252,6 @@ bool Dijkstra::searchPath(node n, BooleanProperty *result) {
       ok = true;
       break;
     }
-    delete it;
   }
 
   if (n != src) {
@@ -150,8 +268,8 @@ bool Dijkstra::searchPath(node n, BooleanProperty *result) {
 //=======================================================================
 void Dijkstra::internalSearchPaths(node n, BooleanProperty *result) {
   result->setNodeValue(n, true);
-  for (auto e : graph->getInOutEdges(n)) {
-    if (!usedEdges.get(e.id))
+  for (auto e : graph->inOutEdges(n)) {
+    if (!usedEdges.getEdgeValue(e))
       continue;
 
     if (result->getEdgeValue(e))
@@ -185,9 +303,9 @@ bool Dijkstra::ancestors(unordered_map<node, std::list<node>> &result) {
   result[src].push_back(src);
   for (auto n : graph->getNodes()) {
     if (n != src) {
-      for (auto e : graph->getInOutEdges(n)) {
+      for (auto e : graph->inOutEdges(n)) {
         node tgt = graph->opposite(e, n);
-        if (usedEdges.get(e.id) && nodeDistance[tgt] < nodeDistance[n]) {
+        if (usedEdges.getEdgeValue(e) && nodeDistance[tgt] < nodeDistance[n]) {
           result[n].push_back(tgt);
         }
       }
@@ -195,3 +313,207 @@ bool Dijkstra::ancestors(unordered_map<node, std::list<node>> &result) {
   }
   return true;
 }
+//========================================
+void Dijkstra::computeDistances(const Graph *const graph, node src,
+                                const EdgeStaticProperty<double> &weights,
+                                NodeStaticProperty<double> &nodeDistance, EDGE_TYPE direction,
+                                double delta) {
+  assert(src.isValid());
+  const vector<node> &nodes = graph->nodes();
+
+  if (delta <= 0) {
+    // the average edge weight
+    delta = 0;
+
+    for (auto weight : weights)
+      delta += weight;
+
+    delta = weights.empty() ? 1 : delta / weights.size();
+  }
+
+  // the weights may all be null
+  delta = std::max(delta, SMALLEST_DELTA);
+
+  // the index of the bucket of a distance
+  auto bucketOf = [delta](double distance) {
+    double index = distance / delta;
+    return index < MAX_BUCKET ? static_cast<unsigned long long>(index) : MAX_BUCKET;
+  };
+
+  nodeDistance.setAll(INFINITE_DISTANCE);
+  unsigned int srcPos = graph->nodePos(src);
+  nodeDistance[srcPos] = 0;
+
+  // the nodes whose distance is in [i * delta, (i + 1) * delta[ are in the bucket i,
+  // a node may remain in the bucket of a greater distance
+  map<unsigned long long, vector<unsigned int>> buckets;
+  buckets[0].push_back(srcPos);
+  // the relaxation requests (node position, distance) of each thread
+  vector<vector<pair<unsigned int, double>>> requests(TLP_MAX_NB_THREADS);
+  // the last round during which a node has been treated
+  NodeStaticProperty<unsigned int> treated(graph);
+  treated.setAll(UINT_MAX);
+  unsigned int round = 0;
+
+  // the requests are computed in parallel for all the nodes of a bucket
+  auto computeRequests = [&](const vector<unsigned int> &bucket, bool light) {
+    TLP_PARALLEL_MAP_INDICES(bucket.size(), [&](unsigned int i) {
+      unsigned int uPos = bucket[i];
+      node u = nodes[uPos];
+      double uDist = nodeDistance[uPos];
+      vector<pair<unsigned int, double>> &threadRequests =
+          requests[ThreadManager::getThreadNumber()];
+
+      for (auto e : graph->adjacentEdges(u, direction)) {
+        double eWeight = weights.getEdgeValue(e);
+
+        // the null weights are light
+        if ((eWeight <= delta) == light) {
+          unsigned int vPos = graph->nodePos(graph->opposite(e, u));
+
+          if (uDist + eWeight < nodeDistance[vPos])
+            threadRequests.emplace_back(vPos, uDist + eWeight);
+        }
+      }
+    });
+  };
+
+  // then applied sequentially
+  auto relaxRequests = [&]() {
+    for (auto &threadRequests : requests) {
+      for (const auto &request : threadRequests) {
+        if (request.second < nodeDistance[request.first]) {
+          nodeDistance[request.first] = request.second;
+          buckets[bucketOf(request.second)].push_back(request.first);
+        }
+      }
+
+      threadRequests.clear();
+    }
+  };
+
+  while (!buckets.empty()) {
+    auto it = buckets.begin();
+    unsigned long long bucketIndex = it->first;
+    // the nodes removed from the bucket
+    vector<unsigned int> removed;
+    ++round;
+
+    while (!it->second.empty()) {
+      vector<unsigned int> bucket;
+      bucket.swap(it->second);
+      // skip the nodes which have moved to a lesser bucket
+      // or are already in the current one
+      bucket.erase(remove_if(bucket.begin(), bucket.end(),
+                             [&](unsigned int pos) {
+                               if (bucketOf(nodeDistance[pos]) != bucketIndex)
+                                 return true;
+
+                               if (treated[pos] == round)
+                                 return true;
+
+                               treated[pos] = round;
+                               return false;
+                             }),
+                   bucket.end());
+      ++round;
+      // the light edges may put nodes back in the current bucket
+      computeRequests(bucket, true);
+      relaxRequests();
+      removed.insert(removed.end(), bucket.begin(), bucket.end());
+      // buckets may have been inserted, but it remains valid
+    }
+
+    buckets.erase(it);
+    // the heavy edges of all the nodes removed from the bucket
+    sort(removed.begin(), removed.end());
+    removed.erase(unique(removed.begin(), removed.end()), removed.end());
+    computeRequests(removed, false);
+    relaxRequests();
+  }
+}
+//========================================
+bool Dijkstra::searchPath(const Graph *const graph, node src, node tgt,
+                          const EdgeStaticProperty<double> &weights, EDGE_TYPE direction,
+                          BooleanProperty *result) {
+  assert(src.isValid() && tgt.isValid());
+  const vector<node> &nodes = graph->nodes();
+  // the forward search from src follows the direction,
+  // the backward one from tgt follows the reversed direction
+  EDGE_TYPE directions[2] = {direction, direction == DIRECTED
+                                            ? INV_DIRECTED
+                                            : (direction == INV_DIRECTED ? DIRECTED : UNDIRECTED)};
+  NodeStaticProperty<double> dists[2] = {NodeStaticProperty<double>(graph),
+                                         NodeStaticProperty<double>(graph)};
+  // the edge through which each node has been reached
+  NodeStaticProperty<edge> previous[2] = {NodeStaticProperty<edge>(graph),
+                                          NodeStaticProperty<edge>(graph)};
+  NodeStaticProperty<bool> treated[2] = {NodeStaticProperty<bool>(graph),
+                                         NodeStaticProperty<bool>(graph)};
+  DijkstraHeap heaps[2] = {DijkstraHeap(dists[0], nodes), DijkstraHeap(dists[1], nodes)};
+  unsigned int ends[2] = {graph->nodePos(src), graph->nodePos(tgt)};
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    dists[i].setAll(INFINITE_DISTANCE);
+    treated[i].setAll(false);
+    dists[i][ends[i]] = 0;
+    heaps[i].push(ends[i]);
+  }
+
+  // the length of the shortest path found so far and the node
+  // where its forward and backward parts meet
+  double best = src == tgt ? 0 : INFINITE_DISTANCE;
+  unsigned int meeting = src == tgt ? ends[0] : UINT_MAX;
+
+  // the search stops as soon as no shorter path can be found
+  while (!heaps[0].empty() && !heaps[1].empty() &&
+         dists[0][heaps[0].top()] + dists[1][heaps[1].top()] < best) {
+    // extend the search having the nearest node
+    unsigned int i = dists[0][heaps[0].top()] <= dists[1][heaps[1].top()] ? 0 : 1;
+    unsigned int uPos = heaps[i].pop();
+    node u = nodes[uPos];
+    treated[i][uPos] = true;
+
+    for (auto e : graph->adjacentEdges(u, directions[i])) {
+      unsigned int vPos = graph->nodePos(graph->opposite(e, u));
+      double dist = dists[i][uPos] + weights.getEdgeValue(e);
+
+      if (treated[i][vPos] || dist >= dists[i][vPos])
+        continue;
+
+      dists[i][vPos] = dist;
+      previous[i][vPos] = e;
+
+      if (heaps[i].contains(vPos))
+        heaps[i].decrease(vPos);
+      else
+        heaps[i].push(vPos);
+
+      if (dist + dists[1 - i][vPos] < best) {
+        best = dist + dists[1 - i][vPos];
+        meeting = vPos;
+      }
+    }
+  }
+
+  if (meeting == UINT_MAX) {
+    result->setAllNodeValue(false);
+    result->setAllEdgeValue(false);
+    return false;
+  }
+
+  // select the path from the meeting node back to src and forward to tgt
+  for (unsigned int i = 0; i < 2; ++i) {
+    unsigned int pos = meeting;
+    result->setNodeValue(nodes[pos], true);
+
+    while (pos != ends[i]) {
+      edge e = previous[i][pos];
+      result->setEdgeValue(e, true);
+      pos = graph->nodePos(graph->opposite(e, nodes[pos]));
+      result->setNodeValue(nodes[pos], true);
+    }
+  }
+
+  return true;
+}
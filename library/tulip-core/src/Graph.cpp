@@ -45,6 +45,7 @@
 #include <tulip/TulipViewSettings.h>
 #include <tulip/vectorgraph.h>
 #include <tulip/PluginLister.h>
+#include <tulip/ParallelTools.h>
 
 using namespace std;
 using namespace tlp;
@@ -822,6 +823,16 @@ tlp::node Graph::getSink() const {
   return node();
 }
 
+std::vector<edge> Graph::existEdges(const std::vector<std::pair<node, node>> &ends,
+                                    bool directed) const {
+  std::vector<edge> edges(ends.size());
+  // the edges indexes of the high degree nodes can be built concurrently
+  TLP_PARALLEL_MAP_INDICES(ends.size(), [&](unsigned int i) {
+    edges[i] = existEdge(ends[i].first, ends[i].second, directed);
+  });
+  return edges;
+}
+
 DataType *Graph::getAttribute(const std::string &name) const {
   return getAttributes().getData(name);
 }
@@ -833,26 +844,50 @@ void Graph::setAttribute(const std::string &name, const DataType *value) {
 }
 
 void Graph::notifyAddNode(const node n) {
+  ++topologyVersion;
+
   if (hasOnlookers())
     sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODE, n));
 }
 
+void Graph::notifyAddNodes(unsigned int nbNodes) {
+  ++topologyVersion;
+
+  if (hasOnlookers())
+    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODES, nbNodes));
+}
+
 void Graph::notifyDelNode(const node n) {
+  ++topologyVersion;
+
   if (hasOnlookers())
     sendEvent(GraphEvent(*this, GraphEvent::TLP_DEL_NODE, n));
 }
 
 void Graph::notifyAddEdge(const edge e) {
+  ++topologyVersion;
+
   if (hasOnlookers())
     sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGE, e));
 }
 
+void Graph::notifyAddEdges(unsigned int nbEdges) {
+  ++topologyVersion;
+
+  if (hasOnlookers())
+    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGES, nbEdges));
+}
+
 void Graph::notifyDelEdge(const edge e) {
+  ++topologyVersion;
+
   if (hasOnlookers())
     sendEvent(GraphEvent(*this, GraphEvent::TLP_DEL_EDGE, e));
 }
 
 void Graph::notifyReverseEdge(const edge e) {
+  ++topologyVersion;
+
   if (hasOnlookers())
     sendEvent(GraphEvent(*this, GraphEvent::TLP_REVERSE_EDGE, e));
 }
@@ -863,6 +898,8 @@ void Graph::notifyBeforeSetEnds(const edge e) {
 }
 
 void Graph::notifyAfterSetEnds(const edge e) {
+  ++topologyVersion;
+
   if (hasOnlookers())
     sendEvent(GraphEvent(*this, GraphEvent::TLP_AFTER_SET_ENDS, e));
 }
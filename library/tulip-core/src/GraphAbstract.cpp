@@ -349,6 +349,10 @@ PropertyInterface *GraphAbstract::getProperty(const string &str) const {
   return propertyContainer->getProperty(str);
 }
 //=========================================================================
+PropertyInterface *GraphAbstract::findProperty(const PropertyKey &key) const {
+  return propertyContainer->findProperty(key);
+}
+//=========================================================================
 void GraphAbstract::delLocalProperty(const std::string &name) {
   std::string nameCopy = name; // the name is copied to ensure that the notifyBeforeDel event will
                                // not use an invalid reference
@@ -308,16 +308,14 @@ node GraphDecorator::addNode() {
 void GraphDecorator::addNodes(unsigned int nb) {
   graph_component->addNodes(nb);
 
-  if (hasOnlookers())
-    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODES, nb));
+  notifyAddNodes(nb);
 }
 
 //============================================================
 void GraphDecorator::addNodes(unsigned int nb, std::vector<node> &addedNodes) {
   graph_component->addNodes(nb, addedNodes);
 
-  if (hasOnlookers())
-    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODES, nb));
+  notifyAddNodes(nb);
 }
 
 //============================================================
@@ -351,8 +349,7 @@ edge GraphDecorator::addEdge(const node n, const node n2) {
 void GraphDecorator::addEdges(const std::vector<std::pair<node, node>> &edges) {
   graph_component->addEdges(edges);
 
-  if (hasOnlookers())
-    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGES, edges.size()));
+  notifyAddEdges(edges.size());
 }
 
 //============================================================
@@ -360,8 +357,7 @@ void GraphDecorator::addEdges(const std::vector<std::pair<node, node>> &edges,
                               std::vector<edge> &addedEdges) {
   graph_component->addEdges(edges, addedEdges);
 
-  if (hasOnlookers())
-    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGES, edges.size()));
+  notifyAddEdges(edges.size());
 }
 
 //============================================================
@@ -488,12 +484,17 @@ const std::vector<edge> &GraphDecorator::allEdges(const node n) const {
   return graph_component->allEdges(n);
 }
 //============================================================
+AdjacencyData GraphDecorator::getAdjacency(const node n) const {
+  return graph_component->getAdjacency(n);
+}
+//============================================================
 Iterator<edge> *GraphDecorator::getEdgeMetaInfo(const edge e) const {
   return graph_component->getEdgeMetaInfo(e);
 }
 //============================================================
 void GraphDecorator::sortElts() {
-  return graph_component->sortElts();
+  graph_component->sortElts();
+  ++topologyVersion;
 }
 //============================================================
 DataSet &GraphDecorator::getNonConstAttributes() {
@@ -504,6 +505,11 @@ PropertyInterface *GraphDecorator::getProperty(const std::string &name) const {
   return graph_component->getProperty(name);
 }
 
+//============================================================
+PropertyInterface *GraphDecorator::findProperty(const PropertyKey &key) const {
+  return graph_component->findProperty(key);
+}
+
 //============================================================
 bool GraphDecorator::existProperty(const std::string &name) const {
   return graph_component->existProperty(name);
@@ -73,6 +73,7 @@ GraphImpl::~GraphImpl() {
 void GraphImpl::clear() {
   GraphAbstract::clear();
   storage.clear();
+  ++topologyVersion;
 }
 //----------------------------------------------------------------
 edge GraphImpl::existEdge(const node src, const node tgt, bool directed) const {
@@ -107,8 +108,7 @@ void GraphImpl::addNodes(unsigned int nb) {
   if (nb) {
     storage.addNodes(nb);
 
-    if (hasOnlookers())
-      sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODES, nb));
+    notifyAddNodes(nb);
   }
 }
 //----------------------------------------------------------------
@@ -116,8 +116,7 @@ void GraphImpl::addNodes(unsigned int nb, std::vector<node> &addedNodes) {
   if (nb) {
     storage.addNodes(nb, &addedNodes);
 
-    if (hasOnlookers())
-      sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODES, nb));
+    notifyAddNodes(nb);
   }
 }
 //----------------------------------------------------------------
@@ -152,8 +151,7 @@ void GraphImpl::addEdges(const std::vector<std::pair<node, node>> &edges,
   if (!edges.empty()) {
     storage.addEdges(edges, &addedEdges);
 
-    if (hasOnlookers())
-      sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGES, edges.size()));
+    notifyAddEdges(edges.size());
   }
 }
 //----------------------------------------------------------------
@@ -161,8 +159,7 @@ void GraphImpl::addEdges(const std::vector<std::pair<node, node>> &edges) {
   if (!edges.empty()) {
     storage.addEdges(edges);
 
-    if (hasOnlookers())
-      sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGES, edges.size()));
+    notifyAddEdges(edges.size());
   }
 }
 //----------------------------------------------------------------
@@ -52,14 +52,12 @@ unsigned int tlp::maxDistance(const Graph *graph, unsigned int nPos,
   distance[nPos] = 0;
   const std::vector<node> &nodes = graph->nodes();
   unsigned int maxDist = 0;
-  auto getNodes = getNodesIterator(direction);
-
   while (!fifo.empty()) {
     unsigned int curPos = fifo.front();
     fifo.pop_front();
     unsigned int nDist = distance[curPos] + 1;
 
-    for (auto n : getNodes(graph, nodes[curPos])) {
+    for (auto n : graph->adjacentNodes(nodes[curPos], direction)) {
       nPos = graph->nodePos(n);
       if (distance[nPos] == UINT_MAX) {
         fifo.push_back(nPos);
@@ -186,7 +184,7 @@ void tlp::clusteringCoefficient(const Graph *graph, tlp::NodeStaticProperty<doub
     while (itr != ite) {
       node itn = itr->first;
 
-      for (auto e : graph->getInOutEdges(itn)) {
+      for (auto e : graph->inOutEdges(itn)) {
         auto eEnds = graph->ends(e);
 
         if ((reachables.find(eEnds.first) != ite) && (reachables.find(eEnds.second) != ite)) {
@@ -232,7 +230,7 @@ void tlp::dagLevel(const Graph *graph, tlp::NodeStaticProperty<unsigned int> &le
     node current = fifo.front();
     fifo.pop_front();
     unsigned int curLevel = level.getNodeValue(current) + 1;
-    for (auto child : graph->getOutNodes(current)) {
+    for (auto child : graph->outNodes(current)) {
       unsigned int childPos = graph->nodePos(child);
       unsigned int childLevel = totreat[childPos];
 
@@ -301,7 +299,7 @@ void tlp::degree(const Graph *graph, tlp::NodeStaticProperty<double> &deg, EDGE_
       case UNDIRECTED:
         TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
           double nWeight = 0.0;
-          for (auto e : graph->getInOutEdges(n)) {
+          for (auto e : graph->inOutEdges(n)) {
             nWeight += weights->getEdgeDoubleValue(e);
           }
           deg[i] = nWeight;
@@ -311,7 +309,7 @@ void tlp::degree(const Graph *graph, tlp::NodeStaticProperty<double> &deg, EDGE_
       case INV_DIRECTED:
         TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
           double nWeight = 0.0;
-          for (auto e : graph->getInEdges(n)) {
+          for (auto e : graph->inEdges(n)) {
             nWeight += weights->getEdgeDoubleValue(e);
           }
           deg[i] = nWeight;
@@ -322,7 +320,7 @@ void tlp::degree(const Graph *graph, tlp::NodeStaticProperty<double> &deg, EDGE_
       case DIRECTED:
         TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
           double nWeight = 0.0;
-          for (auto e : graph->getOutEdges(n)) {
+          for (auto e : graph->outEdges(n)) {
             nWeight += weights->getEdgeDoubleValue(e);
           }
           deg[i] = nWeight;
@@ -352,7 +350,7 @@ void tlp::degree(const Graph *graph, tlp::NodeStaticProperty<double> &deg, EDGE_
       case UNDIRECTED:
         TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
           double nWeight = 0.0;
-          for (auto e : graph->getInOutEdges(n)) {
+          for (auto e : graph->inOutEdges(n)) {
             nWeight += weights->getEdgeDoubleValue(e);
           }
           deg[i] = nWeight * normalization;
@@ -363,7 +361,7 @@ void tlp::degree(const Graph *graph, tlp::NodeStaticProperty<double> &deg, EDGE_
       case INV_DIRECTED:
         TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
           double nWeight = 0.0;
-          for (auto e : graph->getInEdges(n)) {
+          for (auto e : graph->inEdges(n)) {
             nWeight += weights->getEdgeDoubleValue(e);
           }
           deg[i] = nWeight * normalization;
@@ -374,7 +372,7 @@ void tlp::degree(const Graph *graph, tlp::NodeStaticProperty<double> &deg, EDGE_
       case DIRECTED:
         TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
           double nWeight = 0.0;
-          for (auto e : graph->getOutEdges(n)) {
+          for (auto e : graph->outEdges(n)) {
             nWeight += weights->getEdgeDoubleValue(e);
           }
           deg[i] = nWeight * normalization;
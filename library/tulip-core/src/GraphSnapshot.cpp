@@ -0,0 +1,158 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <unordered_map>
+
+#include <tulip/GraphSnapshot.h>
+#include <tulip/ParallelTools.h>
+
+using namespace std;
+
+namespace tlp {
+// the snapshots are removed from the cache when the topology of their graphs changes
+class GraphSnapshotListener : public Observable {
+public:
+  void treatEvent(const Event &evt) override {
+    const GraphEvent *gEvt = dynamic_cast<const GraphEvent *>(&evt);
+
+    if (gEvt) {
+      switch (gEvt->getType()) {
+      case GraphEvent::TLP_ADD_NODE:
+      case GraphEvent::TLP_DEL_NODE:
+      case GraphEvent::TLP_ADD_EDGE:
+      case GraphEvent::TLP_DEL_EDGE:
+      case GraphEvent::TLP_REVERSE_EDGE:
+      case GraphEvent::TLP_AFTER_SET_ENDS:
+      case GraphEvent::TLP_ADD_NODES:
+      case GraphEvent::TLP_ADD_EDGES:
+        invalidate(gEvt->getGraph());
+        break;
+
+      default:
+        // we don't care about other events
+        break;
+      }
+    } else if (evt.type() == Event::TLP_DELETE)
+      invalidate(static_cast<Graph *>(evt.sender()));
+  }
+
+  void invalidate(const Graph *graph) {
+    auto it = snapshots.find(graph);
+
+    if (it != snapshots.end()) {
+      const_cast<Graph *>(graph)->removeListener(this);
+      snapshots.erase(it);
+    }
+  }
+
+  // remove the least recently used snapshots
+  // until there are at most nbSnapshots ones
+  void trim(unsigned int nbSnapshots) {
+    while (snapshots.size() > nbSnapshots) {
+      auto lru = snapshots.begin();
+
+      for (auto it = snapshots.begin(); it != snapshots.end(); ++it) {
+        if (it->second.lastUse < lru->second.lastUse)
+          lru = it;
+      }
+
+      invalidate(lru->first);
+    }
+  }
+
+  struct CachedSnapshot {
+    std::shared_ptr<const GraphSnapshot> snapshot;
+    unsigned int lastUse;
+  };
+
+  std::unordered_map<const Graph *, CachedSnapshot> snapshots;
+  unsigned int cacheSize = 4;
+  unsigned int nbUses = 0;
+  unsigned int nbBuilds = 0;
+};
+} // namespace tlp
+
+using namespace tlp;
+
+static GraphSnapshotListener instance;
+
+GraphSnapshot::GraphSnapshot(const Graph *graph)
+    : graph(graph), topologyVersion(graph->getTopologyVersion()) {
+  const vector<node> &nodes = graph->nodes();
+  const vector<edge> &edges = graph->edges();
+  unsigned int nbNodes = nodes.size();
+  unsigned int nbEdges = edges.size();
+
+  vGraph.reserveNodes(nbNodes);
+  vGraph.reserveEdges(nbEdges);
+  vGraph.addNodes(nbNodes);
+
+  for (unsigned int i = 0; i < nbNodes; ++i)
+    vGraph.reserveAdj(node(i), graph->deg(nodes[i]));
+
+  // the ends of the edges, using the positions of the nodes
+  vector<pair<node, node>> ends(nbEdges);
+  TLP_PARALLEL_MAP_INDICES(nbEdges, [&](unsigned int i) {
+    const pair<node, node> &eEnds = graph->ends(edges[i]);
+    ends[i] = make_pair(node(graph->nodePos(eEnds.first)), node(graph->nodePos(eEnds.second)));
+  });
+  vGraph.addEdges(ends);
+}
+
+shared_ptr<const GraphSnapshot> GraphSnapshot::get(const Graph *graph) {
+  auto it = instance.snapshots.find(graph);
+
+  if (it != instance.snapshots.end()) {
+    // the listener removes the snapshot when the topology changes,
+    // but the version also accounts for sortElts() which is not notified
+    if (it->second.snapshot->topologyVersion == graph->getTopologyVersion()) {
+      it->second.lastUse = ++instance.nbUses;
+      return it->second.snapshot;
+    }
+
+    instance.invalidate(graph);
+  }
+
+  shared_ptr<const GraphSnapshot> snapshot(new GraphSnapshot(graph));
+  ++instance.nbBuilds;
+
+  if (instance.cacheSize) {
+    instance.trim(instance.cacheSize - 1);
+    instance.snapshots[graph] = {snapshot, ++instance.nbUses};
+    const_cast<Graph *>(graph)->addListener(instance);
+  }
+
+  return snapshot;
+}
+
+void GraphSnapshot::invalidate(const Graph *graph) {
+  instance.invalidate(graph);
+}
+
+void GraphSnapshot::setCacheSize(unsigned int nbSnapshots) {
+  instance.cacheSize = nbSnapshots;
+  instance.trim(nbSnapshots);
+}
+
+unsigned int GraphSnapshot::getCacheSize() {
+  return instance.cacheSize;
+}
+
+unsigned int GraphSnapshot::getNumberOfBuilds() {
+  return instance.nbBuilds;
+}
@@ -16,6 +16,10 @@
  * See the GNU General Public License for more details.
  *
  */
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 #include <tulip/GraphStorage.h>
 #include <tulip/Graph.h>
 #include <tulip/memorypool.h>
@@ -23,6 +27,16 @@
 
 using namespace tlp;
 
+// the edges of a node indexed by the id of their opposite node
+struct GraphStorage::EdgesIndex : public std::unordered_multimap<unsigned int, edge> {};
+
+// serialize the concurrent builds of the indexes
+static std::mutex edgesIndexMutex;
+
+GraphStorage::NodeData::~NodeData() {
+  delete edgesIndex.load(std::memory_order_relaxed);
+}
+
 #define VECT_SET_SIZE(v, t, sz) reinterpret_cast<t **>(v)[1] = reinterpret_cast<t **>(v)[0] + sz
 #define VECT_INC_SIZE(v, t, sz)                                                                    \
   (*v).reserve(sz);                                                                                \
@@ -79,6 +93,7 @@ void GraphStorage::reserveAdj(const size_t nb) {
  * @brief restore adjacency edges of a given node
  */
 void GraphStorage::restoreAdj(const node n, const std::vector<edge> &edges) {
+  deleteEdgesIndex(nodeData[n.id]);
   std::vector<edge> &nEdges = nodeData[n.id].edges;
   VECT_INC_SIZE(&nEdges, edge, edges.size());
   memcpy(nEdges.data(), edges.data(), edges.size() * sizeof(edge));
@@ -248,33 +263,62 @@ Iterator<edge> *GraphStorage::getInOutEdges(const node n) const {
 //=======================================================
 bool GraphStorage::getEdges(const node src, const node tgt, bool directed,
                             std::vector<edge> &vEdges, const Graph *sg, bool onlyFirst) const {
-  std::vector<edge>::const_iterator it = nodeData[src.id].edges.begin();
-  edge previous;
+  // the edges are searched in the adjacency of the end with the lowest degree
+  node n = src, m = tgt;
+
+  if (nodeData[tgt.id].edges.size() < nodeData[src.id].edges.size()) {
+    n = tgt;
+    m = src;
+  }
 
-  while (it != nodeData[src.id].edges.end()) {
-    edge e = (*it);
+  // whatever the way they are found, the edges are ordered by id
+  size_t nbEdges = vEdges.size();
+  auto addEdge = [&](const edge e) {
+    if (!onlyFirst || vEdges.size() == nbEdges)
+      vEdges.push_back(e);
+    else if (e.id < vEdges[nbEdges].id)
+      vEdges[nbEdges] = e;
+  };
 
-    // loops appear twice
-    // be aware that we assume that the second instance of the loop
-    // immediately appears after the first one
-    if (e != previous) {
-      const std::pair<node, node> &eEnds = edgeEnds[e.id];
+  const std::vector<edge> &nEdges = nodeData[n.id].edges;
 
-      if (((eEnds.second == tgt && eEnds.first == src) ||
-           (!directed && eEnds.first == tgt && eEnds.second == src)) &&
-          (!sg || sg->isElement(e))) {
-        vEdges.push_back(e);
+  if (nEdges.size() >= EDGES_INDEX_MIN_DEGREE) {
+    auto range = getEdgesIndex(n).equal_range(m.id);
 
-        if (onlyFirst)
-          return true;
-      }
+    for (auto itIdx = range.first; itIdx != range.second; ++itIdx) {
+      edge e = itIdx->second;
+
+      if ((directed && edgeEnds[e.id].first != src) || (sg && !sg->isElement(e)))
+        continue;
+
+      addEdge(e);
     }
+  } else {
+    std::vector<edge>::const_iterator it = nEdges.begin();
+    edge previous;
+
+    while (it != nEdges.end()) {
+      edge e = (*it);
+
+      // loops appear twice
+      // be aware that we assume that the second instance of the loop
+      // immediately appears after the first one
+      if (e != previous) {
+        const std::pair<node, node> &eEnds = edgeEnds[e.id];
+
+        if (((eEnds.second == tgt && eEnds.first == src) ||
+             (!directed && eEnds.first == tgt && eEnds.second == src)) &&
+            (!sg || sg->isElement(e)))
+          addEdge(e);
+      }
 
-    previous = e;
-    ++it;
+      previous = e;
+      ++it;
+    }
   }
 
-  return !vEdges.empty();
+  std::sort(vEdges.begin() + nbEdges, vEdges.end());
+  return vEdges.size() > nbEdges;
 }
 //=======================================================
 Iterator<edge> *GraphStorage::getOutEdges(const node n) const {
@@ -310,6 +354,8 @@ void GraphStorage::setEnds(const edge e, const node newSrc, const node newTgt) {
   if (src == newSrc && tgt == newTgt)
     return;
 
+  unindexEdge(e);
+
   node nSrc = newSrc;
   node nTgt = newTgt;
 
@@ -332,6 +378,8 @@ void GraphStorage::setEnds(const edge e, const node newSrc, const node newTgt) {
     removeFromNodeData(nodeData[tgt.id], e);
   } else
     nTgt = tgt;
+
+  indexEdge(e);
 }
 //=======================================================
 /**
@@ -413,6 +461,7 @@ void GraphStorage::restoreNode(const node n) {
     // clear edge infos
     nData.edges.clear();
     nData.outDegree = 0;
+    deleteEdgesIndex(nData);
   }
 }
 //=======================================================
@@ -469,6 +518,7 @@ void GraphStorage::removeFromNodes(const node n) {
   // clear edge infos
   nData.edges.clear();
   nData.outDegree = 0;
+  deleteEdgesIndex(nData);
   // push in free pool
   nodeIds.free(n);
 
@@ -515,6 +565,9 @@ void GraphStorage::restoreEdge(const node src, const node tgt, const edge e) {
   ends.first = src;
   ends.second = tgt;
   nodeData[src.id].outDegree += 1;
+  // the adjacencies of the ends are restored separately
+  deleteEdgesIndex(nodeData[src.id]);
+  deleteEdgesIndex(nodeData[tgt.id]);
 }
 //=======================================================
 /**
@@ -536,6 +589,7 @@ edge GraphStorage::addEdge(const node src, const node tgt) {
   srcData.outDegree += 1;
   srcData.edges.push_back(e);
   nodeData[tgt.id].edges.push_back(e);
+  indexEdge(e);
 
   return e;
 }
@@ -579,6 +633,7 @@ void GraphStorage::addEdges(const std::vector<std::pair<node, node>> &ends,
     srcData.outDegree += 1;
     srcData.edges.push_back(e);
     nodeData[tgt.id].edges.push_back(e);
+    indexEdge(e);
   }
 }
 //=======================================================
@@ -601,6 +656,7 @@ void GraphStorage::delAllEdges() {
   // loop on nodes to clear adjacency edges
   for (auto &nd : nodeData) {
     nd.edges.clear();
+    deleteEdgesIndex(nd);
   }
 }
 //=======================================================
@@ -636,6 +692,7 @@ void GraphStorage::removeFromNodeData(NodeData &c, const edge e) {
  * except for the end node in argument if it is valid
  */
 void GraphStorage::removeFromEdges(const edge e, node end) {
+  unindexEdge(e, end);
   edgeIds.free(e);
   std::pair<node, node> &eEnds = edgeEnds[e.id];
   // remove from source's edges
@@ -650,3 +707,96 @@ void GraphStorage::removeFromEdges(const edge e, node end) {
   if (n != end)
     removeFromNodeData(nodeData[n.id], e);
 }
+//=======================================================
+/**
+ * @brief return the index of the edges of n, built if needed
+ */
+const GraphStorage::EdgesIndex &GraphStorage::getEdgesIndex(const node n) const {
+  NodeData &nData = nodeData[n.id];
+  EdgesIndex *index = nData.edgesIndex.load(std::memory_order_acquire);
+
+  if (index == nullptr) {
+    std::lock_guard<std::mutex> lock(edgesIndexMutex);
+    index = nData.edgesIndex.load(std::memory_order_relaxed);
+
+    if (index == nullptr) {
+      index = new EdgesIndex();
+      index->reserve(nData.edges.size());
+
+      for (auto e : nData.edges) {
+        node m = opposite(e, n);
+
+        // loops appear twice in the adjacency but are indexed once
+        if (m == n) {
+          auto range = index->equal_range(n.id);
+
+          if (std::find_if(range.first, range.second,
+                           [e](const std::pair<const unsigned int, edge> &p) {
+                             return p.second == e;
+                           }) != range.second)
+            continue;
+        }
+
+        index->emplace(m.id, e);
+      }
+
+      nData.edgesIndex.store(index, std::memory_order_release);
+    }
+  }
+
+  return *index;
+}
+//=======================================================
+/**
+ * @brief add e in the existing indexes of its ends
+ */
+void GraphStorage::indexEdge(const edge e) {
+  const std::pair<node, node> &eEnds = edgeEnds[e.id];
+  EdgesIndex *index = nodeData[eEnds.first.id].edgesIndex.load(std::memory_order_relaxed);
+
+  if (index)
+    index->emplace(eEnds.second.id, e);
+
+  if (eEnds.second != eEnds.first) {
+    index = nodeData[eEnds.second.id].edgesIndex.load(std::memory_order_relaxed);
+
+    if (index)
+      index->emplace(eEnds.first.id, e);
+  }
+}
+//=======================================================
+static void removeFromIndex(std::unordered_multimap<unsigned int, edge> *index, node m,
+                            const edge e) {
+  auto range = index->equal_range(m.id);
+
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == e) {
+      index->erase(it);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief remove e from the existing indexes of its ends
+ * except for the end node in argument if it is valid
+ */
+void GraphStorage::unindexEdge(const edge e, node end) {
+  const std::pair<node, node> &eEnds = edgeEnds[e.id];
+  EdgesIndex *index;
+
+  if (eEnds.first != end &&
+      (index = nodeData[eEnds.first.id].edgesIndex.load(std::memory_order_relaxed)))
+    removeFromIndex(index, eEnds.second, e);
+
+  if (eEnds.second != end && eEnds.second != eEnds.first &&
+      (index = nodeData[eEnds.second.id].edgesIndex.load(std::memory_order_relaxed)))
+    removeFromIndex(index, eEnds.first, e);
+}
+//=======================================================
+/**
+ * @brief delete the index of the edges of n if any
+ */
+void GraphStorage::deleteEdgesIndex(NodeData &nData) {
+  delete nData.edgesIndex.exchange(nullptr, std::memory_order_relaxed);
+}
@@ -324,7 +324,7 @@ void selectSpanningForest(Graph *graph, BooleanProperty *selectionProperty,
     while (!fifo.empty()) {
       node n1 = fifo.front();
       fifo.pop_front();
-      for (auto adjit : graph->getOutEdges(n1)) {
+      for (auto adjit : graph->outEdges(n1)) {
         node tgt = graph->target(adjit);
         unsigned int tgtPos = graph->nodePos(tgt);
 
@@ -410,7 +410,7 @@ void selectSpanningTree(Graph *graph, BooleanProperty *selection, PluginProgress
   while (nbNodes != size) {
     root = roots[i];
 
-    for (auto e : graph->getInOutEdges(root)) {
+    for (auto e : graph->inOutEdges(root)) {
 
       if (!selection->getEdgeValue(e)) {
         node neighbour = graph->opposite(e, root);
@@ -534,7 +534,7 @@ static void bfs(const Graph *graph, node root, std::vector<tlp::node> &nodes,
   unsigned nbNodes = 1;
 
   while (current) {
-    for (auto neigh : graph->getInOutNodes(current->n)) {
+    for (auto neigh : graph->inOutNodes(current->n)) {
       if (!visited.get(neigh)) {
         visited.set(neigh, true);
         last = last->next = new visitedElt(neigh);
@@ -587,28 +587,28 @@ static void dfs(const Graph *graph, node n, std::vector<node> &nodes,
                 MutableContainer<bool> &visited) {
   if (!visited.get(n.id)) {
     visited.set(n.id, true);
-    bool edgeOK = (graph == graph->getRoot());
     std::stack<tlp::node> toVisit;
     toVisit.push(n);
+    // the neighbours of the current node
+    std::vector<node> neighbours;
 
     while (!toVisit.empty()) {
       node current = toVisit.top();
       toVisit.pop();
       nodes.push_back(current);
-      const std::vector<edge> &edges = graph->allEdges(current);
-      unsigned int nbEdges = edges.size();
-      unsigned int i = nbEdges;
+      neighbours.clear();
 
-      while (i) {
-        edge e = edges[--i];
+      for (auto neigh : graph->inOutNodes(current))
+        neighbours.push_back(neigh);
 
-        if (edgeOK || graph->isElement(e)) {
-          node neigh = graph->opposite(e, current);
+      // the neighbours are pushed in reverse order
+      // to be popped in the order of the adjacency
+      for (auto it = neighbours.rbegin(); it != neighbours.rend(); ++it) {
+        node neigh = *it;
 
-          if (!visited.get(neigh.id)) {
-            visited.set(neigh.id, true);
-            toVisit.push(neigh);
-          }
+        if (!visited.get(neigh.id)) {
+          visited.set(neigh.id, true);
+          toVisit.push(neigh);
         }
       }
     }
@@ -782,11 +782,12 @@ bool selectShortestPaths(const Graph *const graph, node src, node tgt, ShortestP
     TLP_PARALLEL_MAP_EDGES_AND_INDICES(graph, fn);
   }
 
+  // one path is found by a bidirectional search
+  if (uint(pathType) < ShortestPathType::AllPaths)
+    return Dijkstra::searchPath(graph, src, tgt, eWeights, direction, result);
+
   NodeStaticProperty<double> nodeDistance(graph);
   Dijkstra dijkstra(graph, src, eWeights, nodeDistance, direction);
-
-  if (uint(pathType) < ShortestPathType::AllPaths)
-    return dijkstra.searchPath(tgt, result);
   return dijkstra.searchPaths(tgt, result);
 }
 
@@ -802,15 +803,13 @@ void markReachableNodes(const Graph *graph, const node startNode,
   visited.set(startNode.id, true);
   distance.set(startNode.id, 0);
 
-  auto getNodes = getNodesIterator(direction);
-
   while (!fifo.empty()) {
     node current = fifo.front();
     unsigned int curDist = distance.get(current.id);
     fifo.pop_front();
 
     if (curDist < maxDistance) {
-      for (auto itn : getNodes(graph, current)) {
+      for (auto itn : graph->adjacentNodes(current, direction)) {
         if (!visited.get(itn.id)) {
           fifo.push_back(itn);
           result[itn] = true;
@@ -830,4 +829,11 @@ void computeDijkstra(const Graph *const graph, node src, const EdgeStaticPropert
   dijkstra.ancestors(ancestors);
 }
 
+void computeDeltaSteppingDistances(const Graph *const graph, node src,
+                                   const EdgeStaticProperty<double> &weights,
+                                   NodeStaticProperty<double> &nodeDistance, EDGE_TYPE direction,
+                                   double delta) {
+  Dijkstra::computeDistances(graph, src, weights, nodeDistance, direction, delta);
+}
+
 } // namespace tlp
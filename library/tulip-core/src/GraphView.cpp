@@ -230,8 +230,7 @@ void GraphView::addNodesInternal(unsigned int nbAdded, const std::vector<node> *
     _nodes.add(n);
   }
 
-  if (hasOnlookers())
-    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_NODES, nbAdded));
+  notifyAddNodes(nbAdded);
 }
 //----------------------------------------------------------------
 void GraphView::addNode(const node n) {
@@ -315,8 +314,7 @@ void GraphView::addEdgesInternal(unsigned int nbAdded, const std::vector<edge> *
     _nodeData.get(tgt.id)->inDegreeAdd(1);
   }
 
-  if (hasOnlookers())
-    sendEvent(GraphEvent(*this, GraphEvent::TLP_ADD_EDGES, nbAdded));
+  notifyAddEdges(nbAdded);
 }
 //----------------------------------------------------------------
 edge GraphView::addEdge(const node n1, const node n2) {
@@ -497,6 +495,13 @@ Iterator<edge> *GraphView::getInOutEdges(const node n) const {
   return (new InOutEdgesIterator(this, n));
 }
 //----------------------------------------------------------------
+AdjacencyData GraphView::getAdjacency(const node n) const {
+  assert(isElement(n));
+  AdjacencyData data = getRootImpl()->getAdjacency(n);
+  data.graphEdges = &_edges;
+  return data;
+}
+//----------------------------------------------------------------
 std::vector<edge> GraphView::getEdges(const node src, const node tgt, bool directed) const {
   std::vector<edge> ee;
 
@@ -0,0 +1,364 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <cmath>
+
+#include <tulip/IncrementalLayout.h>
+#include <tulip/Graph.h>
+#include <tulip/LayoutProperty.h>
+#include <tulip/TlpTools.h>
+
+using namespace std;
+using namespace tlp;
+
+IncrementalLayout::IncrementalLayout(Graph *graph, LayoutProperty *layout, float edgeLength)
+    : graph(graph), layout(layout), edgeLength(edgeLength), maxIterations(10),
+      neighborhoodDepth(1), updating(false), gridBuilt(false) {
+  assert(graph && layout);
+  graph->addListener(this);
+  layout->addListener(this);
+}
+//======================================================
+IncrementalLayout::~IncrementalLayout() {
+  if (graph) {
+    graph->removeListener(this);
+    layout->removeListener(this);
+  }
+}
+//======================================================
+IncrementalLayout::CellKey IncrementalLayout::cellKey(const Coord &c) const {
+  // the cells are large enough to only look for the repulsive forces
+  // in the cell of a node and in its adjacent cells
+  float cellSize = 2 * edgeLength;
+  int x = int(floor(c[0] / cellSize));
+  int y = int(floor(c[1] / cellSize));
+  return (CellKey(uint(x)) << 32) | CellKey(uint(y));
+}
+//======================================================
+void IncrementalLayout::addToGrid(node n, const Coord &c) {
+  CellKey key = cellKey(c);
+  grid[key].push_back(n);
+  nodeCells[n] = key;
+}
+//======================================================
+void IncrementalLayout::removeFromGrid(node n) {
+  auto it = nodeCells.find(n);
+
+  if (it == nodeCells.end())
+    return;
+
+  auto cell = grid.find(it->second);
+  vector<node> &cellNodes = cell->second;
+
+  for (unsigned int i = 0; i < cellNodes.size(); ++i) {
+    if (cellNodes[i] == n) {
+      cellNodes[i] = cellNodes.back();
+      cellNodes.pop_back();
+      break;
+    }
+  }
+
+  if (cellNodes.empty())
+    grid.erase(cell);
+
+  nodeCells.erase(it);
+}
+//======================================================
+void IncrementalLayout::moveInGrid(node n, const Coord &c) {
+  auto it = nodeCells.find(n);
+
+  if (it != nodeCells.end() && it->second != cellKey(c)) {
+    removeFromGrid(n);
+    addToGrid(n, c);
+  }
+}
+//======================================================
+void IncrementalLayout::buildGrid() {
+  grid.clear();
+  nodeCells.clear();
+  // the nodes added since the last update are not placed yet
+  unordered_set<node> notPlaced(addedNodes.begin(), addedNodes.end());
+
+  for (auto n : graph->nodes()) {
+    if (notPlaced.find(n) == notPlaced.end())
+      addToGrid(n, layout->getNodeValue(n));
+  }
+
+  gridBuilt = true;
+}
+//======================================================
+void IncrementalLayout::placeAddedNodes() {
+  unordered_set<node> toPlace;
+
+  for (auto n : addedNodes) {
+    if (graph->isElement(n) && nodeCells.find(n) == nodeCells.end())
+      toPlace.insert(n);
+  }
+
+  // the nodes are placed in a bfs order starting from the already placed ones,
+  // each node being placed at the barycenter of its placed neighbors
+  vector<node> queue;
+
+  for (auto n : addedNodes) {
+    if (toPlace.find(n) == toPlace.end())
+      continue;
+
+    for (auto v : graph->getInOutNodes(n)) {
+      if (nodeCells.find(v) != nodeCells.end()) {
+        queue.push_back(n);
+        break;
+      }
+    }
+  }
+
+  float jitter = edgeLength / 2;
+  unsigned int nextSeed = 0;
+  unsigned int i = 0;
+
+  while (true) {
+    if (i == queue.size()) {
+      // the remaining nodes are not connected to a placed node,
+      // so one of them is randomly placed to start a new bfs
+      while (nextSeed < addedNodes.size() &&
+             toPlace.find(addedNodes[nextSeed]) == toPlace.end())
+        ++nextSeed;
+
+      if (nextSeed == addedNodes.size())
+        break;
+
+      node seed = addedNodes[nextSeed];
+      float radius = edgeLength * sqrt(float(nodeCells.size() + 1));
+      Coord c(radius * float(randomDouble(2.0) - 1.0), radius * float(randomDouble(2.0) - 1.0),
+              0);
+      layout->setNodeValue(seed, c);
+      addToGrid(seed, c);
+      toPlace.erase(seed);
+
+      for (auto v : graph->getInOutNodes(seed)) {
+        if (toPlace.find(v) != toPlace.end())
+          queue.push_back(v);
+      }
+
+      continue;
+    }
+
+    node n = queue[i++];
+
+    if (toPlace.find(n) == toPlace.end())
+      continue;
+
+    Coord barycenter;
+    unsigned int nbPlaced = 0;
+
+    for (auto v : graph->getInOutNodes(n)) {
+      if (nodeCells.find(v) != nodeCells.end()) {
+        barycenter += layout->getNodeValue(v);
+        ++nbPlaced;
+      } else if (toPlace.find(v) != toPlace.end())
+        queue.push_back(v);
+    }
+
+    barycenter /= float(nbPlaced);
+    barycenter[0] += jitter * float(randomDouble(2.0) - 1.0);
+    barycenter[1] += jitter * float(randomDouble(2.0) - 1.0);
+    layout->setNodeValue(n, barycenter);
+    addToGrid(n, barycenter);
+    toPlace.erase(n);
+  }
+}
+//======================================================
+void IncrementalLayout::relax(const vector<node> &region) {
+  float k2 = edgeLength * edgeLength;
+  float minDist = edgeLength / 100;
+  float cellSize = 2 * edgeLength;
+  vector<Coord> disp(region.size());
+
+  for (unsigned int it = 0; it < maxIterations; ++it) {
+    // the maximum displacement decreases linearly with the iterations
+    float temp = edgeLength * float(maxIterations - it) / (2 * maxIterations);
+
+    for (unsigned int i = 0; i < region.size(); ++i) {
+      node n = region[i];
+      const Coord &pos = layout->getNodeValue(n);
+      Coord &d = disp[i];
+      d.fill(0);
+
+      // repulsive forces from the nodes of the neighbor cells
+      int x = int(floor(pos[0] / cellSize));
+      int y = int(floor(pos[1] / cellSize));
+
+      for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+          auto cell = grid.find((CellKey(uint(x + dx)) << 32) | CellKey(uint(y + dy)));
+
+          if (cell == grid.end())
+            continue;
+
+          for (auto v : cell->second) {
+            if (v == n)
+              continue;
+
+            Coord delta = pos - layout->getNodeValue(v);
+            float dist = std::max(delta.norm(), minDist);
+
+            if (dist < cellSize)
+              d += delta * (k2 / (dist * dist));
+          }
+        }
+      }
+
+      // attractive forces from the neighbors
+      for (auto v : graph->getInOutNodes(n)) {
+        Coord delta = layout->getNodeValue(v) - pos;
+        d += delta * (delta.norm() / edgeLength);
+      }
+    }
+
+    for (unsigned int i = 0; i < region.size(); ++i) {
+      float norm = disp[i].norm();
+
+      if (norm > minDist) {
+        node n = region[i];
+        Coord pos = layout->getNodeValue(n) + disp[i] * (std::min(norm, temp) / norm);
+        layout->setNodeValue(n, pos);
+        moveInGrid(n, pos);
+      }
+    }
+  }
+}
+//======================================================
+void IncrementalLayout::update() {
+  if (graph == nullptr || !hasPendingUpdates())
+    return;
+
+  updating = true;
+
+  if (!gridBuilt)
+    buildGrid();
+
+  placeAddedNodes();
+
+  // the relaxed region is made of the nodes close to the modified elements
+  unordered_map<node, unsigned int> depth;
+  vector<node> region;
+
+  for (auto n : addedNodes) {
+    if (graph->isElement(n) && depth.emplace(n, 0).second)
+      region.push_back(n);
+  }
+
+  for (auto n : changedNodes) {
+    if (graph->isElement(n) && depth.emplace(n, 0).second)
+      region.push_back(n);
+  }
+
+  for (unsigned int i = 0; i < region.size(); ++i) {
+    node n = region[i];
+    unsigned int nDepth = depth[n];
+
+    if (nDepth == neighborhoodDepth)
+      continue;
+
+    for (auto v : graph->getInOutNodes(n)) {
+      if (depth.emplace(v, nDepth + 1).second)
+        region.push_back(v);
+    }
+  }
+
+  relax(region);
+
+  addedNodes.clear();
+  changedNodes.clear();
+  updating = false;
+}
+//======================================================
+void IncrementalLayout::treatEvent(const Event &evt) {
+  if (evt.type() == Event::TLP_DELETE) {
+    // stop listening when the graph or the layout is deleted
+    if (evt.sender() == graph)
+      layout->removeListener(this);
+    else
+      graph->removeListener(this);
+
+    graph = nullptr;
+    layout = nullptr;
+    grid.clear();
+    nodeCells.clear();
+    addedNodes.clear();
+    changedNodes.clear();
+    return;
+  }
+
+  const GraphEvent *gEvt = dynamic_cast<const GraphEvent *>(&evt);
+
+  if (gEvt) {
+    switch (gEvt->getType()) {
+    case GraphEvent::TLP_ADD_NODE:
+      addedNodes.push_back(gEvt->getNode());
+      break;
+
+    case GraphEvent::TLP_ADD_NODES:
+      addedNodes.insert(addedNodes.end(), gEvt->getNodes().begin(), gEvt->getNodes().end());
+      break;
+
+    case GraphEvent::TLP_DEL_NODE:
+      removeFromGrid(gEvt->getNode());
+      changedNodes.erase(gEvt->getNode());
+      break;
+
+    case GraphEvent::TLP_ADD_EDGE:
+    case GraphEvent::TLP_DEL_EDGE: {
+      const pair<node, node> &eEnds = graph->ends(gEvt->getEdge());
+      changedNodes.insert(eEnds.first);
+      changedNodes.insert(eEnds.second);
+      break;
+    }
+
+    case GraphEvent::TLP_ADD_EDGES:
+      for (auto e : gEvt->getEdges()) {
+        const pair<node, node> &eEnds = graph->ends(e);
+        changedNodes.insert(eEnds.first);
+        changedNodes.insert(eEnds.second);
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    return;
+  }
+
+  const PropertyEvent *pEvt = dynamic_cast<const PropertyEvent *>(&evt);
+
+  // keep the grid up to date when the layout is modified from outside
+  if (pEvt && !updating && gridBuilt) {
+    switch (pEvt->getType()) {
+    case PropertyEvent::TLP_AFTER_SET_NODE_VALUE:
+      moveInGrid(pEvt->getNode(), layout->getNodeValue(pEvt->getNode()));
+      break;
+
+    case PropertyEvent::TLP_AFTER_SET_ALL_NODE_VALUE:
+      gridBuilt = false;
+      break;
+
+    default:
+      break;
+    }
+  }
+}
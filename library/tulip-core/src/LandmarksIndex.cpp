@@ -0,0 +1,452 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+#include <queue>
+#include <string>
+
+#include <tulip/LandmarksIndex.h>
+#include <tulip/BooleanProperty.h>
+#include <tulip/DoubleProperty.h>
+#include <tulip/Dijkstra.h>
+#include <tulip/GraphParallelTools.h>
+
+#define SMALLEST_WEIGHT 1.E-6
+
+using namespace std;
+
+// the distance of the unreachable nodes, as in Dijkstra
+static const double INFINITE_DISTANCE = DBL_MAX / 2. + 10.;
+// the stored distances may have been rounded when saved in a file,
+// so a lower bound is decreased by this part of the distances it is computed with
+static const double BOUND_MARGIN = 1.E-5;
+static const char *ATTRIBUTE_NAME = "landmarks index";
+
+static inline bool isInfinite(double dist) {
+  // the value may have been rounded when saved
+  return dist > DBL_MAX / 4.;
+}
+
+// the lower bound of a distance d such as d + dist2 >= dist1
+static inline double difference(double dist1, double dist2) {
+  if (isInfinite(dist1))
+    return isInfinite(dist2) ? 0 : INFINITE_DISTANCE;
+
+  if (isInfinite(dist2))
+    return 0;
+
+  return dist1 - dist2 - BOUND_MARGIN * (dist1 + dist2);
+}
+
+namespace tlp {
+// the indices are deleted when the topology of their graphs
+// or the values of their weights change
+class LandmarksIndexListener : public Observable {
+public:
+  ~LandmarksIndexListener() override {
+    for (auto index : indices)
+      delete index;
+  }
+
+  void treatEvent(const Event &evt) override {
+    const GraphEvent *gEvt = dynamic_cast<const GraphEvent *>(&evt);
+
+    if (gEvt) {
+      switch (gEvt->getType()) {
+      case GraphEvent::TLP_ADD_NODE:
+      case GraphEvent::TLP_DEL_NODE:
+      case GraphEvent::TLP_ADD_EDGE:
+      case GraphEvent::TLP_DEL_EDGE:
+      case GraphEvent::TLP_REVERSE_EDGE:
+      case GraphEvent::TLP_AFTER_SET_ENDS:
+      case GraphEvent::TLP_ADD_NODES:
+      case GraphEvent::TLP_ADD_EDGES:
+        invalidate(gEvt->getGraph());
+        break;
+
+      default:
+        // we don't care about other events
+        break;
+      }
+
+      return;
+    }
+
+    const PropertyEvent *pEvt = dynamic_cast<const PropertyEvent *>(&evt);
+
+    if (pEvt) {
+      switch (pEvt->getType()) {
+      case PropertyEvent::TLP_AFTER_SET_EDGE_VALUE:
+      case PropertyEvent::TLP_AFTER_SET_ALL_EDGE_VALUE:
+        invalidate(evt.sender());
+        break;
+
+      default:
+        break;
+      }
+    } else if (evt.type() == Event::TLP_DELETE)
+      invalidate(evt.sender());
+  }
+
+  // deletes the indices of a graph or computed with a weights property
+  void invalidate(const Observable *observable) {
+    vector<LandmarksIndex *> removed;
+    auto uses = [observable](const LandmarksIndex *index) {
+      return static_cast<const Observable *>(index->graph) == observable ||
+             (index->weights && static_cast<const Observable *>(index->weights) == observable);
+    };
+
+    for (auto index : indices) {
+      if (uses(index))
+        removed.push_back(index);
+    }
+
+    if (removed.empty())
+      return;
+
+    indices.erase(remove_if(indices.begin(), indices.end(), uses), indices.end());
+
+    // stop listening to the graphs and weights no longer used
+    for (auto index : removed) {
+      if (!isUsed(index->graph))
+        const_cast<Graph *>(index->graph)->removeListener(this);
+
+      if (index->weights && !isUsed(index->weights))
+        const_cast<DoubleProperty *>(index->weights)->removeListener(this);
+
+      delete index;
+    }
+  }
+
+  bool isUsed(const void *observable) const {
+    for (auto index : indices) {
+      if (index->graph == observable || index->weights == observable)
+        return true;
+    }
+
+    return false;
+  }
+
+  // an index is kept for each graph, weights and direction
+  vector<LandmarksIndex *> indices;
+  unsigned int nbBuilds = 0;
+};
+} // namespace tlp
+
+using namespace tlp;
+
+static LandmarksIndexListener instance;
+
+LandmarksIndex::LandmarksIndex(const Graph *graph, const DoubleProperty *weights, bool directed)
+    : graph(graph), weights(weights), directed(directed),
+      topologyVersion(graph->getTopologyVersion()), edgeWeights(graph), nbTreatedNodes(0) {
+  if (!weights) {
+    edgeWeights.setAll(SMALLEST_WEIGHT);
+  } else {
+    auto fn = [&](edge e, unsigned int i) {
+      double val(weights->getEdgeValue(e));
+
+      edgeWeights[i] = val ? val : SMALLEST_WEIGHT;
+    };
+    TLP_PARALLEL_MAP_EDGES_AND_INDICES(graph, fn);
+  }
+}
+
+void LandmarksIndex::build(unsigned int nbLandmarks) {
+  const vector<node> &nodes = graph->nodes();
+  unsigned int nbNodes = nodes.size();
+  nbLandmarks = std::min(nbLandmarks, nbNodes);
+  landmarks.clear();
+  fromLandmarks.resize(size_t(nbNodes) * nbLandmarks);
+
+  if (nbLandmarks == 0)
+    return;
+
+  // the landmarks are chosen one after the other as far as possible from the previous ones
+  // (the unreachable nodes first), the first one being the farthest from an arbitrary node
+  NodeStaticProperty<double> dist(graph);
+  Dijkstra::computeDistances(graph, nodes[0], edgeWeights, dist,
+                             directed ? DIRECTED : UNDIRECTED);
+  vector<double> minDist(dist.begin(), dist.end());
+
+  for (unsigned int i = 0; i < nbLandmarks; ++i) {
+    unsigned int landmark = std::max_element(minDist.begin(), minDist.end()) - minDist.begin();
+    landmarks.push_back(landmark);
+    Dijkstra::computeDistances(graph, nodes[landmark], edgeWeights, dist,
+                               directed ? DIRECTED : UNDIRECTED);
+    TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int pos) {
+      fromLandmarks[size_t(pos) * nbLandmarks + i] = dist[pos];
+      minDist[pos] = std::min(minDist[pos], dist[pos]);
+    });
+  }
+
+  if (!directed)
+    return;
+
+  // the distances to the landmarks, computed in parallel
+  toLandmarks.resize(fromLandmarks.size());
+  TLP_PARALLEL_MAP_INDICES(nbLandmarks, [&](unsigned int i) {
+    NodeStaticProperty<double> toDist(graph);
+    Dijkstra dijkstra(graph, nodes[landmarks[i]], edgeWeights, toDist, INV_DIRECTED);
+
+    for (unsigned int pos = 0; pos < nbNodes; ++pos)
+      toLandmarks[size_t(pos) * nbLandmarks + i] = toDist[pos];
+  });
+}
+
+const LandmarksIndex &LandmarksIndex::get(const Graph *graph, const DoubleProperty *weights,
+                                          bool directed, unsigned int nbLandmarks) {
+  for (auto index : instance.indices) {
+    if (index->graph != graph || index->weights != weights || index->directed != directed)
+      continue;
+
+    // the listener removes the index when the graph changes, but the version
+    // also accounts for sortElts() which is not notified
+    if (index->topologyVersion == graph->getTopologyVersion())
+      return *index;
+
+    instance.invalidate(graph);
+    break;
+  }
+
+  LandmarksIndex *index = new LandmarksIndex(graph, weights, directed);
+
+  if (!index->restore()) {
+    index->build(nbLandmarks);
+    ++instance.nbBuilds;
+  }
+
+  instance.indices.push_back(index);
+  const_cast<Graph *>(graph)->addListener(instance);
+
+  if (weights)
+    const_cast<DoubleProperty *>(weights)->addListener(instance);
+
+  return *index;
+}
+
+void LandmarksIndex::invalidate(const Graph *graph) {
+  instance.invalidate(graph);
+}
+
+unsigned int LandmarksIndex::getNumberOfBuilds() {
+  return instance.nbBuilds;
+}
+
+vector<node> LandmarksIndex::getLandmarks() const {
+  vector<node> result;
+
+  for (unsigned int pos : landmarks)
+    result.push_back(graph->nodes()[pos]);
+
+  return result;
+}
+
+double LandmarksIndex::lowerBound(unsigned int pos, unsigned int tgtPos) const {
+  size_t nbLandmarks = landmarks.size();
+  const double *from = fromLandmarks.data() + pos * nbLandmarks;
+  const double *tgtFrom = fromLandmarks.data() + tgtPos * nbLandmarks;
+  double bound = 0;
+
+  for (size_t i = 0; i < nbLandmarks; ++i) {
+    // d(L, tgt) <= d(L, n) + d(n, tgt)
+    double lBound = difference(tgtFrom[i], from[i]);
+
+    if (directed) {
+      // d(n, L) <= d(n, tgt) + d(tgt, L)
+      lBound = std::max(lBound, difference(toLandmarks[pos * nbLandmarks + i],
+                                           toLandmarks[tgtPos * nbLandmarks + i]));
+    } else
+      // d(L, n) <= d(L, tgt) + d(tgt, n)
+      lBound = std::max(lBound, difference(from[i], tgtFrom[i]));
+
+    // tgt cannot be reached from n
+    if (lBound == INFINITE_DISTANCE)
+      return INFINITE_DISTANCE;
+
+    bound = std::max(bound, lBound);
+  }
+
+  return bound;
+}
+
+namespace {
+struct AStarElement {
+  // the distance from the source plus the lower bound of the distance to the target
+  double estimate;
+  double dist;
+  unsigned int pos;
+
+  bool operator>(const AStarElement &elt) const {
+    return estimate > elt.estimate || (estimate == elt.estimate && pos > elt.pos);
+  }
+};
+} // namespace
+
+bool LandmarksIndex::searchPath(node src, node tgt, BooleanProperty *result) const {
+  assert(graph->isElement(src) && graph->isElement(tgt));
+  const vector<node> &nodes = graph->nodes();
+  EDGE_TYPE direction = directed ? DIRECTED : UNDIRECTED;
+  unsigned int srcPos = graph->nodePos(src), tgtPos = graph->nodePos(tgt);
+  NodeStaticProperty<double> dists(graph);
+  NodeStaticProperty<double> bounds(graph);
+  // the edge through which each node has been reached
+  NodeStaticProperty<edge> previous(graph);
+  priority_queue<AStarElement, vector<AStarElement>, greater<AStarElement>> queue;
+  bool found = false;
+
+  dists.setAll(INFINITE_DISTANCE);
+  dists[srcPos] = 0;
+  bounds[srcPos] = lowerBound(srcPos, tgtPos);
+  nbTreatedNodes = 0;
+
+  if (bounds[srcPos] != INFINITE_DISTANCE)
+    queue.push({bounds[srcPos], 0, srcPos});
+
+  while (!queue.empty()) {
+    AStarElement elt = queue.top();
+    queue.pop();
+
+    // the node has been reached again with a shorter distance
+    if (elt.dist > dists[elt.pos])
+      continue;
+
+    ++nbTreatedNodes;
+
+    if (elt.pos == tgtPos) {
+      found = true;
+      break;
+    }
+
+    node u = nodes[elt.pos];
+
+    for (auto e : graph->adjacentEdges(u, direction)) {
+      unsigned int vPos = graph->nodePos(graph->opposite(e, u));
+      double dist = elt.dist + edgeWeights.getEdgeValue(e);
+
+      if (dist >= dists[vPos])
+        continue;
+
+      if (dists[vPos] == INFINITE_DISTANCE)
+        bounds[vPos] = lowerBound(vPos, tgtPos);
+
+      dists[vPos] = dist;
+      previous[vPos] = e;
+
+      // as the stored distances may be rounded, the lower bounds may not be consistent,
+      // so a treated node is treated again when it is reached with a shorter distance
+      if (bounds[vPos] != INFINITE_DISTANCE)
+        queue.push({dist + bounds[vPos], dist, vPos});
+    }
+  }
+
+  if (!found) {
+    result->setAllNodeValue(false);
+    result->setAllEdgeValue(false);
+    return false;
+  }
+
+  // select the path from tgt back to src
+  unsigned int pos = tgtPos;
+  result->setNodeValue(tgt, true);
+
+  while (pos != srcPos) {
+    edge e = previous[pos];
+    result->setEdgeValue(e, true);
+    pos = graph->nodePos(graph->opposite(e, nodes[pos]));
+    result->setNodeValue(nodes[pos], true);
+  }
+
+  return true;
+}
+
+unsigned long long LandmarksIndex::checksum() const {
+  // FNV-1a hash of the topology and of the weights
+  unsigned long long hash = 14695981039346656037ULL;
+  auto combine = [&hash](unsigned long long value) {
+    hash = (hash ^ value) * 1099511628211ULL;
+  };
+
+  combine(graph->numberOfNodes());
+  combine(graph->numberOfEdges());
+
+  for (auto e : graph->edges()) {
+    const pair<node, node> &eEnds = graph->ends(e);
+    combine(graph->nodePos(eEnds.first));
+    combine(graph->nodePos(eEnds.second));
+
+    // the weights are saved with a limited precision in the tlp files,
+    // so their textual representation is hashed
+    if (weights) {
+      for (char c : DoubleType::toString(weights->getEdgeValue(e)))
+        combine(c);
+    }
+  }
+
+  return hash;
+}
+
+void LandmarksIndex::store() const {
+  DataSet data;
+  vector<int> positions(landmarks.begin(), landmarks.end());
+  data.set("weights", weights ? weights->getName() : string());
+  data.set("directed", directed);
+  data.set("checksum", to_string(checksum()));
+  data.set("landmarks", positions);
+  data.set("from landmarks", fromLandmarks);
+
+  if (directed)
+    data.set("to landmarks", toLandmarks);
+
+  const_cast<Graph *>(graph)->setAttribute(ATTRIBUTE_NAME, data);
+}
+
+bool LandmarksIndex::restore() {
+  DataSet data;
+
+  if (!graph->getAttribute(ATTRIBUTE_NAME, data))
+    return false;
+
+  string weightsName, sum;
+  bool isDirected = false;
+  vector<int> positions;
+  vector<double> from, to;
+
+  if (!data.get("weights", weightsName) ||
+      weightsName != (weights ? weights->getName() : string()) ||
+      !data.get("directed", isDirected) || isDirected != directed ||
+      !data.get("landmarks", positions) || !data.get("from landmarks", from) ||
+      (directed && !data.get("to landmarks", to)))
+    return false;
+
+  unsigned int nbNodes = graph->numberOfNodes();
+  size_t size = size_t(nbNodes) * positions.size();
+
+  if (from.size() != size || (directed && to.size() != size) ||
+      any_of(positions.begin(), positions.end(),
+             [nbNodes](int pos) { return pos < 0 || unsigned(pos) >= nbNodes; }) ||
+      !data.get("checksum", sum) || sum != to_string(checksum()))
+    return false;
+
+  landmarks.assign(positions.begin(), positions.end());
+  fromLandmarks.swap(from);
+  toLandmarks.swap(to);
+  return true;
+}
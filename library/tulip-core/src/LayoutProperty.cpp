@@ -16,6 +16,7 @@
  * See the GNU General Public License for more details.
  *
  */
+#include <algorithm>
 #include <cmath>
 #include <cfloat>
 #include <forward_list>
@@ -23,10 +24,75 @@
 
 #include <tulip/LayoutProperty.h>
 #include <tulip/Coord.h>
+#include <tulip/GraphParallelTools.h>
 
 using namespace std;
 using namespace tlp;
 
+//=================================================================================
+// The bulk geometric operations below work on a structure of arrays copy
+// of the coordinates: the x, y and z components are stored in contiguous
+// float arrays processed by blocks of LAYOUT_BLOCK_SIZE values.
+// The blocks are dispatched over the available threads, and the loops
+// of the kernels are written to be auto vectorized by the compiler.
+#define LAYOUT_BLOCK_SIZE 4096
+
+namespace {
+struct CoordArrays {
+  std::vector<float> x, y, z;
+
+  size_t size() const {
+    return x.size();
+  }
+
+  void resize(size_t n) {
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+  }
+
+  void set(size_t i, const Coord &c) {
+    x[i] = c[0];
+    y[i] = c[1];
+    z[i] = c[2];
+  }
+
+  Coord get(size_t i) const {
+    return Coord(x[i], y[i], z[i]);
+  }
+};
+
+// call blockFunction(blockIndex, begin, end) on each block of [0, n[
+template <typename BlockFunction>
+void mapBlocks(size_t n, const BlockFunction &blockFunction) {
+  size_t nbBlocks = (n + LAYOUT_BLOCK_SIZE - 1) / LAYOUT_BLOCK_SIZE;
+
+  auto blockIdxFunction = [&](size_t b) {
+    size_t begin = b * LAYOUT_BLOCK_SIZE;
+    blockFunction(b, begin, std::min(n, begin + LAYOUT_BLOCK_SIZE));
+  };
+
+  // avoid the threads overhead for small layouts
+  if (nbBlocks == 1)
+    blockIdxFunction(0);
+  else
+    TLP_PARALLEL_MAP_INDICES(nbBlocks, blockIdxFunction);
+}
+
+// get the nodes and the edges to transform
+void iteratorsToVectors(const LayoutProperty *layout, Iterator<node> *itN, Iterator<edge> *itE,
+                        std::vector<node> &nodes, std::vector<edge> &edges) {
+  if (itN != nullptr)
+    while (itN->hasNext())
+      nodes.push_back(itN->next());
+
+  // edges are only needed if there are some bends
+  if (itE != nullptr && layout->nbBendedEdges > 0)
+    while (itE->hasNext())
+      edges.push_back(itE->next());
+}
+} // namespace
+
 //=================================================================================
 namespace tlp {
 void maxV(tlp::Coord &res, const tlp::Coord &cmp) {
@@ -53,10 +119,25 @@ tlp::MinMaxProperty<tlp::PointType, tlp::LineType>::computeMinMaxNode(const Grap
   tlp::Coord maxT(-FLT_MAX, -FLT_MAX, -FLT_MAX);
   tlp::Coord minT(FLT_MAX, FLT_MAX, FLT_MAX);
 
-  for (auto itn : sg->nodes()) {
-    const Coord &tmpCoord = this->getNodeValue(itn);
-    maxV(maxT, tmpCoord);
-    minV(minT, tmpCoord);
+  // parallel reduction of the min/max values of each block of nodes
+  const std::vector<node> &nodes = sg->nodes();
+  size_t nbBlocks = (nodes.size() + LAYOUT_BLOCK_SIZE - 1) / LAYOUT_BLOCK_SIZE;
+  std::vector<Coord> blocksMin(nbBlocks, minT), blocksMax(nbBlocks, maxT);
+
+  mapBlocks(nodes.size(), [&](size_t b, size_t begin, size_t end) {
+    Coord &bMin = blocksMin[b];
+    Coord &bMax = blocksMax[b];
+
+    for (; begin < end; ++begin) {
+      const Coord &tmpCoord = this->getNodeValue(nodes[begin]);
+      maxV(bMax, tmpCoord);
+      minV(bMin, tmpCoord);
+    }
+  });
+
+  for (size_t b = 0; b < nbBlocks; ++b) {
+    maxV(maxT, blocksMax[b]);
+    minV(minT, blocksMin[b]);
   }
 
   if (static_cast<LayoutProperty *>(this)->nbBendedEdges > 0) {
@@ -234,74 +315,132 @@ Coord LayoutProperty::getMin(const Graph *sg) {
   return LayoutMinMaxProperty::getNodeMin(sg);
 }
 //=================================================================================
-#define X_ROT 0
-#define Y_ROT 1
-#define Z_ROT 2
-static void rotateVector(Coord &vec, double alpha, int rot) {
-  Coord backupVec(vec);
-  double aRot = 2.0 * M_PI * alpha / 360.0;
-  float cosA = float(cos(aRot));
-  float sinA = float(sin(aRot));
+void LayoutProperty::transform(
+    const std::function<void(float *, float *, float *, size_t)> &kernel,
+    const std::vector<node> &nodes, const std::vector<edge> &edges) {
+  // gather the coordinates
+  std::vector<edge> bendedEdges;
+  // offsets of the edges bends in coords
+  std::vector<size_t> bendsOffsets;
 
-  switch (rot) {
-  case Z_ROT:
-    vec[0] = backupVec[0] * cosA - backupVec[1] * sinA;
-    vec[1] = backupVec[0] * sinA + backupVec[1] * cosA;
-    break;
-
-  case Y_ROT:
-    vec[0] = backupVec[0] * cosA + backupVec[2] * sinA;
-    vec[2] = backupVec[2] * cosA - backupVec[0] * sinA;
-    break;
-
-  case X_ROT:
-    vec[1] = backupVec[1] * cosA - backupVec[2] * sinA;
-    vec[2] = backupVec[1] * sinA + backupVec[2] * cosA;
-    break;
+  if (nbBendedEdges > 0) {
+    size_t nbCoords = nodes.size();
+    bendsOffsets.push_back(nbCoords);
+
+    for (auto e : edges) {
+      size_t nbBends = getEdgeValue(e).size();
+
+      if (nbBends) {
+        bendedEdges.push_back(e);
+        bendsOffsets.push_back(nbCoords += nbBends);
+      }
+    }
   }
-}
-//=================================================================================
-void LayoutProperty::rotate(const double &alpha, int rot, Iterator<node> *itN,
-                            Iterator<edge> *itE) {
-  Observable::holdObservers();
 
-  while (itN->hasNext()) {
-    node itn = itN->next();
-    Coord tmpCoord(getNodeValue(itn));
-    rotateVector(tmpCoord, alpha, rot);
-    setNodeValue(itn, tmpCoord);
+  CoordArrays coords;
+  coords.resize(bendsOffsets.empty() ? nodes.size() : bendsOffsets.back());
+
+  mapBlocks(nodes.size(), [&](size_t, size_t begin, size_t end) {
+    for (; begin < end; ++begin)
+      coords.set(begin, getNodeValue(nodes[begin]));
+  });
+
+  for (size_t i = 0; i < bendedEdges.size(); ++i) {
+    size_t j = bendsOffsets[i];
+
+    for (const Coord &c : getEdgeValue(bendedEdges[i]))
+      coords.set(j++, c);
   }
 
-  while (itE->hasNext()) {
-    edge ite = itE->next();
+  // transform them
+  mapBlocks(coords.size(), [&](size_t, size_t begin, size_t end) {
+    kernel(coords.x.data() + begin, coords.y.data() + begin, coords.z.data() + begin,
+           end - begin);
+  });
 
-    if (!getEdgeValue(ite).empty()) {
-      LineType::RealType tmp = getEdgeValue(ite);
-      LineType::RealType::iterator itCoord;
-      itCoord = tmp.begin();
+  // invalidate the previously existing min/max computation
+  resetBoundingBox();
 
-      while (itCoord != tmp.end()) {
-        rotateVector(*itCoord, alpha, rot);
-        ++itCoord;
-      }
+  // and write them back, the set value events are only needed
+  // when there is someone to receive them
+  if (hasOnlookers()) {
+    for (size_t i = 0; i < nodes.size(); ++i)
+      LayoutMinMaxProperty::setNodeValue(nodes[i], coords.get(i));
+  } else {
+    for (size_t i = 0; i < nodes.size(); ++i)
+      nodeProperties.set(nodes[i].id, coords.get(i));
+  }
 
-      setEdgeValue(ite, tmp);
-    }
+  std::vector<Coord> bends;
+
+  for (size_t i = 0; i < bendedEdges.size(); ++i) {
+    bends.clear();
+
+    for (size_t j = bendsOffsets[i]; j < bendsOffsets[i + 1]; ++j)
+      bends.push_back(coords.get(j));
+
+    LayoutMinMaxProperty::setEdgeValue(bendedEdges[i], bends);
+  }
+}
+//=================================================================================
+#define X_ROT 0
+#define Y_ROT 1
+#define Z_ROT 2
+// rotate the (u, v) components of n coordinates
+static void rotateArrays(float *u, float *v, size_t n, float cosA, float sinA) {
+  for (size_t i = 0; i < n; ++i) {
+    float ui = u[i], vi = v[i];
+    u[i] = ui * cosA - vi * sinA;
+    v[i] = ui * sinA + vi * cosA;
   }
+}
+//=================================================================================
+void LayoutProperty::rotate(const double &alpha, int rot, const std::vector<node> &nodes,
+                            const std::vector<edge> &edges) {
+  double aRot = 2.0 * M_PI * alpha / 360.0;
+  float cosA = float(cos(aRot));
+  float sinA = float(sin(aRot));
 
+  Observable::holdObservers();
+  transform(
+      [&](float *x, float *y, float *z, size_t n) {
+        switch (rot) {
+        case Z_ROT:
+          rotateArrays(x, y, n, cosA, sinA);
+          break;
+
+        case Y_ROT:
+          rotateArrays(z, x, n, cosA, sinA);
+          break;
+
+        case X_ROT:
+          rotateArrays(y, z, n, cosA, sinA);
+          break;
+        }
+      },
+      nodes, edges);
   Observable::unholdObservers();
 }
 //=================================================================================
 void LayoutProperty::rotateX(const double &alpha, Iterator<node> *itN, Iterator<edge> *itE) {
-  rotate(alpha, X_ROT, itN, itE);
+  std::vector<node> nodes;
+  std::vector<edge> edges;
+  iteratorsToVectors(this, itN, itE, nodes, edges);
+  rotate(alpha, X_ROT, nodes, edges);
 }
 //=================================================================================
 void LayoutProperty::rotateY(const double &alpha, Iterator<node> *itN, Iterator<edge> *itE) {
-  rotate(alpha, Y_ROT, itN, itE);
+  std::vector<node> nodes;
+  std::vector<edge> edges;
+  iteratorsToVectors(this, itN, itE, nodes, edges);
+  rotate(alpha, Y_ROT, nodes, edges);
 }
 //=================================================================================
 void LayoutProperty::rotateZ(const double &alpha, Iterator<node> *itN, Iterator<edge> *itE) {
-  rotate(alpha, Z_ROT, itN, itE);
+  std::vector<node> nodes;
+  std::vector<edge> edges;
+  iteratorsToVectors(this, itN, itE, nodes, edges);
+  rotate(alpha, Z_ROT, nodes, edges);
 }
 //=================================================================================
 void LayoutProperty::rotateX(const double &alpha, const Graph *sg) {
@@ -313,11 +452,7 @@ void LayoutProperty::rotateX(const double &alpha, const Graph *sg) {
   if (sg->isEmpty())
     return;
 
-  Iterator<node> *itN = sg->getNodes();
-  Iterator<edge> *itE = sg->getEdges();
-  rotateX(alpha, itN, itE);
-  delete itN;
-  delete itE;
+  rotate(alpha, X_ROT, sg->nodes(), sg->edges());
 }
 //=================================================================================
 void LayoutProperty::rotateY(const double &alpha, const Graph *sg) {
@@ -329,11 +464,7 @@ void LayoutProperty::rotateY(const double &alpha, const Graph *sg) {
   if (sg->isEmpty())
     return;
 
-  Iterator<node> *itN = sg->getNodes();
-  Iterator<edge> *itE = sg->getEdges();
-  rotateY(alpha, itN, itE);
-  delete itN;
-  delete itE;
+  rotate(alpha, Y_ROT, sg->nodes(), sg->edges());
 }
 //=================================================================================
 void LayoutProperty::rotateZ(const double &alpha, const Graph *sg) {
@@ -345,40 +476,24 @@ void LayoutProperty::rotateZ(const double &alpha, const Graph *sg) {
   if (sg->isEmpty())
     return;
 
-  Iterator<node> *itN = sg->getNodes();
-  Iterator<edge> *itE = sg->getEdges();
-  rotateZ(alpha, itN, itE);
-  delete itN;
-  delete itE;
+  rotate(alpha, Z_ROT, sg->nodes(), sg->edges());
+}
+//=================================================================================
+static void scaleArrays(float *x, float *y, float *z, size_t n, const tlp::Vec3f &v) {
+  for (size_t i = 0; i < n; ++i) {
+    x[i] *= v[0];
+    y[i] *= v[1];
+    z[i] *= v[2];
+  }
 }
 //=================================================================================
 void LayoutProperty::scale(const tlp::Vec3f &v, Iterator<node> *itN, Iterator<edge> *itE) {
+  std::vector<node> nodes;
+  std::vector<edge> edges;
+  iteratorsToVectors(this, itN, itE, nodes, edges);
   Observable::holdObservers();
-
-  while (itN->hasNext()) {
-    node itn = itN->next();
-    Coord tmpCoord(getNodeValue(itn));
-    tmpCoord *= v;
-    setNodeValue(itn, tmpCoord);
-  }
-
-  while (itE->hasNext()) {
-    edge ite = itE->next();
-
-    if (!getEdgeValue(ite).empty()) {
-      LineType::RealType tmp = getEdgeValue(ite);
-      LineType::RealType::iterator itCoord;
-      itCoord = tmp.begin();
-
-      while (itCoord != tmp.end()) {
-        *itCoord *= v;
-        ++itCoord;
-      }
-
-      setEdgeValue(ite, tmp);
-    }
-  }
-
+  transform([&](float *x, float *y, float *z, size_t n) { scaleArrays(x, y, z, n, v); }, nodes,
+            edges);
   Observable::unholdObservers();
 }
 //=================================================================================
@@ -391,11 +506,18 @@ void LayoutProperty::scale(const tlp::Vec3f &v, const Graph *sg) {
   if (sg->isEmpty())
     return;
 
-  Iterator<node> *itN = sg->getNodes();
-  Iterator<edge> *itE = sg->getEdges();
-  scale(v, itN, itE);
-  delete itN;
-  delete itE;
+  Observable::holdObservers();
+  transform([&](float *x, float *y, float *z, size_t n) { scaleArrays(x, y, z, n, v); },
+            sg->nodes(), sg->edges());
+  Observable::unholdObservers();
+}
+//=================================================================================
+static void translateArrays(float *x, float *y, float *z, size_t n, const tlp::Vec3f &v) {
+  for (size_t i = 0; i < n; ++i) {
+    x[i] += v[0];
+    y[i] += v[1];
+    z[i] += v[2];
+  }
 }
 //=================================================================================
 void LayoutProperty::translate(const tlp::Vec3f &v, Iterator<node> *itN, Iterator<edge> *itE) {
@@ -405,39 +527,12 @@ void LayoutProperty::translate(const tlp::Vec3f &v, Iterator<node> *itN, Iterato
   if ((v == tlp::Vec3f(0.0f)) || (itE == nullptr && itN == nullptr))
     return;
 
+  std::vector<node> nodes;
+  std::vector<edge> edges;
+  iteratorsToVectors(this, itN, itE, nodes, edges);
   Observable::holdObservers();
-
-  // invalidate the previously existing min/max computation
-  resetBoundingBox();
-
-  if (itN != nullptr)
-    while (itN->hasNext()) {
-      node itn = itN->next();
-      Coord tmpCoord(getNodeValue(itn));
-      tmpCoord += v;
-      // minimize computation time
-      LayoutMinMaxProperty::setNodeValue(itn, tmpCoord);
-    }
-
-  if (itE != nullptr && (nbBendedEdges > 0))
-    while (itE->hasNext()) {
-      edge ite = itE->next();
-
-      if (!getEdgeValue(ite).empty()) {
-        LineType::RealType tmp = getEdgeValue(ite);
-        LineType::RealType::iterator itCoord;
-        itCoord = tmp.begin();
-
-        while (itCoord != tmp.end()) {
-          *itCoord += v;
-          ++itCoord;
-        }
-
-        // minimize computation time
-        LayoutMinMaxProperty::setEdgeValue(ite, tmp);
-      }
-    }
-
+  transform([&](float *x, float *y, float *z, size_t n) { translateArrays(x, y, z, n, v); },
+            nodes, edges);
   Observable::unholdObservers();
 }
 //=================================================================================
@@ -447,14 +542,14 @@ void LayoutProperty::translate(const tlp::Vec3f &v, const Graph *sg) {
 
   assert(sg == graph || graph->isDescendantGraph(sg));
 
-  if (sg->isEmpty())
+  // nothing to do if it is the null vector
+  if (sg->isEmpty() || (v == tlp::Vec3f(0.0f)))
     return;
 
-  Iterator<node> *itN = sg->getNodes();
-  Iterator<edge> *itE = sg->getEdges();
-  translate(v, itN, itE);
-  delete itN;
-  delete itE;
+  Observable::holdObservers();
+  transform([&](float *x, float *y, float *z, size_t n) { translateArrays(x, y, z, n, v); },
+            sg->nodes(), sg->edges());
+  Observable::unholdObservers();
 }
 //=================================================================================
 void LayoutProperty::center(const Graph *sg) {
@@ -502,11 +597,22 @@ void LayoutProperty::normalize(const Graph *sg) {
   Observable::holdObservers();
   center();
   double dtmpMax = 1.0;
+  // parallel reduction of the max norm of each block of nodes
+  const std::vector<node> &nodes = sg->nodes();
+  std::vector<double> blocksMax((nodes.size() + LAYOUT_BLOCK_SIZE - 1) / LAYOUT_BLOCK_SIZE,
+                                dtmpMax);
 
-  for (auto itn : sg->nodes()) {
-    const Coord &tmpCoord = getNodeValue(itn);
-    dtmpMax = std::max(dtmpMax, sqr(tmpCoord[0]) + sqr(tmpCoord[1]) + sqr(tmpCoord[2]));
-  }
+  mapBlocks(nodes.size(), [&](size_t b, size_t begin, size_t end) {
+    double &bMax = blocksMax[b];
+
+    for (; begin < end; ++begin) {
+      const Coord &tmpCoord = getNodeValue(nodes[begin]);
+      bMax = std::max(bMax, sqr(tmpCoord[0]) + sqr(tmpCoord[1]) + sqr(tmpCoord[2]));
+    }
+  });
+
+  for (double bMax : blocksMax)
+    dtmpMax = std::max(dtmpMax, bMax);
 
   dtmpMax = 1.0 / sqrt(dtmpMax);
   scale(Coord(float(dtmpMax), float(dtmpMax), float(dtmpMax)), sg);
@@ -600,11 +706,18 @@ double LayoutProperty::averageAngularResolution(const Graph *sg) const {
 
   assert(sg == graph || graph->isDescendantGraph(sg));
 
+  const std::vector<node> &nodes = sg->nodes();
+  std::vector<double> blocksSum((nodes.size() + LAYOUT_BLOCK_SIZE - 1) / LAYOUT_BLOCK_SIZE, 0);
+
+  mapBlocks(nodes.size(), [&](size_t b, size_t begin, size_t end) {
+    for (; begin < end; ++begin)
+      blocksSum[b] += averageAngularResolution(nodes[begin], sg);
+  });
+
   double result = 0;
 
-  for (auto n : sg->nodes()) {
-    result += averageAngularResolution(n, sg);
-  }
+  for (double bSum : blocksSum)
+    result += bSum;
 
   return result / double(sg->numberOfNodes());
 }
@@ -618,75 +731,89 @@ struct AngularOrder {
   }
 };
 
-/*
- * TODO check code duplication with angularresolution function
- */
-void LayoutProperty::computeEmbedding(Graph *sg) {
-  if (sg == nullptr)
-    sg = graph;
-
-  assert(sg == graph || graph->isDescendantGraph(sg));
-
-  for (auto n : sg->nodes()) {
-    computeEmbedding(n, sg);
-  }
-}
-
-void LayoutProperty::computeEmbedding(const node n, Graph *sg) {
-  if (sg == nullptr)
-    sg = graph;
-
-  assert(sg == graph || graph->isDescendantGraph(sg));
-
+namespace {
+// compute the order of the edges adjacent to n, sorted
+// by the angle of their first segment around n
+// returns false if there is no order to set
+bool computeEmbeddingOrder(const LayoutProperty *layout, const node n, const Graph *sg,
+                           vector<edge> &order) {
   if (sg->deg(n) < 2)
-    return;
+    return false;
 
   //===========
   typedef pair<Coord, edge> pCE;
 
-  forward_list<pCE> adjCoord;
-  unsigned int adjSize = 0;
+  vector<pCE> adjCoord;
+  adjCoord.reserve(sg->deg(n));
+  const Coord &center = layout->getNodeValue(n);
   // Extract all adjacent edges, the bends are taken
   // into account.
   for (auto e : sg->getInOutEdges(n)) {
-    if (getEdgeValue(e).empty())
-      adjCoord.emplace_front(getNodeValue(sg->opposite(e, n)), e);
-    else {
-      const auto &bends = getEdgeValue(e);
-      if (sg->source(e) == n)
-        adjCoord.emplace_front(bends.front(), e);
-      else
-        adjCoord.emplace_front(bends.back(), e);
-    }
-    ++adjSize;
-  }
+    const auto &bends = layout->getEdgeValue(e);
+    Coord c;
 
-  const Coord &center = getNodeValue(n);
-  forward_list<pCE>::iterator it, bit;
+    if (bends.empty())
+      c = layout->getNodeValue(sg->opposite(e, n));
+    else if (sg->source(e) == n)
+      c = bends.front();
+    else
+      c = bends.back();
 
-  for (bit = adjCoord.before_begin(), it = adjCoord.begin(); it != adjCoord.end(); ++it) {
-    it->first -= center;
-    float norm = it->first.norm();
+    c -= center;
 
-    if (norm < 1E-5) {
-      adjCoord.erase_after(bit);
-      it = bit;
+    if (c.norm() < 1E-5) {
       cerr << "[ERROR]:" << __PRETTY_FUNCTION__ << " :: norms are too small for node:" << n << endl;
-      --adjSize;
+      continue;
     }
-    bit = it;
+
+    adjCoord.emplace_back(c, e);
   }
 
-  adjCoord.sort(AngularOrder());
+  stable_sort(adjCoord.begin(), adjCoord.end(), AngularOrder());
+
+  order.reserve(adjCoord.size());
+
+  for (const auto &ce : adjCoord)
+    order.push_back(ce.second);
+
+  return true;
+}
+} // namespace
 
-  vector<edge> tmpOrder;
-  tmpOrder.reserve(adjSize);
+void LayoutProperty::computeEmbedding(Graph *sg) {
+  if (sg == nullptr)
+    sg = graph;
 
-  for (it = adjCoord.begin(); it != adjCoord.end(); ++it) {
-    tmpOrder.push_back(it->second);
+  assert(sg == graph || graph->isDescendantGraph(sg));
+
+  // the orders are computed in parallel,
+  // then set one after the other because
+  // the graph update is not thread safe
+  const std::vector<node> &nodes = sg->nodes();
+  std::vector<std::vector<edge>> orders(nodes.size());
+  std::vector<unsigned char> hasOrder(nodes.size(), 0);
+
+  mapBlocks(nodes.size(), [&](size_t, size_t begin, size_t end) {
+    for (; begin < end; ++begin)
+      hasOrder[begin] = computeEmbeddingOrder(this, nodes[begin], sg, orders[begin]);
+  });
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (hasOrder[i])
+      sg->setEdgeOrder(nodes[i], orders[i]);
   }
+}
+
+void LayoutProperty::computeEmbedding(const node n, Graph *sg) {
+  if (sg == nullptr)
+    sg = graph;
+
+  assert(sg == graph || graph->isDescendantGraph(sg));
+
+  vector<edge> order;
 
-  sg->setEdgeOrder(n, tmpOrder);
+  if (computeEmbeddingOrder(this, n, sg, order))
+    sg->setEdgeOrder(n, order);
 }
 //=================================================================================
 vector<double> LayoutProperty::angularResolutions(const node n, const Graph *sg) const {
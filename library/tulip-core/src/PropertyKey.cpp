@@ -0,0 +1,65 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include <tulip/PropertyKey.h>
+
+using namespace std;
+using namespace tlp;
+
+// the registered names, they are never removed
+// so their references remain valid
+static deque<string> &keyNames() {
+  static deque<string> names;
+  return names;
+}
+
+static unordered_map<string, unsigned int> &keyIds() {
+  static unordered_map<string, unsigned int> ids;
+  return ids;
+}
+
+static mutex &keysMutex() {
+  static mutex keysMutex;
+  return keysMutex;
+}
+
+PropertyKey::PropertyKey(const string &name) {
+  lock_guard<mutex> lock(keysMutex());
+  auto it = keyIds().find(name);
+
+  if (it == keyIds().end()) {
+    it = keyIds().emplace(name, keyNames().size()).first;
+    keyNames().push_back(name);
+  }
+
+  id = it->second;
+}
+
+const string &PropertyKey::getName() const {
+  lock_guard<mutex> lock(keysMutex());
+  return keyNames()[id];
+}
+
+unsigned int PropertyKey::getNumberOfKeys() {
+  lock_guard<mutex> lock(keysMutex());
+  return keyNames().size();
+}
@@ -17,49 +17,64 @@
  *
  */
 
+#include <algorithm>
+
 #include <tulip/GraphAbstract.h>
 #include <tulip/PropertyManager.h>
 #include <tulip/PropertyInterface.h>
+#include <tulip/PropertyKey.h>
 #include <tulip/GraphProperty.h>
 
 namespace tlp {
 //======================================================================================
+// the properties are iterated in the order of their names
+typedef std::vector<std::pair<std::string, PropertyInterface *>> SortedProperties;
+
+static SortedProperties
+sortProperties(const std::unordered_map<std::string, PropertyInterface *> &properties) {
+  SortedProperties sorted(properties.begin(), properties.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<std::string, PropertyInterface *> &p1,
+               const std::pair<std::string, PropertyInterface *> &p2) {
+              return p1.first < p2.first;
+            });
+  return sorted;
+}
+//======================================================================================
 class PropertiesIterator : public Iterator<PropertyInterface *> {
 public:
-  PropertiesIterator(std::map<std::string, PropertyInterface *>::iterator,
-                     std::map<std::string, PropertyInterface *>::iterator);
-  PropertyInterface *next() override;
-  bool hasNext() override;
-  std::map<std::string, PropertyInterface *>::iterator it, itEnd;
+  PropertiesIterator(const std::unordered_map<std::string, PropertyInterface *> &properties)
+      : properties(sortProperties(properties)), it(this->properties.begin()) {}
+  PropertyInterface *next() override {
+    PropertyInterface *tmp = it->second;
+    ++it;
+    return tmp;
+  }
+  bool hasNext() override {
+    return it != properties.end();
+  }
+
+private:
+  SortedProperties properties;
+  SortedProperties::const_iterator it;
 };
-//==============================================================
-PropertiesIterator::PropertiesIterator(std::map<std::string, PropertyInterface *>::iterator itB,
-                                       std::map<std::string, PropertyInterface *>::iterator itE)
-    : it(itB), itEnd(itE) {}
-PropertyInterface *PropertiesIterator::next() {
-  PropertyInterface *tmp = (*it).second;
-  ++it;
-  return tmp;
-}
-bool PropertiesIterator::hasNext() {
-  return (it != itEnd);
-}
 //======================================================================================
 class PropertyNamesIterator : public Iterator<std::string> {
 public:
-  PropertyNamesIterator(std::map<std::string, PropertyInterface *>::iterator itB,
-                        std::map<std::string, PropertyInterface *>::iterator itE)
-      : itProp(itB, itE) {}
+  PropertyNamesIterator(const std::unordered_map<std::string, PropertyInterface *> &properties)
+      : properties(sortProperties(properties)), it(this->properties.begin()) {}
   std::string next() override {
-    std::string tmp = (*(itProp.it)).first;
-    ++(itProp.it);
+    std::string tmp = it->first;
+    ++it;
     return tmp;
   }
-
   bool hasNext() override {
-    return itProp.hasNext();
+    return it != properties.end();
   }
-  PropertiesIterator itProp;
+
+private:
+  SortedProperties properties;
+  SortedProperties::const_iterator it;
 };
 } // namespace tlp
 
@@ -75,6 +90,7 @@ PropertyManager::PropertyManager(Graph *g) : graph(g) {
 
     for (PropertyInterface *prop : graph->getSuperGraph()->getObjectProperties()) {
       inheritedProperties[prop->getName()] = prop;
+      updateKeyProperty(prop->getName());
 
       if (prop->getName() == metaGraphPropertyName)
         static_cast<GraphAbstract *>(graph)->metaGraphProperty = static_cast<GraphProperty *>(prop);
@@ -83,15 +99,39 @@ PropertyManager::PropertyManager(Graph *g) : graph(g) {
 }
 //==============================================================
 PropertyManager::~PropertyManager() {
-  map<string, PropertyInterface *>::const_iterator itP;
-
-  for (itP = localProperties.begin(); itP != localProperties.end(); ++itP) {
-    PropertyInterface *prop = (*itP).second;
+  for (auto &it : localProperties) {
+    PropertyInterface *prop = it.second;
     prop->graph = nullptr;
     delete prop;
   }
 }
 //==============================================================
+void PropertyManager::updateKeyProperty(const string &str) {
+  unsigned int id = PropertyKey(str).getId();
+
+  if (id >= keyProperties.size())
+    keyProperties.resize(PropertyKey::getNumberOfKeys(), nullptr);
+
+  auto it = localProperties.find(str);
+
+  if (it == localProperties.end()) {
+    it = inheritedProperties.find(str);
+
+    if (it == inheritedProperties.end()) {
+      keyProperties[id] = nullptr;
+      return;
+    }
+  }
+
+  keyProperties[id] = it->second;
+}
+//==============================================================
+PropertyInterface *PropertyManager::findProperty(const PropertyKey &key) const {
+  // the keys registered after the last update of keyProperties
+  // are not names of properties of the graph
+  return key.getId() < keyProperties.size() ? keyProperties[key.getId()] : nullptr;
+}
+//==============================================================
 bool PropertyManager::existProperty(const string &str) const {
   return existLocalProperty(str) || existInheritedProperty(str);
 }
@@ -107,12 +147,14 @@ bool PropertyManager::existInheritedProperty(const string &str) const {
 void PropertyManager::setLocalProperty(const string &str, PropertyInterface *p) {
   bool hasInheritedProperty = false;
 
-  if (existLocalProperty(str))
+  auto itLocal = localProperties.find(str);
+
+  if (itLocal != localProperties.end())
     // delete previously existing local property
-    delete localProperties[str];
+    delete itLocal->second;
   else {
     // remove previously existing inherited property
-    map<string, PropertyInterface *>::iterator it;
+    std::unordered_map<string, PropertyInterface *>::iterator it;
     hasInheritedProperty = ((it = inheritedProperties.find(str)) != inheritedProperties.end());
 
     if (hasInheritedProperty) {
@@ -125,6 +167,7 @@ void PropertyManager::setLocalProperty(const string &str, PropertyInterface *p)
 
   // register property as local
   localProperties[str] = p;
+  updateKeyProperty(str);
 
   // If we had an inherited property notify it's destruction.
   if (hasInheritedProperty) {
@@ -145,8 +188,7 @@ bool PropertyManager::renameLocalProperty(PropertyInterface *prop, const string
     return false;
 
   std::string propName = prop->getName();
-  map<string, PropertyInterface *>::iterator it;
-  it = localProperties.find(propName);
+  auto it = localProperties.find(propName);
 
   if (it == localProperties.end())
     return false;
@@ -193,6 +235,7 @@ bool PropertyManager::renameLocalProperty(PropertyInterface *prop, const string
 
   // register property as local
   localProperties[newName] = prop;
+  updateKeyProperty(newName);
 
   // If we had an inherited property notify it's destruction.
   if (hasInheritedProperty) {
@@ -231,6 +274,8 @@ void PropertyManager::setInheritedProperty(const string &str, PropertyInterface
       inheritedProperties.erase(str);
     }
 
+    updateKeyProperty(str);
+
     if (hasInheritedProperty) {
       static_cast<GraphAbstract *>(graph)->notifyAfterDelInheritedProperty(str);
     }
@@ -250,29 +295,29 @@ void PropertyManager::setInheritedProperty(const string &str, PropertyInterface
 //==============================================================
 PropertyInterface *PropertyManager::getProperty(const string &str) const {
   assert(existProperty(str));
+  auto it = localProperties.find(str);
 
-  if (existLocalProperty(str))
-    return getLocalProperty(str);
-
-  if (existInheritedProperty(str))
-    return getInheritedProperty(str);
+  if (it != localProperties.end())
+    return it->second;
 
-  return nullptr;
+  it = inheritedProperties.find(str);
+  return it == inheritedProperties.end() ? nullptr : it->second;
 }
 //==============================================================
 PropertyInterface *PropertyManager::getLocalProperty(const string &str) const {
   assert(existLocalProperty(str));
-  return const_cast<PropertyManager *>(this)->localProperties[str];
+  auto it = localProperties.find(str);
+  return it == localProperties.end() ? nullptr : it->second;
 }
 //==============================================================
 PropertyInterface *PropertyManager::getInheritedProperty(const string &str) const {
   assert(existInheritedProperty(str));
-  return const_cast<PropertyManager *>(this)->inheritedProperties[str];
+  auto it = inheritedProperties.find(str);
+  return it == inheritedProperties.end() ? nullptr : it->second;
 }
 //==============================================================
 void PropertyManager::delLocalProperty(const string &str) {
-  map<string, PropertyInterface *>::iterator it;
-  it = localProperties.find(str);
+  auto it = localProperties.find(str);
 
   // if found remove from local properties
   if (it != localProperties.end()) {
@@ -313,8 +358,7 @@ void PropertyManager::delLocalProperty(const string &str) {
 }
 //==============================================================
 void PropertyManager::notifyBeforeDelInheritedProperty(const string &str) {
-  map<string, PropertyInterface *>::iterator it;
-  it = inheritedProperties.find(str);
+  auto it = inheritedProperties.find(str);
 
   // if found remove from inherited properties
   if (it != inheritedProperties.end()) {
@@ -329,30 +373,24 @@ void PropertyManager::notifyBeforeDelInheritedProperty(const string &str) {
 }
 
 Iterator<string> *PropertyManager::getLocalProperties() {
-  return new PropertyNamesIterator(localProperties.begin(), localProperties.end());
+  return new PropertyNamesIterator(localProperties);
 }
 Iterator<string> *PropertyManager::getInheritedProperties() {
-  return new PropertyNamesIterator(inheritedProperties.begin(), inheritedProperties.end());
+  return new PropertyNamesIterator(inheritedProperties);
 }
 Iterator<PropertyInterface *> *PropertyManager::getLocalObjectProperties() {
-  return new PropertiesIterator(localProperties.begin(), localProperties.end());
+  return new PropertiesIterator(localProperties);
 }
 Iterator<PropertyInterface *> *PropertyManager::getInheritedObjectProperties() {
-  return new PropertiesIterator(inheritedProperties.begin(), inheritedProperties.end());
+  return new PropertiesIterator(inheritedProperties);
 }
 //===============================================================
 void PropertyManager::erase(const node n) {
-  map<string, PropertyInterface *>::iterator itP;
-
-  for (itP = localProperties.begin(); itP != localProperties.end(); ++itP) {
-    itP->second->erase(n);
-  }
+  for (auto &it : localProperties)
+    it.second->erase(n);
 }
 //===============================================================
 void PropertyManager::erase(const edge e) {
-  map<string, PropertyInterface *>::iterator itP;
-
-  for (itP = localProperties.begin(); itP != localProperties.end(); ++itP) {
-    itP->second->erase(e);
-  }
+  for (auto &it : localProperties)
+    it.second->erase(e);
 }
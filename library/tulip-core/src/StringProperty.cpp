@@ -59,6 +59,8 @@ static ViewLabelCalculator vLabelCalc;
 
 //=================================================================================
 StringProperty::StringProperty(Graph *g, const std::string &n) : AbstractStringProperty(g, n) {
+  setInterningMode(AUTO_INTERNED);
+
   if (n == "viewLabel") {
     setMetaValueCalculator(&vLabelCalc);
   }
@@ -16,8 +16,10 @@
  * See the GNU General Public License for more details.
  *
  */
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <cerrno>
 
@@ -35,6 +37,7 @@
 #include <tulip/StringProperty.h>
 #include <tulip/TlpTools.h>
 #include <tulip/TLPParser.h>
+#include <tulip/ParallelTools.h>
 
 #define TLP "tlp"
 #define AUTHOR "author"
@@ -514,12 +517,11 @@ struct TLPNodesBuilder : public TLPFalse {
 struct TLPEdgeBuilder : public TLPFalse {
   TLPGraphBuilder *graphBuilder;
   int nbParameter;
-  std::vector<int> parameters;
+  int parameters[3];
   TLPEdgeBuilder(TLPGraphBuilder *graphBuilder) : graphBuilder(graphBuilder), nbParameter(0) {}
   bool addInt(const int id) override {
     if (nbParameter < 3) {
-      parameters.push_back(id);
-      nbParameter++;
+      parameters[nbParameter++] = id;
       return true;
     }
     parser->errorMsg = "wrong edge format, must be (edge id src target)";
@@ -734,6 +736,244 @@ bool TLPClusterBuilder::addStruct(const std::string &structName, TLPBuilder *&ne
   return true;
 }
 //=================================================================================
+// Conversions of the most common property values, only accepting the format
+// written by the TLP export; the other values are converted by the property itself
+static bool isNumber(const char *str, const char *end) {
+  if (str == end)
+    return false;
+
+  // inf and nan are left to the property
+  for (; str != end; ++str) {
+    char c = *str;
+
+    if (!((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E'))
+      return false;
+  }
+
+  return true;
+}
+
+static bool parseTLPValue(const char *str, const char *end, double &value) {
+  if (!isNumber(str, end))
+    return false;
+
+  int savedErrno = errno;
+  errno = 0;
+  char *endPtr = nullptr;
+  value = strtod(str, &endPtr);
+  bool ok = (endPtr == end) && (errno != ERANGE);
+  errno = savedErrno;
+  return ok;
+}
+
+static bool parseTLPValue(const char *str, const char *end, float &value) {
+  if (!isNumber(str, end))
+    return false;
+
+  int savedErrno = errno;
+  errno = 0;
+  char *endPtr = nullptr;
+  value = strtof(str, &endPtr);
+  bool ok = (endPtr == end) && (errno != ERANGE);
+  errno = savedErrno;
+  return ok;
+}
+
+static bool parseTLPValue(const char *str, const char *end, int &value) {
+  bool negative = (*str == '-');
+
+  if (negative)
+    ++str;
+
+  if (str == end || end - str > 10)
+    return false;
+
+  long long result = 0;
+
+  for (; str != end; ++str) {
+    if (*str < '0' || *str > '9')
+      return false;
+
+    result = result * 10 + (*str - '0');
+  }
+
+  if (negative)
+    result = -result;
+
+  if (result < INT_MIN || result > INT_MAX)
+    return false;
+
+  value = int(result);
+  return true;
+}
+
+static bool parseTLPValue(const char *str, const char *end, bool &value) {
+  size_t length = end - str;
+
+  if (length == 4 && memcmp(str, "true", 4) == 0)
+    value = true;
+  else if (length == 5 && memcmp(str, "false", 5) == 0)
+    value = false;
+  else
+    return false;
+
+  return true;
+}
+
+// (x,y,z)
+static bool parseTLPValue(const char *str, const char *end, Vec3f &value) {
+  if (str == end || *str != '(')
+    return false;
+
+  ++str;
+
+  for (unsigned int i = 0; i < 3; ++i) {
+    const char *numberEnd = str;
+
+    while (numberEnd != end && *numberEnd != ',' && *numberEnd != ')')
+      ++numberEnd;
+
+    if (numberEnd == end || *numberEnd != (i < 2 ? ',' : ')') ||
+        !parseTLPValue(str, numberEnd, value[i]))
+      return false;
+
+    str = numberEnd + 1;
+  }
+
+  return str == end;
+}
+
+// (r,g,b,a)
+static bool parseTLPValue(const char *str, const char *end, Color &value) {
+  if (str == end || *str != '(')
+    return false;
+
+  ++str;
+
+  for (unsigned int i = 0; i < 4; ++i) {
+    const char *digits = str;
+    unsigned int component = 0;
+
+    while (str != end && *str >= '0' && *str <= '9' && str - digits < 3)
+      component = component * 10 + (*str++ - '0');
+
+    if (str == digits || component > 255 || str == end || *str != (i < 3 ? ',' : ')'))
+      return false;
+
+    value[i] = component;
+    ++str;
+  }
+
+  return str == end;
+}
+
+static bool parseTLPValue(const char *str, const char *end, std::string &value) {
+  value.assign(str, end);
+  return true;
+}
+//=================================================================================
+// The node or edge values of a property, stored as they are read
+// to be converted in parallel, then set at once
+struct TLPValuesBatch {
+  std::vector<unsigned int> ids;
+  // the values, each one being followed by a null char
+  std::string chars;
+  std::vector<size_t> ends;
+  // the lines of the values, to report an invalid one
+  std::vector<int> lines;
+
+  // the number of values converted at once
+  static const size_t MAX_SIZE = 1 << 16;
+
+  virtual ~TLPValuesBatch() {}
+
+  // returns false if the batch is full
+  bool add(unsigned int id, const std::string &value, int line) {
+    ids.push_back(id);
+    lines.push_back(line);
+    chars.append(value);
+    ends.push_back(chars.size());
+    chars.push_back('\0');
+    return ids.size() < MAX_SIZE;
+  }
+
+  const char *valueBegin(size_t i) const {
+    return chars.data() + (i ? ends[i - 1] + 1 : 0);
+  }
+
+  const char *valueEnd(size_t i) const {
+    return chars.data() + ends[i];
+  }
+
+  void clear() {
+    ids.clear();
+    chars.clear();
+    ends.clear();
+    lines.clear();
+  }
+
+  // sets the values of the nodes (or edges) of prop and clears the batch
+  virtual bool setValues(PropertyInterface *prop, TLPParser *parser) = 0;
+};
+
+template <typename PROPTYPE, typename VALUE>
+static void setTLPValue(PROPTYPE *property, node n, const VALUE &value) {
+  property->setNodeValue(n, value);
+}
+
+template <typename PROPTYPE, typename VALUE>
+static void setTLPValue(PROPTYPE *property, edge e, const VALUE &value) {
+  property->setEdgeValue(e, value);
+}
+
+static bool setTLPStringValue(PropertyInterface *property, node n, const std::string &value) {
+  return property->setNodeStringValue(n, value);
+}
+
+static bool setTLPStringValue(PropertyInterface *property, edge e, const std::string &value) {
+  return property->setEdgeStringValue(e, value);
+}
+
+// ELT is node or edge
+template <typename PROPTYPE, typename ELT, typename VALUE>
+struct TLPTypedValuesBatch : public TLPValuesBatch {
+  struct ParsedValue {
+    VALUE value;
+    bool ok;
+  };
+
+  bool setValues(PropertyInterface *prop, TLPParser *parser) override {
+    PROPTYPE *property = static_cast<PROPTYPE *>(prop);
+    size_t nbValues = ids.size();
+    std::vector<ParsedValue> values(nbValues);
+
+    TLP_PARALLEL_MAP_INDICES(nbValues, [&](unsigned int i) {
+      values[i].ok = parseTLPValue(valueBegin(i), valueEnd(i), values[i].value);
+    });
+
+    for (size_t i = 0; i < nbValues; ++i) {
+      ELT elt(ids[i]);
+      assert(prop->getGraph()->isElement(elt));
+
+      if (values[i].ok)
+        setTLPValue(property, elt, values[i].value);
+      else if (!setTLPStringValue(prop, elt, std::string(valueBegin(i), valueEnd(i)))) {
+        std::stringstream ess;
+        ess << "invalid value '" << valueBegin(i) << "' for "
+            << (std::is_same<ELT, node>::value ? "node " : "edge ") << ids[i] << " of property "
+            << prop->getName();
+        parser->errorMsg = ess.str();
+        parser->errorLine = lines[i];
+        clear();
+        return false;
+      }
+    }
+
+    clear();
+    return true;
+  }
+};
+//=================================================================================
 struct TLPPropertyBuilder : public TLPFalse {
   TLPGraphBuilder *graphBuilder;
   int clusterId;
@@ -741,19 +981,70 @@ struct TLPPropertyBuilder : public TLPFalse {
   PropertyInterface *property;
   bool isGraphProperty;
   bool isPathViewProperty;
-
-  ~TLPPropertyBuilder() override {}
+  // the (node|edge|default) struct being read, its values are added
+  // to the property builder itself to avoid a builder allocation per value
+  enum ValueStruct { NO_VALUE, NODE_VALUE, EDGE_VALUE, DEFAULT_VALUE };
+  ValueStruct valueStruct;
+  int eltId;
+  int nbDefaultValues;
+  // the values of the most common property types, converted by batches
+  TLPValuesBatch *nodeValues, *edgeValues;
+
+  ~TLPPropertyBuilder() override {
+    delete nodeValues;
+    delete edgeValues;
+  }
   TLPPropertyBuilder(TLPGraphBuilder *graphBuilder)
       : graphBuilder(graphBuilder), clusterId(INT_MAX), propertyType(std::string()),
         propertyName(std::string()), property(nullptr), isGraphProperty(false),
-        isPathViewProperty(false) {}
+        isPathViewProperty(false), valueStruct(NO_VALUE), eltId(INT_MAX), nbDefaultValues(0),
+        nodeValues(nullptr), edgeValues(nullptr) {}
+  template <typename PROPTYPE, typename VALUE>
+  bool createNodeValuesBatch() {
+    if (dynamic_cast<PROPTYPE *>(property) == nullptr)
+      return false;
+
+    nodeValues = new TLPTypedValuesBatch<PROPTYPE, node, VALUE>();
+    return true;
+  }
+  template <typename PROPTYPE, typename VALUE>
+  bool createValuesBatches() {
+    if (!createNodeValuesBatch<PROPTYPE, VALUE>())
+      return false;
+
+    edgeValues = new TLPTypedValuesBatch<PROPTYPE, edge, VALUE>();
+    return true;
+  }
   bool getProperty() {
     assert(property == nullptr);
     property = graphBuilder->createProperty(clusterId, propertyType, propertyName, isGraphProperty,
                                             isPathViewProperty);
+
+    // the values needing a specific conversion (see TLPGraphBuilder::setNodeValue)
+    // are not converted by batches
+    if (property != nullptr && !isGraphProperty && !isPathViewProperty &&
+        graphBuilder->version >= 2.2) {
+      createValuesBatches<DoubleProperty, double>() ||
+          // the edge values of a layout property are vectors of coords
+          createNodeValuesBatch<LayoutProperty, Coord>() ||
+          createValuesBatches<SizeProperty, Size>() ||
+          createValuesBatches<ColorProperty, Color>() ||
+          createValuesBatches<IntegerProperty, int>() ||
+          createValuesBatches<BooleanProperty, bool>() ||
+          createValuesBatches<StringProperty, std::string>();
+    }
+
     return property != nullptr;
   }
   bool addInt(const int id) override {
+    if (valueStruct == NODE_VALUE || valueStruct == EDGE_VALUE) {
+      eltId = id;
+      return true;
+    }
+
+    if (valueStruct == DEFAULT_VALUE)
+      return false;
+
     assert(id != INT_MAX);
     clusterId = id;
 
@@ -763,6 +1054,31 @@ struct TLPPropertyBuilder : public TLPFalse {
     return true;
   }
   bool addString(const std::string &str) override {
+    switch (valueStruct) {
+    case NODE_VALUE:
+      return setNodeValue(eltId, str);
+
+    case EDGE_VALUE:
+      return setEdgeValue(eltId, str);
+
+    case DEFAULT_VALUE:
+      if (nbDefaultValues == 0) {
+        ++nbDefaultValues;
+        return setAllNodeValue(str);
+      }
+
+      if (nbDefaultValues == 1) {
+        ++nbDefaultValues;
+        return setAllEdgeValue(str);
+      }
+
+      parser->errorMsg = "invalid property default value format";
+      return false;
+
+    default:
+      break;
+    }
+
     if (propertyType.empty()) {
       propertyType = str;
     } else if (propertyName.empty()) {
@@ -777,108 +1093,75 @@ struct TLPPropertyBuilder : public TLPFalse {
 
     return true;
   }
+  bool setNodeValues() {
+    return nodeValues == nullptr || nodeValues->setValues(property, parser);
+  }
+  bool setEdgeValues() {
+    return edgeValues == nullptr || edgeValues->setValues(property, parser);
+  }
   bool setNodeValue(int nodeId, const std::string &value) {
-    return property ? graphBuilder->setNodeValue(nodeId, property, const_cast<std::string &>(value),
-                                                 isGraphProperty, isPathViewProperty)
-                    : false;
+    if (property == nullptr)
+      return false;
+
+    if (nodeValues)
+      return nodeValues->add(nodeId, value, parser->tokenParser->curLine) || setNodeValues();
+
+    return graphBuilder->setNodeValue(nodeId, property, const_cast<std::string &>(value),
+                                      isGraphProperty, isPathViewProperty);
   }
   bool setEdgeValue(int edgeId, const std::string &value) {
-    return property ? graphBuilder->setEdgeValue(edgeId, property, const_cast<std::string &>(value),
-                                                 isGraphProperty, isPathViewProperty)
-                    : false;
+    if (property == nullptr)
+      return false;
+
+    if (edgeValues)
+      return edgeValues->add(edgeId, value, parser->tokenParser->curLine) || setEdgeValues();
+
+    return graphBuilder->setEdgeValue(edgeId, property, const_cast<std::string &>(value),
+                                      isGraphProperty, isPathViewProperty);
   }
   bool setAllNodeValue(const std::string &value) {
-    return property ? graphBuilder->setAllNodeValue(property, const_cast<std::string &>(value),
-                                                    isGraphProperty, isPathViewProperty)
+    return property ? setNodeValues() &&
+                          graphBuilder->setAllNodeValue(property, const_cast<std::string &>(value),
+                                                        isGraphProperty, isPathViewProperty)
                     : false;
   }
   bool setAllEdgeValue(const std::string &value) {
-    return property ? graphBuilder->setAllEdgeValue(property, const_cast<std::string &>(value),
-                                                    isGraphProperty, isPathViewProperty)
+    return property ? setEdgeValues() &&
+                          graphBuilder->setAllEdgeValue(property, const_cast<std::string &>(value),
+                                                        isGraphProperty, isPathViewProperty)
                     : false;
   }
   bool addStruct(const std::string &structName, TLPBuilder *&newBuilder) override;
   bool close() override {
-    return property != nullptr;
-  }
-};
-//=================================================================================
-struct TLPNodePropertyBuilder : public TLPFalse {
-  TLPPropertyBuilder *propertyBuilder;
-  int nodeId;
-  TLPNodePropertyBuilder(TLPPropertyBuilder *propertyBuilder)
-      : propertyBuilder(propertyBuilder), nodeId(INT_MAX) {}
-  bool addInt(const int id) override {
-    nodeId = id;
-    return true;
-  }
-  bool addString(const std::string &val) override {
-    return propertyBuilder->setNodeValue(nodeId, val);
-  }
-  bool close() override {
-    return true;
-  }
-};
-//=================================================================================
-struct TLPEdgePropertyBuilder : public TLPFalse {
-  TLPPropertyBuilder *propertyBuilder;
-  int edgeId;
-  std::string nodeValue;
-  TLPEdgePropertyBuilder(TLPPropertyBuilder *propertyBuilder)
-      : propertyBuilder(propertyBuilder), edgeId(INT_MAX) {}
-  ~TLPEdgePropertyBuilder() override {}
-  bool addInt(const int id) override {
-    edgeId = id;
-    return true;
-  }
-  bool addString(const std::string &val) override {
-    return propertyBuilder->setEdgeValue(edgeId, val);
-  }
-  bool close() override {
-    return true;
-  }
-};
-struct TLPDefaultPropertyBuilder : public TLPFalse {
-  TLPPropertyBuilder *propertyBuilder;
-  int edgeId;
-  std::string nodeValue;
-  int i;
-  TLPDefaultPropertyBuilder(TLPPropertyBuilder *propertyBuilder)
-      : propertyBuilder(propertyBuilder), edgeId(INT_MAX), i(0) {}
-  ~TLPDefaultPropertyBuilder() override {}
-  bool addString(const std::string &val) override {
-    if (i == 0) {
-      i++;
-      return propertyBuilder->setAllNodeValue(val);
+    if (valueStruct != NO_VALUE) {
+      valueStruct = NO_VALUE;
+      return true;
     }
 
-    if (i == 1) {
-      i++;
-      return propertyBuilder->setAllEdgeValue(val);
-    }
-    parser->errorMsg = "invalid property default value format";
-    return false;
-  }
-  bool close() override {
-    return true;
+    return property != nullptr && setNodeValues() && setEdgeValues();
   }
 };
 
 } // namespace tlp
 //=================================================================================
 bool TLPPropertyBuilder::addStruct(const std::string &structName, TLPBuilder *&newBuilder) {
+  if (valueStruct != NO_VALUE)
+    return false;
+
   if (structName == DEFAULTVALUE) {
-    newBuilder = new TLPDefaultPropertyBuilder(this);
-    return true;
+    valueStruct = DEFAULT_VALUE;
+    nbDefaultValues = 0;
   } else if (structName == NODEVALUE) {
-    newBuilder = new TLPNodePropertyBuilder(this);
-    return true;
+    valueStruct = NODE_VALUE;
+    eltId = INT_MAX;
   } else if (structName == EDGEVALUE) {
-    newBuilder = new TLPEdgePropertyBuilder(this);
-    return true;
-  }
+    valueStruct = EDGE_VALUE;
+    eltId = INT_MAX;
+  } else
+    return false;
 
-  return false;
+  newBuilder = this;
+  return true;
 }
 //=================================================================================
 bool TLPGraphBuilder::addStruct(const std::string &structName, TLPBuilder *&newBuilder) {
@@ -346,11 +346,13 @@ std::ostream *tlp::getOgzstream(const std::string &name, int open_mode) {
 //=========================================================
 
 static unsigned int randomSeed = UINT_MAX;
+// the generators below are specific to each thread,
+// so that concurrent algorithms have their own random sequences
 // uniformly-distributed integer random number generator that produces non-deterministic random
 // numbers
-static std::random_device rd;
+static thread_local std::random_device rd;
 // Mersenne Twister pseudo-random generator of 32-bit numbers
-static std::mt19937 mt;
+static thread_local std::mt19937 mt;
 
 void tlp::setSeedOfRandomSequence(unsigned int seed) {
   randomSeed = seed;
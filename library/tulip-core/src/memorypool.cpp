@@ -0,0 +1,71 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <algorithm>
+
+#include <tulip/memorypool.h>
+#include <tulip/TlpTools.h>
+
+using namespace std;
+using namespace tlp;
+
+static vector<MemoryPools::Pool *> &pools() {
+  static vector<MemoryPools::Pool *> pools;
+  return pools;
+}
+
+static mutex &poolsMutex() {
+  static mutex poolsMutex;
+  return poolsMutex;
+}
+
+void MemoryPools::registerPool(Pool *pool) {
+  lock_guard<mutex> lock(poolsMutex());
+  pools().push_back(pool);
+}
+
+void MemoryPools::unregisterPool(Pool *pool) {
+  lock_guard<mutex> lock(poolsMutex());
+  auto it = find(pools().begin(), pools().end(), pool);
+
+  if (it != pools().end())
+    pools().erase(it);
+}
+
+vector<MemoryPoolStatistics> MemoryPools::getStatistics() {
+  vector<MemoryPoolStatistics> statistics;
+  lock_guard<mutex> lock(poolsMutex());
+
+  for (Pool *pool : pools()) {
+    statistics.push_back(pool->getStatistics());
+    MemoryPoolStatistics &poolStatistics = statistics.back();
+    poolStatistics.typeName = demangleClassName(poolStatistics.typeName.c_str());
+  }
+
+  return statistics;
+}
+
+size_t MemoryPools::trim() {
+  size_t nbBytes = 0;
+  lock_guard<mutex> lock(poolsMutex());
+
+  for (Pool *pool : pools())
+    nbBytes += pool->trim();
+
+  return nbBytes;
+}
@@ -36,6 +36,7 @@
 #include <tulip/Graph.h>
 #include <tulip/GlTools.h>
 #include <tulip/GlTextureManager.h>
+#include <tulip/GlFrameProfiler.h>
 #include <tulip/Gl2DRect.h>
 #include <tulip/GlQuadTreeLODCalculator.h>
 #include <tulip/GLInteractor.h>
@@ -76,6 +77,12 @@ GlMainWidget::GlMainWidget(QWidget *parent, View *view)
 }
 //==================================================
 GlMainWidget::~GlMainWidget() {
+  // the timer queries of the widget OpenGL context, if it has been created
+  if (context()) {
+    QOpenGLWidget::makeCurrent();
+    GlFrameProfiler::releaseGpuQueries();
+  }
+
   delete glFrameBuf;
   delete glFrameBuf2;
 }
@@ -390,9 +397,13 @@ QImage GlMainWidget::createPicture(int width, int height, bool center, QImage::F
     if (center)
       scene.adjustSceneToSize(width, height);
 
+    // the picture must not contain placeholder textures
+    bool asynchronousTextures = GlTextureManager::isAsynchronousLoading();
+    GlTextureManager::setAsynchronousLoading(false);
     computeInteractors();
     scene.draw();
     drawInteractors();
+    GlTextureManager::setAsynchronousLoading(asynchronousTextures);
     frameBuf->release();
 
     QOpenGLFramebufferObject::blitFramebuffer(frameBuf2, QRect(0, 0, width, height), frameBuf,
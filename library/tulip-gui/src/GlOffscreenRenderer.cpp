@@ -39,6 +39,8 @@
 #include <tulip/GlGraphComposite.h>
 #include <tulip/OpenGlConfigManager.h>
 #include <tulip/GlTools.h>
+#include <tulip/GlTextureManager.h>
+#include <tulip/GlFrameProfiler.h>
 
 #include <sstream>
 
@@ -65,6 +67,11 @@ GlOffscreenRenderer::GlOffscreenRenderer()
 }
 
 GlOffscreenRenderer::~GlOffscreenRenderer() {
+  if (glContext) {
+    makeOpenGLContextCurrent();
+    GlFrameProfiler::releaseGpuQueries();
+  }
+
   delete glFrameBuf;
   delete glFrameBuf2;
   delete offscreenSurface;
@@ -181,7 +188,11 @@ void GlOffscreenRenderer::renderScene(const bool centerScene, const bool antiali
     camera.setZoomFactor(zoomFactor);
   }
 
+  // the image must not contain placeholder textures
+  bool asynchronousTextures = GlTextureManager::isAsynchronousLoading();
+  GlTextureManager::setAsynchronousLoading(false);
   scene.draw();
+  GlTextureManager::setAsynchronousLoading(asynchronousTextures);
   glFrameBuf->release();
 
   if (antialiasedFbo)
@@ -201,7 +212,10 @@ void GlOffscreenRenderer::renderExternalScene(GlScene *scene, const bool antiali
   scene->setViewport(0, 0, vPWidth, vPHeight);
 
   glFrameBuf->bind();
+  bool asynchronousTextures = GlTextureManager::isAsynchronousLoading();
+  GlTextureManager::setAsynchronousLoading(false);
   scene->draw();
+  GlTextureManager::setAsynchronousLoading(asynchronousTextures);
   glFrameBuf->release();
 
   if (antialiasedFbo)
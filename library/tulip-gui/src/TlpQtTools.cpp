@@ -40,6 +40,7 @@
 #include <QDir>
 #include <QApplication>
 #include <QStandardPaths>
+#include <QTimer>
 #if defined(__MINGW32__) && defined(TULIP_BUILD_PYTHON_COMPONENTS)
 #include <QSslSocket>
 #endif
@@ -70,6 +71,7 @@
 #include <tulip/FileDownloader.h>
 #include <tulip/TulipItemEditorCreators.h>
 #include <tulip/GlOffscreenRenderer.h>
+#include <tulip/GlMainWidget.h>
 /**
  * For openDataSetDialog function : see OpenDataSet.cpp
  */
@@ -360,6 +362,41 @@ public:
 
     return true;
   }
+
+  // the local files are decoded with QImage which can be used in any thread,
+  // so they can be loaded asynchronously
+  bool canDecodeTexture(const std::string &filename) const override {
+    return !tlpStringToQString(filename).startsWith("http");
+  }
+
+  bool decodeTexture(const std::string &filename, GlTextureData &data) override {
+    QImage image(tlpStringToQString(filename));
+
+    if (image.isNull()) {
+      tlp::error() << "Error when loading texture from " << filename.c_str() << std::endl;
+      return false;
+    }
+
+    unsigned int width = image.width();
+    unsigned int height = image.height();
+
+    // same animated textures as in loadTexture
+    data.spriteNumber = 1;
+
+    if (width != height && ((width & (width - 1)) == 0) && ((height & (height - 1)) == 0))
+      data.spriteNumber = (width > height) ? width / height : height / width;
+
+    data.width = width;
+    data.height = height;
+    data.hasAlpha = image.hasAlphaChannel();
+    image = image.mirrored().convertToFormat(QImage::Format_RGBA8888);
+    data.pixels.resize(size_t(width) * height * 4);
+
+    for (unsigned int i = 0; i < height; ++i)
+      memcpy(&data.pixels[size_t(i) * width * 4], image.constScanLine(i), width * 4);
+
+    return true;
+  }
 };
 
 void initTulipSoftware(tlp::PluginLoader *loader, bool removeDiscardedPlugins) {
@@ -416,6 +453,33 @@ void initTulipSoftware(tlp::PluginLoader *loader, bool removeDiscardedPlugins) {
   initQTypeSerializers();
   // initialize Texture loader
   GlTextureManager::setTextureLoader(new GlTextureFromQImageLoader());
+  // the textures files are decoded in worker threads,
+  // the OpenGL views are drawn again once they are available
+  GlTextureManager::setAsynchronousLoading(true);
+  // the callback is called in a decoding thread, without Qt event dispatcher,
+  // so the drawing is queued to the GUI thread
+  auto drawGlMainWidgets = []() {
+    for (QWidget *widget : QApplication::allWidgets()) {
+      GlMainWidget *glMainWidget = qobject_cast<GlMainWidget *>(widget);
+
+      if (glMainWidget && glMainWidget->isVisible())
+        glMainWidget->draw(false);
+    }
+  };
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 10, 0))
+  GlTextureManager::setTexturesDecodedCallback([drawGlMainWidgets]() {
+    QMetaObject::invokeMethod(qApp, drawGlMainWidgets, Qt::QueuedConnection);
+  });
+#else
+  // the start slot of a timer living in the GUI thread is queued to it
+  QTimer *drawTimer = new QTimer(qApp);
+  drawTimer->setSingleShot(true);
+  drawTimer->setInterval(0);
+  QObject::connect(drawTimer, &QTimer::timeout, drawGlMainWidgets);
+  GlTextureManager::setTexturesDecodedCallback([drawTimer]() {
+    QMetaObject::invokeMethod(drawTimer, "start", Qt::QueuedConnection);
+  });
+#endif
   // Load plugins
   tlp::PluginLibraryLoader::loadPluginsFromDir(
       tlp::TulipPluginsPath, loader,
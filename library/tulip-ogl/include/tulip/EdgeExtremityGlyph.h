@@ -31,6 +31,7 @@
 namespace tlp {
 
 class Color;
+struct GlyphGeometry;
 
 static const std::string EEGLYPH_CATEGORY = "Edge extremity";
 
@@ -50,6 +51,14 @@ public:
   ~EdgeExtremityGlyph() override;
   virtual void draw(edge e, node n, const Color &glyphColor, const Color &borderColor,
                     float lod) = 0;
+  /**
+   * Fills geometry with the geometry of the glyph to allow its instanced
+   * rendering (see GlGlyphRenderer). Returns false if the glyph has to be
+   * drawn by its draw method (default)
+   */
+  virtual bool getGeometry(GlyphGeometry &) const {
+    return false;
+  }
   void get2DTransformationMatrix(const Coord &src, const Coord &dest, const Size &glyphSize,
                                  MatrixGL &transformationMatrix, MatrixGL &scalingMatrix);
   void get3DTransformationMatrix(const Coord &src, const Coord &dest, const Size &glyphSize,
@@ -0,0 +1,233 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef Tulip_GLFRAMEPROFILER_H
+#define Tulip_GLFRAMEPROFILER_H
+
+#include <tulip/tulipconf.h>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tlp {
+
+/**
+ * @ingroup OpenGL
+ * @brief Measure where the time of the rendering goes.
+ *
+ * The rendering code is instrumented with nested sections (GlScene::draw,
+ * LOD computation, vertex arrays, glyphs, labels, selection, ...) whose CPU time,
+ * and GPU time when the GL_ARB_timer_query extension is available, are measured
+ * when the profiling is enabled. An outermost section and the sections nested in it form
+ * a frame; the last frames are kept in a ring buffer (see getFrames()).
+ *
+ * When the profiling is disabled, a section only costs the test of a boolean.
+ * The sections must be opened and closed in the thread rendering the scenes.
+ *
+ * @code
+ * void MyEntity::draw(float lod, Camera *camera) {
+ *   GlFrameProfiler::Scope profilingScope("MyEntity::draw");
+ *   ...
+ * }
+ * @endcode
+ */
+class TLP_GL_SCOPE GlFrameProfiler {
+
+public:
+  /**
+   * @brief A measured section of a frame. The times are in milliseconds.
+   */
+  struct Section {
+    // the name given to beginSection()
+    const char *name;
+    // 0 for the section forming the frame
+    unsigned int depth;
+    // the start of the section, since the start of the frame
+    double start;
+    double cpuTime;
+    // the start of the section on the GPU, since the start of the frame on the GPU,
+    // and its duration; they are negative while they are not available
+    double gpuStart;
+    double gpuTime;
+  };
+
+  /**
+   * @brief A measured frame, its sections are ordered by start time
+   * and the first one covers the whole frame.
+   */
+  struct Frame {
+    unsigned int number;
+    // the start of the frame, in milliseconds since the start of the profiling
+    double start;
+    std::vector<Section> sections;
+
+    const char *name() const {
+      return sections.front().name;
+    }
+
+    double cpuTime() const {
+      return sections.front().cpuTime;
+    }
+
+    double gpuTime() const {
+      return sections.front().gpuTime;
+    }
+  };
+
+  /**
+   * @brief Measures the section enclosing it.
+   */
+  class Scope {
+  public:
+    /**
+     * @param name the name of the section, it must remain valid
+     * while the profiled frames are kept (usually a string literal)
+     */
+    Scope(const char *name) : active(GlFrameProfiler::enabled) {
+      if (active)
+        GlFrameProfiler::beginSection(name);
+    }
+
+    ~Scope() {
+      if (active)
+        GlFrameProfiler::endSection();
+    }
+
+  private:
+    bool active;
+  };
+
+  /**
+   * @brief Enables or disables the profiling (disabled by default).
+   * Disabling it keeps the profiled frames.
+   */
+  static void setEnabled(bool enabled);
+
+  static bool isEnabled() {
+    return enabled;
+  }
+
+  /**
+   * @brief Enables or disables the measure of the GPU times with timer queries
+   * (enabled by default). It has no effect when GL_ARB_timer_query is not supported.
+   * As the queries cannot be shared, they are created and read in the OpenGL context
+   * current at the beginning of each frame (see releaseGpuQueries()).
+   */
+  static void setGpuTimingEnabled(bool enabled);
+
+  static bool isGpuTimingEnabled() {
+    return gpuTimingEnabled;
+  }
+
+  /**
+   * @brief Sets the number of frames kept (120 by default).
+   */
+  static void setHistorySize(unsigned int size);
+
+  static unsigned int getHistorySize() {
+    return historySize;
+  }
+
+  /**
+   * @brief Returns the last profiled frames, the most recent one being at the back.
+   * The GPU times of a frame are only available a few frames later.
+   */
+  static const std::deque<Frame> &getFrames() {
+    return frames;
+  }
+
+  /**
+   * @brief Returns the last profiled frame whose name is the given one,
+   * nullptr if there is none.
+   */
+  static const Frame *getLastFrame(const std::string &name);
+
+  /**
+   * @brief Removes the profiled frames.
+   */
+  static void clear();
+
+  /**
+   * @brief Writes the profiled frames in a file using the JSON trace event format
+   * which can be loaded in Chrome (chrome://tracing) or Perfetto.
+   * The CPU and GPU sections are displayed in two different tracks.
+   */
+  static bool saveChromeTrace(const std::string &fileName);
+
+  /**
+   * @brief Deletes the timer queries created in the current OpenGL context.
+   * It must be called, while it is current, before the destruction of a context
+   * in which profiled frames have been rendered. The GPU times of its frames
+   * not yet available are lost.
+   */
+  static void releaseGpuQueries();
+
+  /**
+   * @brief Opens a section, it is usually easier to use a Scope.
+   * The name must remain valid while the profiled frames are kept.
+   */
+  static void beginSection(const char *name);
+
+  /**
+   * @brief Closes the last opened section.
+   */
+  static void endSection();
+
+private:
+  struct GpuQueries {
+    unsigned int frameNumber;
+    unsigned int section;
+    unsigned int begin, end;
+  };
+
+  // the timer queries created in an OpenGL context
+  struct ContextQueries {
+    // the queries of the frames whose GPU times are not yet available,
+    // and the unused ones
+    std::deque<GpuQueries> pendingQueries;
+    std::vector<unsigned int> freeQueries;
+    // the timestamp of the beginning of the frame whose queries are read
+    unsigned long long frameBegin;
+  };
+
+  static double now();
+  static unsigned int newQuery();
+  static void readGpuTimes();
+
+  static bool enabled;
+  static bool gpuTimingEnabled;
+  static unsigned int historySize;
+  static std::deque<Frame> frames;
+  static unsigned int frameCounter;
+  // the frame being profiled and the indices of its opened sections
+  static Frame currentFrame;
+  static std::vector<unsigned int> openedSections;
+  // indicates if the GPU times of the current frame are measured
+  static bool gpuTimedFrame;
+  // the timer queries of the current frame,
+  // and those of each OpenGL context, the one of the current frame first
+  static std::vector<GpuQueries> currentQueries;
+  static std::unordered_map<const void *, ContextQueries> contextsQueries;
+  static ContextQueries *frameQueries;
+};
+} // namespace tlp
+
+#endif // Tulip_GLFRAMEPROFILER_H
@@ -0,0 +1,61 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef Tulip_GLFRAMEPROFILEROVERLAY_H
+#define Tulip_GLFRAMEPROFILEROVERLAY_H
+
+#include <tulip/GlSimpleEntity.h>
+
+namespace tlp {
+
+class GlLabel;
+
+/**
+ * @ingroup OpenGL
+ * @brief Displays the times of the last frames measured by GlFrameProfiler.
+ *
+ * The top left corner of the viewport shows a chart of the CPU times
+ * of the last frames having the given name, and the CPU and GPU times
+ * of the main sections of the last one.
+ * It must be drawn with a 2D camera, it is usually displayed
+ * with GlScene::setFrameProfilerOverlayVisible().
+ */
+class TLP_GL_SCOPE GlFrameProfilerOverlay : public GlSimpleEntity {
+
+public:
+  /**
+   * @param frameName the name of the displayed frames
+   */
+  GlFrameProfilerOverlay(const std::string &frameName = "GlScene::draw");
+
+  ~GlFrameProfilerOverlay() override;
+
+  void draw(float lod, Camera *camera) override;
+
+  void getXML(std::string &) override {}
+
+  void setWithXML(const std::string &, unsigned int &) override {}
+
+private:
+  std::string frameName;
+  GlLabel *label;
+};
+} // namespace tlp
+
+#endif // Tulip_GLFRAMEPROFILEROVERLAY_H
@@ -26,6 +26,7 @@
 #include <tulip/Node.h>
 #include <tulip/Edge.h>
 
+#include <unordered_map>
 #include <vector>
 
 namespace tlp {
@@ -35,6 +36,7 @@ class GlShaderProgram;
 class Glyph;
 class EdgeExtremityGlyph;
 class GlBox;
+struct GlyphGeometry;
 
 struct TLP_GL_SCOPE NodeGlyphData {
 
@@ -80,7 +82,24 @@ struct TLP_GL_SCOPE EdgeExtremityGlyphData {
 class TLP_GL_SCOPE GlGlyphRenderer {
 
 public:
-  GlGlyphRenderer(GlGraphInputData *inputData) : _inputData(inputData), _renderingStarted(false) {}
+  GlGlyphRenderer(GlGraphInputData *inputData)
+      : _inputData(inputData), _renderingStarted(false), _instancedRendering(false),
+        _instancesBuffer(0) {}
+
+  ~GlGlyphRenderer();
+
+  /**
+   * Enables / disables the instanced rendering of the glyphs providing their geometry.
+   * It is enabled by default but only used when the OpenGL implementation
+   * supports the GL_ARB_instanced_arrays and GL_ARB_draw_instanced extensions.
+   */
+  static void setInstancedRenderingEnabled(bool enabled) {
+    _instancedRenderingEnabled = enabled;
+  }
+
+  static bool isInstancedRenderingEnabled() {
+    return _instancedRenderingEnabled;
+  }
 
   void startRendering();
 
@@ -93,14 +112,46 @@ public:
                                       Color glyphColor, Color glyphBorderColor, float lod,
                                       Coord beginAnchor, Coord srcAnchor, Size size, bool selected);
 
+  /**
+   * Returns true if the glyph can be rendered with instancing in the current rendering,
+   * in that case the glyph does not need to support the shader rendering.
+   */
+  bool hasInstancedGeometry(Glyph *glyph);
+  bool hasInstancedGeometry(EdgeExtremityGlyph *glyph);
+
   void endRendering();
 
 private:
+  // the buffers holding the geometry of a glyph,
+  // a glyph without geometry has no vertices
+  struct InstancedGeometry {
+    InstancedGeometry()
+        : fillBuffer(0), outlineBuffer(0), nbFillVertices(0), nbOutlineVertices(0),
+          lighting(false) {}
+    unsigned int fillBuffer;
+    unsigned int outlineBuffer;
+    unsigned int nbFillVertices;
+    unsigned int nbOutlineVertices;
+    bool lighting;
+  };
+
+  static InstancedGeometry createInstancedGeometry(const GlyphGeometry &geometry);
+  void renderInstancedGlyphs();
+
   GlGraphInputData *_inputData;
   bool _renderingStarted;
+  bool _instancedRendering;
   std::vector<NodeGlyphData> _nodeGlyphsToRender;
   std::vector<EdgeExtremityGlyphData> _edgeExtremityGlyphsToRender;
+  std::vector<NodeGlyphData> _instancedNodeGlyphsToRender;
+  std::vector<EdgeExtremityGlyphData> _instancedEdgeExtremityGlyphsToRender;
+  // the geometries of the glyphs indexed by their ids
+  std::unordered_map<int, InstancedGeometry> _nodeGlyphsGeometry;
+  std::unordered_map<int, InstancedGeometry> _edgeExtremityGlyphsGeometry;
+  unsigned int _instancesBuffer;
+  static bool _instancedRenderingEnabled;
   static GlShaderProgram *_glyphShader;
+  static GlShaderProgram *_instancedGlyphShader;
   static GlBox *_selectionBox;
 };
 } // namespace tlp
@@ -24,6 +24,7 @@
 #include <tulip/GlGraphRenderer.h>
 
 #include <unordered_map>
+#include <vector>
 
 namespace tlp {
 
@@ -62,11 +63,21 @@ protected:
   void drawLabelsForComplexEntities(bool drawSelected, OcclusionTest *occlusionTest,
                                     LayerLODUnit &layerLODUnit);
 
+  // aggregates the nodes and edges smaller than threshold pixels
+  // in screen tiles and draws a splat for each non empty tile
+  void drawDensitySplats(LayerLODUnit &layerLODUnit, Camera *camera, float threshold,
+                         bool aggregateNodes, bool aggregateEdges);
+
   GlLODCalculator *lodCalculator;
 
   GlScene *baseScene;
   GlScene *fakeScene;
   Vec4i selectionViewport;
+
+  // the screen tile of each aggregated element,
+  // and the count and color sums of each tile
+  std::vector<unsigned int> elementsTiles;
+  std::vector<float> tilesSums;
 };
 } // namespace tlp
 
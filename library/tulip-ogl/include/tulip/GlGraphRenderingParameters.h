@@ -494,6 +494,25 @@ public:
     _labelsAreBillboarded = billboarded;
   }
 
+  /**
+   * @brief Return the size (in pixels) under which the displayed nodes and edges
+   * are aggregated in density splats, 0 if the aggregation is disabled
+   */
+  float getDensityAggregationThreshold() const;
+
+  /**
+   * @brief Set the size (in pixels) under which the displayed nodes and edges are aggregated.
+   *
+   * When the projected size of a node or an edge is lower than this threshold,
+   * it is no longer drawn: it is accumulated in the screen tile (of threshold * threshold pixels)
+   * containing its center, and each non empty tile is drawn as a single splat whose color
+   * is the mean of the colors of its elements and whose opacity increases with their number.
+   * The elements above the threshold are drawn with full details.
+   * This aggregation is not applied when the elements are ordered (by a metric or along Z).
+   * 0 (the default) disables the aggregation.
+   */
+  void setDensityAggregationThreshold(float threshold);
+
   /**
    * @brief This property is use to filter nodes/edges display, for a node/edge if this property is
    * false : the node/edge will not be displayed
@@ -543,6 +562,7 @@ private:
   int _labelMaxSize;
   int _labelsDensity;
   bool _labelsAreBillboarded;
+  float _densityAggregationThreshold;
   std::string _fontsPath;
   std::string _texturePath;
   bool _edgesMaxSizeToNodesSize;
@@ -0,0 +1,206 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef Tulip_GLHEADLESSRENDERER_H
+#define Tulip_GLHEADLESSRENDERER_H
+
+#include <tulip/tulipconf.h>
+#include <tulip/GlScene.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tlp {
+
+class Graph;
+class GlGraphComposite;
+
+/**
+ * @brief Render graphs in images without any window system.
+ *
+ * Unlike GlOffscreenRenderer, this renderer does not depend on Qt: it creates its own
+ * OpenGL context through EGL (surfaceless when the Mesa platform is available),
+ * so it can be used on a server to produce the pictures of a lot of graphs.
+ *
+ * The frames are pipelined: the pixels of a rendered frame are read back asynchronously
+ * in a pixel buffer object and only delivered to the callback of the frame when the next one
+ * has been submitted, so the preparation of a scene on the CPU overlaps the rasterization
+ * and the readback of the previous one. The callbacks, in which the images are usually
+ * encoded (see savePNG), are executed in worker threads.
+ *
+ * All the methods, except savePNG, must be called from the thread which called init().
+ *
+ * @code
+ * GlHeadlessRenderer renderer;
+ * if (renderer.init(1024, 1024)) {
+ *   renderer.setGraph(graph);
+ *   renderer.renderScene([](const std::vector<unsigned char> &rgba, unsigned int w,
+ *                           unsigned int h) {
+ *     GlHeadlessRenderer::savePNG("graph.png", rgba, w, h);
+ *   });
+ *   renderer.flush();
+ * }
+ * @endcode
+ */
+class TLP_GL_SCOPE GlHeadlessRenderer {
+
+public:
+  /**
+   * @brief The function receiving the pixels of a rendered frame:
+   * width * height RGBA pixels, from the top row to the bottom one.
+   */
+  typedef std::function<void(const std::vector<unsigned char> &rgba, unsigned int width,
+                             unsigned int height)>
+      ImageCallback;
+
+  /**
+   * @param nbEncodingThreads the number of threads executing the image callbacks
+   */
+  GlHeadlessRenderer(unsigned int nbEncodingThreads = 1);
+  ~GlHeadlessRenderer();
+
+  /**
+   * @brief Creates the OpenGL context and the frame buffers.
+   *
+   * @param width the width of the rendered images
+   * @param height the height of the rendered images
+   * @param samples the number of samples per pixel used for antialiasing,
+   * 0 to disable it
+   * @return false if the context cannot be created, see getErrorMessage()
+   */
+  bool init(unsigned int width, unsigned int height, unsigned int samples = 0);
+
+  /**
+   * @brief Returns the cause of the last failure of init().
+   */
+  const std::string &getErrorMessage() const {
+    return errorMessage;
+  }
+
+  /**
+   * @brief Changes the size of the rendered images.
+   */
+  void setViewportSize(unsigned int width, unsigned int height);
+
+  unsigned int getViewportWidth() const {
+    return width;
+  }
+
+  unsigned int getViewportHeight() const {
+    return height;
+  }
+
+  /**
+   * @brief Sets the graph to render. Setting again the same graph keeps
+   * its rendering data (vertex arrays, ...) so only its modified elements are updated.
+   * The renderer does not take the ownership of the graph.
+   */
+  void setGraph(Graph *graph);
+
+  /**
+   * @brief Returns the composite of the rendered graph, nullptr if there is none.
+   * It can be used to change the rendering parameters.
+   */
+  GlGraphComposite *getGraphComposite() const {
+    return graphComposite;
+  }
+
+  void setBackgroundColor(const Color &color);
+
+  GlScene *getScene() {
+    return &scene;
+  }
+
+  /**
+   * @brief Returns the camera of the layer displaying the graph.
+   */
+  Camera &getCamera();
+
+  /**
+   * @brief Renders the scene and queues the readback of its pixels.
+   * The callback will be executed in a worker thread once the pixels are available,
+   * at the latest when flush() is called.
+   *
+   * @param centerScene indicates if the camera has to be set to see the whole scene
+   */
+  void renderScene(const ImageCallback &callback, bool centerScene = true);
+
+  /**
+   * @brief Waits until the callbacks of all the rendered frames have been executed.
+   */
+  void flush();
+
+  /**
+   * @brief Writes width * height RGBA pixels, ordered from the top row
+   * to the bottom one, in a PNG file. It can be called from any thread.
+   */
+  static bool savePNG(const std::string &fileName, const std::vector<unsigned char> &rgba,
+                      unsigned int width, unsigned int height);
+
+private:
+  struct PendingFrame {
+    std::vector<unsigned char> pixels;
+    unsigned int width, height;
+    ImageCallback callback;
+  };
+
+  void releaseFrameBuffers();
+  bool initFrameBuffers();
+  void destroyContext();
+  void readPreviousFrame();
+  void encodingThread();
+
+  void *display;
+  void *context;
+  void *surface;
+  std::string errorMessage;
+  unsigned int width, height, samples;
+
+  // the frame buffer read back, and the multisampled one
+  // in which the scene is drawn when antialiasing is enabled
+  unsigned int fbo, colorBuffer, depthBuffer;
+  unsigned int msFbo, msColorBuffer, msDepthBuffer;
+  // the pixel buffers used alternately for the readback
+  unsigned int pbos[2];
+  unsigned int currentPbo;
+  // the frame whose readback is in progress
+  bool readbackPending;
+  PendingFrame readbackFrame;
+
+  GlScene scene;
+  GlLayer *mainLayer;
+  GlGraphComposite *graphComposite;
+
+  // the frames waiting for their callback
+  std::deque<PendingFrame> frames;
+  unsigned int nbRunningCallbacks;
+  bool stopThreads;
+  std::mutex framesMutex;
+  std::condition_variable framesAvailable;
+  std::condition_variable framesDone;
+  std::vector<std::thread> threads;
+};
+} // namespace tlp
+
+#endif // Tulip_GLHEADLESSRENDERER_H
@@ -25,6 +25,7 @@
 #include <tulip/Size.h>
 #include <tulip/Camera.h>
 #include <tulip/GlSimpleEntity.h>
+#include <tulip/GlSdfFont.h>
 
 class FTGLPolygonFont;
 class FTOutlineFont;
@@ -143,9 +144,7 @@ public:
   /**
    * @brief Return the bounding box of the text of the label after transformations
    */
-  const BoundingBox &getTextBoundingBox() {
-    return textBoundingBox;
-  }
+  const BoundingBox &getTextBoundingBox();
 
   /**
    * @brief Set the size of the label
@@ -438,7 +437,38 @@ public:
     this->billboarded = billboarded;
   }
 
+  /**
+   * @brief Enables / disables the rendering of the labels with the signed distance field
+   * atlases of their fonts.
+   * When disabled, or when it is not supported by the host system, the labels are rendered
+   * with the tessellated polygons of their glyphs. It is enabled by default.
+   */
+  static void setSdfRenderingEnabled(bool enabled);
+
+  /**
+   * @brief Return if the rendering of the labels with signed distance field atlases is enabled
+   */
+  static bool isSdfRenderingEnabled();
+
+  /**
+   * @brief Starts to gather the labels drawn with drawWithStencil() using
+   * a signed distance field atlas, in order to render them all at once
+   * when endBatchRendering() is called.
+   * The projection must not change until the batch rendering ends.
+   */
+  static void beginBatchRendering();
+
+  /**
+   * @brief Renders the labels gathered since the call to beginBatchRendering()
+   */
+  static void endBatchRendering();
+
 private:
+  // computes the FTGL metrics of the text if needed
+  void computeTextMetrics();
+  void drawSdfText(float xAlignFactor, float xShiftFactor, float yShiftFactor,
+                   float outlineWidth);
+
   std::string text;
   std::string fontName;
   int fontSize;
@@ -474,8 +504,16 @@ private:
   Vec4i oldViewport;
 
   std::vector<std::string> textVector;
+  // the FTGL metrics of the text
   std::vector<float> textWidthVector;
   BoundingBox textBoundingBox;
+  bool textMetricsOutdated;
+  // the glyphs and the metrics of each line when the label can be rendered
+  // with the signed distance field atlas of its font
+  GlSdfFont *sdfFont;
+  std::vector<std::vector<const GlSdfFont::GlyphInfo *>> sdfGlyphsVector;
+  std::vector<float> sdfTextWidthVector;
+  BoundingBox sdfTextBoundingBox;
 };
 } // namespace tlp
 #endif
@@ -0,0 +1,156 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+///@cond DOXYGEN_HIDDEN
+
+#ifndef Tulip_GLPICKINGBUFFER_H
+#define Tulip_GLPICKINGBUFFER_H
+
+#include <tulip/tulipconf.h>
+
+#include <vector>
+
+namespace tlp {
+
+/**
+ * \brief Class to perform picking by rendering entity ids as colors
+ *
+ * Instead of using the OpenGL selection mode (GL_SELECT), which is
+ * emulated in software by most drivers, the entities are rendered
+ * in an offscreen framebuffer covering only the selection area,
+ * each one with a flat color encoding its selection id.
+ * The framebuffer is then read back once and decoded.
+ *
+ * Usage :
+ * \code
+ * if (GlPickingBuffer::begin(w, h, lastId)) {
+ *   do {
+ *     // for each entity
+ *     GlPickingBuffer::loadName(id);
+ *     entity->draw(lod, camera);
+ *     ...
+ *   } while (GlPickingBuffer::nextPass());
+ *   GlPickingBuffer::end(hits);
+ * } else {
+ *   // use GL_SELECT rendering mode
+ * }
+ * \endcode
+ *
+ * As with the GL_SELECT mode, the picking ignores the depth buffer and
+ * the entities are reported from the last drawn to the first drawn.
+ * The entities covered by the ones drawn after them are found by peeling:
+ * the entities are drawn again, the ones already found no longer covering
+ * the others, until a pass finds no new id. Then the polygons are drawn
+ * as points, one pixel wide as the lines, to find the entities
+ * not covering the center of any pixel.
+ *
+ * While picking, the shader programs cannot be activated,
+ * blending has no effect and lighting is disabled before each entity:
+ * the entities must fall back to their fixed pipeline rendering.
+ */
+class TLP_GL_SCOPE GlPickingBuffer {
+
+public:
+  /**
+   * Returns true if the host system supports the framebuffer objects
+   * needed by the picking buffer.
+   * A valid OpenGL context is needed.
+   */
+  static bool isSupported();
+
+  /**
+   * Enables / disables the use of the picking buffer.
+   * When disabled, begin() always returns false and the OpenGL
+   * selection mode is used instead. It is enabled by default.
+   */
+  static void setEnabled(bool enabled) {
+    _enabled = enabled;
+  }
+
+  /**
+   * Returns if the use of the picking buffer is enabled
+   */
+  static bool isEnabled() {
+    return _enabled;
+  }
+
+  /**
+   * Starts a picking rendering in an offscreen framebuffer of width x height pixels
+   * for entities whose ids are in the range [1, maxId].
+   * The current projection must map the selection area onto the whole viewport.
+   * Returns false if the picking buffer cannot be used (disabled, not supported,
+   * maxId greater than 2^24 - 1, or a selection area larger than a renderbuffer),
+   * in that case the OpenGL state is left unchanged.
+   */
+  static bool begin(int width, int height, unsigned int maxId);
+
+  /**
+   * Collects the ids rendered by the current pass and returns true if the entities
+   * have to be drawn again, with the same ids, to find the ones not yet rendered.
+   */
+  static bool nextPass();
+
+  /**
+   * Ends the picking rendering started by begin(), restores the previous OpenGL state,
+   * and appends to hits the ids of the entities rendered in the selection area
+   * by all the passes, the last drawn first.
+   */
+  static void end(std::vector<unsigned int> &hits);
+
+  /**
+   * Returns true if a picking rendering is in progress
+   */
+  static bool isActive() {
+    return _active;
+  }
+
+  /**
+   * Returns true if a picking rendering or an OpenGL selection is in progress.
+   * Entities using shaders to compute their geometry or colors
+   * must fall back to their fixed pipeline rendering in that case.
+   */
+  static bool inSelectionMode();
+
+  /**
+   * Sets the id of the entities to draw next.
+   * If no picking rendering is in progress it calls glLoadName(id).
+   */
+  static void loadName(unsigned int id);
+
+private:
+  static bool _enabled;
+  static bool _active;
+  static unsigned int _fbo;
+  static unsigned int _colorBuffer;
+  static int _previousFbo;
+  static int _width, _height;
+  static unsigned int _maxId;
+  static int _previousViewport[4];
+  static std::vector<bool> _found;
+  static unsigned int _nbFound;
+  static bool _verticesPass;
+  static bool _passRead;
+
+  // collects the ids rendered by the current pass,
+  // returns true if new ones are found
+  static bool readPass();
+};
+} // namespace tlp
+
+#endif // Tulip_GLPICKINGBUFFER_H
+///@endcond
@@ -22,9 +22,12 @@
 #define Tulip_QLQUADTREELODCALCULATOR_H
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <tulip/GlCPULODCalculator.h>
+#include <tulip/Node.h>
+#include <tulip/Edge.h>
 #include <tulip/Observable.h>
 #include <tulip/GlGraphRenderingParameters.h>
 
@@ -32,7 +35,7 @@ namespace tlp {
 
 class Camera;
 template <class TYPE>
-class QuadTreeNode;
+class PackedRTree;
 class GlScene;
 class PropertyInterface;
 class Graph;
@@ -103,6 +106,9 @@ public:
 
 protected:
   void update(PropertyInterface *property);
+  bool elementModified(PropertyInterface *property, node n);
+  bool elementModified(PropertyInterface *property, edge e);
+  void updateModifiedElements();
   void treatEvent(const Event &ev) override;
 
   void removeObservers();
@@ -113,9 +119,13 @@ protected:
 
   void setHaveToCompute();
 
-  std::vector<QuadTreeNode<std::pair<uint, uint>> *> nodesQuadTree;
-  std::vector<QuadTreeNode<std::pair<uint, uint>> *> edgesQuadTree;
-  std::vector<QuadTreeNode<GlSimpleEntity *> *> entitiesQuadTree;
+  std::vector<PackedRTree<std::pair<uint, uint>> *> nodesRTree;
+  std::vector<PackedRTree<std::pair<uint, uint>> *> edgesRTree;
+  std::vector<PackedRTree<GlSimpleEntity *> *> entitiesRTree;
+  // positions of the graph elements whose bounding box has to be updated
+  // in the R-trees before the next computation
+  std::unordered_set<unsigned int> modifiedNodes;
+  std::unordered_set<unsigned int> modifiedEdges;
   std::vector<std::vector<SimpleEntityLODUnit>> simpleEntities;
 
   bool haveToCompute;
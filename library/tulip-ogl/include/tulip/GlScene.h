@@ -32,6 +32,7 @@ namespace tlp {
 class GlSimpleEntity;
 class Graph;
 class GlGraphComposite;
+class GlFrameProfilerOverlay;
 
 /**
  * @ingroup OpenGL
@@ -547,6 +548,16 @@ public:
     return clearStencilBufferAtDraw;
   }
 
+  /**
+   * @brief Set if the times of the last frames measured by GlFrameProfiler
+   * are displayed over the scene. Displaying them enables the profiling.
+   */
+  void setFrameProfilerOverlayVisible(bool visible);
+
+  bool isFrameProfilerOverlayVisible() const {
+    return frameProfilerOverlay != nullptr;
+  }
+
 private:
   std::vector<std::pair<std::string, GlLayer *>> layersList;
   GlLODCalculator *lodCalculator;
@@ -565,6 +576,8 @@ private:
 
   bool clearStencilBufferAtDraw;
 
+  GlFrameProfilerOverlay *frameProfilerOverlay;
+
 public:
   ///@cond DOXYGEN_HIDDEN
 
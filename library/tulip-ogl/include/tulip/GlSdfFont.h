@@ -0,0 +1,120 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+///@cond DOXYGEN_HIDDEN
+
+#ifndef Tulip_GLSDFFONT_H
+#define Tulip_GLSDFFONT_H
+
+#include <tulip/tulipconf.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct FT_FaceRec_;
+
+namespace tlp {
+
+/**
+ * \brief A signed distance field atlas of the glyphs of a font
+ *
+ * The glyphs of a font are rasterized once at a reference size, and their
+ * signed distance fields are packed in a single texture. Text can then be rendered
+ * at any scale with one textured quad per glyph, the edges of the glyphs and their outline
+ * being computed in a fragment shader.
+ * The glyphs of the printable ASCII and Latin-1 characters are computed
+ * when the font is loaded, the other ones when they are first needed.
+ *
+ * The distance stored in the texture is 0.5 on the contour of the glyphs,
+ * greater inside them, and varies of getDistanceScale() for one pixel
+ * of the reference size.
+ */
+class TLP_GL_SCOPE GlSdfFont {
+
+public:
+  struct GlyphInfo {
+    // the bounding box of the glyph outline relative to the pen position,
+    // for a font of size 1
+    float xMin, yMin, xMax, yMax;
+    // the box of the textured quad relative to the pen position,
+    // for a font of size 1
+    float quadXMin, quadYMin, quadXMax, quadYMax;
+    // the texture coordinates of the (quadXMin, quadYMin)
+    // and (quadXMax, quadYMax) corners of the quad
+    float sMin, tMin, sMax, tMax;
+    // the horizontal advance of the pen, for a font of size 1
+    float advance;
+    // the glyph index in the font face
+    unsigned int index;
+    // indicates if the glyph has no outline (a space for instance)
+    bool empty;
+  };
+
+  ~GlSdfFont();
+
+  /**
+   * Returns the atlas of the font file fontFile,
+   * or nullptr if it cannot be loaded.
+   * The atlases are cached and never released.
+   */
+  static GlSdfFont *getFont(const std::string &fontFile);
+
+  /**
+   * Returns the glyph of a unicode code point,
+   * or nullptr if it cannot be added to the atlas.
+   */
+  const GlyphInfo *getGlyph(unsigned int codePoint);
+
+  /**
+   * Returns the horizontal kerning between two glyphs, for a font of size 1
+   */
+  float getKerning(const GlyphInfo *left, const GlyphInfo *right) const;
+
+  /**
+   * Returns the variation of the distance stored in the texture
+   * for one pixel of the reference size.
+   */
+  static float getDistanceScale();
+
+  /**
+   * Binds the atlas texture to the current texture unit, after uploading
+   * the glyphs added since the previous call.
+   * A valid OpenGL context is needed.
+   */
+  void bindTexture();
+
+private:
+  GlSdfFont(FT_FaceRec_ *face);
+  bool addGlyph(unsigned int codePoint, GlyphInfo &glyph);
+
+  FT_FaceRec_ *face;
+  std::unordered_map<unsigned int, GlyphInfo> glyphs;
+  // the code points whose glyph cannot be added to the atlas
+  std::unordered_set<unsigned int> failedGlyphs;
+  // the atlas pixels, and the current shelf of the packing
+  std::vector<unsigned char> pixels;
+  unsigned int shelfX, shelfY, shelfHeight;
+  unsigned int texture;
+  bool textureUpToDate;
+};
+} // namespace tlp
+
+#endif // Tulip_GLSDFFONT_H
+///@endcond
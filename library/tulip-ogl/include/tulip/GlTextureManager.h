@@ -27,9 +27,13 @@
 #endif
 #include <tulip/OpenGlIncludes.h>
 
+#include <functional>
+#include <list>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <vector>
 
 namespace tlp {
 
@@ -40,6 +44,22 @@ struct GlTexture {
   unsigned int spriteNumber;
 };
 
+/**
+ * The decoded pixels of a texture file
+ */
+struct GlTextureData {
+  GlTextureData() : width(0), height(0), spriteNumber(1), hasAlpha(false) {}
+  // the size of the whole image
+  unsigned int width;
+  unsigned int height;
+  // the number of animation frames, the image is split
+  // along its largest dimension
+  unsigned int spriteNumber;
+  bool hasAlpha;
+  // RGBA pixels, the rows are ordered from the bottom of the image to its top
+  std::vector<unsigned char> pixels;
+};
+
 /**
  *  \brief Class to load textures
  */
@@ -56,6 +76,27 @@ public:
 #else
   virtual bool loadTexture(const std::string &filename, GlTexture &texture) = 0;
 #endif
+
+  /**
+   * Indicates if the file can be decoded by decodeTexture,
+   * which allows its asynchronous loading
+   */
+  virtual bool canDecodeTexture(const std::string &filename) const;
+
+  /**
+   * Decode the pixels of a texture file without any OpenGL call.
+   * As it is called from worker threads when the textures are loaded
+   * asynchronously, it must be thread safe.
+   * Return false if an error occurs
+   */
+  virtual bool decodeTexture(const std::string &filename, GlTextureData &data);
+
+  /**
+   * Create the OpenGL textures of decoded pixels
+   */
+  static bool uploadTexture(const std::string &filename, const GlTextureData &data,
+                            GlTexture &texture);
+
   virtual ~GlTextureLoader() {}
 };
 
@@ -155,13 +196,80 @@ public:
 
   static void deleteAllTextures();
 
+  /**
+   * Enable or disable the asynchronous loading of the textures.
+   * When enabled, the textures that the loader can decode (see GlTextureLoader::canDecodeTexture)
+   * are decoded in worker threads, a placeholder texture being activated until they are uploaded
+   * by uploadDecodedTextures. It is disabled by default.
+   */
+  static void setAsynchronousLoading(bool asynchronous);
+
+  static bool isAsynchronousLoading() {
+    return asynchronousLoading;
+  }
+
+  /**
+   * Set the function called, from a worker thread, when decoded textures
+   * are waiting to be uploaded. It should request a new rendering of the scenes.
+   */
+  static void setTexturesDecodedCallback(const std::function<void()> &callback);
+
+  /**
+   * Upload in OpenGL textures the textures decoded since the previous call,
+   * within a limit of bytes per call to keep the rendering responsive.
+   * It is called at the beginning of each GlScene::draw
+   */
+  static void uploadDecodedTextures();
+
+  /**
+   * Set the maximum number of bytes used by the textures loaded from files.
+   * When it is exceeded, the least recently activated textures are deleted, and will be loaded
+   * again when needed. The textures activated during the last two frames are never deleted,
+   * so the budget may be exceeded by the textures of the displayed scenes.
+   * 0, the default, means no limit.
+   */
+  static void setMemoryBudget(size_t bytes);
+
+  static size_t getMemoryBudget() {
+    return memoryBudget;
+  }
+
+  /**
+   * Return the number of bytes used by the textures loaded from files
+   */
+  static size_t getMemoryUsage() {
+    return memoryUsage;
+  }
+
 private:
+  static void addTexture(const std::string &filename, const GlTexture &texture);
+  static void touchTexture(const std::string &filename);
+  static void enforceMemoryBudget();
+  static void activatePlaceholderTexture();
+
   static GlTextureLoader *loader;
 
   static TextureMap texturesMap;
   static std::set<std::string> texturesWithError;
 
   static unsigned int animationFrame;
+
+  // the least recently activated textures loaded from files come first
+  struct TextureUsage {
+    size_t bytes;
+    unsigned int lastFrame;
+    std::list<std::string>::iterator lruPos;
+  };
+  static std::list<std::string> lruTextures;
+  static std::unordered_map<std::string, TextureUsage> texturesUsage;
+  static size_t memoryBudget;
+  static size_t memoryUsage;
+  static unsigned int currentFrame;
+
+  static bool asynchronousLoading;
+  // the textures being decoded in worker threads
+  static std::unordered_set<std::string> texturesInDecoding;
+  static GLuint placeholderTexture;
 };
 } // namespace tlp
 
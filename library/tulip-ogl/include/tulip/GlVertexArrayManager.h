@@ -27,8 +27,11 @@
 #include <tulip/Color.h>
 #include <tulip/Observable.h>
 #include <tulip/GlSceneVisitor.h>
+#include <tulip/Node.h>
+#include <tulip/Edge.h>
 
 #include <map>
+#include <unordered_set>
 #include <vector>
 
 namespace tlp {
@@ -153,6 +156,9 @@ public:
 
 protected:
   void propertyValueChanged(tlp::PropertyInterface *property);
+  bool nodeValueChanged(tlp::PropertyInterface *property, node n);
+  bool edgeValueChanged(tlp::PropertyInterface *property, edge e);
+  void updateModifiedElements();
   void treatEvent(const Event &) override;
 
   void clearLayoutData();
@@ -229,6 +235,27 @@ protected:
 
   std::vector<edgeInfos> edgeInfosVector;
 
+  void computeEdgeLayout(GlEdge *glEdge, edgeInfos &eInfos);
+  void computeEdgeColors(GlEdge *glEdge, edgeInfos &eInfos);
+
+  // positions of the elements modified since the last rendering,
+  // whose data have to be updated without recomputing the whole arrays
+  std::unordered_set<unsigned int> layoutModifiedNodes;
+  std::unordered_set<unsigned int> layoutModifiedEdges;
+  std::unordered_set<unsigned int> colorModifiedNodes;
+  std::unordered_set<unsigned int> colorModifiedEdges;
+
+  // ranges (first index, number of elements) of the arrays
+  // to upload in the already filled vertex buffer objects
+  typedef std::vector<std::pair<unsigned int, unsigned int>> ArrayRanges;
+  ArrayRanges pointsVerticesRanges;
+  ArrayRanges linesVerticesRanges;
+  ArrayRanges quadsVerticesRanges;
+  ArrayRanges pointsColorsRanges;
+  ArrayRanges linesColorsRanges;
+  // also used for quadsOutlineColorsArray
+  ArrayRanges quadsColorsRanges;
+
   GLuint pointsVerticesVBO;
   GLuint pointsColorsVBO;
   GLuint linesVerticesVBO;
@@ -37,6 +37,7 @@ class Graph;
 struct node;
 class GlGraphInputData;
 class GlRect;
+struct GlyphGeometry;
 
 class GlyphContext : public PluginContext {
 public:
@@ -92,6 +93,15 @@ public:
     return true;
   }
 
+  /**
+   * Fills geometry with the geometry of the glyph to allow
+   * the instanced rendering of the nodes using it (see GlGlyphRenderer).
+   * Returns false if the glyph has to be drawn by its draw method (default)
+   */
+  virtual bool getGeometry(GlyphGeometry &) const {
+    return false;
+  }
+
   /**
    * draw a preconfigured GlRect in the screen plane
    */
@@ -0,0 +1,80 @@
+/*
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+///@cond DOXYGEN_HIDDEN
+
+#ifndef Tulip_GLYPHGEOMETRY_H
+#define Tulip_GLYPHGEOMETRY_H
+
+#include <tulip/Coord.h>
+
+#include <vector>
+
+namespace tlp {
+
+/**
+ * \brief The geometry of a glyph used for its instanced rendering
+ *
+ * A glyph (or an edge extremity glyph) describing its geometry can be drawn
+ * by GlGlyphRenderer for all the nodes (or edges) using it with a few instanced draw calls,
+ * instead of calling its draw method for each of them.
+ * The geometry is defined in the unit cube centered on (0, 0, 0), as if it were drawn
+ * by the draw method of the glyph. It is filled with the color and the texture of the element,
+ * and outlined with its border color and width.
+ */
+struct TLP_GL_SCOPE GlyphGeometry {
+
+  GlyphGeometry() : lighting(false) {}
+
+  /**
+   * Adds the triangles filling a star-shaped polygon (centered on (0, 0, 0)
+   * and in the z = 0 plane) and the segments of its outline.
+   * The texture coordinates are computed from the bounding box of the polygon.
+   */
+  void addPolygon(const std::vector<Coord> &points);
+
+  /**
+   * Adds a regular polygon inscribed in the unit square,
+   * as drawn by GlRegularPolygon.
+   */
+  void addRegularPolygon(unsigned int numberOfSides, float startAngle = float(M_PI) / 2.0f);
+
+  /**
+   * Adds the faces and the edges of the unit cube
+   */
+  void addBox();
+
+  /**
+   * Adds the triangles of a sphere of diameter 1, with the texture
+   * wrapped around it.
+   */
+  void addSphere(unsigned int slices = 40, unsigned int stacks = 20);
+
+  // the vertices, normals and texture coordinates of the filled triangles
+  std::vector<Coord> fillVertices;
+  std::vector<Coord> fillNormals;
+  std::vector<Vec2f> fillTexCoords;
+  // the vertices of the outline segments
+  std::vector<Coord> outlineVertices;
+  // indicates if the filled triangles are lit
+  bool lighting;
+};
+} // namespace tlp
+
+#endif // Tulip_GLYPHGEOMETRY_H
+///@endcond
@@ -24,6 +24,7 @@
 #include <tulip/TlpTools.h>
 #include <tulip/GlShaderProgram.h>
 #include <tulip/OpenGlConfigManager.h>
+#include <tulip/GlPickingBuffer.h>
 
 #include <sstream>
 
@@ -716,8 +717,7 @@ void AbstractGlCurve::drawCurve(std::vector<Coord> &controlPoints, const Color &
                                 const Color &endColor, const float startSize, const float endSize,
                                 const unsigned int nbCurvePoints) {
 
-  GLint renderMode;
-  glGetIntegerv(GL_RENDER_MODE, &renderMode);
+  bool selectionMode = GlPickingBuffer::inSelectionMode();
 
   float currentLineWidth;
   glGetFloatv(GL_LINE_WIDTH, &currentLineWidth);
@@ -742,7 +742,7 @@ void AbstractGlCurve::drawCurve(std::vector<Coord> &controlPoints, const Color &
   static bool canUseFloatTextures =
       OpenGlConfigManager::isExtensionSupported("GL_ARB_texture_float");
 
-  if (curveShaderProgram != nullptr && canUseFloatTextures && renderMode != GL_SELECT) {
+  if (curveShaderProgram != nullptr && canUseFloatTextures && !selectionMode) {
 
     static bool vboOk = OpenGlConfigManager::hasVertexBufferObject();
 
@@ -25,6 +25,7 @@
 #include <tulip/GlBezierCurve.h>
 #include <tulip/ParametricCurves.h>
 #include <tulip/GlShaderProgram.h>
+#include <tulip/GlPickingBuffer.h>
 
 using namespace std;
 
@@ -147,8 +148,7 @@ void GlCatmullRomCurve::drawCurve(vector<Coord> &controlPoints, const Color &sta
                                   const Color &endColor, const float startSize, const float endSize,
                                   const unsigned int nbCurvePoints) {
 
-  GLint renderMode;
-  glGetIntegerv(GL_RENDER_MODE, &renderMode);
+  bool selectionMode = GlPickingBuffer::inSelectionMode();
 
   vector<Coord> controlPointsCp;
   vector<Coord> *controlPointsP = &controlPoints;
@@ -161,7 +161,7 @@ void GlCatmullRomCurve::drawCurve(vector<Coord> &controlPoints, const Color &sta
     alpha = 1.0f;
   }
 
-  if (closedCurve && renderMode != GL_SELECT && curveShaderProgramNormal != nullptr) {
+  if (closedCurve && !selectionMode && curveShaderProgramNormal != nullptr) {
     controlPointsCp = controlPoints;
     controlPointsCp.push_back(controlPointsCp[0]);
     controlPointsP = &controlPointsCp;
@@ -32,6 +32,7 @@
 #include <tulip/GlTextureManager.h>
 #include <tulip/ParametricCurves.h>
 #include <tulip/GlShaderProgram.h>
+#include <tulip/GlPickingBuffer.h>
 #include <tulip/GlXMLTools.h>
 
 using namespace std;
@@ -491,8 +492,9 @@ void GlComplexPolygon::draw(float, Camera *) {
 
     if (quadBorderActivated[v]) {
 
+      // the shader outputs its own colors, so the outline cannot be picked
       if (GlShaderProgram::shaderProgramsSupported() &&
-          GlShaderProgram::geometryShaderSupported()) {
+          GlShaderProgram::geometryShaderSupported() && !GlPickingBuffer::isActive()) {
 
         static GlShaderProgram *outlineExtrusionShader = nullptr;
 
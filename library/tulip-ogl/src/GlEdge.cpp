@@ -774,9 +774,12 @@ void GlEdge::displayArrowAndAdjustAnchor(const GlGraphInputData *data, const edg
                               ? color
                               : data->getElementBorderColor()->getEdgeValue(e);
 
-      if (data->getGlGlyphRenderer()->renderingHasStarted() &&
-          noShaderGlyphs.find(extremityGlyph->id()) == noShaderGlyphs.end()) {
-        data->getGlGlyphRenderer()->addEdgeExtremityGlyphRendering(
+      GlGlyphRenderer *glyphRenderer = data->getGlGlyphRenderer();
+
+      if (glyphRenderer->renderingHasStarted() &&
+          (noShaderGlyphs.find(extremityGlyph->id()) == noShaderGlyphs.end() ||
+           glyphRenderer->hasInstancedGeometry(extremityGlyph))) {
+        glyphRenderer->addEdgeExtremityGlyphRendering(
             extremityGlyph, e, src, color, borderColor, 100., beginTmpAnchor, srcAnchor, size,
             selected);
       } else {
@@ -0,0 +1,307 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <GL/glew.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <OpenGL/OpenGL.h>
+#else
+#include <GL/glx.h>
+#ifdef TULIP_HAVE_EGL
+#include <EGL/egl.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include <tulip/GlFrameProfiler.h>
+#include <tulip/OpenGlConfigManager.h>
+#include <tulip/TlpTools.h>
+
+using namespace std;
+
+namespace tlp {
+
+bool GlFrameProfiler::enabled = false;
+bool GlFrameProfiler::gpuTimingEnabled = true;
+unsigned int GlFrameProfiler::historySize = 120;
+deque<GlFrameProfiler::Frame> GlFrameProfiler::frames;
+unsigned int GlFrameProfiler::frameCounter = 0;
+GlFrameProfiler::Frame GlFrameProfiler::currentFrame;
+vector<unsigned int> GlFrameProfiler::openedSections;
+bool GlFrameProfiler::gpuTimedFrame = false;
+vector<GlFrameProfiler::GpuQueries> GlFrameProfiler::currentQueries;
+unordered_map<const void *, GlFrameProfiler::ContextQueries> GlFrameProfiler::contextsQueries;
+GlFrameProfiler::ContextQueries *GlFrameProfiler::frameQueries = nullptr;
+
+// the number of timer queries created at once
+static const unsigned int QUERIES_BLOCK_SIZE = 64;
+
+// returns an identifier of the current OpenGL context
+static const void *currentContext() {
+#if defined(_WIN32)
+  return wglGetCurrentContext();
+#elif defined(__APPLE__)
+  return CGLGetCurrentContext();
+#else
+#ifdef TULIP_HAVE_EGL
+  // the headless rendering uses EGL contexts
+  EGLContext context = eglGetCurrentContext();
+
+  if (context != EGL_NO_CONTEXT)
+    return context;
+
+#endif
+  return glXGetCurrentContext();
+#endif
+}
+//====================================================================
+double GlFrameProfiler::now() {
+  static const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - origin).count();
+}
+//====================================================================
+void GlFrameProfiler::setEnabled(bool state) {
+  enabled = state;
+}
+//====================================================================
+void GlFrameProfiler::setGpuTimingEnabled(bool state) {
+  gpuTimingEnabled = state;
+}
+//====================================================================
+void GlFrameProfiler::setHistorySize(unsigned int size) {
+  historySize = std::max(size, 1u);
+
+  while (frames.size() > historySize)
+    frames.pop_front();
+}
+//====================================================================
+const GlFrameProfiler::Frame *GlFrameProfiler::getLastFrame(const string &name) {
+  for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+    if (name == it->name())
+      return &(*it);
+  }
+
+  return nullptr;
+}
+//====================================================================
+void GlFrameProfiler::clear() {
+  frames.clear();
+}
+//====================================================================
+unsigned int GlFrameProfiler::newQuery() {
+  vector<unsigned int> &freeQueries = frameQueries->freeQueries;
+
+  if (freeQueries.empty()) {
+    freeQueries.resize(QUERIES_BLOCK_SIZE);
+    glGenQueries(QUERIES_BLOCK_SIZE, freeQueries.data());
+  }
+
+  unsigned int query = freeQueries.back();
+  freeQueries.pop_back();
+  return query;
+}
+//====================================================================
+void GlFrameProfiler::readGpuTimes() {
+  deque<GpuQueries> &pendingQueries = frameQueries->pendingQueries;
+  vector<unsigned int> &freeQueries = frameQueries->freeQueries;
+
+  // the queries are read in the order of their submission,
+  // so the results of the next ones cannot be available
+  // when those of the first one are not
+  while (!pendingQueries.empty()) {
+    GpuQueries &queries = pendingQueries.front();
+    GLint available = 0;
+    glGetQueryObjectiv(queries.end, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (!available)
+      break;
+
+    GLuint64 begin, end;
+    glGetQueryObjectui64v(queries.begin, GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(queries.end, GL_QUERY_RESULT, &end);
+
+    if (queries.section == 0)
+      frameQueries->frameBegin = begin;
+
+    // the frame may have been removed from the history
+    if (!frames.empty() && queries.frameNumber >= frames.front().number &&
+        queries.frameNumber - frames.front().number < frames.size()) {
+      Section &section =
+          frames[queries.frameNumber - frames.front().number].sections[queries.section];
+      section.gpuStart = (begin - frameQueries->frameBegin) / 1e6;
+      section.gpuTime = (end - begin) / 1e6;
+    }
+
+    freeQueries.push_back(queries.begin);
+    freeQueries.push_back(queries.end);
+    pendingQueries.pop_front();
+  }
+}
+//====================================================================
+void GlFrameProfiler::releaseGpuQueries() {
+  auto it = contextsQueries.find(currentContext());
+
+  if (it == contextsQueries.end())
+    return;
+
+  // the queries of a frame being profiled are kept until its end
+  if (!openedSections.empty() && gpuTimedFrame && frameQueries == &it->second)
+    return;
+
+  vector<unsigned int> queries(it->second.freeQueries);
+
+  for (const GpuQueries &gpuQueries : it->second.pendingQueries) {
+    queries.push_back(gpuQueries.begin);
+    queries.push_back(gpuQueries.end);
+  }
+
+  if (!queries.empty())
+    glDeleteQueries(queries.size(), queries.data());
+
+  contextsQueries.erase(it);
+}
+//====================================================================
+void GlFrameProfiler::beginSection(const char *name) {
+  if (!enabled)
+    return;
+
+  double time = now();
+
+  if (openedSections.empty()) {
+    // a new frame begins
+    gpuTimedFrame =
+        gpuTimingEnabled && OpenGlConfigManager::isExtensionSupported("GL_ARB_timer_query");
+
+    if (gpuTimedFrame) {
+      frameQueries = &contextsQueries[currentContext()];
+      readGpuTimes();
+    }
+
+    currentFrame.number = frameCounter++;
+    currentFrame.start = time;
+    currentFrame.sections.clear();
+  }
+
+  openedSections.push_back(currentFrame.sections.size());
+  Section section = {name, static_cast<unsigned int>(openedSections.size() - 1),
+                     time - currentFrame.start, 0, -1, -1};
+  currentFrame.sections.push_back(section);
+
+  if (gpuTimedFrame) {
+    GpuQueries queries = {currentFrame.number, openedSections.back(), newQuery(), 0};
+    glQueryCounter(queries.begin, GL_TIMESTAMP);
+    currentQueries.push_back(queries);
+  }
+}
+//====================================================================
+void GlFrameProfiler::endSection() {
+  if (openedSections.empty())
+    return;
+
+  unsigned int sectionIndex = openedSections.back();
+  openedSections.pop_back();
+  Section &section = currentFrame.sections[sectionIndex];
+  section.cpuTime = now() - currentFrame.start - section.start;
+
+  if (gpuTimedFrame) {
+    GpuQueries &queries = currentQueries[sectionIndex];
+    queries.end = newQuery();
+    glQueryCounter(queries.end, GL_TIMESTAMP);
+  }
+
+  if (openedSections.empty()) {
+    // the frame is complete
+    frames.push_back(currentFrame);
+
+    while (frames.size() > historySize)
+      frames.pop_front();
+
+    if (gpuTimedFrame)
+      frameQueries->pendingQueries.insert(frameQueries->pendingQueries.end(),
+                                          currentQueries.begin(), currentQueries.end());
+
+    currentQueries.clear();
+  }
+}
+//====================================================================
+static void writeJSONString(ostream &os, const char *str) {
+  os << '"';
+
+  for (; *str; ++str) {
+    if (*str == '"' || *str == '\\')
+      os << '\\';
+
+    os << *str;
+  }
+
+  os << '"';
+}
+
+static void writeTraceEvent(ostream &os, bool &first, const char *name, const char *category,
+                            unsigned int track, double start, double duration,
+                            unsigned int frameNumber) {
+  if (!first)
+    os << ",\n";
+
+  first = false;
+  os << "{\"name\":";
+  writeJSONString(os, name);
+  // the times are in microseconds
+  os << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track
+     << ",\"ts\":" << start * 1000 << ",\"dur\":" << duration * 1000
+     << ",\"args\":{\"frame\":" << frameNumber << "}}";
+}
+
+bool GlFrameProfiler::saveChromeTrace(const string &fileName) {
+  ofstream os(fileName.c_str());
+
+  if (!os.is_open()) {
+    tlp::error() << "Unable to write the frames profiling in " << fileName << endl;
+    return false;
+  }
+
+  os.setf(ios::fixed);
+  os.precision(3);
+  os << "{\"traceEvents\":[\n"
+     << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+     << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+  bool first = false;
+
+  for (const Frame &frame : frames) {
+    for (const Section &section : frame.sections)
+      writeTraceEvent(os, first, section.name, "cpu", 1, frame.start + section.start,
+                      section.cpuTime, frame.number);
+
+    // the GPU sections are aligned on the start of their frame on the CPU
+    for (const Section &section : frame.sections) {
+      if (section.gpuTime >= 0)
+        writeTraceEvent(os, first, section.name, "gpu", 2, frame.start + section.gpuStart,
+                        section.gpuTime, frame.number);
+    }
+  }
+
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return !os.fail();
+}
+} // namespace tlp
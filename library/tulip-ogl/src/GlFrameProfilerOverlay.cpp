@@ -0,0 +1,189 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include <tulip/GlFrameProfilerOverlay.h>
+#include <tulip/GlFrameProfiler.h>
+#include <tulip/GlLabel.h>
+#include <tulip/Camera.h>
+#include <tulip/TulipViewSettings.h>
+
+using namespace std;
+
+namespace tlp {
+
+// the layout of the overlay, in pixels
+static const float MARGIN = 10;
+static const float PADDING = 5;
+static const float WIDTH = 320;
+static const float LINE_HEIGHT = 14;
+static const float CHART_HEIGHT = 60;
+// the number of sections listed
+static const unsigned int MAX_SECTIONS = 8;
+// the frame time of 60 frames per second
+static const double TARGET_FRAME_TIME = 1000. / 60.;
+
+GlFrameProfilerOverlay::GlFrameProfilerOverlay(const string &frameName)
+    : frameName(frameName), label(new GlLabel(Coord(), Size(), Color(255, 255, 255))) {
+  // the lines are left aligned on the position of the label
+  label->setAlignment(LabelPosition::Right);
+}
+
+GlFrameProfilerOverlay::~GlFrameProfilerOverlay() {
+  delete label;
+}
+
+static void drawRect(float left, float bottom, float right, float top) {
+  glVertex2f(left, bottom);
+  glVertex2f(right, bottom);
+  glVertex2f(right, top);
+  glVertex2f(left, top);
+}
+
+void GlFrameProfilerOverlay::draw(float lod, Camera *camera) {
+  const deque<GlFrameProfiler::Frame> &frames = GlFrameProfiler::getFrames();
+  const GlFrameProfiler::Frame *lastFrame = GlFrameProfiler::getLastFrame(frameName);
+
+  // the times of the main sections of the last frame, summed by name
+  vector<GlFrameProfiler::Section> sections;
+
+  if (lastFrame != nullptr) {
+    for (const GlFrameProfiler::Section &section : lastFrame->sections) {
+      if (section.depth != 1)
+        continue;
+
+      auto it = find_if(sections.begin(), sections.end(),
+                        [&section](const GlFrameProfiler::Section &s) {
+                          return strcmp(s.name, section.name) == 0;
+                        });
+
+      if (it == sections.end())
+        sections.push_back(section);
+      else {
+        it->cpuTime += section.cpuTime;
+        it->gpuTime = (it->gpuTime < 0 || section.gpuTime < 0) ? -1 : it->gpuTime + section.gpuTime;
+      }
+    }
+
+    sort(sections.begin(), sections.end(),
+         [](const GlFrameProfiler::Section &s1, const GlFrameProfiler::Section &s2) {
+           return s1.cpuTime > s2.cpuTime;
+         });
+
+    if (sections.size() > MAX_SECTIONS)
+      sections.resize(MAX_SECTIONS);
+  }
+
+  ostringstream text;
+  text.setf(ios::fixed);
+  text.precision(2);
+
+  if (lastFrame == nullptr)
+    text << (GlFrameProfiler::isEnabled() ? "no profiled frame" : "profiling disabled");
+  else {
+    text << frameName << " #" << lastFrame->number << ": " << lastFrame->cpuTime() << " ms";
+
+    if (lastFrame->gpuTime() >= 0)
+      text << " (gpu " << lastFrame->gpuTime() << " ms)";
+
+    for (const GlFrameProfiler::Section &section : sections) {
+      text << "\n" << section.name << ": " << section.cpuTime << " ms";
+
+      if (section.gpuTime >= 0)
+        text << " (gpu " << section.gpuTime << " ms)";
+    }
+  }
+
+  unsigned int nbLines = lastFrame ? sections.size() + 1 : 1;
+  const Vector<int, 4> &viewport = camera->getViewport();
+  float left = MARGIN;
+  float top = viewport[3] - MARGIN;
+  float textHeight = nbLines * LINE_HEIGHT;
+  float bottom = top - 3 * PADDING - textHeight - CHART_HEIGHT;
+  float chartWidth = WIDTH - 2 * PADDING;
+
+  // the maximum time displayed in the chart
+  double maxTime = 2 * TARGET_FRAME_TIME;
+
+  for (const GlFrameProfiler::Frame &frame : frames) {
+    if (frameName == frame.name())
+      maxTime = std::max(maxTime, frame.cpuTime());
+  }
+
+  glPushAttrib(GL_ALL_ATTRIB_BITS);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_TEXTURE_2D);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+  glStencilFunc(GL_ALWAYS, 0, 0xFFFF);
+  glEnable(GL_BLEND);
+  // the overlay remains opaque in the exported pictures
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+  glBegin(GL_QUADS);
+  // the background
+  glColor4ub(0, 0, 0, 170);
+  drawRect(left, bottom, left + WIDTH, top);
+
+  // the chart of the last frames, from left to right
+  float barWidth = chartWidth / GlFrameProfiler::getHistorySize();
+  float chartLeft = left + PADDING;
+  float chartBottom = bottom + PADDING;
+  float x = chartLeft + chartWidth;
+
+  for (auto it = frames.rbegin(); it != frames.rend() && x > chartLeft; ++it) {
+    if (frameName != it->name())
+      continue;
+
+    double time = it->cpuTime();
+
+    if (time <= TARGET_FRAME_TIME)
+      glColor4ub(80, 200, 80, 255);
+    else if (time <= 2 * TARGET_FRAME_TIME)
+      glColor4ub(230, 160, 40, 255);
+    else
+      glColor4ub(220, 60, 60, 255);
+
+    drawRect(x - barWidth, chartBottom, x, chartBottom + float(time / maxTime) * CHART_HEIGHT);
+    x -= barWidth;
+  }
+
+  glEnd();
+
+  // the line of the target frame time
+  float targetY = chartBottom + float(TARGET_FRAME_TIME / maxTime) * CHART_HEIGHT;
+  glColor4ub(255, 255, 255, 200);
+  glBegin(GL_LINES);
+  glVertex2f(chartLeft, targetY);
+  glVertex2f(chartLeft + chartWidth, targetY);
+  glEnd();
+
+  label->setText(text.str());
+  label->setPosition(Coord(left + PADDING, top - PADDING - textHeight / 2));
+  label->setSize(Size(chartWidth, textHeight));
+  label->setSizeForOutAlign(Size(0, 0, 0));
+  label->draw(lod, camera);
+
+  glPopAttrib();
+}
+} // namespace tlp
@@ -16,6 +16,12 @@
  * See the GNU General Public License for more details.
  *
  */
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+
 #include <tulip/GlGlyphRenderer.h>
 #include <tulip/GlGraphInputData.h>
 #include <tulip/GlGraphRenderingParameters.h>
@@ -23,6 +29,10 @@
 #include <tulip/Glyph.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlBox.h>
+#include <tulip/GlyphGeometry.h>
+#include <tulip/GlTextureManager.h>
+#include <tulip/GlFrameProfiler.h>
+#include <tulip/OpenGlConfigManager.h>
 
 using namespace std;
 
@@ -75,16 +85,108 @@ static string glyphShaderSrc =
   "}"
   ;
 
+// the per instance attributes replace the uniform variables of the shader above,
+// the lighting of the fixed pipeline is emulated for the lit glyphs
+static string instancedGlyphShaderSrc =
+  "#version 120\n"
+
+  "attribute vec3 instancePos;"
+  "attribute vec3 instanceSize;"
+  "attribute vec4 instanceRot;"
+  "attribute vec4 instanceColor;"
+  "uniform bool lighting;"
+
+  "mat3 rotationMatrix(vec3 rotVector, float rotAngle) {"
+  "   mat3 ret;"
+  "   float c = cos(rotAngle);"
+  "   float s = sin(rotAngle);"
+  "   ret[0][0] = rotVector[0]*rotVector[0]*(1.0 - c) + c;"
+  "   ret[1][0] = rotVector[0]*rotVector[1]*(1.0 - c) - rotVector[2]*s;"
+  "   ret[2][0] = rotVector[0]*rotVector[2]*(1.0 - c) + rotVector[1]*s;"
+  "   ret[0][1] = rotVector[1]*rotVector[0]*(1.0 - c) + rotVector[2]*s;"
+  "   ret[1][1] = rotVector[1]*rotVector[1]*(1.0 - c) + c;"
+  "   ret[2][1] = rotVector[1]*rotVector[2]*(1.0 - c) - rotVector[0]*s;"
+  "   ret[0][2] = rotVector[0]*rotVector[2]*(1.0 - c) - rotVector[1]*s;"
+  "   ret[1][2] = rotVector[1]*rotVector[2]*(1.0 - c) + rotVector[0]*s;"
+  "   ret[2][2] = rotVector[2]*rotVector[2]*(1.0 - c) + c;"
+  "   return ret;"
+  "}"
+
+  "void main() {"
+  "   mat3 rot = rotationMatrix(instanceRot.xyz, instanceRot.w);"
+  "   vec4 vertex = vec4(instancePos + rot * (instanceSize * gl_Vertex.xyz), 1.0);"
+  "   gl_Position = gl_ModelViewProjectionMatrix * vertex;"
+  "   gl_TexCoord[0] = gl_MultiTexCoord0;"
+  "   if (lighting) {"
+  "      vec3 normal = normalize(gl_NormalMatrix * (rot * (gl_Normal / max(abs(instanceSize), vec3(1e-6)))));"
+  "      vec4 lightPos = gl_LightSource[0].position;"
+  "      vec3 lightDir = lightPos.xyz;"
+  "      if (lightPos.w != 0.0)"
+  "         lightDir -= (gl_ModelViewMatrix * vertex).xyz;"
+  "      vec4 light = gl_LightModel.ambient + gl_LightSource[0].ambient +"
+  "                   gl_LightSource[0].diffuse * max(dot(normal, normalize(lightDir)), 0.0);"
+  "      gl_FrontColor = vec4(instanceColor.rgb * light.rgb, instanceColor.a);"
+  "   } else {"
+  "      gl_FrontColor = instanceColor;"
+  "   }"
+  "}"
+  ;
+
 // clang-format on
 
 namespace tlp {
 
+bool GlGlyphRenderer::_instancedRenderingEnabled(true);
 GlShaderProgram *GlGlyphRenderer::_glyphShader(nullptr);
+GlShaderProgram *GlGlyphRenderer::_instancedGlyphShader(nullptr);
 GlBox *GlGlyphRenderer::_selectionBox(nullptr);
 
+// the data of a glyph instance as stored in the instances buffer
+struct GlyphInstance {
+  GlyphInstance(const Coord &p, const Size &s, const Coord &rotVector, float rotAngle,
+                const Color &fill, const Color &border) {
+    for (unsigned int i = 0; i < 3; ++i) {
+      pos[i] = p[i];
+      size[i] = s[i];
+      rot[i] = rotVector[i];
+    }
+
+    rot[3] = rotAngle;
+
+    for (unsigned int i = 0; i < 4; ++i) {
+      fillColor[i] = fill[i];
+      borderColor[i] = border[i];
+    }
+  }
+
+  float pos[3];
+  float size[3];
+  // rotation axis and angle in radians
+  float rot[4];
+  unsigned char fillColor[4];
+  unsigned char borderColor[4];
+};
+
+GlGlyphRenderer::~GlGlyphRenderer() {
+  for (auto geometries : {&_nodeGlyphsGeometry, &_edgeExtremityGlyphsGeometry}) {
+    for (auto &it : *geometries) {
+      if (it.second.fillBuffer)
+        glDeleteBuffers(1, &it.second.fillBuffer);
+
+      if (it.second.outlineBuffer)
+        glDeleteBuffers(1, &it.second.outlineBuffer);
+    }
+  }
+
+  if (_instancesBuffer)
+    glDeleteBuffers(1, &_instancesBuffer);
+}
+
 void GlGlyphRenderer::startRendering() {
   _nodeGlyphsToRender.clear();
   _edgeExtremityGlyphsToRender.clear();
+  _instancedNodeGlyphsToRender.clear();
+  _instancedEdgeExtremityGlyphsToRender.clear();
   _nodeGlyphsToRender.reserve(_inputData->getGraph()->numberOfNodes());
   _edgeExtremityGlyphsToRender.reserve(_inputData->getGraph()->numberOfEdges());
 
@@ -98,30 +200,284 @@ void GlGlyphRenderer::startRendering() {
   if (_glyphShader && _glyphShader->isLinked() && !GlShaderProgram::getCurrentActiveShader()) {
     _renderingStarted = true;
   }
+
+  if (_renderingStarted && _instancedRenderingEnabled && _instancedGlyphShader == nullptr &&
+      OpenGlConfigManager::isExtensionSupported("GL_ARB_instanced_arrays") &&
+      OpenGlConfigManager::isExtensionSupported("GL_ARB_draw_instanced")) {
+    _instancedGlyphShader = new GlShaderProgram();
+    _instancedGlyphShader->addShaderFromSourceCode(Vertex, instancedGlyphShaderSrc);
+    _instancedGlyphShader->link();
+    _instancedGlyphShader->printInfoLog();
+  }
+
+  _instancedRendering = _renderingStarted && _instancedRenderingEnabled && _instancedGlyphShader &&
+                        _instancedGlyphShader->isLinked();
 }
 
 bool GlGlyphRenderer::renderingHasStarted() {
   return _renderingStarted;
 }
 
+GlGlyphRenderer::InstancedGeometry
+GlGlyphRenderer::createInstancedGeometry(const GlyphGeometry &geometry) {
+  InstancedGeometry instancedGeometry;
+  instancedGeometry.nbFillVertices = geometry.fillVertices.size();
+  instancedGeometry.nbOutlineVertices = geometry.outlineVertices.size();
+  instancedGeometry.lighting = geometry.lighting;
+
+  if (instancedGeometry.nbFillVertices) {
+    // interleave vertices, normals and texture coordinates
+    vector<float> data;
+    data.reserve(instancedGeometry.nbFillVertices * 8);
+
+    for (unsigned int i = 0; i < instancedGeometry.nbFillVertices; ++i) {
+      const Coord &v = geometry.fillVertices[i];
+      const Coord &n = geometry.fillNormals[i];
+      const Vec2f &t = geometry.fillTexCoords[i];
+      data.insert(data.end(), {v[0], v[1], v[2], n[0], n[1], n[2], t[0], t[1]});
+    }
+
+    glGenBuffers(1, &instancedGeometry.fillBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instancedGeometry.fillBuffer);
+    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
+  }
+
+  if (instancedGeometry.nbOutlineVertices) {
+    glGenBuffers(1, &instancedGeometry.outlineBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instancedGeometry.outlineBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instancedGeometry.nbOutlineVertices * sizeof(Coord),
+                 geometry.outlineVertices.data(), GL_STATIC_DRAW);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  return instancedGeometry;
+}
+
+bool GlGlyphRenderer::hasInstancedGeometry(Glyph *glyph) {
+  if (!_instancedRendering)
+    return false;
+
+  auto it = _nodeGlyphsGeometry.find(glyph->id());
+
+  if (it == _nodeGlyphsGeometry.end()) {
+    GlyphGeometry geometry;
+    it = _nodeGlyphsGeometry
+             .emplace(glyph->id(), glyph->getGeometry(geometry) ? createInstancedGeometry(geometry)
+                                                                : InstancedGeometry())
+             .first;
+  }
+
+  return it->second.nbFillVertices != 0;
+}
+
+bool GlGlyphRenderer::hasInstancedGeometry(EdgeExtremityGlyph *glyph) {
+  if (!_instancedRendering)
+    return false;
+
+  auto it = _edgeExtremityGlyphsGeometry.find(glyph->id());
+
+  if (it == _edgeExtremityGlyphsGeometry.end()) {
+    GlyphGeometry geometry;
+    it = _edgeExtremityGlyphsGeometry
+             .emplace(glyph->id(), glyph->getGeometry(geometry) ? createInstancedGeometry(geometry)
+                                                                : InstancedGeometry())
+             .first;
+  }
+
+  return it->second.nbFillVertices != 0;
+}
+
 void GlGlyphRenderer::addNodeGlyphRendering(Glyph *glyph, node n, float lod, const Coord &nodePos,
                                             const Size &nodeSize, float nodeRot, bool selected) {
-  _nodeGlyphsToRender.emplace_back(glyph, n, lod, nodePos, nodeSize, nodeRot, selected);
+  if (hasInstancedGeometry(glyph))
+    _instancedNodeGlyphsToRender.emplace_back(glyph, n, lod, nodePos, nodeSize, nodeRot, selected);
+  else
+    _nodeGlyphsToRender.emplace_back(glyph, n, lod, nodePos, nodeSize, nodeRot, selected);
 }
 
 void GlGlyphRenderer::addEdgeExtremityGlyphRendering(EdgeExtremityGlyph *glyph, edge e, node source,
                                                      Color glyphColor, Color glyphBorderColor,
                                                      float lod, Coord beginAnchor, Coord srcAnchor,
                                                      Size size, bool selected) {
-  _edgeExtremityGlyphsToRender.emplace_back(glyph, e, source, glyphColor, glyphBorderColor, lod,
-                                            beginAnchor, srcAnchor, size, selected);
+  if (hasInstancedGeometry(glyph))
+    _instancedEdgeExtremityGlyphsToRender.emplace_back(glyph, e, source, glyphColor,
+                                                       glyphBorderColor, lod, beginAnchor,
+                                                       srcAnchor, size, selected);
+  else
+    _edgeExtremityGlyphsToRender.emplace_back(glyph, e, source, glyphColor, glyphBorderColor, lod,
+                                              beginAnchor, srcAnchor, size, selected);
 }
 
-void GlGlyphRenderer::endRendering() {
+// compute the position and the rotation of an edge extremity glyph
+static void edgeExtremityGlyphTransform(const EdgeExtremityGlyphData &glyphData, Coord &pos,
+                                        Coord &rotVector, float &rotAngle) {
+  Coord &&dir = glyphData.srcAnchor - glyphData.beginAnchor;
+
+  if (dir.norm() > 0) {
+    dir /= dir.norm();
+  }
+
+  rotVector = dir ^ Coord(1, 0, 0);
+
+  if (rotVector.norm() > 0) {
+    rotVector /= rotVector.norm();
+  }
+
+  pos = glyphData.srcAnchor - glyphData.size / 2.f * dir;
+  rotAngle = -acos(dir.dotProduct(Coord(1, 0, 0)));
+}
+
+void GlGlyphRenderer::renderInstancedGlyphs() {
+  GlGraphRenderingParameters *parameters = _inputData->parameters;
+  const string &texturePath = parameters->getTexturePath();
+
+  // group the instances sharing the same geometry, stencil, texture and border width
+  typedef std::tuple<const InstancedGeometry *, unsigned int, string, float> GroupKey;
+  map<GroupKey, vector<GlyphInstance>> groups;
+
+  for (const NodeGlyphData &glyphData : _instancedNodeGlyphsToRender) {
+    node n = glyphData.n;
+    const string &texture = _inputData->getElementTexture()->getNodeValue(n);
+    GroupKey key(&_nodeGlyphsGeometry[glyphData.glyph->id()],
+                 glyphData.selected ? parameters->getSelectedNodesStencil()
+                                    : parameters->getNodesStencil(),
+                 texture.empty() ? texture : texturePath + texture,
+                 _inputData->getElementBorderWidth()->getNodeValue(n));
+    groups[key].emplace_back(glyphData.nodePos, glyphData.nodeSize, Coord(0, 0, 1),
+                             float(glyphData.nodeRot * M_PI / 180.),
+                             _inputData->getElementColor()->getNodeValue(n),
+                             _inputData->getElementBorderColor()->getNodeValue(n));
+  }
+
+  for (const EdgeExtremityGlyphData &glyphData : _instancedEdgeExtremityGlyphsToRender) {
+    edge e = glyphData.e;
+    const string &texture = _inputData->getElementTexture()->getEdgeValue(e);
+    GroupKey key(&_edgeExtremityGlyphsGeometry[glyphData.glyph->id()],
+                 glyphData.selected ? parameters->getSelectedEdgesStencil()
+                                    : parameters->getEdgesStencil(),
+                 texture.empty() ? texture : texturePath + texture,
+                 _inputData->getElementBorderWidth()->getEdgeValue(e));
+    Coord pos, rotVector;
+    float rotAngle;
+    edgeExtremityGlyphTransform(glyphData, pos, rotVector, rotAngle);
+    groups[key].emplace_back(pos, glyphData.size, rotVector, rotAngle, glyphData.glyphColor,
+                             glyphData.glyphBorderColor);
+  }
+
+  if (groups.empty())
+    return;
+
+  // upload all the instances at once
+  vector<GlyphInstance> instances;
+  instances.reserve(_instancedNodeGlyphsToRender.size() +
+                    _instancedEdgeExtremityGlyphsToRender.size());
+
+  for (const auto &group : groups)
+    instances.insert(instances.end(), group.second.begin(), group.second.end());
+
+  if (_instancesBuffer == 0)
+    glGenBuffers(1, &_instancesBuffer);
+
+  glBindBuffer(GL_ARRAY_BUFFER, _instancesBuffer);
+  glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(GlyphInstance), instances.data(),
+               GL_STREAM_DRAW);
+
+  _instancedGlyphShader->activate();
+  GLuint programId = _instancedGlyphShader->getShaderProgramId();
+  GLint posLoc = glGetAttribLocation(programId, "instancePos");
+  GLint sizeLoc = glGetAttribLocation(programId, "instanceSize");
+  GLint rotLoc = glGetAttribLocation(programId, "instanceRot");
+  GLint colorLoc = glGetAttribLocation(programId, "instanceColor");
+  GLint locs[] = {posLoc, sizeLoc, rotLoc, colorLoc};
+
+  glPushAttrib(GL_ENABLE_BIT | GL_LINE_BIT);
+  glDisable(GL_CULL_FACE);
+  glEnableClientState(GL_VERTEX_ARRAY);
+
+  for (auto loc : locs) {
+    glEnableVertexAttribArray(loc);
+    glVertexAttribDivisorARB(loc, 1);
+  }
+
+  size_t first = 0;
+
+  for (const auto &group : groups) {
+    const InstancedGeometry *geometry = std::get<0>(group.first);
+    const string &texture = std::get<2>(group.first);
+    float borderWidth = std::get<3>(group.first);
+    GLsizei nbInstances = group.second.size();
+
+    glStencilFunc(GL_LEQUAL, std::get<1>(group.first), 0xFFFF);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _instancesBuffer);
+    const char *instancesOffset =
+        static_cast<const char *>(nullptr) + first * sizeof(GlyphInstance);
+    glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                          instancesOffset + offsetof(GlyphInstance, pos));
+    glVertexAttribPointer(sizeLoc, 3, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                          instancesOffset + offsetof(GlyphInstance, size));
+    glVertexAttribPointer(rotLoc, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                          instancesOffset + offsetof(GlyphInstance, rot));
+    glVertexAttribPointer(colorLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphInstance),
+                          instancesOffset + offsetof(GlyphInstance, fillColor));
+
+    // the filled triangles
+    glBindBuffer(GL_ARRAY_BUFFER, geometry->fillBuffer);
+    glVertexPointer(3, GL_FLOAT, 8 * sizeof(float), nullptr);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, 8 * sizeof(float),
+                    static_cast<const char *>(nullptr) + 3 * sizeof(float));
+
+    bool textured = !texture.empty() && GlTextureManager::activateTexture(texture);
+
+    if (textured) {
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      glTexCoordPointer(2, GL_FLOAT, 8 * sizeof(float),
+                        static_cast<const char *>(nullptr) + 6 * sizeof(float));
+    }
 
+    _instancedGlyphShader->setUniformBool("lighting", geometry->lighting);
+    glDrawArraysInstancedARB(GL_TRIANGLES, 0, geometry->nbFillVertices, nbInstances);
+
+    if (textured) {
+      glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+      GlTextureManager::deactivateTexture();
+    }
+
+    glDisableClientState(GL_NORMAL_ARRAY);
+
+    // the outline segments
+    if (borderWidth > 0 && geometry->nbOutlineVertices) {
+      glBindBuffer(GL_ARRAY_BUFFER, _instancesBuffer);
+      glVertexAttribPointer(colorLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphInstance),
+                            instancesOffset + offsetof(GlyphInstance, borderColor));
+      glBindBuffer(GL_ARRAY_BUFFER, geometry->outlineBuffer);
+      glVertexPointer(3, GL_FLOAT, 0, nullptr);
+      _instancedGlyphShader->setUniformBool("lighting", false);
+      glLineWidth(borderWidth);
+      glDrawArraysInstancedARB(GL_LINES, 0, geometry->nbOutlineVertices, nbInstances);
+    }
+
+    first += nbInstances;
+  }
+
+  for (auto loc : locs) {
+    glVertexAttribDivisorARB(loc, 0);
+    glDisableVertexAttribArray(loc);
+  }
+
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glPopAttrib();
+  _instancedGlyphShader->deactivate();
+}
+
+void GlGlyphRenderer::endRendering() {
   if (!_renderingStarted)
     return;
 
+  GlFrameProfiler::Scope profilingScope("glyphs rendering");
+
   if (!_selectionBox) {
     _selectionBox = new GlBox(Coord(0, 0, 0), Size(1, 1, 1), Color(0, 0, 255, 255),
                               Color(0, 255, 0, 255), false, true);
@@ -130,8 +486,25 @@ void GlGlyphRenderer::endRendering() {
 
   const Color &colorSelect = _inputData->parameters->getSelectionColor();
 
+  if (_instancedRendering)
+    renderInstancedGlyphs();
+
   _glyphShader->activate();
 
+  // the selection boxes of the nodes rendered with instancing
+  for (const NodeGlyphData &glyphData : _instancedNodeGlyphsToRender) {
+    if (glyphData.selected) {
+      glStencilFunc(GL_LEQUAL, _inputData->parameters->getSelectedNodesStencil(), 0xFFFF);
+      _glyphShader->setUniformVec3Float("pos", glyphData.nodePos);
+      _glyphShader->setUniformVec3Float("size", glyphData.nodeSize);
+      _glyphShader->setUniformVec3Float("rotVector", Coord(0, 0, 1));
+      _glyphShader->setUniformFloat("rotAngle", float(glyphData.nodeRot * M_PI / 180.));
+      _selectionBox->setStencil(_inputData->parameters->getSelectedNodesStencil() - 1);
+      _selectionBox->setOutlineColor(colorSelect);
+      _selectionBox->draw(10, nullptr);
+    }
+  }
+
   for (size_t i = 0; i < _nodeGlyphsToRender.size(); ++i) {
     const NodeGlyphData &glyphData = _nodeGlyphsToRender[i];
 
@@ -144,7 +517,7 @@ void GlGlyphRenderer::endRendering() {
     _glyphShader->setUniformVec3Float("pos", glyphData.nodePos);
     _glyphShader->setUniformVec3Float("size", glyphData.nodeSize);
     _glyphShader->setUniformVec3Float("rotVector", Coord(0, 0, 1));
-    _glyphShader->setUniformFloat("rotAngle", glyphData.nodeRot);
+    _glyphShader->setUniformFloat("rotAngle", float(glyphData.nodeRot * M_PI / 180.));
 
     if (glyphData.selected) {
       _selectionBox->setStencil(_inputData->parameters->getSelectedNodesStencil() - 1);
@@ -164,22 +537,14 @@ void GlGlyphRenderer::endRendering() {
       glStencilFunc(GL_LEQUAL, _inputData->parameters->getEdgesStencil(), 0xFFFF);
     }
 
-    Coord &&dir = glyphData.srcAnchor - glyphData.beginAnchor;
-
-    if (dir.norm() > 0) {
-      dir /= dir.norm();
-    }
-
-    Coord &&cross = dir ^ Coord(1, 0, 0);
-
-    if (cross.norm() > 0) {
-      cross /= cross.norm();
-    }
+    Coord pos, rotVector;
+    float rotAngle;
+    edgeExtremityGlyphTransform(glyphData, pos, rotVector, rotAngle);
 
-    _glyphShader->setUniformVec3Float("pos", glyphData.srcAnchor - glyphData.size / 2.f * dir);
+    _glyphShader->setUniformVec3Float("pos", pos);
     _glyphShader->setUniformVec3Float("size", glyphData.size);
-    _glyphShader->setUniformVec3Float("rotVector", cross);
-    _glyphShader->setUniformFloat("rotAngle", -acos(dir.dotProduct(Coord(1, 0, 0))));
+    _glyphShader->setUniformVec3Float("rotVector", rotVector);
+    _glyphShader->setUniformFloat("rotAngle", rotAngle);
     glyphData.glyph->draw(glyphData.e, glyphData.source, glyphData.glyphColor,
                           glyphData.glyphBorderColor, glyphData.lod);
   }
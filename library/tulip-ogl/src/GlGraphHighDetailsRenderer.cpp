@@ -16,6 +16,8 @@
  * See the GNU General Public License for more details.
  *
  */
+#include <GL/glew.h>
+
 #include <algorithm>
 #include <array>
 
@@ -34,6 +36,9 @@
 #include <tulip/GlGraphRenderingParameters.h>
 #include <tulip/GlGlyphRenderer.h>
 #include <tulip/OpenGlConfigManager.h>
+#include <tulip/GlPickingBuffer.h>
+#include <tulip/ParallelTools.h>
+#include <tulip/GlFrameProfiler.h>
 
 using namespace std;
 
@@ -163,6 +168,7 @@ GlGraphHighDetailsRenderer::~GlGraphHighDetailsRenderer() {
 }
 //===================================================================
 void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
+  GlFrameProfiler::Scope profilingScope("graph rendering");
 
   if (!inputData->renderingParameters()->isAntialiased()) {
     OpenGlConfigManager::deactivateAntiAliasing();
@@ -184,6 +190,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
     lodCalculator->setScene(*fakeScene);
   }
 
+  GlFrameProfiler::beginSection("graph LOD computation");
   lodCalculator->clear();
 
   if (!selectionDrawActivate) {
@@ -212,6 +219,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
   }
 
   LayersLODVector &layersLODVector = lodCalculator->getResult();
+  GlFrameProfiler::endSection();
 
   auto vertexArrayManager = inputData->getGlVertexArrayManager();
   bool vertexArrayManagerActivated = vertexArrayManager->isActivated();
@@ -229,6 +237,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
   // VertexArrayManager update
   if (vertexArrayManager->haveToCompute()) {
+    GlFrameProfiler::Scope profilingScope("vertex arrays computation");
     visitGraph(vertexArrayManager, true);
     vertexArrayManager->setHaveToComputeAll(false);
   }
@@ -244,6 +253,25 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
                            !inputData->getElementLayout()->hasNonDefaultValuatedNodes() &&
                            !inputData->getElementSize()->hasNonDefaultValuatedNodes();
 
+  // the elements too small to be seen individually are aggregated in density splats,
+  // except when picking or when the drawing order matters
+  float aggregationThreshold = 0;
+
+  if (!selectionDrawActivate && !renderOnlyOneNode && !metric &&
+      !inputData->parameters->isElementZOrdered())
+    aggregationThreshold = inputData->parameters->getDensityAggregationThreshold();
+
+  float nodesAggregationThreshold = displayNodes ? aggregationThreshold : 0;
+  float edgesAggregationThreshold = displayEdges ? aggregationThreshold : 0;
+
+  if (aggregationThreshold > 0 && (displayNodes || displayEdges)) {
+    GlFrameProfiler::Scope profilingScope("density splats");
+    drawDensitySplats(layersLODVector[0], camera, aggregationThreshold, displayNodes,
+                      displayEdges);
+  }
+
+  GlFrameProfiler::beginSection("elements drawing");
+
   if (!inputData->parameters->isElementZOrdered()) {
 
     vector<pair<node, float>> nodesMetricOrdered;
@@ -252,7 +280,8 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
     // draw nodes and metanodes
     for (auto &it : layersLODVector[0].nodesLODVector) {
 
-      if ((it.lod <= 0) || (filteringProperty && filteringProperty->getNodeValue(node(it.id))))
+      if ((it.lod <= 0) || (it.lod < nodesAggregationThreshold) ||
+          (filteringProperty && filteringProperty->getNodeValue(node(it.id))))
         continue;
 
       if (displayNodes ||
@@ -264,7 +293,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
             (*selectionIdMap)[*selectionCurrentId] =
                 SelectedEntity(graph, it.id, SelectedEntity::NODE_SELECTED);
-            glLoadName(*selectionCurrentId);
+            GlPickingBuffer::loadName(*selectionCurrentId);
             (*selectionCurrentId)++;
           }
 
@@ -296,7 +325,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
           (*selectionIdMap)[*selectionCurrentId] =
               SelectedEntity(graph, it.first.id, SelectedEntity::NODE_SELECTED);
-          glLoadName(*selectionCurrentId);
+          GlPickingBuffer::loadName(*selectionCurrentId);
           (*selectionCurrentId)++;
         }
 
@@ -310,8 +339,8 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
       // draw edges
       for (auto &it : layersLODVector[0].edgesLODVector) {
 
-        if ((it.lod <= 0) || (filteringProperty && filteringProperty->getEdgeValue(edge(it.id))) ||
-            !displayEdges)
+        if ((it.lod <= 0) || (it.lod < edgesAggregationThreshold) ||
+            (filteringProperty && filteringProperty->getEdgeValue(edge(it.id))) || !displayEdges)
           continue;
 
         if (!metric) {
@@ -321,7 +350,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
             (*selectionIdMap)[*selectionCurrentId] =
                 SelectedEntity(graph, it.id, SelectedEntity::EDGE_SELECTED);
-            glLoadName(*selectionCurrentId);
+            GlPickingBuffer::loadName(*selectionCurrentId);
             (*selectionCurrentId)++;
           }
 
@@ -349,7 +378,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
             (*selectionIdMap)[*selectionCurrentId] =
                 SelectedEntity(graph, it.first.id, SelectedEntity::EDGE_SELECTED);
-            glLoadName(*selectionCurrentId);
+            GlPickingBuffer::loadName(*selectionCurrentId);
             (*selectionCurrentId)++;
           }
 
@@ -419,7 +448,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
             (*selectionIdMap)[*selectionCurrentId] =
                 SelectedEntity(graph, entity->id, SelectedEntity::NODE_SELECTED);
-            glLoadName(*selectionCurrentId);
+            GlPickingBuffer::loadName(*selectionCurrentId);
             (*selectionCurrentId)++;
           }
 
@@ -446,7 +475,7 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
 
           (*selectionIdMap)[*selectionCurrentId] =
               SelectedEntity(graph, entity->id, SelectedEntity::EDGE_SELECTED);
-          glLoadName(*selectionCurrentId);
+          GlPickingBuffer::loadName(*selectionCurrentId);
           (*selectionCurrentId)++;
         }
 
@@ -458,6 +487,8 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
     glDepthMask(GL_TRUE);
   }
 
+  GlFrameProfiler::endSection();
+
   if (!selectionDrawActivate) {
     if (vertexArrayManagerActivated) {
       if (inputData->renderingParameters()->isEdgeFrontDisplay()) {
@@ -485,18 +516,25 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
     labelDensityAtZero = false;
 
   if (!labelDensityAtZero) {
+    GlFrameProfiler::Scope profilingScope("labels rendering");
     glPushAttrib(GL_ALL_ATTRIB_BITS);
     glDisable(GL_LIGHTING);
     glDepthFunc(GL_ALWAYS);
     glDisable(GL_CULL_FACE);
     glDisable(GL_COLOR_MATERIAL);
 
+    // the labels rendered with signed distance field atlases
+    // are gathered in a single vertex buffer
+    GlLabel::beginBatchRendering();
+
     // Draw Labels for selected entities
     drawLabelsForComplexEntities(true, &occlusionTest, layersLODVector[0]);
 
     // Draw Labels for unselected entities
     drawLabelsForComplexEntities(false, &occlusionTest, layersLODVector[0]);
 
+    GlLabel::endBatchRendering();
+
     glPopAttrib();
   }
 
@@ -505,6 +543,134 @@ void GlGraphHighDetailsRenderer::draw(float, Camera *camera) {
   OpenGlConfigManager::activateAntiAliasing();
 }
 //===================================================================
+void GlGraphHighDetailsRenderer::drawDensitySplats(LayerLODUnit &layerLODUnit, Camera *camera,
+                                                   float threshold, bool aggregateNodes,
+                                                   bool aggregateEdges) {
+  const Vec4i &viewport = camera->getViewport();
+
+  if (viewport[2] <= 0 || viewport[3] <= 0)
+    return;
+
+  MatrixGL transformMatrix;
+  camera->getTransformMatrix(viewport, transformMatrix);
+
+  unsigned int tileSize = std::max(1u, static_cast<unsigned int>(ceil(threshold)));
+  unsigned int nbColumns = (viewport[2] + tileSize - 1) / tileSize;
+  unsigned int nbRows = (viewport[3] + tileSize - 1) / tileSize;
+
+  vector<ComplexEntityLODUnit> &nodesLOD = layerLODUnit.nodesLODVector;
+  vector<ComplexEntityLODUnit> &edgesLOD = layerLODUnit.edgesLODVector;
+  size_t nbNodes = aggregateNodes ? nodesLOD.size() : 0;
+  size_t nbEdges = aggregateEdges ? edgesLOD.size() : 0;
+  BooleanProperty *filteringProperty = inputData->parameters->getDisplayFilteringProperty();
+
+  // the projection of the elements is done in parallel,
+  // the elements ignored get the UINT_MAX tile
+  elementsTiles.resize(nbNodes + nbEdges);
+  TLP_PARALLEL_MAP_INDICES(nbNodes + nbEdges, [&](unsigned int i) {
+    bool isNode = i < nbNodes;
+    const ComplexEntityLODUnit &unit = isNode ? nodesLOD[i] : edgesLOD[i - nbNodes];
+    unsigned int tile = UINT_MAX;
+
+    if (unit.lod > 0 && unit.lod < threshold &&
+        (!filteringProperty || !(isNode ? filteringProperty->getNodeValue(node(unit.id))
+                                        : filteringProperty->getEdgeValue(edge(unit.id))))) {
+      Coord center = projectPoint((unit.boundingBox[0] + unit.boundingBox[1]) / 2.f,
+                                  transformMatrix, viewport);
+      float x = center[0] - viewport[0];
+      float y = center[1] - viewport[1];
+
+      if (x >= 0 && y >= 0 && x < viewport[2] && y < viewport[3])
+        tile = (unsigned(y) / tileSize) * nbColumns + unsigned(x) / tileSize;
+    }
+
+    elementsTiles[i] = tile;
+  });
+
+  // accumulate the elements count and colors of each tile
+  ColorProperty *colors = inputData->getElementColor();
+  BooleanProperty *selection = inputData->getElementSelected();
+  const Color &selectionColor = inputData->parameters->getSelectionColor();
+  tilesSums.assign(size_t(nbColumns) * nbRows * 5, 0.f);
+
+  for (size_t i = 0; i < elementsTiles.size(); ++i) {
+    unsigned int tile = elementsTiles[i];
+
+    if (tile == UINT_MAX)
+      continue;
+
+    bool isNode = i < nbNodes;
+    unsigned int id = isNode ? nodesLOD[i].id : edgesLOD[i - nbNodes].id;
+    bool selected = isNode ? selection->getNodeValue(node(id)) : selection->getEdgeValue(edge(id));
+    const Color &color =
+        selected ? selectionColor
+                 : (isNode ? colors->getNodeValue(node(id)) : colors->getEdgeValue(edge(id)));
+    float *sums = &tilesSums[size_t(tile) * 5];
+    sums[0] += 1;
+
+    for (unsigned int j = 0; j < 4; ++j)
+      sums[j + 1] += color[j];
+  }
+
+  float maxCount = 0;
+
+  for (size_t i = 0; i < tilesSums.size(); i += 5)
+    maxCount = std::max(maxCount, tilesSums[i]);
+
+  if (maxCount == 0)
+    return;
+
+  // one splat per non empty tile, the mean color of its elements
+  // with an opacity increasing with their number
+  vector<Vec2f> points;
+  vector<Color> splatColors;
+  float logMaxCount = log(1.f + maxCount);
+
+  for (unsigned int tile = 0; tile < nbColumns * nbRows; ++tile) {
+    const float *sums = &tilesSums[size_t(tile) * 5];
+
+    if (sums[0] == 0)
+      continue;
+
+    float density = 0.3f + 0.7f * log(1.f + sums[0]) / logMaxCount;
+    points.emplace_back(viewport[0] + (tile % nbColumns + 0.5f) * tileSize,
+                        viewport[1] + (tile / nbColumns + 0.5f) * tileSize);
+    splatColors.emplace_back(uchar(sums[1] / sums[0]), uchar(sums[2] / sums[0]),
+                             uchar(sums[3] / sums[0]), uchar(density * sums[4] / sums[0]));
+  }
+
+  glPushAttrib(GL_ENABLE_BIT | GL_POINT_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_TEXTURE_2D);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_POINT_SMOOTH);
+  glStencilFunc(GL_LEQUAL, inputData->parameters->getNodesStencil(), 0xFFFF);
+  glPointSize(float(tileSize));
+
+  glMatrixMode(GL_PROJECTION);
+  glPushMatrix();
+  glLoadIdentity();
+  glOrtho(viewport[0], viewport[0] + viewport[2], viewport[1], viewport[1] + viewport[3], -1, 1);
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glLoadIdentity();
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(2, GL_FLOAT, 0, points.data());
+  glColorPointer(4, GL_UNSIGNED_BYTE, 0, splatColors.data());
+  glDrawArrays(GL_POINTS, 0, GLsizei(points.size()));
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+
+  glPopMatrix();
+  glMatrixMode(GL_PROJECTION);
+  glPopMatrix();
+  glMatrixMode(GL_MODELVIEW);
+  glPopAttrib();
+}
+//===================================================================
 void GlGraphHighDetailsRenderer::selectEntities(Camera *camera, RenderingEntitiesFlag type, int x,
                                                 int y, int w, int h,
                                                 vector<SelectedEntity> &selectedEntities) {
@@ -514,6 +680,26 @@ void GlGraphHighDetailsRenderer::selectEntities(Camera *camera, RenderingEntitie
   unsigned int size =
       inputData->getGraph()->numberOfNodes() + inputData->getGraph()->numberOfEdges();
 
+  // render the ids of the entities in an offscreen buffer if possible,
+  // as many times as needed to find the covered ones
+  if (GlPickingBuffer::begin(w, h, size)) {
+    do {
+      id = 1;
+      initSelectionRendering(type, x, y, w, h, idToEntity, id);
+
+      draw(20, camera);
+    } while (GlPickingBuffer::nextPass());
+
+    vector<unsigned int> hits;
+    GlPickingBuffer::end(hits);
+
+    selectedEntities.reserve(selectedEntities.size() + hits.size());
+    for (auto hit : hits) {
+      selectedEntities.emplace_back(idToEntity[hit]);
+    }
+    return;
+  }
+
   // Allocate memory to store the result of the selection
   vector<std::array<GLuint, 4>> selectBuf(size);
   glSelectBuffer(size * 4, reinterpret_cast<GLuint *>(selectBuf.data()));
@@ -34,8 +34,8 @@ GlGraphRenderingParameters::GlGraphRenderingParameters()
       _metaNodesStencil(0xFFFF), _edgesStencil(0xFFFF), _nodesLabelStencil(0xFFFF),
       _metaNodesLabelStencil(0xFFFF), _edgesLabelStencil(0xFFFF), _labelScaled(false),
       _labelFixedFontSize(false), _labelMinSize(4), _labelMaxSize(30), _labelsDensity(0),
-      _labelsAreBillboarded(false), _fontsPath(tlp::TulipBitmapDir), _texturePath(""),
-      _edgesMaxSizeToNodesSize(true),
+      _labelsAreBillboarded(false), _densityAggregationThreshold(0),
+      _fontsPath(tlp::TulipBitmapDir), _texturePath(""), _edgesMaxSizeToNodesSize(true),
       _selectionColor(GlDefaultSelectionColorManager::getDefaultSelectionColor()),
       _displayFilteringProperty(nullptr), _elementOrderingProperty(nullptr) {}
 // This function should rewritten completly
@@ -74,6 +74,8 @@ DataSet GlGraphRenderingParameters::getParameters() const {
   data.set("selectionColor", _selectionColor);
   data.set("labelsDensity", _labelsDensity);
   data.set("labelsAreBillboarded", _labelsAreBillboarded);
+  // float
+  data.set("densityAggregationThreshold", _densityAggregationThreshold);
   // ordering
   data.set("elementsOrdered", _elementOrdered);
   data.set("elementsOrderedDescending", _elementOrderedDescending);
@@ -189,6 +191,11 @@ void GlGraphRenderingParameters::setParameters(const DataSet &data) {
   if (data.get<int>("labelsDensity", i))
     setLabelsDensity(i);
 
+  float f = 0;
+
+  if (data.get<float>("densityAggregationThreshold", f))
+    setDensityAggregationThreshold(f);
+
   if (data.get<bool>("edgesMaxSizeToNodesSize", b))
     setEdgesMaxSizeToNodesSize(b);
 
@@ -449,6 +456,13 @@ void GlGraphRenderingParameters::setLabelsDensity(int density) {
   _labelsDensity = density;
 }
 //====================================================
+float GlGraphRenderingParameters::getDensityAggregationThreshold() const {
+  return _densityAggregationThreshold;
+}
+void GlGraphRenderingParameters::setDensityAggregationThreshold(float threshold) {
+  _densityAggregationThreshold = threshold;
+}
+//====================================================
 int GlGraphRenderingParameters::getMinSizeOfLabel() const {
   return _labelMinSize;
 }
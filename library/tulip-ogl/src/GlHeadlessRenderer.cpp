@@ -0,0 +1,518 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <GL/glew.h>
+
+#ifdef TULIP_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <zlib.h>
+
+#include <cstring>
+#include <fstream>
+
+#include <tulip/GlHeadlessRenderer.h>
+#include <tulip/GlGraphComposite.h>
+#include <tulip/GlGraphInputData.h>
+#include <tulip/GlVertexArrayManager.h>
+#include <tulip/OpenGlConfigManager.h>
+#include <tulip/GlFrameProfiler.h>
+
+using namespace std;
+
+namespace tlp {
+
+// the maximum number of frames waiting for their callback per encoding thread,
+// the rendering is blocked when it is reached to bound the memory used
+static const unsigned int MAX_QUEUED_FRAMES = 4;
+
+GlHeadlessRenderer::GlHeadlessRenderer(unsigned int nbEncodingThreads)
+    : display(nullptr), context(nullptr), surface(nullptr), width(512), height(512), samples(0),
+      fbo(0), colorBuffer(0), depthBuffer(0), msFbo(0), msColorBuffer(0), msDepthBuffer(0),
+      currentPbo(0), readbackPending(false), mainLayer(new GlLayer("Main")),
+      graphComposite(nullptr), nbRunningCallbacks(0), stopThreads(false) {
+  pbos[0] = pbos[1] = 0;
+  GlLayer *backgroundLayer = new GlLayer("Background");
+  backgroundLayer->setVisible(true);
+  GlLayer *foregroundLayer = new GlLayer("Foreground");
+  foregroundLayer->setVisible(true);
+  backgroundLayer->set2DMode();
+  foregroundLayer->set2DMode();
+  scene.addExistingLayer(backgroundLayer);
+  scene.addExistingLayer(mainLayer);
+  scene.addExistingLayer(foregroundLayer);
+
+  for (unsigned int i = 0; i < max(nbEncodingThreads, 1u); ++i)
+    threads.push_back(thread(&GlHeadlessRenderer::encodingThread, this));
+}
+
+GlHeadlessRenderer::~GlHeadlessRenderer() {
+  if (context != nullptr)
+    flush();
+
+  {
+    lock_guard<mutex> lock(framesMutex);
+    stopThreads = true;
+  }
+  framesAvailable.notify_all();
+
+  for (auto &t : threads)
+    t.join();
+
+#ifdef TULIP_HAVE_EGL
+
+  if (context != nullptr) {
+    // the OpenGL resources of the scene entities
+    // must be released while the context is current
+    mainLayer->getComposite()->reset(true);
+    graphComposite = nullptr;
+    GlFrameProfiler::releaseGpuQueries();
+    releaseFrameBuffers();
+    destroyContext();
+  }
+
+  if (display != nullptr)
+    eglTerminate(display);
+
+#endif
+}
+
+bool GlHeadlessRenderer::init(unsigned int width, unsigned int height, unsigned int samples) {
+  if (context != nullptr) {
+    readPreviousFrame();
+    releaseFrameBuffers();
+    this->samples = samples;
+    this->width = width;
+    this->height = height;
+    return initFrameBuffers();
+  }
+
+  this->width = width;
+  this->height = height;
+  this->samples = samples;
+
+#ifdef TULIP_HAVE_EGL
+  EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  // with Mesa, a display which does not need any window system
+  // (X11, Wayland) can be used
+  const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+  if (clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay)
+      eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+  }
+
+#endif
+
+  if (eglDisplay == EGL_NO_DISPLAY)
+    eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+  if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr)) {
+    errorMessage = "unable to initialize an EGL display";
+    return false;
+  }
+
+  display = eglDisplay;
+
+  if (!eglBindAPI(EGL_OPENGL_API)) {
+    errorMessage = "the EGL display does not support the OpenGL API";
+    return false;
+  }
+
+  // the rendering is done in frame buffer objects,
+  // so the config needs no surface type
+  const EGLint configAttribs[] = {EGL_SURFACE_TYPE,
+                                  0,
+                                  EGL_RED_SIZE,
+                                  8,
+                                  EGL_GREEN_SIZE,
+                                  8,
+                                  EGL_BLUE_SIZE,
+                                  8,
+                                  EGL_ALPHA_SIZE,
+                                  8,
+                                  EGL_RENDERABLE_TYPE,
+                                  EGL_OPENGL_BIT,
+                                  EGL_NONE};
+  EGLConfig config;
+  EGLint nbConfigs = 0;
+
+  if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &nbConfigs) || nbConfigs == 0) {
+    errorMessage = "no EGL config supports the OpenGL rendering";
+    return false;
+  }
+
+  EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, nullptr);
+
+  if (eglContext == EGL_NO_CONTEXT) {
+    errorMessage = "unable to create an OpenGL context";
+    return false;
+  }
+
+  context = eglContext;
+
+  // without the EGL_KHR_surfaceless_context extension,
+  // a dummy pixel buffer surface is needed to make the context current
+  if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+    const EGLint pbufferAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+    EGLSurface pbuffer = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+
+    if (pbuffer != EGL_NO_SURFACE)
+      surface = pbuffer;
+
+    if (pbuffer == EGL_NO_SURFACE || !eglMakeCurrent(eglDisplay, pbuffer, pbuffer, eglContext)) {
+      errorMessage = "unable to make the OpenGL context current";
+      destroyContext();
+      return false;
+    }
+  }
+
+  OpenGlConfigManager::initExtensions();
+
+  if (!OpenGlConfigManager::isExtensionSupported("GL_ARB_framebuffer_object") ||
+      !OpenGlConfigManager::isExtensionSupported("GL_ARB_pixel_buffer_object")) {
+    errorMessage = "the OpenGL implementation does not support frame and pixel buffer objects";
+    destroyContext();
+    return false;
+  }
+
+  return initFrameBuffers();
+#else
+  errorMessage = "Tulip has been built without EGL support";
+  return false;
+#endif
+}
+
+#ifdef TULIP_HAVE_EGL
+// a null context means that the OpenGL functions cannot be called,
+// so it is destroyed when the initialization fails
+void GlHeadlessRenderer::destroyContext() {
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(display, context);
+  context = nullptr;
+
+  if (surface != nullptr) {
+    eglDestroySurface(display, surface);
+    surface = nullptr;
+  }
+}
+#endif
+
+bool GlHeadlessRenderer::initFrameBuffers() {
+  glGenRenderbuffers(1, &colorBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glGenRenderbuffers(1, &depthBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                            depthBuffer);
+  bool ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+  if (ok && samples > 0) {
+    GLint maxSamples = 0;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    GLsizei nbSamples = min(GLsizei(samples), GLsizei(maxSamples));
+    glGenRenderbuffers(1, &msColorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, msColorBuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, nbSamples, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &msDepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, msDepthBuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, nbSamples, GL_DEPTH24_STENCIL8, width,
+                                     height);
+    glGenFramebuffers(1, &msFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, msFbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              msColorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                              msDepthBuffer);
+    ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  }
+
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  glGenBuffers(2, pbos);
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(width) * height * 4, nullptr, GL_STREAM_READ);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (!ok)
+    errorMessage = "unable to create the frame buffer objects";
+
+  return ok;
+}
+
+void GlHeadlessRenderer::releaseFrameBuffers() {
+  glDeleteBuffers(2, pbos);
+  pbos[0] = pbos[1] = 0;
+  glDeleteFramebuffers(1, &fbo);
+  glDeleteRenderbuffers(1, &colorBuffer);
+  glDeleteRenderbuffers(1, &depthBuffer);
+  fbo = colorBuffer = depthBuffer = 0;
+
+  if (msFbo) {
+    glDeleteFramebuffers(1, &msFbo);
+    glDeleteRenderbuffers(1, &msColorBuffer);
+    glDeleteRenderbuffers(1, &msDepthBuffer);
+    msFbo = msColorBuffer = msDepthBuffer = 0;
+  }
+}
+
+void GlHeadlessRenderer::setViewportSize(unsigned int width, unsigned int height) {
+  if (width == this->width && height == this->height)
+    return;
+
+  if (context != nullptr) {
+    // the frame being read back must be delivered
+    // before its pixel buffer is released
+    readPreviousFrame();
+    releaseFrameBuffers();
+    this->width = width;
+    this->height = height;
+    initFrameBuffers();
+  } else {
+    this->width = width;
+    this->height = height;
+  }
+}
+
+void GlHeadlessRenderer::setGraph(Graph *graph) {
+  if (graphComposite != nullptr) {
+    // keep the rendering data already computed
+    if (graphComposite->getGraph() == graph)
+      return;
+
+    mainLayer->deleteGlEntity(graphComposite);
+    delete graphComposite;
+    graphComposite = nullptr;
+  }
+
+  if (graph != nullptr) {
+    graphComposite = new GlGraphComposite(graph);
+    graphComposite->getInputData()->getGlVertexArrayManager()->setHaveToComputeAll(true);
+    mainLayer->addGlEntity(graphComposite, "graph");
+  }
+}
+
+void GlHeadlessRenderer::setBackgroundColor(const Color &color) {
+  scene.setBackgroundColor(color);
+}
+
+Camera &GlHeadlessRenderer::getCamera() {
+  return mainLayer->getCamera();
+}
+
+void GlHeadlessRenderer::renderScene(const ImageCallback &callback, bool centerScene) {
+  if (context == nullptr)
+    return;
+
+  scene.setViewport(0, 0, width, height);
+
+  if (centerScene)
+    scene.centerScene();
+
+  glBindFramebuffer(GL_FRAMEBUFFER, msFbo ? msFbo : fbo);
+  scene.draw();
+
+  if (msFbo) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, msFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  }
+
+  // the pixels are copied asynchronously in the pixel buffer,
+  // so glReadPixels returns without waiting for the end of the rendering
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[currentPbo]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  // the previous frame is now complete
+  readPreviousFrame();
+
+  readbackFrame.width = width;
+  readbackFrame.height = height;
+  readbackFrame.callback = callback;
+  readbackPending = true;
+  currentPbo = 1 - currentPbo;
+}
+
+void GlHeadlessRenderer::readPreviousFrame() {
+  if (!readbackPending)
+    return;
+
+  readbackPending = false;
+
+  PendingFrame frame;
+  frame.width = readbackFrame.width;
+  frame.height = readbackFrame.height;
+  frame.callback = std::move(readbackFrame.callback);
+  frame.pixels.resize(size_t(frame.width) * frame.height * 4);
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[1 - currentPbo]);
+  const unsigned char *data =
+      static_cast<const unsigned char *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+  if (data != nullptr) {
+    // OpenGL rows are ordered from the bottom to the top
+    size_t rowSize = size_t(frame.width) * 4;
+
+    for (unsigned int y = 0; y < frame.height; ++y)
+      memcpy(&frame.pixels[y * rowSize], data + (frame.height - 1 - y) * rowSize, rowSize);
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  {
+    unique_lock<mutex> lock(framesMutex);
+    framesDone.wait(lock, [this] { return frames.size() < MAX_QUEUED_FRAMES * threads.size(); });
+    frames.push_back(std::move(frame));
+  }
+  framesAvailable.notify_one();
+}
+
+void GlHeadlessRenderer::flush() {
+  readPreviousFrame();
+
+  unique_lock<mutex> lock(framesMutex);
+  framesDone.wait(lock, [this] { return frames.empty() && nbRunningCallbacks == 0; });
+}
+
+void GlHeadlessRenderer::encodingThread() {
+  for (;;) {
+    PendingFrame frame;
+
+    {
+      unique_lock<mutex> lock(framesMutex);
+      framesAvailable.wait(lock, [this] { return stopThreads || !frames.empty(); });
+
+      if (frames.empty())
+        return;
+
+      frame = std::move(frames.front());
+      frames.pop_front();
+      ++nbRunningCallbacks;
+    }
+
+    // a frame has been dequeued
+    framesDone.notify_all();
+
+    if (frame.callback)
+      frame.callback(frame.pixels, frame.width, frame.height);
+
+    {
+      lock_guard<mutex> lock(framesMutex);
+      --nbRunningCallbacks;
+    }
+    framesDone.notify_all();
+  }
+}
+
+static void writePNGChunk(ofstream &os, const char *type, const unsigned char *data,
+                          size_t length) {
+  unsigned char header[8] = {
+      static_cast<unsigned char>(length >> 24), static_cast<unsigned char>(length >> 16),
+      static_cast<unsigned char>(length >> 8), static_cast<unsigned char>(length)};
+  memcpy(header + 4, type, 4);
+  uLong crc = crc32(0, header + 4, 4);
+
+  if (length)
+    crc = crc32(crc, data, uInt(length));
+
+  unsigned char footer[4] = {static_cast<unsigned char>(crc >> 24),
+                             static_cast<unsigned char>(crc >> 16),
+                             static_cast<unsigned char>(crc >> 8), static_cast<unsigned char>(crc)};
+  os.write(reinterpret_cast<const char *>(header), 8);
+
+  if (length)
+    os.write(reinterpret_cast<const char *>(data), length);
+
+  os.write(reinterpret_cast<const char *>(footer), 4);
+}
+
+bool GlHeadlessRenderer::savePNG(const string &fileName, const vector<unsigned char> &rgba,
+                                 unsigned int width, unsigned int height) {
+  size_t rowSize = size_t(width) * 4;
+
+  if (rgba.size() < rowSize * height)
+    return false;
+
+  // each row starts with its filter type, none here
+  vector<unsigned char> raw((rowSize + 1) * height);
+
+  for (unsigned int y = 0; y < height; ++y) {
+    raw[y * (rowSize + 1)] = 0;
+    memcpy(&raw[y * (rowSize + 1) + 1], &rgba[y * rowSize], rowSize);
+  }
+
+  uLongf compressedSize = compressBound(uLong(raw.size()));
+  vector<unsigned char> compressed(compressedSize);
+
+  // a fast compression level as the rendering throughput matters more than the files size
+  if (compress2(compressed.data(), &compressedSize, raw.data(), uLong(raw.size()), 1) != Z_OK)
+    return false;
+
+  ofstream os(fileName.c_str(), ios::out | ios::binary);
+
+  if (!os)
+    return false;
+
+  static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  os.write(reinterpret_cast<const char *>(signature), 8);
+
+  // 8 bits per channel, RGBA color type, no interlacing
+  unsigned char ihdr[13] = {static_cast<unsigned char>(width >> 24),
+                            static_cast<unsigned char>(width >> 16),
+                            static_cast<unsigned char>(width >> 8),
+                            static_cast<unsigned char>(width),
+                            static_cast<unsigned char>(height >> 24),
+                            static_cast<unsigned char>(height >> 16),
+                            static_cast<unsigned char>(height >> 8),
+                            static_cast<unsigned char>(height),
+                            8,
+                            6,
+                            0,
+                            0,
+                            0};
+  writePNGChunk(os, "IHDR", ihdr, 13);
+  writePNGChunk(os, "IDAT", compressed.data(), compressedSize);
+  writePNGChunk(os, "IEND", nullptr, 0);
+
+  return bool(os);
+}
+} // namespace tlp
@@ -17,6 +17,10 @@
  *
  */
 
+#include <GL/glew.h>
+
+#include <cstddef>
+
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -40,10 +44,14 @@
 #include <tulip/OcclusionTest.h>
 #include <tulip/OcclusionTest.h>
 #include <tulip/GlTextureManager.h>
+#include <tulip/GlPickingBuffer.h>
 #include <tulip/GlXMLTools.h>
 #include <tulip/TlpTools.h>
 #include <tulip/TulipViewSettings.h>
 #include <tulip/ParallelTools.h>
+#include <tulip/GlShaderProgram.h>
+
+#include <utf8.h>
 
 using namespace std;
 
@@ -90,6 +98,247 @@ static void initTulipFont(std::string &fontName, FTGLPolygonFont *&font, FTOutli
 
 static const int SpaceBetweenLine = 5;
 
+// signed distance field rendering of the labels
+static bool sdfRenderingEnabled = true;
+static bool sdfBatchRendering = false;
+
+struct SdfVertex {
+  float pos[3];
+  float texCoord[2];
+  unsigned char color[4];
+  unsigned char outlineColor[4];
+  float outlineWidth;
+};
+
+// the vertices of the labels using the same font, stencil and depth test
+struct SdfBatch {
+  GlSdfFont *font;
+  int stencil;
+  bool depthTest;
+  vector<SdfVertex> vertices;
+};
+
+static vector<SdfBatch> sdfBatches;
+static GlShaderProgram *sdfShader = nullptr;
+static bool sdfShaderCreated = false;
+static unsigned int sdfVertexBuffer = 0;
+
+static const char *sdfVertexShaderSrc =
+    "#version 120\n"
+    "attribute vec4 outlineColorAttr;\n"
+    "attribute float outlineWidthAttr;\n"
+    "varying vec4 outlineColor;\n"
+    "varying float outlineWidth;\n"
+    "void main() {\n"
+    "  gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+    "  gl_FrontColor = gl_Color;\n"
+    "  gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "  outlineColor = outlineColorAttr;\n"
+    "  outlineWidth = outlineWidthAttr;\n"
+    "}\n";
+
+// the fill and the outline (whose width is given in pixels)
+// are computed from the screen space variation of the distance
+static const char *sdfFragmentShaderSrc =
+    "#version 120\n"
+    "uniform sampler2D atlas;\n"
+    "varying vec4 outlineColor;\n"
+    "varying float outlineWidth;\n"
+    "void main() {\n"
+    "  float dist = texture2D(atlas, gl_TexCoord[0].st).a;\n"
+    "  float pixelDist = max(length(vec2(dFdx(dist), dFdy(dist))), 0.00001);\n"
+    "  float aa = 0.5 * pixelDist;\n"
+    "  float halfOutline = 0.5 * outlineWidth * pixelDist;\n"
+    "  float alpha = smoothstep(0.5 - halfOutline - aa, 0.5 - halfOutline + aa, dist);\n"
+    "  vec4 color = gl_Color;\n"
+    "  if (outlineWidth > 0.0)\n"
+    "    color = mix(outlineColor, gl_Color,\n"
+    "                smoothstep(0.5 + halfOutline - aa, 0.5 + halfOutline + aa, dist));\n"
+    "  gl_FragColor = vec4(color.rgb, color.a * alpha);\n"
+    "}\n";
+
+static GlShaderProgram *getSdfShader() {
+  if (!sdfShaderCreated) {
+    sdfShaderCreated = true;
+
+    if (GlShaderProgram::shaderProgramsSupported()) {
+      sdfShader = new GlShaderProgram();
+      sdfShader->addShaderFromSourceCode(Vertex, sdfVertexShaderSrc);
+      sdfShader->addShaderFromSourceCode(Fragment, sdfFragmentShaderSrc);
+      sdfShader->link();
+
+      if (!sdfShader->isLinked()) {
+        sdfShader->printInfoLog();
+        delete sdfShader;
+        sdfShader = nullptr;
+      }
+    }
+  }
+
+  return sdfShader;
+}
+
+static void renderSdfBatches(vector<SdfBatch> &batches, bool setStencil) {
+  size_t nbVertices = 0;
+
+  for (const SdfBatch &batch : batches)
+    nbVertices += batch.vertices.size();
+
+  if (nbVertices == 0) {
+    batches.clear();
+    return;
+  }
+
+  glPushAttrib(GL_ALL_ATTRIB_BITS);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  // the vertices are given in eye coordinates
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glLoadIdentity();
+
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_LIGHTING);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  // all the vertices are uploaded at once
+  if (sdfVertexBuffer == 0) {
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    sdfVertexBuffer = buffer;
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, sdfVertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, nbVertices * sizeof(SdfVertex), nullptr, GL_STREAM_DRAW);
+  size_t offset = 0;
+
+  for (const SdfBatch &batch : batches) {
+    glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(SdfVertex),
+                    batch.vertices.size() * sizeof(SdfVertex), batch.vertices.data());
+    offset += batch.vertices.size();
+  }
+
+  sdfShader->activate();
+  sdfShader->setUniformInt("atlas", 0);
+  GLuint programId = sdfShader->getShaderProgramId();
+  GLint outlineColorLoc = glGetAttribLocation(programId, "outlineColorAttr");
+  GLint outlineWidthLoc = glGetAttribLocation(programId, "outlineWidthAttr");
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(3, GL_FLOAT, sizeof(SdfVertex),
+                  reinterpret_cast<void *>(offsetof(SdfVertex, pos)));
+  glTexCoordPointer(2, GL_FLOAT, sizeof(SdfVertex),
+                    reinterpret_cast<void *>(offsetof(SdfVertex, texCoord)));
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(SdfVertex),
+                 reinterpret_cast<void *>(offsetof(SdfVertex, color)));
+
+  if (outlineColorLoc != -1) {
+    glEnableVertexAttribArray(outlineColorLoc);
+    glVertexAttribPointer(outlineColorLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SdfVertex),
+                          reinterpret_cast<void *>(offsetof(SdfVertex, outlineColor)));
+  }
+
+  if (outlineWidthLoc != -1) {
+    glEnableVertexAttribArray(outlineWidthLoc);
+    glVertexAttribPointer(outlineWidthLoc, 1, GL_FLOAT, GL_FALSE, sizeof(SdfVertex),
+                          reinterpret_cast<void *>(offsetof(SdfVertex, outlineWidth)));
+  }
+
+  glActiveTexture(GL_TEXTURE0);
+  offset = 0;
+
+  for (const SdfBatch &batch : batches) {
+    batch.font->bindTexture();
+
+    if (setStencil)
+      glStencilFunc(GL_LEQUAL, batch.stencil, 0xFFFF);
+
+    if (batch.depthTest)
+      glEnable(GL_DEPTH_TEST);
+    else
+      glDisable(GL_DEPTH_TEST);
+
+    glDrawArrays(GL_TRIANGLES, offset, batch.vertices.size());
+    offset += batch.vertices.size();
+  }
+
+  if (outlineColorLoc != -1)
+    glDisableVertexAttribArray(outlineColorLoc);
+
+  if (outlineWidthLoc != -1)
+    glDisableVertexAttribArray(outlineWidthLoc);
+
+  sdfShader->deactivate();
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glPopMatrix();
+  glPopClientAttrib();
+  glPopAttrib();
+
+  batches.clear();
+}
+
+// decodes a line of text into the glyphs of a signed distance field atlas;
+// returns false if the text is not valid UTF-8 or if a glyph is not available
+static bool getSdfGlyphs(GlSdfFont *font, const string &text,
+                         vector<const GlSdfFont::GlyphInfo *> &glyphs) {
+  glyphs.clear();
+
+  try {
+    string::const_iterator it = text.begin();
+
+    while (it != text.end()) {
+      const GlSdfFont::GlyphInfo *glyph = font->getGlyph(utf8::next(it, text.end()));
+
+      if (glyph == nullptr)
+        return false;
+
+      glyphs.push_back(glyph);
+    }
+  } catch (utf8::exception &) {
+    return false;
+  }
+
+  return true;
+}
+
+// computes the bounding box of a line of glyphs the same way as FTGL:
+// the union of the glyphs bounding boxes (which is a point for the empty ones)
+static void getSdfBBox(GlSdfFont *font, const vector<const GlSdfFont::GlyphInfo *> &glyphs,
+                       float fontSize, float &x1, float &y1, float &x2, float &y2) {
+  x1 = y1 = x2 = y2 = 0;
+  float pen = 0;
+
+  for (size_t i = 0; i < glyphs.size(); ++i) {
+    const GlSdfFont::GlyphInfo *glyph = glyphs[i];
+
+    if (i == 0) {
+      x1 = glyph->xMin;
+      y1 = glyph->yMin;
+      x2 = glyph->xMax;
+      y2 = glyph->yMax;
+    } else {
+      x1 = min(x1, pen + glyph->xMin);
+      y1 = min(y1, glyph->yMin);
+      x2 = max(x2, pen + glyph->xMax);
+      y2 = max(y2, glyph->yMax);
+    }
+
+    pen += glyph->advance;
+
+    if (i + 1 < glyphs.size())
+      pen += font->getKerning(glyph, glyphs[i + 1]);
+  }
+
+  x1 *= fontSize;
+  y1 *= fontSize;
+  x2 *= fontSize;
+  y2 *= fontSize;
+}
+
 GlLabel::GlLabel() : leftAlign(false), oldCamera(nullptr) {
   init();
 }
@@ -123,6 +372,8 @@ void GlLabel::init() {
   billboarded = false;
   sizeForOutAlign = size;
   oldLod = -1;
+  textMetricsOutdated = true;
+  sdfFont = nullptr;
 }
 //============================================================
 void GlLabel::setText(const string &text) {
@@ -139,7 +390,6 @@ void GlLabel::setText(const string &text) {
 
   // split each line
   textVector.clear();
-  textWidthVector.clear();
   size_t lastPos = 0;
   size_t pos = this->text.find_first_of("\n");
 
@@ -153,9 +403,57 @@ void GlLabel::setText(const string &text) {
   string s = this->text.substr(lastPos) + " ";
   textVector.push_back(std::move(s));
 
+  // the FTGL metrics are computed when needed
+  textMetricsOutdated = true;
+
+  // when available, the signed distance field atlas is used
+  // to avoid the tessellation of the glyphs by FTGL
+  sdfFont = sdfRenderingEnabled ? GlSdfFont::getFont(fontName) : nullptr;
+  sdfGlyphsVector.resize(sdfFont ? textVector.size() : 0);
+
+  for (size_t i = 0; i < sdfGlyphsVector.size(); ++i) {
+    if (!getSdfGlyphs(sdfFont, textVector[i], sdfGlyphsVector[i])) {
+      sdfFont = nullptr;
+      sdfGlyphsVector.clear();
+      break;
+    }
+  }
+
+  sdfTextWidthVector.clear();
+  sdfTextBoundingBox.clear();
+
+  if (sdfFont) {
+    float x1, y1, x2, y2;
+
+    for (size_t i = 0; i < textVector.size(); ++i) {
+      getSdfBBox(sdfFont, sdfGlyphsVector[i], fontSize, x1, y1, x2, y2);
+      sdfTextWidthVector.push_back(x2 - x1);
+
+      if (i == 0) {
+        sdfTextBoundingBox.expand(Coord(0, y1, 0));
+        sdfTextBoundingBox.expand(Coord(x2 - x1, y2, 0), true);
+      } else {
+        if (x2 - x1 > sdfTextBoundingBox[1][0])
+          sdfTextBoundingBox[1][0] = (x2 - x1);
+
+        sdfTextBoundingBox[0][1] -= fontSize + SpaceBetweenLine;
+      }
+    }
+  }
+}
+//============================================================
+void GlLabel::computeTextMetrics() {
+  if (!textMetricsOutdated)
+    return;
+
+  textMetricsOutdated = false;
+  textWidthVector.clear();
   // Text bounding box computation
   textBoundingBox.clear();
 
+  if (font->Error())
+    return;
+
   float x1, y1, z1, x2, y2, z2;
 
   // After we compute width of text
@@ -177,6 +475,15 @@ void GlLabel::setText(const string &text) {
   }
 }
 //============================================================
+const BoundingBox &GlLabel::getTextBoundingBox() {
+  // the metrics of the rendering used outside of the picking
+  if (sdfFont && textureName.empty())
+    return sdfTextBoundingBox;
+
+  computeTextMetrics();
+  return textBoundingBox;
+}
+//============================================================
 BoundingBox GlLabel::getBoundingBox() {
   if (!leftAlign)
     return BoundingBox(centerPosition - size / 2.f, centerPosition + size / 2.f);
@@ -228,6 +535,7 @@ void GlLabel::drawWithStencil(float lod, Camera *camera) {
 }
 //============================================================
 float GlLabel::getHeightAfterScale() {
+  const BoundingBox &textBoundingBox = getTextBoundingBox();
   float w = textBoundingBox[1][0] - textBoundingBox[0][0];
   float h = textBoundingBox[1][1] - textBoundingBox[0][1];
   float div_w, div_h;
@@ -279,6 +587,17 @@ void GlLabel::draw(float, Camera *camera) {
     glPopMatrix();
   }
 
+  // the signed distance field rendering uses a shader,
+  // and cannot render the textured labels
+  bool sdfRendering = sdfFont && textureName.empty() && !GlPickingBuffer::inSelectionMode() &&
+                      !GlShaderProgram::getCurrentActiveShader() && getSdfShader();
+
+  if (!sdfRendering)
+    computeTextMetrics();
+
+  // the metrics of the rendering actually used
+  const BoundingBox &textBB = sdfRendering ? sdfTextBoundingBox : textBoundingBox;
+
   glPushAttrib(GL_ALL_ATTRIB_BITS);
 
   if (depthTestEnabled)
@@ -291,8 +610,8 @@ void GlLabel::draw(float, Camera *camera) {
   glDisable(GL_BLEND);
 
   // Store width and height of the text
-  float w = textBoundingBox[1][0] - textBoundingBox[0][0];
-  float h = textBoundingBox[1][1] - textBoundingBox[0][1];
+  float w = textBB[1][0] - textBB[0][0];
+  float h = textBB[1][1] - textBB[0][1];
 
   // avoid a division by zero for strings with only space chars
   if (h == 0)
@@ -609,8 +928,11 @@ void GlLabel::draw(float, Camera *camera) {
   if (viewportH < 0)
     viewportH = -viewportH;
 
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  // blending would alter the id colors of the picking buffer
+  if (!GlPickingBuffer::isActive()) {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
 
   // The label is too small to be read, draw a line
   if (viewportH < 2 && useLOD) {
@@ -697,6 +1019,18 @@ void GlLabel::draw(float, Camera *camera) {
       break;
     }
 
+    float outlineWidth = 0;
+
+    if (outlineSize > 0 && outlineColor.getA() != 0)
+      outlineWidth = (!useLOD || viewportH > 25) ? outlineSize : 1;
+
+    if (sdfRendering) {
+      drawSdfText(xAlignFactor, xShiftFactor, yShiftFactor, outlineWidth);
+      glPopMatrix();
+      glPopAttrib();
+      return;
+    }
+
     // space between lines
     float yShift = 0.;
 
@@ -706,11 +1040,11 @@ void GlLabel::draw(float, Camera *camera) {
     for (const string &s : textVector) {
       font->BBox(s.c_str(), x1, y1, z1, x2, y2, z2);
 
-      FTPoint shift(-(textBoundingBox[1][0] - textBoundingBox[0][0]) / 2. - x1 +
-                        ((textBoundingBox[1][0] - textBoundingBox[0][0]) - (*itW)) * xAlignFactor +
-                        (textBoundingBox[1][0] - textBoundingBox[0][0]) * xShiftFactor,
-                    -textBoundingBox[1][1] + (textBoundingBox[1][1] - textBoundingBox[0][1]) / 2. +
-                        yShift + (textBoundingBox[1][1] - textBoundingBox[0][1]) * yShiftFactor);
+      FTPoint shift(-(textBB[1][0] - textBB[0][0]) / 2. - x1 +
+                        ((textBB[1][0] - textBB[0][0]) - (*itW)) * xAlignFactor +
+                        (textBB[1][0] - textBB[0][0]) * xShiftFactor,
+                    -textBB[1][1] + (textBB[1][1] - textBB[0][1]) / 2. + yShift +
+                        (textBB[1][1] - textBB[0][1]) * yShiftFactor);
 
       if (!textureName.empty())
         GlTextureManager::activateTexture(textureName);
@@ -734,7 +1068,7 @@ void GlLabel::draw(float, Camera *camera) {
         borderFont->Render(s.c_str(), -1, shift);
       }
 
-      yShift -= fontSize + 5;
+      yShift -= fontSize + SpaceBetweenLine;
       ++itW;
     }
   }
@@ -743,6 +1077,118 @@ void GlLabel::draw(float, Camera *camera) {
   glPopAttrib();
 }
 //===========================================================
+void GlLabel::drawSdfText(float xAlignFactor, float xShiftFactor, float yShiftFactor,
+                          float outlineWidth) {
+  SdfBatch *batch = nullptr;
+
+  if (sdfBatchRendering) {
+    for (SdfBatch &b : sdfBatches) {
+      if (b.font == sdfFont && b.stencil == stencil && b.depthTest == depthTestEnabled) {
+        batch = &b;
+        break;
+      }
+    }
+  } else
+    sdfBatches.clear();
+
+  if (batch == nullptr) {
+    sdfBatches.emplace_back();
+    batch = &sdfBatches.back();
+    batch->font = sdfFont;
+    batch->stencil = stencil;
+    batch->depthTest = depthTestEnabled;
+  }
+
+  // the quads are transformed in eye coordinates
+  // in order to be rendered with the other labels
+  GLfloat mdlM[16];
+  glGetFloatv(GL_MODELVIEW_MATRIX, mdlM);
+
+  SdfVertex vertex;
+  vertex.color[0] = color[0];
+  vertex.color[1] = color[1];
+  vertex.color[2] = color[2];
+  vertex.color[3] = color[3];
+  vertex.outlineColor[0] = outlineColor[0];
+  vertex.outlineColor[1] = outlineColor[1];
+  vertex.outlineColor[2] = outlineColor[2];
+  vertex.outlineColor[3] = outlineColor[3];
+  vertex.outlineWidth = outlineWidth;
+
+  auto addVertex = [&](float x, float y, float s, float t) {
+    vertex.pos[0] = mdlM[0] * x + mdlM[4] * y + mdlM[12];
+    vertex.pos[1] = mdlM[1] * x + mdlM[5] * y + mdlM[13];
+    vertex.pos[2] = mdlM[2] * x + mdlM[6] * y + mdlM[14];
+    vertex.texCoord[0] = s;
+    vertex.texCoord[1] = t;
+    batch->vertices.push_back(vertex);
+  };
+
+  float textWidth = sdfTextBoundingBox[1][0] - sdfTextBoundingBox[0][0];
+  float textHeight = sdfTextBoundingBox[1][1] - sdfTextBoundingBox[0][1];
+  // space between lines
+  float yShift = 0.;
+  float x1, y1, x2, y2;
+  vector<float>::iterator itW = sdfTextWidthVector.begin();
+
+  for (const vector<const GlSdfFont::GlyphInfo *> &glyphs : sdfGlyphsVector) {
+    getSdfBBox(sdfFont, glyphs, fontSize, x1, y1, x2, y2);
+
+    // the same pen position as the FTGL rendering
+    float penX = -textWidth / 2. - x1 + (textWidth - (*itW)) * xAlignFactor +
+                 textWidth * xShiftFactor;
+    float penY = -sdfTextBoundingBox[1][1] + textHeight / 2. + yShift + textHeight * yShiftFactor;
+
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+      const GlSdfFont::GlyphInfo *glyph = glyphs[i];
+
+      if (!glyph->empty) {
+        float qx1 = penX + glyph->quadXMin * fontSize;
+        float qy1 = penY + glyph->quadYMin * fontSize;
+        float qx2 = penX + glyph->quadXMax * fontSize;
+        float qy2 = penY + glyph->quadYMax * fontSize;
+        addVertex(qx1, qy1, glyph->sMin, glyph->tMin);
+        addVertex(qx2, qy1, glyph->sMax, glyph->tMin);
+        addVertex(qx2, qy2, glyph->sMax, glyph->tMax);
+        addVertex(qx1, qy1, glyph->sMin, glyph->tMin);
+        addVertex(qx2, qy2, glyph->sMax, glyph->tMax);
+        addVertex(qx1, qy2, glyph->sMin, glyph->tMax);
+      }
+
+      penX += glyph->advance * fontSize;
+
+      if (i + 1 < glyphs.size())
+        penX += sdfFont->getKerning(glyph, glyphs[i + 1]) * fontSize;
+    }
+
+    yShift -= fontSize + SpaceBetweenLine;
+    ++itW;
+  }
+
+  // outside of a batch rendering, the label is rendered with the current stencil function
+  if (!sdfBatchRendering)
+    renderSdfBatches(sdfBatches, false);
+}
+//===========================================================
+void GlLabel::setSdfRenderingEnabled(bool enabled) {
+  sdfRenderingEnabled = enabled;
+}
+//===========================================================
+bool GlLabel::isSdfRenderingEnabled() {
+  return sdfRenderingEnabled;
+}
+//===========================================================
+void GlLabel::beginBatchRendering() {
+  sdfBatchRendering = true;
+}
+//===========================================================
+void GlLabel::endBatchRendering() {
+  if (sdfBatchRendering) {
+    sdfBatchRendering = false;
+    renderSdfBatches(sdfBatches, true);
+  }
+}
+//===========================================================
 void GlLabel::translate(const Coord &mouvement) {
   centerPosition += mouvement;
 }
@@ -25,6 +25,7 @@
 #include <tulip/GlGraphComposite.h>
 #include <tulip/Glyph.h>
 #include <tulip/Camera.h>
+#include <tulip/GlPickingBuffer.h>
 
 #include <tulip/OpenGlIncludes.h>
 
@@ -58,10 +59,7 @@ void GlMetaNodeRenderer::render(node n, float, Camera *camera) {
     return;
   }
 
-  GLint renderMode;
-  glGetIntegerv(GL_RENDER_MODE, &renderMode);
-
-  if (renderMode == GL_SELECT)
+  if (GlPickingBuffer::inSelectionMode())
     return;
 
   Graph *metaGraph = _inputData->getGraph()->getNodeMetaInfo(n);
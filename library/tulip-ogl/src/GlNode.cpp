@@ -139,10 +139,13 @@ void GlNode::draw(float lod, const GlGraphInputData *data, Camera *camera) {
 
   auto *glyphObj = data->glyphs.get(glyph);
   // Some glyphs can not benefit from the shader rendering optimization
-  // due to the use of quadrics or modelview matrix modification or lighting effect
-  if (data->getGlGlyphRenderer()->renderingHasStarted() && glyphObj->shaderSupported()) {
-    data->getGlGlyphRenderer()->addNodeGlyphRendering(glyphObj, n, lod, coord, nodeSize, rot,
-                                                      selected);
+  // due to the use of quadrics or modelview matrix modification or lighting effect,
+  // unless they provide their geometry for the instanced rendering
+  GlGlyphRenderer *glyphRenderer = data->getGlGlyphRenderer();
+
+  if (glyphRenderer->renderingHasStarted() &&
+      (glyphObj->shaderSupported() || glyphRenderer->hasInstancedGeometry(glyphObj))) {
+    glyphRenderer->addNodeGlyphRendering(glyphObj, n, lod, coord, nodeSize, rot, selected);
   } else {
 
     if (selected) {
@@ -0,0 +1,247 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <GL/glew.h>
+
+#include <tulip/GlPickingBuffer.h>
+#include <tulip/GlShaderProgram.h>
+#include <tulip/OpenGlConfigManager.h>
+
+using namespace std;
+
+namespace tlp {
+
+// ids are encoded in the red, green and blue components of the pixels
+static const unsigned int MAX_PICKING_ID = 0xFFFFFF;
+
+bool GlPickingBuffer::_enabled = true;
+bool GlPickingBuffer::_active = false;
+unsigned int GlPickingBuffer::_fbo = 0;
+unsigned int GlPickingBuffer::_colorBuffer = 0;
+int GlPickingBuffer::_previousFbo = 0;
+int GlPickingBuffer::_width = 0;
+int GlPickingBuffer::_height = 0;
+unsigned int GlPickingBuffer::_maxId = 0;
+int GlPickingBuffer::_previousViewport[4] = {0, 0, 0, 0};
+std::vector<bool> GlPickingBuffer::_found;
+unsigned int GlPickingBuffer::_nbFound = 0;
+bool GlPickingBuffer::_verticesPass = false;
+bool GlPickingBuffer::_passRead = false;
+
+bool GlPickingBuffer::isSupported() {
+  OpenGlConfigManager::initExtensions();
+  return OpenGlConfigManager::isExtensionSupported("GL_ARB_framebuffer_object");
+}
+
+bool GlPickingBuffer::begin(int width, int height, unsigned int maxId) {
+  if (!_enabled || _active || maxId > MAX_PICKING_ID || width <= 0 || height <= 0 ||
+      !isSupported())
+    return false;
+
+  GLint maxSize;
+  glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxSize);
+
+  if (width > maxSize || height > maxSize)
+    return false;
+
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_previousFbo);
+
+  // the framebuffer objects are not shared between OpenGL contexts
+  // so a new one is created for each picking rendering
+  GLuint fbo, colorBuffer;
+  glGenFramebuffers(1, &fbo);
+  glGenRenderbuffers(1, &colorBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+  // no multisampling, no depth buffer: the ids are rendered in the drawing order
+  // and the covered entities are found by the next passes
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    glBindFramebuffer(GL_FRAMEBUFFER, _previousFbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &fbo);
+    return false;
+  }
+
+  _fbo = fbo;
+  _colorBuffer = colorBuffer;
+  _width = width;
+  _height = height;
+  _maxId = maxId;
+  _found.assign(maxId + 1, false);
+  _nbFound = 0;
+  _verticesPass = false;
+  _passRead = false;
+  _active = true;
+
+  glGetIntegerv(GL_VIEWPORT, _previousViewport);
+  glPushAttrib(GL_ALL_ATTRIB_BITS);
+  glViewport(0, 0, width, height);
+
+  glDisable(GL_SCISSOR_TEST);
+  glDisable(GL_STENCIL_TEST);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_ALPHA_TEST);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_DITHER);
+  glDisable(GL_MULTISAMPLE);
+  glDisable(GL_BLEND);
+  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+  // an entity enabling blending must not mix its id with the ones
+  // already rendered: blending is not performed while
+  // a logical operation is enabled
+  glEnable(GL_COLOR_LOGIC_OP);
+  glLogicOp(GL_COPY);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+  // the id colors are applied with a full fog, overriding the colors
+  // and textures set by the entities themselves:
+  // the fog factor (end - z) / (end - start) is clamped to 0
+  // so the fragment color is the fog color
+  glEnable(GL_FOG);
+  glFogi(GL_FOG_MODE, GL_LINEAR);
+  glFogf(GL_FOG_START, -1.0f);
+  glFogf(GL_FOG_END, 0.0f);
+
+  // the shader programs bypass the fog,
+  // they cannot be activated until end() is called
+  if (GlShaderProgram::getCurrentActiveShader())
+    GlShaderProgram::getCurrentActiveShader()->deactivate();
+
+  glClearColor(0.f, 0.f, 0.f, 0.f);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  return true;
+}
+
+void GlPickingBuffer::loadName(unsigned int id) {
+  if (_active) {
+    // the entities found by the previous passes no longer cover the other ones
+    bool found = id <= _maxId && _found[id];
+    glColorMask(!found, !found, !found, !found);
+    GLfloat color[4] = {(id & 0xFF) / 255.f, ((id >> 8) & 0xFF) / 255.f,
+                        ((id >> 16) & 0xFF) / 255.f, 1.f};
+    glFogfv(GL_FOG_COLOR, color);
+    // reset the state possibly changed by the previous entity,
+    // without smoothing the points and lines of at least one pixel wide
+    // always produce a fragment
+    glDisable(GL_LIGHTING);
+    glDisable(GL_BLEND);
+    glDisable(GL_POINT_SMOOTH);
+    glDisable(GL_LINE_SMOOTH);
+    glDisable(GL_POLYGON_SMOOTH);
+    glPointSize(1.f);
+    glLineWidth(1.f);
+  } else
+    glLoadName(id);
+}
+
+bool GlPickingBuffer::readPass() {
+  _passRead = true;
+  glFlush();
+
+  vector<unsigned char> pixels(size_t(_width) * _height * 4);
+  glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+  glPopClientAttrib();
+
+  // decode the ids found in the selection area
+  unsigned int nbFound = _nbFound;
+
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    unsigned int id = pixels[i] | (pixels[i + 1] << 8) | (pixels[i + 2] << 16);
+
+    if (id != 0 && id <= _maxId && !_found[id]) {
+      _found[id] = true;
+      ++_nbFound;
+    }
+  }
+
+  return _nbFound != nbFound;
+}
+
+bool GlPickingBuffer::nextPass() {
+  if (!_active)
+    return false;
+
+  bool newIds = readPass();
+
+  if (_nbFound == _maxId)
+    return false;
+
+  if (!newIds) {
+    // the entities not covering the center of any pixel
+    // are found by drawing the vertices of their polygons
+    if (_verticesPass)
+      return false;
+
+    _verticesPass = true;
+    glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+  }
+
+  _passRead = false;
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glClear(GL_COLOR_BUFFER_BIT);
+  return true;
+}
+
+void GlPickingBuffer::end(vector<unsigned int> &hits) {
+  if (!_active)
+    return;
+
+  if (!_passRead)
+    readPass();
+
+  glPopAttrib();
+  glViewport(_previousViewport[0], _previousViewport[1], _previousViewport[2],
+             _previousViewport[3]);
+  glBindFramebuffer(GL_FRAMEBUFFER, _previousFbo);
+  GLuint fbo = _fbo, colorBuffer = _colorBuffer;
+  glDeleteRenderbuffers(1, &colorBuffer);
+  glDeleteFramebuffers(1, &fbo);
+  _active = false;
+
+  // ids are given in the drawing order
+  // so report them from the last drawn one
+  hits.reserve(hits.size() + _nbFound);
+
+  for (unsigned int id = _maxId; _nbFound > 0; --id) {
+    if (_found[id]) {
+      hits.push_back(id);
+      --_nbFound;
+    }
+  }
+
+  _found.clear();
+  _found.shrink_to_fit();
+}
+
+bool GlPickingBuffer::inSelectionMode() {
+  if (_active)
+    return true;
+
+  GLint renderMode;
+  glGetIntegerv(GL_RENDER_MODE, &renderMode);
+  return renderMode == GL_SELECT;
+}
+} // namespace tlp
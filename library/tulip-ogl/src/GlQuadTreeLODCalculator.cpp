@@ -21,7 +21,7 @@
 #include <tulip/GlQuadTreeLODCalculator.h>
 
 #include <tulip/Matrix.h>
-#include <tulip/QuadTree.h>
+#include <tulip/PackedRTree.h>
 #include <tulip/GlGraphInputData.h>
 #include <tulip/Camera.h>
 #include <tulip/GlEntity.h>
@@ -49,6 +49,45 @@ BoundingBox computeNewBoundingBox(const BoundingBox &box, const Coord &centerSce
   return BoundingBox(center - size, center + size);
 }
 
+// above that ratio of modified graph elements, the R-trees are rebuilt
+// instead of being updated
+static const unsigned int MAX_MODIFIED_ELEMENTS_RATIO = 8;
+
+// expand the bounding box of an edge with a (0,0,x) direction
+static void expandEdgeBoundingBox(BoundingBox &bb) {
+  if (bb[0][0] == bb[1][0] && bb[0][1] == bb[1][1])
+    bb.expand(bb[1] + Coord(0.01f, 0.01f, 0));
+}
+
+// bulk build an R-tree with the elements of a vector of LOD units
+template <typename TYPE, typename UNIT, typename ELT_FN>
+static PackedRTree<TYPE> *buildRTree(const vector<UNIT> &units, const ELT_FN &getElement) {
+  vector<Rectangle<float>> boxes(units.size());
+  vector<TYPE> elements(units.size());
+  TLP_PARALLEL_MAP_INDICES(units.size(), [&](unsigned int i) {
+    boxes[i] = units[i].boundingBox;
+    elements[i] = getElement(units[i]);
+  });
+  PackedRTree<TYPE> *rTree = new PackedRTree<TYPE>();
+  rTree->build(boxes, elements);
+  return rTree;
+}
+
+// get the elements of an R-tree to render
+template <typename TYPE>
+static void queryElements(const PackedRTree<TYPE> *rTree, const BoundingBox &cameraBoundingBox,
+                          int ratio, bool allElements, bool withoutRemove, vector<TYPE> &result) {
+  if (rTree == nullptr)
+    return;
+
+  if (allElements)
+    rTree->getElements(result);
+  else if (withoutRemove)
+    rTree->getElements(cameraBoundingBox, result);
+  else
+    rTree->getElementsWithRatio(cameraBoundingBox, result, ratio);
+}
+
 GlQuadTreeLODCalculator::GlQuadTreeLODCalculator()
     : haveToCompute(true), haveToInitObservers(true),
       seBBIndex(2 * ThreadManager::getNumberOfThreads()),
@@ -67,13 +106,13 @@ GlQuadTreeLODCalculator::~GlQuadTreeLODCalculator() {
   setHaveToCompute();
   clearCamerasObservers();
 
-  for (auto it : nodesQuadTree)
+  for (auto it : nodesRTree)
     delete it;
 
-  for (auto it : edgesQuadTree)
+  for (auto it : edgesRTree)
     delete it;
 
-  for (auto it : entitiesQuadTree)
+  for (auto it : entitiesRTree)
     delete it;
 }
 
@@ -188,7 +227,7 @@ void GlQuadTreeLODCalculator::compute(const Vector<int, 4> &globalViewport,
                                       const Vector<int, 4> &currentViewport) {
 
   if (haveToCompute) {
-    // if have to compute : rebuild quadtree
+    // if have to compute : rebuild R-trees
 
     if (haveToInitObservers) {
       addObservers();
@@ -201,21 +240,23 @@ void GlQuadTreeLODCalculator::compute(const Vector<int, 4> &globalViewport,
     cameras.clear();
     layerToCamera.clear();
     simpleEntities.clear();
+    modifiedNodes.clear();
+    modifiedEdges.clear();
 
-    for (auto it : nodesQuadTree)
+    for (auto it : nodesRTree)
       delete it;
 
-    nodesQuadTree.clear();
+    nodesRTree.clear();
 
-    for (auto it : edgesQuadTree)
+    for (auto it : edgesRTree)
       delete it;
 
-    edgesQuadTree.clear();
+    edgesRTree.clear();
 
-    for (auto it : entitiesQuadTree)
+    for (auto it : entitiesRTree)
       delete it;
 
-    entitiesQuadTree.clear();
+    entitiesRTree.clear();
 
     quadTreesVectorPosition = 0;
     const vector<pair<std::string, GlLayer *>> &layersVector = glScene->getLayersList();
@@ -264,7 +305,8 @@ void GlQuadTreeLODCalculator::compute(const Vector<int, 4> &globalViewport,
     haveToCompute = false;
 
   } else {
-    // if don't have to compute : use stored quadtree data
+    // if don't have to compute : use stored R-trees data
+    updateModifiedElements();
 
     layersLODVector.clear();
 
@@ -307,86 +349,34 @@ void GlQuadTreeLODCalculator::computeFor3DCamera(LayerLODUnit *layerLODUnit, con
   double aY = atan(eyeCenter[0] / eyeCenter[2]);
 
   if (haveToCompute) {
-    // Create quadtrees
+    // Build R-trees, each build being performed concurrently
+    auto getGraphElement = [](const ComplexEntityLODUnit &unit) {
+      return std::make_pair(unit.id, unit.pos);
+    };
+
     if (noBBCheck[seBBIndex]) // is bb for simple entities valid
-      entitiesQuadTree.push_back(new QuadTreeNode<GlSimpleEntity *>(bbs[seBBIndex]));
+      entitiesRTree.push_back(buildRTree<GlSimpleEntity *>(
+          layerLODUnit->simpleEntitiesLODVector,
+          [](const SimpleEntityLODUnit &unit) { return unit.entity; }));
     else
-      entitiesQuadTree.push_back(nullptr);
-
-    bool bbsOK = false;
-    for (unsigned int i = 0; i < ThreadManager::getNumberOfThreads(); ++i) {
-      if (noBBCheck[i]) {
-        bbsOK = true;
-        break;
-      }
-    }
-    if (bbsOK) { // check validity of bbs for nodes
-      // compute nodes dedicated bb
-      BoundingBox bb(bbs[0]);
-
-      for (unsigned int i = 1; i < eBBOffset; ++i) {
-        if (noBBCheck[i])
-          bb.expand(bbs[i], true);
-      }
-
-      nodesQuadTree.push_back(new QuadTreeNode<std::pair<unsigned int, unsigned int>>(bb));
-    } else {
-      nodesQuadTree.push_back(nullptr);
-    }
-
-    bbsOK = false;
-    for (unsigned int i = 0; i < ThreadManager::getNumberOfThreads(); ++i) {
-      if (noBBCheck[eBBOffset + i]) {
-        bbsOK = true;
-        break;
-      }
-    }
-    if (bbsOK) { // check validity of bbs for edges
-      // compute edges dedicated bb
-      BoundingBox bb(bbs[eBBOffset]);
-
-      for (unsigned int i = eBBOffset + 1; i < seBBIndex; ++i) {
-        if (noBBCheck[i])
-          bb.expand(bbs[i], true);
-      }
+      entitiesRTree.push_back(nullptr);
 
-      edgesQuadTree.push_back(new QuadTreeNode<std::pair<unsigned int, unsigned int>>(bb));
-    } else {
-      edgesQuadTree.push_back(nullptr);
-    }
-
-    // Add entities in quadtrees
-    size_t nbSimples = layerLODUnit->simpleEntitiesLODVector.size();
-    size_t nbNodes = layerLODUnit->nodesLODVector.size();
-    size_t nbEdges = layerLODUnit->edgesLODVector.size();
-    auto thrdF1 = [&]() {
-      for (size_t i = 0; i < nbSimples; ++i) {
-        const auto &entity = layerLODUnit->simpleEntitiesLODVector[i];
-        entitiesQuadTree[quadTreesVectorPosition]->insert(entity.boundingBox, entity.entity);
-      }
-    };
-    auto thrdF2 = [&]() {
-      for (size_t i = 0; i < nbNodes; ++i) {
-        const auto &entity = layerLODUnit->nodesLODVector[i];
-        nodesQuadTree[quadTreesVectorPosition]->insert(entity.boundingBox,
-                                                       std::make_pair(entity.id, entity.pos));
-      }
-    };
-    auto thrdF3 = [&]() {
-      for (size_t i = 0; i < nbEdges; ++i) {
-        // This code is here to expand edge bounding box when we have an edge with direction
-        // (0,0,x)
-        auto &entity = layerLODUnit->edgesLODVector[i];
-        if (entity.boundingBox[0][0] == entity.boundingBox[1][0] &&
-            entity.boundingBox[0][1] == entity.boundingBox[1][1]) {
-          entity.boundingBox.expand(entity.boundingBox[1] + Coord(0.01f, 0.01f, 0));
-        }
-
-        edgesQuadTree[quadTreesVectorPosition]->insert(entity.boundingBox,
-                                                       std::make_pair(entity.id, entity.pos));
-      }
-    };
-    TLP_PARALLEL_SECTIONS(thrdF1, thrdF2, thrdF3);
+    if (!layerLODUnit->nodesLODVector.empty())
+      nodesRTree.push_back(buildRTree<std::pair<unsigned int, unsigned int>>(
+          layerLODUnit->nodesLODVector, getGraphElement));
+    else
+      nodesRTree.push_back(nullptr);
+
+    if (!layerLODUnit->edgesLODVector.empty()) {
+      // This code is here to expand edge bounding box when we have an edge with direction
+      // (0,0,x)
+      TLP_PARALLEL_MAP_INDICES(layerLODUnit->edgesLODVector.size(), [&](unsigned int i) {
+        expandEdgeBoundingBox(layerLODUnit->edgesLODVector[i].boundingBox);
+      });
+      edgesRTree.push_back(buildRTree<std::pair<unsigned int, unsigned int>>(
+          layerLODUnit->edgesLODVector, getGraphElement));
+    } else
+      edgesRTree.push_back(nullptr);
 
     layerLODUnit->simpleEntitiesLODVector.clear();
     layerLODUnit->nodesLODVector.clear();
@@ -400,7 +390,7 @@ void GlQuadTreeLODCalculator::computeFor3DCamera(LayerLODUnit *layerLODUnit, con
   Vector<int, 4> transformedViewport = currentViewport;
   transformedViewport[1] = globalViewport[3] - (currentViewport[1] + currentViewport[3]);
 
-  // Project camera bondinx box to know visible part of the quadtree
+  // Project camera bondinx box to know visible part of the R-trees
   pSrc[0] = transformedViewport[0];
   pSrc[1] =
       (globalViewport[1] + globalViewport[3]) - (transformedViewport[1] + transformedViewport[3]);
@@ -424,64 +414,30 @@ void GlQuadTreeLODCalculator::computeFor3DCamera(LayerLODUnit *layerLODUnit, con
   vector<std::pair<unsigned int, unsigned int>> resEdges;
   vector<GlSimpleEntity *> resEntities;
 
-  // Get result of quadtrees
-  auto thrdF1 = [&]() {
-    if ((renderingEntitiesFlag & RenderingNodes) != 0) {
-      auto &quadTree = nodesQuadTree[quadTreesVectorPosition];
-      if (quadTree) {
-        if (aX == 0 && aY == 0) {
-          if ((renderingEntitiesFlag & RenderingWithoutRemove) == 0) {
-            quadTree->getElementsWithRatio(cameraBoundingBox, resNodes, ratio);
-          } else {
-            quadTree->getElements(cameraBoundingBox, resNodes);
-          }
-        } else {
-          quadTree->getElements(resNodes);
-        }
-      }
-    }
-    size_t nbRes = resNodes.size();
-    layerLODUnit->nodesLODVector.resize(nbRes);
-  };
-  auto thrdF2 = [&]() {
-    if ((renderingEntitiesFlag & RenderingEdges) != 0) {
-      auto &quadTree = edgesQuadTree[quadTreesVectorPosition];
-      if (quadTree) {
-        if (aX == 0 && aY == 0) {
-          if ((renderingEntitiesFlag & RenderingWithoutRemove) == 0) {
-            quadTree->getElementsWithRatio(cameraBoundingBox, resEdges, ratio);
-          } else {
-            quadTree->getElements(cameraBoundingBox, resEdges);
-          }
-        } else {
-          quadTree->getElements(resEdges);
-        }
-      }
-    }
-    size_t nbRes = resEdges.size();
-    layerLODUnit->edgesLODVector.resize(nbRes);
-  };
-  auto thrdF3 = [&]() {
-    if ((renderingEntitiesFlag & RenderingSimpleEntities) != 0) {
-      auto &quadTree = entitiesQuadTree[quadTreesVectorPosition];
-      if (quadTree) {
-        if (aX == 0 && aY == 0) {
-          if ((renderingEntitiesFlag & RenderingWithoutRemove) == 0)
-            quadTree->getElementsWithRatio(cameraBoundingBox, resEntities, ratio);
-          else
-            quadTree->getElements(cameraBoundingBox, resEntities);
-        } else {
-          quadTree->getElements(resEntities);
-        }
-      }
-    }
-    size_t nbRes = resEntities.size();
-    for (size_t i = 0; i < nbRes; ++i) {
-      layerLODUnit->simpleEntitiesLODVector.emplace_back(resEntities[i],
-                                                         resEntities[i]->getBoundingBox());
-    }
-  };
-  TLP_PARALLEL_SECTIONS(thrdF1, thrdF2, thrdF3);
+  // Get result of R-trees
+  // (the queries are performed one after the other as each one is parallelized)
+  bool allElements = aX != 0 || aY != 0;
+  bool withoutRemove = (renderingEntitiesFlag & RenderingWithoutRemove) != 0;
+
+  if ((renderingEntitiesFlag & RenderingNodes) != 0)
+    queryElements(nodesRTree[quadTreesVectorPosition], cameraBoundingBox, ratio, allElements,
+                  withoutRemove, resNodes);
+
+  layerLODUnit->nodesLODVector.resize(resNodes.size());
+
+  if ((renderingEntitiesFlag & RenderingEdges) != 0)
+    queryElements(edgesRTree[quadTreesVectorPosition], cameraBoundingBox, ratio, allElements,
+                  withoutRemove, resEdges);
+
+  layerLODUnit->edgesLODVector.resize(resEdges.size());
+
+  if ((renderingEntitiesFlag & RenderingSimpleEntities) != 0)
+    queryElements(entitiesRTree[quadTreesVectorPosition], cameraBoundingBox, ratio, allElements,
+                  withoutRemove, resEntities);
+
+  for (auto entity : resEntities)
+    layerLODUnit->simpleEntitiesLODVector.emplace_back(entity, entity->getBoundingBox());
+
   TLP_PARALLEL_MAP_INDICES(resNodes.size(), [&](unsigned int i) {
     const auto &res = resNodes[i];
     GlNode glNode(res.first, res.second);
@@ -556,6 +512,120 @@ void GlQuadTreeLODCalculator::update(PropertyInterface *property) {
     setHaveToCompute();
 }
 
+bool GlQuadTreeLODCalculator::elementModified(PropertyInterface *property, node n) {
+  // nothing to record if everything has to be recomputed
+  if (haveToCompute || (property != inputData->getElementLayout() &&
+                        property != inputData->getElementSize() &&
+                        property != inputData->getElementSelected()))
+    return true;
+
+  Graph *graph = inputData->getGraph();
+
+  if (!graph->isElement(n))
+    return true;
+
+  if ((modifiedNodes.size() + modifiedEdges.size()) * MAX_MODIFIED_ELEMENTS_RATIO >
+      graph->numberOfNodes() + graph->numberOfEdges())
+    return false;
+
+  modifiedNodes.insert(graph->nodePos(n));
+
+  // the bounding box of the graph has to be recomputed
+  // in the calculator of the scene
+  GlQuadTreeLODCalculator *attachedQuadTreeLODCalculator =
+      dynamic_cast<GlQuadTreeLODCalculator *>(attachedLODCalculator);
+
+  if (attachedQuadTreeLODCalculator)
+    attachedQuadTreeLODCalculator->setHaveToCompute();
+
+  return true;
+}
+
+bool GlQuadTreeLODCalculator::elementModified(PropertyInterface *property, edge e) {
+  if (haveToCompute || (property != inputData->getElementLayout() &&
+                        property != inputData->getElementSize() &&
+                        property != inputData->getElementSelected()))
+    return true;
+
+  Graph *graph = inputData->getGraph();
+
+  if (!graph->isElement(e))
+    return true;
+
+  if ((modifiedNodes.size() + modifiedEdges.size()) * MAX_MODIFIED_ELEMENTS_RATIO >
+      graph->numberOfNodes() + graph->numberOfEdges())
+    return false;
+
+  modifiedEdges.insert(graph->edgePos(e));
+
+  GlQuadTreeLODCalculator *attachedQuadTreeLODCalculator =
+      dynamic_cast<GlQuadTreeLODCalculator *>(attachedLODCalculator);
+
+  if (attachedQuadTreeLODCalculator)
+    attachedQuadTreeLODCalculator->setHaveToCompute();
+
+  return true;
+}
+
+void GlQuadTreeLODCalculator::updateModifiedElements() {
+  if (modifiedNodes.empty() && modifiedEdges.empty())
+    return;
+
+  Graph *graph = inputData->getGraph();
+  const std::vector<node> &nodes = graph->nodes();
+  const std::vector<edge> &edges = graph->edges();
+
+  // the edges of a modified node are modified too
+  for (auto pos : modifiedNodes) {
+    for (auto e : graph->allEdges(nodes[pos]))
+      modifiedEdges.insert(graph->edgePos(e));
+  }
+
+  vector<unsigned int> nodesPos(modifiedNodes.begin(), modifiedNodes.end());
+  vector<unsigned int> edgesPos(modifiedEdges.begin(), modifiedEdges.end());
+  modifiedNodes.clear();
+  modifiedEdges.clear();
+
+  // compute the new bounding boxes
+  vector<BoundingBox> nodesBBs(nodesPos.size());
+  vector<BoundingBox> edgesBBs(edgesPos.size());
+  TLP_PARALLEL_MAP_INDICES(nodesPos.size(), [&](unsigned int i) {
+    GlNode glNode(nodes[nodesPos[i]].id, nodesPos[i]);
+    nodesBBs[i] = glNode.getBoundingBox(inputData);
+  });
+  TLP_PARALLEL_MAP_INDICES(edgesPos.size(), [&](unsigned int i) {
+    GlEdge glEdge(edges[edgesPos[i]].id, edgesPos[i]);
+    edgesBBs[i] = glEdge.getBoundingBox(inputData);
+    expandEdgeBoundingBox(edgesBBs[i]);
+  });
+
+  // then refit the R-trees built with the elements of the graph
+  for (auto rTree : nodesRTree) {
+    if (rTree && rTree->size() == nodes.size()) {
+      for (unsigned int i = 0; i < nodesPos.size(); ++i)
+        rTree->update(nodesPos[i], nodesBBs[i]);
+    }
+  }
+
+  for (auto rTree : edgesRTree) {
+    if (rTree && rTree->size() == edges.size()) {
+      for (unsigned int i = 0; i < edgesPos.size(); ++i)
+        rTree->update(edgesPos[i], edgesBBs[i]);
+    }
+  }
+
+  // the scene bounding box must include the new bounding boxes
+  for (const auto &bb : nodesBBs) {
+    bbs[0].expand(bb, noBBCheck[0]);
+    noBBCheck[0] = true;
+  }
+
+  for (const auto &bb : edgesBBs) {
+    bbs[eBBOffset].expand(bb, noBBCheck[eBBOffset]);
+    noBBCheck[eBBOffset] = true;
+  }
+}
+
 void GlQuadTreeLODCalculator::treatEvent(const Event &ev) {
   const GlSceneEvent *sceneEv = dynamic_cast<const GlSceneEvent *>(&ev);
 
@@ -594,10 +664,19 @@ void GlQuadTreeLODCalculator::treatEvent(const Event &ev) {
     PropertyInterface *property = propertyEvent->getProperty();
 
     switch (propertyEvent->getType()) {
-    case PropertyEvent::TLP_BEFORE_SET_ALL_NODE_VALUE:
     case PropertyEvent::TLP_BEFORE_SET_NODE_VALUE:
-    case PropertyEvent::TLP_BEFORE_SET_ALL_EDGE_VALUE:
+      // only the bounding box of the node has to be updated
+      if (!elementModified(property, propertyEvent->getNode()))
+        update(property);
+      break;
+
     case PropertyEvent::TLP_BEFORE_SET_EDGE_VALUE:
+      if (!elementModified(property, propertyEvent->getEdge()))
+        update(property);
+      break;
+
+    case PropertyEvent::TLP_BEFORE_SET_ALL_NODE_VALUE:
+    case PropertyEvent::TLP_BEFORE_SET_ALL_EDGE_VALUE:
       update(property);
       break;
 
@@ -671,6 +750,8 @@ void GlQuadTreeLODCalculator::setHaveToCompute() {
 
   haveToCompute = true;
   haveToInitObservers = true;
+  modifiedNodes.clear();
+  modifiedEdges.clear();
   removeObservers();
 }
 } // namespace tlp
@@ -34,6 +34,10 @@
 #include <tulip/GlSimpleEntity.h>
 #include <tulip/GlGraphComposite.h>
 #include <tulip/GlSceneObserver.h>
+#include <tulip/GlPickingBuffer.h>
+#include <tulip/GlTextureManager.h>
+#include <tulip/GlFrameProfiler.h>
+#include <tulip/GlFrameProfilerOverlay.h>
 
 using namespace std;
 
@@ -82,7 +86,7 @@ struct entityWithDistanceCompare {
 GlScene::GlScene(GlLODCalculator *calculator)
     : backgroundColor(255, 255, 255, 255), viewOrtho(true), glGraphComposite(nullptr),
       graphLayer(nullptr), clearBufferAtDraw(true), inDraw(false), clearDepthBufferAtDraw(true),
-      clearStencilBufferAtDraw(true) {
+      clearStencilBufferAtDraw(true), frameProfilerOverlay(nullptr) {
 
   if (calculator != nullptr)
     lodCalculator = calculator;
@@ -94,6 +98,7 @@ GlScene::GlScene(GlLODCalculator *calculator)
 
 GlScene::~GlScene() {
   delete lodCalculator;
+  delete frameProfilerOverlay;
 
   for (auto &it : layersList) {
     delete it.second;
@@ -152,13 +157,19 @@ void GlScene::draw() {
 
   assert(inDraw == false);
 
+  GlFrameProfiler::Scope profilingScope("GlScene::draw");
+
   inDraw = true;
 
   initGlParameters();
 
+  // the textures decoded asynchronously since the previous draw
+  GlTextureManager::uploadDecodedTextures();
+
   /**********************************************************************
   LOD Compute
   **********************************************************************/
+  GlFrameProfiler::beginSection("LOD computation");
   lodCalculator->clear();
   lodCalculator->setRenderingEntitiesFlag(RenderingAll);
 
@@ -174,6 +185,7 @@ void GlScene::draw() {
   lodCalculator->compute(viewport, viewport);
   LayersLODVector &layersLODVector = lodCalculator->getResult();
   BoundingBox &&sceneBoundingBox = lodCalculator->getSceneBoundingBox();
+  GlFrameProfiler::endSection();
 
   Camera *camera;
   // Iterate on Camera
@@ -227,6 +239,12 @@ void GlScene::draw() {
     }
   }
 
+  if (frameProfilerOverlay != nullptr) {
+    Camera camera2D(this, false);
+    camera2D.initGl();
+    frameProfilerOverlay->draw(0, &camera2D);
+  }
+
   inDraw = false;
 
   OpenGlConfigManager::deactivateAntiAliasing();
@@ -639,6 +657,19 @@ void GlScene::rotateCamera(const int x, const int y, const int z) {
   }
 }
 //========================================================================================================
+void GlScene::setFrameProfilerOverlayVisible(bool visible) {
+  if (visible == (frameProfilerOverlay != nullptr))
+    return;
+
+  if (visible) {
+    frameProfilerOverlay = new GlFrameProfilerOverlay();
+    GlFrameProfiler::setEnabled(true);
+  } else {
+    delete frameProfilerOverlay;
+    frameProfilerOverlay = nullptr;
+  }
+}
+//========================================================================================================
 void GlScene::glGraphCompositeAdded(GlLayer *layer, GlGraphComposite *glGraphComposite) {
   this->graphLayer = layer;
   this->glGraphComposite = glGraphComposite;
@@ -691,6 +722,8 @@ static void pickMatrix(GLdouble x, GLdouble y, GLdouble width, GLdouble height,
 //========================================================================================================
 bool GlScene::selectEntities(RenderingEntitiesFlag type, int x, int y, int w, int h, GlLayer *layer,
                              vector<SelectedEntity> &selectedEntities) {
+  GlFrameProfiler::Scope profilingScope("GlScene::selectEntities");
+
   if (w == 0)
     w = 1;
 
@@ -754,14 +787,6 @@ bool GlScene::selectEntities(RenderingEntitiesFlag type, int x, int y, int w, in
     glPushAttrib(GL_ALL_ATTRIB_BITS);              // save previous attributes
     glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS); // save previous attributes
 
-    // Allocate memory to store the result of the selection
-    GLuint(*selectBuf)[4] = new GLuint[size][4];
-    glSelectBuffer(size * 4, reinterpret_cast<GLuint *>(selectBuf));
-    // Activate Open Gl Selection mode
-    glRenderMode(GL_SELECT);
-    glInitNames();
-    glPushName(0);
-
     glMatrixMode(GL_PROJECTION);
     glPushMatrix(); // save previous projection matrix
 
@@ -786,16 +811,55 @@ bool GlScene::selectEntities(RenderingEntitiesFlag type, int x, int y, int w, in
     unordered_map<unsigned int, SelectedEntity> idToEntity;
 
     if (type & RenderingSimpleEntities) {
-      unsigned int id = 1;
+      // render the ids of the entities in an offscreen buffer
+      // if possible, else use the OpenGL selection mode
+      bool pickingBuffer = GlPickingBuffer::begin(w, h, size);
+      GLuint(*selectBuf)[4] = nullptr;
+
+      if (!pickingBuffer) {
+        // Allocate memory to store the result of the selection
+        selectBuf = new GLuint[size][4];
+        glSelectBuffer(size * 4, reinterpret_cast<GLuint *>(selectBuf));
+        // Activate Open Gl Selection mode
+        glRenderMode(GL_SELECT);
+        glInitNames();
+        glPushName(0);
+      }
 
-      for (auto &it : itLayer.simpleEntitiesLODVector) {
-        if (it.lod < 0)
-          continue;
+      // the picking buffer may need several passes to find the covered entities
+      do {
+        unsigned int id = 1;
 
-        idToEntity[id] = SelectedEntity(it.entity);
-        glLoadName(id);
-        ++id;
-        it.entity->draw(20., camera);
+        for (auto &it : itLayer.simpleEntitiesLODVector) {
+          if (it.lod < 0)
+            continue;
+
+          idToEntity[id] = SelectedEntity(it.entity);
+          GlPickingBuffer::loadName(id);
+          ++id;
+          it.entity->draw(20., camera);
+        }
+      } while (pickingBuffer && GlPickingBuffer::nextPass());
+
+      if (pickingBuffer) {
+        vector<unsigned int> hits;
+        GlPickingBuffer::end(hits);
+
+        selectedEntities.reserve(selectedEntities.size() + hits.size());
+        for (auto hit : hits) {
+          selectedEntities.emplace_back(idToEntity[hit]);
+        }
+      } else {
+        glFlush();
+        GLint hits = glRenderMode(GL_RENDER);
+
+        selectedEntities.reserve(selectedEntities.size() + hits);
+        while (hits > 0) {
+          selectedEntities.emplace_back(idToEntity[selectBuf[hits - 1][3]]);
+          hits--;
+        }
+
+        delete[] selectBuf;
       }
     }
 
@@ -812,17 +876,6 @@ bool GlScene::selectEntities(RenderingEntitiesFlag type, int x, int y, int w, in
       }
     }
 
-    glFlush();
-    GLint hits = glRenderMode(GL_RENDER);
-
-    selectedEntities.reserve(selectedEntities.size() + hits);
-    while (hits > 0) {
-      selectedEntities.emplace_back(idToEntity[selectBuf[hits - 1][3]]);
-      hits--;
-    }
-
-    delete[] selectBuf;
-
     for (auto it : compositesToRender) {
       it->selectEntities(camera, type, x, y, w, h, selectedEntities);
     }
@@ -0,0 +1,298 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <GL/glew.h>
+
+#include <cmath>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+
+#include <tulip/GlSdfFont.h>
+#include <tulip/ParallelTools.h>
+
+using namespace std;
+
+namespace tlp {
+
+// the pixel size of the rasterized glyphs
+static const unsigned int REFERENCE_SIZE = 48;
+// the maximum distance (in pixels of the reference size) stored in the fields
+static const unsigned int SPREAD = 6;
+// the width and height of the atlases
+static const unsigned int ATLAS_SIZE = 1024;
+// used as an infinite squared distance
+static const float FAR_AWAY = 1e20f;
+
+static FT_Library ftLibrary = nullptr;
+static unordered_map<string, GlSdfFont *> sdfFonts;
+
+GlSdfFont::GlSdfFont(FT_FaceRec_ *face)
+    : face(face), pixels(ATLAS_SIZE * ATLAS_SIZE, 0), shelfX(0), shelfY(0), shelfHeight(0),
+      texture(0), textureUpToDate(false) {}
+
+GlSdfFont::~GlSdfFont() {
+  FT_Done_Face(face);
+}
+
+GlSdfFont *GlSdfFont::getFont(const string &fontFile) {
+  GlSdfFont *font = nullptr;
+
+  TLP_LOCK_SECTION(sdf_fonts) {
+    auto it = sdfFonts.find(fontFile);
+
+    if (it != sdfFonts.end())
+      font = it->second;
+    else {
+      FT_Face face;
+
+      if ((ftLibrary || FT_Init_FreeType(&ftLibrary) == 0) &&
+          FT_New_Face(ftLibrary, fontFile.c_str(), 0, &face) == 0) {
+        if (FT_IS_SCALABLE(face) && FT_Set_Pixel_Sizes(face, 0, REFERENCE_SIZE) == 0) {
+          font = new GlSdfFont(face);
+
+          // printable ASCII and Latin-1 characters
+          for (unsigned int c = 32; c < 127; ++c)
+            font->getGlyph(c);
+
+          for (unsigned int c = 160; c < 256; ++c)
+            font->getGlyph(c);
+        } else
+          FT_Done_Face(face);
+      }
+
+      // a null font is also cached to avoid to try to load it again
+      sdfFonts[fontFile] = font;
+    }
+  }
+  TLP_UNLOCK_SECTION(sdf_fonts);
+
+  return font;
+}
+
+const GlSdfFont::GlyphInfo *GlSdfFont::getGlyph(unsigned int codePoint) {
+  auto it = glyphs.find(codePoint);
+
+  if (it != glyphs.end())
+    return &(it->second);
+
+  if (failedGlyphs.find(codePoint) != failedGlyphs.end())
+    return nullptr;
+
+  GlyphInfo glyph;
+
+  if (!addGlyph(codePoint, glyph)) {
+    failedGlyphs.insert(codePoint);
+    return nullptr;
+  }
+
+  return &(glyphs[codePoint] = glyph);
+}
+
+float GlSdfFont::getKerning(const GlyphInfo *left, const GlyphInfo *right) const {
+  FT_Vector kerning;
+
+  // the same kerning mode as the FTGL fonts
+  if (!FT_HAS_KERNING(face) ||
+      FT_Get_Kerning(face, left->index, right->index, FT_KERNING_UNFITTED, &kerning))
+    return 0;
+
+  return kerning.x / (64.f * REFERENCE_SIZE);
+}
+
+float GlSdfFont::getDistanceScale() {
+  return 0.5f / SPREAD;
+}
+
+// one dimensional squared euclidean distance transform
+// of a sampled function (Felzenszwalb & Huttenlocher)
+static void distanceTransform(const float *f, unsigned int n, float *d, unsigned int *v,
+                              float *z) {
+  unsigned int k = 0;
+  v[0] = 0;
+  z[0] = -FAR_AWAY;
+  z[1] = FAR_AWAY;
+
+  for (unsigned int q = 1; q < n; ++q) {
+    float s;
+
+    for (;;) {
+      s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.f * q - 2.f * v[k]);
+
+      if (s > z[k] || k == 0)
+        break;
+
+      --k;
+    }
+
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = FAR_AWAY;
+  }
+
+  k = 0;
+
+  for (unsigned int q = 0; q < n; ++q) {
+    while (z[k + 1] < q)
+      ++k;
+
+    float dq = float(q) - v[k];
+    d[q] = dq * dq + f[v[k]];
+  }
+}
+
+// squared distances from each pixel of a width x height grid
+// to the nearest pixel whose value in grid is 0
+static void distanceTransform(vector<float> &grid, unsigned int width, unsigned int height) {
+  unsigned int n = max(width, height);
+  vector<float> f(n), d(n), z(n + 1);
+  vector<unsigned int> v(n);
+
+  for (unsigned int x = 0; x < width; ++x) {
+    for (unsigned int y = 0; y < height; ++y)
+      f[y] = grid[y * width + x];
+
+    distanceTransform(f.data(), height, d.data(), v.data(), z.data());
+
+    for (unsigned int y = 0; y < height; ++y)
+      grid[y * width + x] = d[y];
+  }
+
+  for (unsigned int y = 0; y < height; ++y) {
+    distanceTransform(&grid[y * width], width, d.data(), v.data(), z.data());
+    copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+  }
+}
+
+bool GlSdfFont::addGlyph(unsigned int codePoint, GlyphInfo &glyph) {
+  // as FTGL does, the missing glyphs are rendered
+  // with the glyph of index 0
+  glyph.index = FT_Get_Char_Index(face, codePoint);
+
+  // the same load flags as the FTGL polygon fonts
+  if (FT_Load_Glyph(face, glyph.index, FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP) ||
+      face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+    return false;
+
+  FT_GlyphSlot slot = face->glyph;
+  const float scale = 1.f / REFERENCE_SIZE;
+  FT_BBox cbox;
+  FT_Outline_Get_CBox(&slot->outline, &cbox);
+  glyph.xMin = cbox.xMin * scale / 64.f;
+  glyph.yMin = cbox.yMin * scale / 64.f;
+  glyph.xMax = cbox.xMax * scale / 64.f;
+  glyph.yMax = cbox.yMax * scale / 64.f;
+  glyph.advance = slot->advance.x * scale / 64.f;
+
+  if (FT_Render_Glyph(slot, FT_RENDER_MODE_NORMAL))
+    return false;
+
+  const FT_Bitmap &bitmap = slot->bitmap;
+  glyph.empty = bitmap.width == 0 || bitmap.rows == 0;
+
+  if (glyph.empty)
+    return true;
+
+  unsigned int width = bitmap.width + 2 * SPREAD;
+  unsigned int height = bitmap.rows + 2 * SPREAD;
+
+  // find room in the atlas
+  if (shelfX + width > ATLAS_SIZE) {
+    shelfX = 0;
+    shelfY += shelfHeight + 1;
+    shelfHeight = 0;
+  }
+
+  if (width > ATLAS_SIZE || shelfY + height > ATLAS_SIZE)
+    return false;
+
+  // the squared distances to the glyph (outside)
+  // and to the background (inside)
+  vector<float> outside(width * height, FAR_AWAY), inside(width * height, 0);
+
+  for (unsigned int y = 0; y < bitmap.rows; ++y) {
+    const unsigned char *row = bitmap.buffer + y * bitmap.pitch;
+
+    for (unsigned int x = 0; x < bitmap.width; ++x) {
+      if (row[x] > 127) {
+        unsigned int i = (y + SPREAD) * width + x + SPREAD;
+        outside[i] = 0;
+        inside[i] = FAR_AWAY;
+      }
+    }
+  }
+
+  distanceTransform(outside, width, height);
+  distanceTransform(inside, width, height);
+
+  for (unsigned int y = 0; y < height; ++y) {
+    unsigned char *row = &pixels[(shelfY + y) * ATLAS_SIZE + shelfX];
+
+    for (unsigned int x = 0; x < width; ++x) {
+      unsigned int i = y * width + x;
+      // the signed distance to the contour, which lies
+      // half a pixel away from the pixels centers
+      float dist = outside[i] > 0 ? 0.5f - sqrt(outside[i]) : sqrt(inside[i]) - 0.5f;
+      float value = 0.5f + dist * getDistanceScale();
+      row[x] = static_cast<unsigned char>(255.f * min(max(value, 0.f), 1.f) + 0.5f);
+    }
+  }
+
+  // the bitmap rows are stored from top to bottom
+  glyph.quadXMin = (float(slot->bitmap_left) - SPREAD) * scale;
+  glyph.quadXMax = glyph.quadXMin + width * scale;
+  glyph.quadYMax = (float(slot->bitmap_top) + SPREAD) * scale;
+  glyph.quadYMin = glyph.quadYMax - height * scale;
+  glyph.sMin = float(shelfX) / ATLAS_SIZE;
+  glyph.sMax = float(shelfX + width) / ATLAS_SIZE;
+  glyph.tMax = float(shelfY) / ATLAS_SIZE;
+  glyph.tMin = float(shelfY + height) / ATLAS_SIZE;
+
+  shelfX += width + 1;
+  shelfHeight = max(shelfHeight, height);
+  textureUpToDate = false;
+
+  return true;
+}
+
+void GlSdfFont::bindTexture() {
+  if (texture == 0) {
+    GLuint textureId;
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    texture = textureId;
+  } else
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+  if (!textureUpToDate) {
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_ALPHA,
+                 GL_UNSIGNED_BYTE, pixels.data());
+    glPopClientAttrib();
+    textureUpToDate = true;
+  }
+}
+} // namespace tlp
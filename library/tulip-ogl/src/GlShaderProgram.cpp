@@ -24,6 +24,7 @@
 #include <algorithm>
 
 #include <tulip/GlShaderProgram.h>
+#include <tulip/GlPickingBuffer.h>
 #include <tulip/OpenGlConfigManager.h>
 #include <tulip/TlpTools.h>
 
@@ -270,6 +271,10 @@ void GlShaderProgram::printInfoLog() {
 }
 
 void GlShaderProgram::activate() {
+  // the shaders would override the colors encoding the picked entities ids
+  if (GlPickingBuffer::isActive())
+    return;
+
   if (!programLinked) {
     link();
   }
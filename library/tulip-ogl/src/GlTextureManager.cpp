@@ -32,7 +32,14 @@
 
 #include <GL/glew.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <tulip/GlTextureManager.h>
+#include <tulip/GlFrameProfiler.h>
 #include <tulip/OpenGlConfigManager.h>
 
 //====================================================
@@ -40,6 +47,15 @@ tlp::GlTextureLoader *tlp::GlTextureManager::loader = nullptr;
 tlp::GlTextureManager::TextureMap tlp::GlTextureManager::texturesMap;
 std::set<std::string> tlp::GlTextureManager::texturesWithError;
 unsigned int tlp::GlTextureManager::animationFrame = 0;
+std::list<std::string> tlp::GlTextureManager::lruTextures;
+std::unordered_map<std::string, tlp::GlTextureManager::TextureUsage>
+    tlp::GlTextureManager::texturesUsage;
+size_t tlp::GlTextureManager::memoryBudget = 0;
+size_t tlp::GlTextureManager::memoryUsage = 0;
+unsigned int tlp::GlTextureManager::currentFrame = 0;
+bool tlp::GlTextureManager::asynchronousLoading = false;
+std::unordered_set<std::string> tlp::GlTextureManager::texturesInDecoding;
+GLuint tlp::GlTextureManager::placeholderTexture = 0;
 
 using namespace std;
 
@@ -313,134 +329,144 @@ static bool loadPNG(const string &filename, TextureInfo *texture) {
   return true;
 }
 
-static bool generateTexture(const std::string &filename, const TextureInfo &texti,
-                            GlTexture &glTexture) {
-  int GLFmt = texti.hasAlpha ? GL_RGBA : GL_RGB;
+static TextureLoader_t *getFileLoader(const string &filename) {
+  string extension = filename.substr(filename.find_last_of('.') + 1);
+
+  for (unsigned int i = 0; i < extension.length(); ++i)
+    extension[i] = static_cast<char>(toupper(extension[i]));
 
-  bool spriteOnWidth = false;
-  unsigned int spriteNumber = 1;
-  unsigned int width = texti.width;
-  unsigned int height = texti.height;
+  if (extension == "BMP")
+    return &loadBMP;
+  else if ((extension == "JPG") || (extension == "JPEG"))
+    return &loadJPEG;
+  else if (extension == "PNG")
+    return &loadPNG;
+
+  return nullptr;
+}
+//====================================================================
+bool GlTextureLoader::canDecodeTexture(const string &filename) const {
+  return getFileLoader(filename) != nullptr;
+}
+//====================================================================
+bool GlTextureLoader::decodeTexture(const string &filename, GlTextureData &data) {
+  TextureLoader_t *loader = getFileLoader(filename);
+
+  if (loader == nullptr) {
+    tlp::error() << "GlTextureLoader Error: no texture loader found for file \"" << filename
+                 << "\"" << std::endl;
+    return false;
+  }
+
+  TextureInfo texti;
+
+  if (!(*loader)(filename, &texti))
+    return false;
 
   if ((texti.height - (texti.height / texti.width) * texti.width) != 0 &&
       (texti.width - (texti.width / texti.height) * texti.height) != 0) {
     tlp::error() << "Texture loader error: invalid size\ntexture size should be of the form:\n - "
                     "width=height or\n - height=N*width (for animated textures)\nfor file: "
                  << filename << std::endl;
+    delete[] texti.data;
     return false;
-  } else {
-    if (texti.width != texti.height) {
-      if (texti.height > texti.width) {
-        // spriteOnHeight=true;
-        spriteNumber = texti.height / texti.width;
-        height = width;
-      } else {
-        spriteOnWidth = true;
-        spriteNumber = texti.width / texti.height;
-        width = height;
-      }
-    }
+  }
 
-    bool canUseNpotTextures =
-        OpenGlConfigManager::isExtensionSupported("GL_ARB_texture_non_power_of_two");
+  data.width = texti.width;
+  data.height = texti.height;
+  data.hasAlpha = texti.hasAlpha;
+  data.spriteNumber = (texti.height > texti.width) ? texti.height / texti.width
+                                                   : texti.width / texti.height;
+  size_t nbPixels = size_t(texti.width) * texti.height;
+  data.pixels.resize(nbPixels * 4);
 
-    if (!canUseNpotTextures) {
-      bool formatOk = false;
+  if (texti.hasAlpha)
+    memcpy(data.pixels.data(), texti.data, nbPixels * 4);
+  else {
+    for (size_t i = 0; i < nbPixels; ++i) {
+      memcpy(&data.pixels[4 * i], texti.data + 3 * i, 3);
+      data.pixels[4 * i + 3] = 255;
+    }
+  }
 
-      for (unsigned int i = 1; i <= width; i *= 2) {
-        if (i == width)
-          formatOk = true;
-      }
+  delete[] texti.data;
+  return true;
+}
+//====================================================================
+bool GlTextureLoader::loadTexture(const string &filename, GlTexture &texture) {
+  GlTextureData data;
 
-      if (!formatOk) {
-        tlp::error() << "Texture loader error: invalid size\ntexture width should be a power of "
-                        "2\nfor file: "
-                     << filename << std::endl;
-        return false;
-      }
+  return decodeTexture(filename, data) && uploadTexture(filename, data, texture);
+}
+#else
+//====================================================================
+bool GlTextureLoader::canDecodeTexture(const string &) const {
+  return false;
+}
+//====================================================================
+bool GlTextureLoader::decodeTexture(const string &, GlTextureData &) {
+  return false;
+}
+#endif
 
-      formatOk = false;
+//====================================================================
+static bool isPowerOfTwo(unsigned int value) {
+  return value != 0 && (value & (value - 1)) == 0;
+}
 
-      for (unsigned int i = 1; i <= height; i *= 2) {
-        if (i == height)
-          formatOk = true;
-      }
+bool GlTextureLoader::uploadTexture(const std::string &filename, const GlTextureData &data,
+                                    GlTexture &glTexture) {
+  unsigned int spriteNumber = std::max(data.spriteNumber, 1u);
+  bool spriteOnWidth = spriteNumber > 1 && data.width > data.height;
+  unsigned int width = spriteOnWidth ? data.width / spriteNumber : data.width;
+  unsigned int height = spriteOnWidth ? data.height : data.height / spriteNumber;
 
-      if (!formatOk) {
-        tlp::error() << "Texture loader error: invalid size\ntexture height should be a power of "
-                        "2\nfor file: "
-                     << filename << std::endl;
-        return false;
-      }
-    }
+  if (width == 0 || height == 0 || data.pixels.size() < size_t(data.width) * data.height * 4) {
+    tlp::error() << "Texture loader error: invalid data for file: " << filename << std::endl;
+    return false;
+  }
+
+  if (!OpenGlConfigManager::isExtensionSupported("GL_ARB_texture_non_power_of_two") &&
+      (!isPowerOfTwo(width) || !isPowerOfTwo(height))) {
+    tlp::error() << "Texture loader error: invalid size\ntexture width and height should be "
+                    "powers of 2\nfor file: "
+                 << filename << std::endl;
+    return false;
   }
 
   bool canUseMipmaps = OpenGlConfigManager::isExtensionSupported("GL_ARB_framebuffer_object") ||
                        OpenGlConfigManager::isExtensionSupported("GL_EXT_framebuffer_object");
 
-  GLuint *textureNum = new GLuint[spriteNumber];
-
   glTexture.width = width;
   glTexture.height = height;
   glTexture.spriteNumber = spriteNumber;
   glTexture.id = new GLuint[spriteNumber];
 
-  unsigned char **dataForWidthSpriteTexture;
-  dataForWidthSpriteTexture = new unsigned char *[spriteNumber];
+  glGenTextures(spriteNumber, glTexture.id);
 
-  if (spriteOnWidth) {
-    for (unsigned int i = 0; i < spriteNumber; i++) {
-      if (texti.hasAlpha)
-        dataForWidthSpriteTexture[i] = new unsigned char[4 * width * height];
-      else
-        dataForWidthSpriteTexture[i] = new unsigned char[3 * width * height];
-    }
-
-    for (unsigned int i = 0; i < texti.height; i++) {
-      for (unsigned int j = 0; j < texti.width; ++j) {
-        if (texti.hasAlpha) {
-          dataForWidthSpriteTexture[j / width][i * width * 4 + (j - (j / width) * width) * 4] =
-              texti.data[i * texti.width * 4 + j * 4];
-          dataForWidthSpriteTexture[j / width][i * width * 4 + (j - (j / width) * width) * 4 + 1] =
-              texti.data[i * texti.width * 4 + j * 4 + 1];
-          dataForWidthSpriteTexture[j / width][i * width * 4 + (j - (j / width) * width) * 4 + 2] =
-              texti.data[i * texti.width * 4 + j * 4 + 2];
-          dataForWidthSpriteTexture[j / width][i * width * 4 + (j - (j / width) * width) * 4 + 3] =
-              texti.data[i * texti.width * 4 + j * 4 + 3];
-        } else {
-          dataForWidthSpriteTexture[j / width][i * width * 3 + (j - (j / width) * width) * 3] =
-              texti.data[i * texti.width * 3 + j * 3];
-          dataForWidthSpriteTexture[j / width][i * width * 3 + (j - (j / width) * width) * 3 + 1] =
-              texti.data[i * texti.width * 3 + j * 3 + 1];
-          dataForWidthSpriteTexture[j / width][i * width * 3 + (j - (j / width) * width) * 3 + 2] =
-              texti.data[i * texti.width * 3 + j * 3 + 2];
-        }
-      }
-    }
-  }
+  glEnable(GL_TEXTURE_2D);
 
-  glGenTextures(spriteNumber, textureNum);
+  vector<unsigned char> sprite;
 
-  glEnable(GL_TEXTURE_2D);
+  if (spriteOnWidth)
+    sprite.resize(size_t(width) * height * 4);
 
   for (unsigned int i = 0; i < spriteNumber; ++i) {
-    glBindTexture(GL_TEXTURE_2D, textureNum[i]);
+    const unsigned char *pixels;
 
-    glTexture.id[i] = textureNum[i];
+    if (spriteOnWidth) {
+      // gather the columns of the sprite
+      for (unsigned int row = 0; row < height; ++row)
+        memcpy(&sprite[size_t(row) * width * 4],
+               &data.pixels[(size_t(row) * data.width + size_t(i) * width) * 4], width * 4);
 
-    if (!spriteOnWidth) {
-      if (texti.hasAlpha)
-        glTexImage2D(GL_TEXTURE_2D, 0, GLFmt, width, height, 0, GLFmt, GL_UNSIGNED_BYTE,
-                     texti.data + (width * height * 4 * i));
-      else
-        glTexImage2D(GL_TEXTURE_2D, 0, GLFmt, width, height, 0, GLFmt, GL_UNSIGNED_BYTE,
-                     texti.data + (width * height * 3 * i));
-    } else {
-      glTexImage2D(GL_TEXTURE_2D, 0, GLFmt, width, height, 0, GLFmt, GL_UNSIGNED_BYTE,
-                   dataForWidthSpriteTexture[i]);
+      pixels = sprite.data();
+    } else
+      pixels = data.pixels.data() + size_t(width) * height * 4 * i;
 
-      delete[] dataForWidthSpriteTexture[i];
-    }
+    glBindTexture(GL_TEXTURE_2D, glTexture.id[i]);
+    glTexImage2D(GL_TEXTURE_2D, 0, data.hasAlpha ? GL_RGBA : GL_RGB, width, height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, pixels);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -454,45 +480,120 @@ static bool generateTexture(const std::string &filename, const TextureInfo &text
 
   glDisable(GL_TEXTURE_2D);
 
-  delete[] textureNum;
-  delete[] dataForWidthSpriteTexture;
-
   return true;
 }
 //====================================================================
-bool GlTextureLoader::loadTexture(const string &filename, GlTexture &texture) {
-  string extension = filename.substr(filename.find_last_of('.') + 1);
+// the decoding of the textures in worker threads
+class TextureDecoder {
+public:
+  struct Result {
+    string filename;
+    GlTextureData data;
+    bool ok;
+  };
+
+  ~TextureDecoder() {
+    {
+      lock_guard<mutex> lock(decoderMutex);
+      stop = true;
+    }
+    requestsAvailable.notify_all();
 
-  for (unsigned int i = 0; i < extension.length(); ++i)
-    extension[i] = static_cast<char>(toupper(extension[i]));
+    for (auto &t : threads)
+      t.join();
+  }
 
-  TextureLoader_t *loader = nullptr;
+  void decode(const string &filename, GlTextureLoader *loader) {
+    {
+      lock_guard<mutex> lock(decoderMutex);
 
-  if (extension == "BMP")
-    loader = &loadBMP;
-  else if ((extension == "JPG") || (extension == "JPEG"))
-    loader = &loadJPEG;
-  else if (extension == "PNG")
-    loader = &loadPNG;
-  else {
-    tlp::error() << "GlTextureLoader Error: no texture loader found for file extension \""
-                 << extension << "\"" << std::endl;
+      if (threads.empty()) {
+        unsigned int nbThreads = std::max(1u, std::min(4u, thread::hardware_concurrency()));
+
+        for (unsigned int i = 0; i < nbThreads; ++i)
+          threads.push_back(thread(&TextureDecoder::run, this));
+      }
+
+      requests.push_back(make_pair(filename, loader));
+    }
+    requestsAvailable.notify_one();
   }
 
-  TextureInfo texti;
+  void setCallback(const function<void()> &f) {
+    lock_guard<mutex> lock(decoderMutex);
+    callback = f;
+  }
 
-  if ((loader == nullptr) || !(*loader)(filename, &texti)) {
-    return false;
+  void takeResults(vector<Result> &decoded) {
+    lock_guard<mutex> lock(decoderMutex);
+    decoded.swap(results);
   }
 
-  bool result = generateTexture(filename, texti, texture);
+  // give back the results which have not been uploaded
+  void giveBackResults(vector<Result> &decoded) {
+    function<void()> f;
 
-  delete[] texti.data;
+    {
+      lock_guard<mutex> lock(decoderMutex);
+      results.insert(results.begin(), make_move_iterator(decoded.begin()),
+                     make_move_iterator(decoded.end()));
+      f = callback;
+    }
 
-  return result;
-}
-#endif
+    if (f)
+      f();
+  }
+
+private:
+  void run() {
+    for (;;) {
+      pair<string, GlTextureLoader *> request;
+
+      {
+        unique_lock<mutex> lock(decoderMutex);
+        requestsAvailable.wait(lock, [this] { return stop || !requests.empty(); });
+
+        if (stop)
+          return;
+
+        request = requests.front();
+        requests.pop_front();
+      }
+
+      Result result;
+      result.filename = request.first;
+      result.ok = request.second->decodeTexture(request.first, result.data);
+
+      function<void()> f;
+
+      {
+        lock_guard<mutex> lock(decoderMutex);
 
+        // only notify when the first result is waiting
+        if (results.empty())
+          f = callback;
+
+        results.push_back(std::move(result));
+      }
+
+      if (f)
+        f();
+    }
+  }
+
+  mutex decoderMutex;
+  condition_variable requestsAvailable;
+  deque<pair<string, GlTextureLoader *>> requests;
+  vector<Result> results;
+  vector<thread> threads;
+  function<void()> callback;
+  bool stop = false;
+};
+
+static TextureDecoder textureDecoder;
+
+// the maximum number of bytes uploaded by a call to uploadDecodedTextures
+static const size_t MAX_UPLOADED_BYTES = 64 * 1024 * 1024;
 //====================================================================
 GlTexture GlTextureManager::getTextureInfo(const string &filename) {
   if (texturesMap.find(filename) != texturesMap.end())
@@ -516,9 +617,111 @@ bool GlTextureManager::loadTexture(const string &filename) {
   if (!getTextureLoader()->loadTexture(filename, texture))
     return false;
 
-  (texturesMap)[filename] = texture;
+  addTexture(filename, texture);
   return true;
 }
+//====================================================================
+void GlTextureManager::addTexture(const string &filename, const GlTexture &texture) {
+  texturesMap[filename] = texture;
+
+  // the mipmaps use one third more memory
+  size_t bytes = size_t(texture.width) * texture.height * 4 * texture.spriteNumber;
+  bytes += bytes / 3;
+  TextureUsage &usage = texturesUsage[filename];
+  usage.bytes = bytes;
+  usage.lastFrame = currentFrame;
+  usage.lruPos = lruTextures.insert(lruTextures.end(), filename);
+  memoryUsage += bytes;
+
+  enforceMemoryBudget();
+}
+//====================================================================
+void GlTextureManager::touchTexture(const string &filename) {
+  auto it = texturesUsage.find(filename);
+
+  if (it != texturesUsage.end()) {
+    it->second.lastFrame = currentFrame;
+    lruTextures.splice(lruTextures.end(), lruTextures, it->second.lruPos);
+  }
+}
+//====================================================================
+void GlTextureManager::enforceMemoryBudget() {
+  if (memoryBudget == 0)
+    return;
+
+  while (memoryUsage > memoryBudget && !lruTextures.empty()) {
+    const string &filename = lruTextures.front();
+
+    // the textures activated during the frame being rendered
+    // or the previous one are kept, else the textures of a working set
+    // exceeding the budget would be deleted and loaded again at each frame
+    if (texturesUsage[filename].lastFrame + 1 >= currentFrame)
+      break;
+
+    deleteTexture(string(filename));
+  }
+}
+//====================================================================
+void GlTextureManager::setMemoryBudget(size_t bytes) {
+  memoryBudget = bytes;
+  enforceMemoryBudget();
+}
+//====================================================================
+void GlTextureManager::setAsynchronousLoading(bool asynchronous) {
+  asynchronousLoading = asynchronous;
+}
+//====================================================================
+void GlTextureManager::setTexturesDecodedCallback(const std::function<void()> &callback) {
+  textureDecoder.setCallback(callback);
+}
+//====================================================================
+void GlTextureManager::uploadDecodedTextures() {
+  GlFrameProfiler::Scope profilingScope("textures upload");
+
+  ++currentFrame;
+
+  vector<TextureDecoder::Result> results;
+  textureDecoder.takeResults(results);
+
+  size_t uploadedBytes = 0;
+  size_t i = 0;
+
+  for (; i < results.size() && uploadedBytes < MAX_UPLOADED_BYTES; ++i) {
+    TextureDecoder::Result &result = results[i];
+
+    // the texture may have been deleted during its decoding
+    if (texturesInDecoding.erase(result.filename) == 0)
+      continue;
+
+    GlTexture texture;
+
+    if (result.ok && GlTextureLoader::uploadTexture(result.filename, result.data, texture)) {
+      addTexture(result.filename, texture);
+      uploadedBytes += result.data.pixels.size();
+    } else
+      texturesWithError.insert(result.filename);
+  }
+
+  if (i < results.size()) {
+    results.erase(results.begin(), results.begin() + i);
+    textureDecoder.giveBackResults(results);
+  }
+}
+//====================================================================
+void GlTextureManager::activatePlaceholderTexture() {
+  if (placeholderTexture == 0) {
+    // a light grey pixel
+    const unsigned char pixel[4] = {200, 200, 200, 255};
+    glGenTextures(1, &placeholderTexture);
+    glBindTexture(GL_TEXTURE_2D, placeholderTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  }
+
+  glEnable(GL_TEXTURE_2D);
+  glBindTexture(GL_TEXTURE_2D, placeholderTexture);
+}
 
 void GlTextureManager::registerExternalTexture(const std::string &textureName,
                                                const GLuint textureId) {
@@ -538,11 +741,20 @@ static void deleteGlTexture(GlTexture &texture) {
 }
 
 void GlTextureManager::deleteTexture(const string &name) {
+  texturesInDecoding.erase(name);
+
   TextureMap::iterator it = texturesMap.find(name);
   if (it != texturesMap.end()) {
     deleteGlTexture(it->second);
     texturesMap.erase(it);
   }
+
+  auto itUsage = texturesUsage.find(name);
+  if (itUsage != texturesUsage.end()) {
+    memoryUsage -= itUsage->second.bytes;
+    lruTextures.erase(itUsage->second.lruPos);
+    texturesUsage.erase(itUsage);
+  }
 }
 //====================================================================
 void GlTextureManager::beginNewTexture(const string &) {
@@ -565,9 +777,25 @@ bool GlTextureManager::activateTexture(const string &filename, unsigned int fram
 
   bool loadOk = true;
 
-  if (texturesMap.find(filename) == texturesMap.end())
+  if (texturesMap.find(filename) == texturesMap.end()) {
+    if (texturesInDecoding.count(filename) != 0) {
+      // a placeholder is used until the decoded texture is uploaded
+      if (asynchronousLoading) {
+        activatePlaceholderTexture();
+        return true;
+      }
+
+      // the texture is needed now, the result of its decoding will be ignored
+      texturesInDecoding.erase(filename);
+    } else if (asynchronousLoading && getTextureLoader()->canDecodeTexture(filename)) {
+      texturesInDecoding.insert(filename);
+      textureDecoder.decode(filename, getTextureLoader());
+      activatePlaceholderTexture();
+      return true;
+    }
+
     loadOk = loadTexture(filename);
-  else
+  } else
     glEnable(GL_TEXTURE_2D);
 
   if (!loadOk) {
@@ -576,6 +804,8 @@ bool GlTextureManager::activateTexture(const string &filename, unsigned int fram
     return false;
   }
 
+  touchTexture(filename);
+
   unsigned int spriteNumber = texturesMap[filename].spriteNumber;
   frame = frame - (frame / spriteNumber) * spriteNumber;
   glBindTexture(GL_TEXTURE_2D, texturesMap[filename].id[frame]);
@@ -590,6 +820,11 @@ void GlTextureManager::deleteAllTextures() {
   for (auto &it : texturesMap) {
     deleteGlTexture(it.second);
   }
+
+  lruTextures.clear();
+  texturesUsage.clear();
+  memoryUsage = 0;
+  texturesInDecoding.clear();
 }
 
 } // namespace tlp
@@ -19,6 +19,8 @@
 
 #include <GL/glew.h>
 
+#include <algorithm>
+
 #include <tulip/OpenGlConfigManager.h>
 #include <tulip/GlVertexArrayManager.h>
 #include <tulip/GlEdge.h>
@@ -28,6 +30,8 @@
 #include <tulip/Curves.h>
 #include <tulip/GlShaderProgram.h>
 #include <tulip/GlGraphRenderingParameters.h>
+#include <tulip/ParallelTools.h>
+#include <tulip/GlFrameProfiler.h>
 
 using namespace std;
 
@@ -42,6 +46,38 @@ static bool isOpenGlOutOfMemory() {
   return glGetError() == GL_OUT_OF_MEMORY;
 }
 
+// upload the given ranges of an array in an already filled vertex buffer object
+template <typename T>
+static void uploadArrayRanges(GLuint vbo, const vector<T> &array,
+                              vector<pair<unsigned int, unsigned int>> &ranges) {
+  if (ranges.empty())
+    return;
+
+  // merge the overlapping or contiguous ranges
+  // to limit the number of calls to glBufferSubData
+  sort(ranges.begin(), ranges.end());
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  unsigned int first = ranges[0].first;
+  unsigned int last = first + ranges[0].second;
+
+  for (size_t i = 1; i <= ranges.size(); ++i) {
+    if (i < ranges.size() && ranges[i].first <= last) {
+      last = max(last, ranges[i].first + ranges[i].second);
+      continue;
+    }
+
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(T), (last - first) * sizeof(T),
+                    VECTOR_DATA(array) + first);
+
+    if (i < ranges.size()) {
+      first = ranges[i].first;
+      last = first + ranges[i].second;
+    }
+  }
+
+  ranges.clear();
+}
+
 namespace tlp {
 GlVertexArrayManager::GlVertexArrayManager(GlGraphInputData *i)
     : inputData(i), graph(inputData->getGraph()), layoutProperty(inputData->getElementLayout()),
@@ -248,7 +284,11 @@ bool GlVertexArrayManager::haveToCompute() {
     recompute = true;
   }
 
-  return recompute;
+  // update the data of the elements modified since the last rendering
+  // which are not already planned to be recomputed
+  updateModifiedElements();
+
+  return recompute || toComputeLayout || toComputeColor;
 }
 
 void GlVertexArrayManager::setHaveToComputeAll(bool compute) {
@@ -338,6 +378,8 @@ void GlVertexArrayManager::endRendering() {
   if (!isBegin)
     return;
 
+  GlFrameProfiler::Scope profilingScope("vertex arrays rendering");
+
   isBegin = false;
 
   static bool canUseVBO = OpenGlConfigManager::hasVertexBufferObject();
@@ -411,6 +453,42 @@ void GlVertexArrayManager::endRendering() {
     colorsUploadNeeded = false;
   }
 
+  if (canUseVBO) {
+    // only upload the parts of the arrays updated since the last rendering
+    if (pointsVerticesUploaded)
+      uploadArrayRanges(pointsVerticesVBO, pointsCoordsArray, pointsVerticesRanges);
+
+    if (linesVerticesUploaded)
+      uploadArrayRanges(linesVerticesVBO, linesCoordsArray, linesVerticesRanges);
+
+    if (quadsVerticesUploaded)
+      uploadArrayRanges(quadsVerticesVBO, quadsCoordsArray, quadsVerticesRanges);
+
+    if (pointsColorsUploaded)
+      uploadArrayRanges(pointsColorsVBO, pointsColorsArray, pointsColorsRanges);
+
+    if (linesColorsUploaded)
+      uploadArrayRanges(linesColorsVBO, linesColorsArray, linesColorsRanges);
+
+    if (quadsOutlineColorsUploaded) {
+      ArrayRanges outlineRanges(quadsColorsRanges);
+      uploadArrayRanges(quadsOutlineColorsVBO, quadsOutlineColorsArray, outlineRanges);
+    }
+
+    if (quadsColorsUploaded)
+      uploadArrayRanges(quadsColorsVBO, quadsColorsArray, quadsColorsRanges);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  // the arrays not stored in vertex buffer objects are directly used
+  pointsVerticesRanges.clear();
+  linesVerticesRanges.clear();
+  quadsVerticesRanges.clear();
+  pointsColorsRanges.clear();
+  linesColorsRanges.clear();
+  quadsColorsRanges.clear();
+
   glDisable(GL_LIGHTING);
   glDisable(GL_CULL_FACE);
   glDepthFunc(GL_LEQUAL);
@@ -653,72 +731,79 @@ void GlVertexArrayManager::activate(bool act) {
 }
 
 void GlVertexArrayManager::visit(GlEdge *glEdge) {
+  auto &eInfos = edgeInfosVector[glEdge->pos];
+
+  if (toComputeLayout)
+    computeEdgeLayout(glEdge, eInfos);
+
+  if (toComputeColor)
+    computeEdgeColors(glEdge, eInfos);
+}
+
+void GlVertexArrayManager::computeEdgeLayout(GlEdge *glEdge, edgeInfos &eInfos) {
   edge e(glEdge->id);
   auto ends = graph->ends(e);
   node src = ends.first;
   node tgt = ends.second;
 
-  auto nbNodes = graph->numberOfNodes();
-  auto &eInfos = edgeInfosVector[glEdge->pos];
-
-  if (toComputeLayout) {
-    Coord srcCoord, tgtCoord;
-    Size srcSize, tgtSize;
+  Coord srcCoord, tgtCoord;
+  Size srcSize, tgtSize;
 
-    vector<Coord> &vertices = eInfos.lineVertices;
-    const unsigned int nbLines =
-        glEdge->getVertices(inputData, e, src, tgt, srcCoord, tgtCoord, srcSize, tgtSize, vertices);
+  vector<Coord> &vertices = eInfos.lineVertices;
+  const unsigned int nbLines =
+      glEdge->getVertices(inputData, e, src, tgt, srcCoord, tgtCoord, srcSize, tgtSize, vertices);
 
-    if (nbLines != 0) {
-      pointsCoordsArray[glEdge->pos + nbNodes] = vertices[0];
+  if (nbLines != 0) {
+    pointsCoordsArray[glEdge->pos + graph->numberOfNodes()] = vertices[0];
 
-      Size edgeSize;
-      float maxSrcSize, maxTgtSize;
+    Size edgeSize;
+    float maxSrcSize, maxTgtSize;
 
-      maxSrcSize = std::max(srcSize[0], srcSize[1]);
-      maxTgtSize = std::max(tgtSize[0], tgtSize[1]);
+    maxSrcSize = std::max(srcSize[0], srcSize[1]);
+    maxTgtSize = std::max(tgtSize[0], tgtSize[1]);
 
-      glEdge->getEdgeSize(inputData, e, srcSize, tgtSize, maxSrcSize, maxTgtSize, edgeSize);
+    glEdge->getEdgeSize(inputData, e, srcSize, tgtSize, maxSrcSize, maxTgtSize, edgeSize);
 
-      vector<float> edgeSizes;
-      getSizes(vertices, edgeSize[0] / 2.0f, edgeSize[1] / 2.0f, edgeSizes);
+    vector<float> edgeSizes;
+    getSizes(vertices, edgeSize[0] / 2.0f, edgeSize[1] / 2.0f, edgeSizes);
 
-      vector<Coord> &quadVertices = eInfos.quadVertices;
-      buildCurvePoints(vertices, edgeSizes, srcCoord, tgtCoord, quadVertices);
+    vector<Coord> &quadVertices = eInfos.quadVertices;
+    buildCurvePoints(vertices, edgeSizes, srcCoord, tgtCoord, quadVertices);
 
-      const vector<Coord> &bends = layoutProperty->getEdgeValue(e);
-      glEdge->getEdgeAnchor(inputData, src, tgt, bends, srcCoord, tgtCoord, srcSize, tgtSize,
-                            vertices[0], vertices[nbLines - 1]);
-    }
+    const vector<Coord> &bends = layoutProperty->getEdgeValue(e);
+    glEdge->getEdgeAnchor(inputData, src, tgt, bends, srcCoord, tgtCoord, srcSize, tgtSize,
+                          vertices[0], vertices[nbLines - 1]);
   }
+}
 
-  if (toComputeColor) {
-    const unsigned int nbLines = eInfos.lineVertices.size();
+void GlVertexArrayManager::computeEdgeColors(GlEdge *glEdge, edgeInfos &eInfos) {
+  const unsigned int nbLines = eInfos.lineVertices.size();
 
-    if (nbLines != 0) {
-      const Color &edgeColor = colorProperty->getEdgeValue(e);
-      eInfos.edgeColor = edgeColor;
-      eInfos.borderColor = borderColorProperty->getEdgeValue(e);
-      Color srcColor, tgtColor;
+  if (nbLines != 0) {
+    edge e(glEdge->id);
+    auto ends = graph->ends(e);
+    const Color &edgeColor = colorProperty->getEdgeValue(e);
+    eInfos.edgeColor = edgeColor;
+    eInfos.borderColor = borderColorProperty->getEdgeValue(e);
+    Color srcColor, tgtColor;
 
-      vector<Color> &lColors = eInfos.lineColors;
-      glEdge->getColors(inputData, src, tgt, edgeColor, srcColor, tgtColor, &eInfos.lineVertices[0],
-                        nbLines, lColors);
-      pointsColorsArray[glEdge->pos + nbNodes] = lColors[0];
+    vector<Color> &lColors = eInfos.lineColors;
+    glEdge->getColors(inputData, ends.first, ends.second, edgeColor, srcColor, tgtColor,
+                      &eInfos.lineVertices[0], nbLines, lColors);
+    pointsColorsArray[glEdge->pos + graph->numberOfNodes()] = lColors[0];
 
-      const unsigned int nbQuads = eInfos.quadVertices.size();
-      auto &quadVertices = eInfos.quadVertices;
+    const unsigned int nbQuads = eInfos.quadVertices.size();
+    auto &quadVertices = eInfos.quadVertices;
 
-      vector<Coord> centerLine;
-      centerLine.reserve(nbQuads / 2);
+    vector<Coord> centerLine;
+    centerLine.reserve(nbQuads / 2);
 
-      for (unsigned int i = 0; i < nbQuads / 2; ++i) {
-        centerLine.push_back((quadVertices[2 * i] + quadVertices[2 * i + 1]) / 2.f);
-      }
-
-      vector<Color> &qColors = eInfos.quadColors;
-      getColors(&centerLine[0], centerLine.size(), srcColor, tgtColor, qColors);
+    for (unsigned int i = 0; i < nbQuads / 2; ++i) {
+      centerLine.push_back((quadVertices[2 * i] + quadVertices[2 * i + 1]) / 2.f);
     }
+
+    vector<Color> &qColors = eInfos.quadColors;
+    getColors(&centerLine[0], centerLine.size(), srcColor, tgtColor, qColors);
   }
 }
 
@@ -737,35 +822,73 @@ void GlVertexArrayManager::visit(GlNode *glNode) {
 void GlVertexArrayManager::endOfVisit() {
   // we now have to build the global vectors
   // with the infos collected during the visit of edges
-  for (auto &eInfos : edgeInfosVector) {
+  if (!toComputeLayout && !toComputeColor)
+    return;
+
+  if (toComputeLayout) {
+    // first compute the offsets of each edge vertices in the global vectors
+    unsigned int nbLinesVertices = 0;
+    unsigned int nbQuadsVertices = 0;
+
+    for (auto &eInfos : edgeInfosVector) {
+      if (eInfos.lineVertices.empty())
+        continue;
+      eInfos.linesIndex = nbLinesVertices;
+      nbLinesVertices += eInfos.lineVertices.size();
+      eInfos.quadsIndex = nbQuadsVertices;
+      nbQuadsVertices += eInfos.quadVertices.size();
+    }
+
+    // no need to initialize each Coord element
+    // as they will be all set below
+    linesCoordsArray.reserve(nbLinesVertices);
+    vector_set_size<Coord>(linesCoordsArray, nbLinesVertices);
+    quadsCoordsArray.reserve(nbQuadsVertices);
+    vector_set_size<Coord>(quadsCoordsArray, nbQuadsVertices);
+  }
+
+  if (toComputeColor) {
+    // the colors are stored at the same offsets than the vertices
+    linesColorsArray.reserve(linesCoordsArray.size());
+    vector_set_size<Color>(linesColorsArray, linesCoordsArray.size());
+    quadsColorsArray.reserve(quadsCoordsArray.size());
+    vector_set_size<Color>(quadsColorsArray, quadsCoordsArray.size());
+    quadsOutlineColorsArray.reserve(quadsCoordsArray.size());
+    vector_set_size<Color>(quadsOutlineColorsArray, quadsCoordsArray.size());
+  }
+
+  // then fill the global vectors concurrently
+  TLP_PARALLEL_MAP_INDICES(edgeInfosVector.size(), [&](unsigned int i) {
+    auto &eInfos = edgeInfosVector[i];
     auto &vertices = eInfos.lineVertices;
     if (vertices.empty())
-      continue;
+      return;
     if (toComputeLayout) {
       // update lines global vectors
-      eInfos.linesIndex = linesCoordsArray.size();
-      linesCoordsArray.insert(linesCoordsArray.end(), vertices.begin(), vertices.end());
+      std::copy(vertices.begin(), vertices.end(), linesCoordsArray.begin() + eInfos.linesIndex);
       // update quads global vectors
       auto &quadVertices = eInfos.quadVertices;
-      eInfos.quadsIndex = quadsCoordsArray.size();
-      quadsCoordsArray.insert(quadsCoordsArray.end(), quadVertices.begin(), quadVertices.end());
+      std::copy(quadVertices.begin(), quadVertices.end(),
+                quadsCoordsArray.begin() + eInfos.quadsIndex);
     }
     if (toComputeColor) {
       auto &lcolors = eInfos.lineColors;
-      linesColorsArray.insert(linesColorsArray.end(), lcolors.begin(), lcolors.end());
+      std::copy(lcolors.begin(), lcolors.end(), linesColorsArray.begin() + eInfos.linesIndex);
 
       auto &qcolors = eInfos.quadColors;
+      auto qColorsIt = quadsColorsArray.begin() + eInfos.quadsIndex;
       if (colorInterpolate)
-        for (size_t i = 0; i < qcolors.size(); ++i) {
-          quadsColorsArray.push_back(qcolors[i]);
-          quadsColorsArray.push_back(qcolors[i]);
+        for (auto &color : qcolors) {
+          *qColorsIt++ = color;
+          *qColorsIt++ = color;
         }
       else
-        quadsColorsArray.insert(quadsColorsArray.end(), 2 * qcolors.size(), eInfos.edgeColor);
-      quadsOutlineColorsArray.insert(quadsOutlineColorsArray.end(), 2 * qcolors.size(),
-                                     eInfos.borderColor);
+        std::fill(qColorsIt, qColorsIt + 2 * qcolors.size(), eInfos.edgeColor);
+      std::fill(quadsOutlineColorsArray.begin() + eInfos.quadsIndex,
+                quadsOutlineColorsArray.begin() + eInfos.quadsIndex + 2 * qcolors.size(),
+                eInfos.borderColor);
     }
-  }
+  });
 }
 
 void GlVertexArrayManager::activateLineEdgeDisplay(GlEdge *glEdge, bool selected) {
@@ -908,10 +1031,182 @@ void GlVertexArrayManager::propertyValueChanged(PropertyInterface *property) {
   edgesModified = false;
 }
 
+// when more elements have been modified, the whole arrays are recomputed
+#define MAX_MODIFIED_ELEMENTS_RATIO 8
+
+bool GlVertexArrayManager::nodeValueChanged(PropertyInterface *property, node n) {
+  if (toComputeLayout || toComputeColor)
+    return false;
+
+  // the value of a node not displayed has no effect
+  if (!graph->isElement(n))
+    return true;
+
+  bool layoutModified;
+
+  if (layoutProperty == property || sizeProperty == property || shapeProperty == property ||
+      rotationProperty == property)
+    layoutModified = true;
+  else if (colorProperty == property || borderColorProperty == property ||
+           borderWidthProperty == property)
+    layoutModified = false;
+  else
+    // the anchor properties are only used for edges
+    return true;
+
+  if (MAX_MODIFIED_ELEMENTS_RATIO *
+          (layoutModifiedNodes.size() + layoutModifiedEdges.size() + colorModifiedNodes.size() +
+           colorModifiedEdges.size()) >
+      graph->numberOfNodes() + graph->numberOfEdges())
+    return false;
+
+  (layoutModified ? layoutModifiedNodes : colorModifiedNodes).insert(graph->nodePos(n));
+  return true;
+}
+
+bool GlVertexArrayManager::edgeValueChanged(PropertyInterface *property, edge e) {
+  if (toComputeLayout || toComputeColor)
+    return false;
+
+  // the value of an edge not displayed has no effect
+  if (!graph->isElement(e))
+    return true;
+
+  bool layoutModified;
+
+  if (layoutProperty == property || sizeProperty == property || shapeProperty == property ||
+      srcAnchorShapeProperty == property || tgtAnchorShapeProperty == property ||
+      srcAnchorSizeProperty == property || tgtAnchorSizeProperty == property)
+    layoutModified = true;
+  else if (colorProperty == property || borderColorProperty == property)
+    layoutModified = false;
+  else
+    // the edges border width and rotation are not stored in the arrays
+    return true;
+
+  if (MAX_MODIFIED_ELEMENTS_RATIO *
+          (layoutModifiedNodes.size() + layoutModifiedEdges.size() + colorModifiedNodes.size() +
+           colorModifiedEdges.size()) >
+      graph->numberOfNodes() + graph->numberOfEdges())
+    return false;
+
+  (layoutModified ? layoutModifiedEdges : colorModifiedEdges).insert(graph->edgePos(e));
+  return true;
+}
+
+void GlVertexArrayManager::updateModifiedElements() {
+  const std::vector<node> &nodes = graph->nodes();
+  const std::vector<edge> &edges = graph->edges();
+  unsigned int nbNodes = nodes.size();
+
+  if (!toComputeLayout) {
+    for (auto pos : layoutModifiedNodes) {
+      node n = nodes[pos];
+      GlNode glNode(n.id, pos);
+      pointsCoordsArray[pos] = glNode.getPoint(inputData);
+      pointsVerticesRanges.emplace_back(pos, 1);
+
+      // the anchors of its edges may have changed
+      for (auto e : graph->allEdges(n))
+        layoutModifiedEdges.insert(graph->edgePos(e));
+    }
+
+    layoutModifiedNodes.clear();
+
+    for (auto pos : layoutModifiedEdges) {
+      edgeInfos &eInfos = edgeInfosVector[pos];
+      size_t nbLines = eInfos.lineVertices.size();
+      size_t nbQuads = eInfos.quadVertices.size();
+      GlEdge glEdge(edges[pos].id, pos);
+      computeEdgeLayout(&glEdge, eInfos);
+
+      if (eInfos.lineVertices.size() != nbLines || eInfos.quadVertices.size() != nbQuads) {
+        // the number of vertices of the edge has changed
+        // so the whole arrays have to be rebuilt
+        clearLayoutData();
+        clearColorData();
+        return;
+      }
+
+      if (nbLines != 0) {
+        pointsVerticesRanges.emplace_back(nbNodes + pos, 1);
+        std::copy(eInfos.lineVertices.begin(), eInfos.lineVertices.end(),
+                  linesCoordsArray.begin() + eInfos.linesIndex);
+        linesVerticesRanges.emplace_back(eInfos.linesIndex, nbLines);
+        std::copy(eInfos.quadVertices.begin(), eInfos.quadVertices.end(),
+                  quadsCoordsArray.begin() + eInfos.quadsIndex);
+        quadsVerticesRanges.emplace_back(eInfos.quadsIndex, nbQuads);
+      }
+
+      // the colors are interpolated along the edge vertices
+      colorModifiedEdges.insert(pos);
+    }
+
+    layoutModifiedEdges.clear();
+  }
+
+  if (!toComputeColor) {
+    for (auto pos : colorModifiedNodes) {
+      node n = nodes[pos];
+      GlNode glNode(n.id, pos);
+      pointsColorsArray[pos] = glNode.getColor(inputData);
+      pointsColorsRanges.emplace_back(pos, 1);
+
+      if (colorInterpolate) {
+        for (auto e : graph->allEdges(n))
+          colorModifiedEdges.insert(graph->edgePos(e));
+      }
+    }
+
+    colorModifiedNodes.clear();
+
+    for (auto pos : colorModifiedEdges) {
+      edgeInfos &eInfos = edgeInfosVector[pos];
+      size_t nbLines = eInfos.lineVertices.size();
+
+      if (nbLines == 0)
+        continue;
+
+      GlEdge glEdge(edges[pos].id, pos);
+      computeEdgeColors(&glEdge, eInfos);
+
+      pointsColorsRanges.emplace_back(nbNodes + pos, 1);
+      std::copy(eInfos.lineColors.begin(), eInfos.lineColors.end(),
+                linesColorsArray.begin() + eInfos.linesIndex);
+      linesColorsRanges.emplace_back(eInfos.linesIndex, nbLines);
+
+      // same filling as in endOfVisit
+      auto qColorsIt = quadsColorsArray.begin() + eInfos.quadsIndex;
+      auto &qcolors = eInfos.quadColors;
+
+      if (colorInterpolate) {
+        for (auto &color : qcolors) {
+          *qColorsIt++ = color;
+          *qColorsIt++ = color;
+        }
+      } else
+        std::fill(qColorsIt, qColorsIt + 2 * qcolors.size(), eInfos.edgeColor);
+
+      std::fill(quadsOutlineColorsArray.begin() + eInfos.quadsIndex,
+                quadsOutlineColorsArray.begin() + eInfos.quadsIndex + 2 * qcolors.size(),
+                eInfos.borderColor);
+      quadsColorsRanges.emplace_back(eInfos.quadsIndex, 2 * qcolors.size());
+    }
+
+    colorModifiedEdges.clear();
+  }
+}
+
 void GlVertexArrayManager::clearLayoutData() {
   toComputeLayout = true;
   verticesUploadNeeded = true;
 
+  layoutModifiedNodes.clear();
+  layoutModifiedEdges.clear();
+  pointsVerticesRanges.clear();
+  linesVerticesRanges.clear();
+  quadsVerticesRanges.clear();
+
   linesCoordsArray.clear();
   pointsCoordsArray.clear();
   quadsCoordsArray.clear();
@@ -925,6 +1220,12 @@ void GlVertexArrayManager::clearColorData() {
   toComputeColor = true;
   colorsUploadNeeded = true;
 
+  colorModifiedNodes.clear();
+  colorModifiedEdges.clear();
+  pointsColorsRanges.clear();
+  linesColorsRanges.clear();
+  quadsColorsRanges.clear();
+
   linesColorsArray.clear();
   pointsColorsArray.clear();
   quadsColorsArray.clear();
@@ -1093,8 +1394,13 @@ void GlVertexArrayManager::treatEvent(const Event &evt) {
     PropertyInterface *property = propertyEvent->getProperty();
 
     switch (propertyEvent->getType()) {
-    case PropertyEvent::TLP_BEFORE_SET_ALL_NODE_VALUE:
     case PropertyEvent::TLP_BEFORE_SET_NODE_VALUE:
+      // only update the data of the modified node if possible
+      if (nodeValueChanged(property, propertyEvent->getNode()))
+        break;
+      // fall through
+
+    case PropertyEvent::TLP_BEFORE_SET_ALL_NODE_VALUE:
       if (shapeProperty == property || sizeProperty == property) {
         edgesModified = true;
       }
@@ -1102,8 +1408,13 @@ void GlVertexArrayManager::treatEvent(const Event &evt) {
       propertyValueChanged(property);
       break;
 
-    case PropertyEvent::TLP_BEFORE_SET_ALL_EDGE_VALUE:
     case PropertyEvent::TLP_BEFORE_SET_EDGE_VALUE:
+      // only update the data of the modified edge if possible
+      if (edgeValueChanged(property, propertyEvent->getEdge()))
+        break;
+      // fall through
+
+    case PropertyEvent::TLP_BEFORE_SET_ALL_EDGE_VALUE:
 
       if (layoutProperty == property || shapeProperty == property ||
           srcAnchorShapeProperty == property || tgtAnchorShapeProperty == property ||
@@ -0,0 +1,126 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <cmath>
+
+#include <tulip/GlyphGeometry.h>
+#include <tulip/BoundingBox.h>
+#include <tulip/DrawingTools.h>
+
+using namespace std;
+
+namespace tlp {
+
+void GlyphGeometry::addPolygon(const vector<Coord> &points) {
+  BoundingBox bb;
+
+  for (const auto &p : points)
+    bb.expand(p);
+
+  Coord center = bb.center();
+  Coord bbSize = bb[1] - bb[0];
+
+  auto texCoord = [&](const Coord &p) {
+    return Vec2f((p[0] - bb[0][0]) / bbSize[0], (p[1] - bb[0][1]) / bbSize[1]);
+  };
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Coord &p1 = points[i];
+    const Coord &p2 = points[(i + 1) % points.size()];
+
+    // a fan of triangles around the center
+    fillVertices.push_back(center);
+    fillVertices.push_back(p1);
+    fillVertices.push_back(p2);
+    fillTexCoords.push_back(texCoord(center));
+    fillTexCoords.push_back(texCoord(p1));
+    fillTexCoords.push_back(texCoord(p2));
+    fillNormals.insert(fillNormals.end(), 3, Coord(0, 0, 1));
+
+    outlineVertices.push_back(p1);
+    outlineVertices.push_back(p2);
+  }
+}
+
+void GlyphGeometry::addRegularPolygon(unsigned int numberOfSides, float startAngle) {
+  addPolygon(computeRegularPolygon(numberOfSides, Coord(0, 0, 0), Size(.5, .5, 0), startAngle));
+}
+
+void GlyphGeometry::addBox() {
+  // for each face, its normal and two vectors spanning it
+  static const float faces[6][3][3] = {
+      {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}},  {{0, 0, -1}, {-1, 0, 0}, {0, 1, 0}},
+      {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}}, {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+      {{0, 1, 0}, {1, 0, 0}, {0, 0, -1}}, {{0, -1, 0}, {1, 0, 0}, {0, 0, 1}}};
+  static const float corners[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+
+  for (unsigned int i = 0; i < 6; ++i) {
+    Coord normal(faces[i][0][0], faces[i][0][1], faces[i][0][2]);
+    Coord u(faces[i][1][0], faces[i][1][1], faces[i][1][2]);
+    Coord v(faces[i][2][0], faces[i][2][1], faces[i][2][2]);
+
+    // two triangles per face
+    for (unsigned int j = 0; j < 6; ++j) {
+      fillVertices.push_back(normal * 0.5f + u * (corners[j][0] - 0.5f) +
+                             v * (corners[j][1] - 0.5f));
+      fillNormals.push_back(normal);
+      fillTexCoords.emplace_back(corners[j][0], corners[j][1]);
+    }
+  }
+
+  // the 12 edges of the cube
+  for (unsigned int i = 0; i < 3; ++i) {
+    for (unsigned int j = 0; j < 4; ++j) {
+      Coord p;
+      p[(i + 1) % 3] = (j & 1) ? 0.5f : -0.5f;
+      p[(i + 2) % 3] = (j & 2) ? 0.5f : -0.5f;
+      p[i] = -0.5f;
+      outlineVertices.push_back(p);
+      p[i] = 0.5f;
+      outlineVertices.push_back(p);
+    }
+  }
+
+  lighting = true;
+}
+
+void GlyphGeometry::addSphere(unsigned int slices, unsigned int stacks) {
+  auto vertex = [&](unsigned int slice, unsigned int stack) {
+    float theta = float(2 * M_PI * slice / slices);
+    float phi = float(M_PI * stack / stacks);
+    Coord normal(sin(phi) * cos(theta), sin(phi) * sin(theta), -cos(phi));
+    fillVertices.push_back(normal * 0.5f);
+    fillNormals.push_back(normal);
+    fillTexCoords.emplace_back(float(slice) / slices, float(stack) / stacks);
+  };
+
+  for (unsigned int i = 0; i < stacks; ++i) {
+    for (unsigned int j = 0; j < slices; ++j) {
+      vertex(j, i);
+      vertex(j + 1, i);
+      vertex(j + 1, i + 1);
+      vertex(j, i);
+      vertex(j + 1, i + 1);
+      vertex(j, i + 1);
+    }
+  }
+
+  lighting = true;
+}
+} // namespace tlp
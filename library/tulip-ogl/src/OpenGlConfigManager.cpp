@@ -38,7 +38,15 @@ std::unordered_map<std::string, bool> OpenGlConfigManager::_checkedExtensions;
 void OpenGlConfigManager::initExtensions() {
   if (!_glewIsInit) {
     glewExperimental = true;
-    _glewIsInit = (glewInit() == GLEW_OK);
+    GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // a GLX based glew reports this error when the current context
+    // has not been created through GLX (EGL headless rendering),
+    // but the OpenGL entry points have been loaded anyway
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY)
+      err = GLEW_OK;
+#endif
+    _glewIsInit = (err == GLEW_OK);
   }
 }
 
@@ -17,189 +17,264 @@
  *
  */
 
+#include <algorithm>
+#include <functional>
+
 #include "Dijkstra.h"
 #include <tulip/LayoutProperty.h>
-#include <tulip/ParallelTools.h>
 
 using namespace tlp;
 using namespace std;
 
-NodeProperty<node> Dijkstra::ndik2tlp;
-EdgeProperty<edge> Dijkstra::edik2tlp;
-MutableContainer<node> Dijkstra::ntlp2dik;
-MutableContainer<edge> Dijkstra::etlp2dik;
-VectorGraph Dijkstra::graph;
-bool Dijkstra::_initB = Dijkstra::initG();
+vector<unsigned int> Dijkstra::adjOffsets;
+vector<pair<unsigned int, unsigned int>> Dijkstra::adjacency;
+vector<Coord> Dijkstra::nodeCoords;
+vector<node> Dijkstra::ndik2tlp;
+vector<unsigned int> Dijkstra::edgePos;
+MutableContainer<unsigned int> Dijkstra::ntlp2dik;
+
+//============================================================
+void Dijkstra::loadGraph(const Graph *src, const Graph *propGraph, const LayoutProperty *layout) {
+  unsigned int nbNodes = src->numberOfNodes();
+  const vector<edge> &edges = src->edges();
+
+  ndik2tlp = src->nodes();
+  nodeCoords.resize(nbNodes);
+  ntlp2dik.setAll(UINT_MAX);
+
+  for (unsigned int i = 0; i < nbNodes; ++i) {
+    node n = ndik2tlp[i];
+    ntlp2dik.set(n.id, i);
+    nodeCoords[i] = layout->getNodeValue(n);
+  }
+
+  // count the adjacencies of each node
+  adjOffsets.assign(nbNodes + 1, 0);
+  edgePos.resize(edges.size());
+
+  for (unsigned int i = 0; i < edges.size(); ++i) {
+    auto eEnds = src->ends(edges[i]);
+    ++adjOffsets[ntlp2dik.get(eEnds.first.id) + 1];
+    ++adjOffsets[ntlp2dik.get(eEnds.second.id) + 1];
+    edgePos[i] = propGraph->edgePos(edges[i]);
+  }
 
-// define the lock needed to protect Dijkstra()/~Dijkstra()
-TLP_DEFINE_GLOBAL_LOCK(DijkstraProps);
+  for (unsigned int i = 0; i < nbNodes; ++i)
+    adjOffsets[i + 1] += adjOffsets[i];
 
+  // then fill them, the edges order is preserved
+  vector<unsigned int> cursor(adjOffsets.begin(), adjOffsets.end() - 1);
+  adjacency.resize(adjOffsets.back());
+
+  for (unsigned int i = 0; i < edges.size(); ++i) {
+    auto eEnds = src->ends(edges[i]);
+    unsigned int s = ntlp2dik.get(eEnds.first.id);
+    unsigned int t = ntlp2dik.get(eEnds.second.id);
+    adjacency[cursor[s]++] = make_pair(t, i);
+    adjacency[cursor[t]++] = make_pair(s, i);
+  }
+}
+//============================================================
+Dijkstra::Dijkstra()
+    : src(UINT_MAX), weights(nullptr), forbiddenGraph(nullptr),
+      nodeDistance(ndik2tlp.size(), DBL_MAX), nodeState(ndik2tlp.size(), 0),
+      forbiddenNodes(ndik2tlp.size(), false), resultEdges(edgePos.size(), false) {}
+//============================================================
+void Dijkstra::resetResultEdges() {
+  for (auto e : touchedEdges)
+    resultEdges[e] = false;
+
+  touchedEdges.clear();
+}
+//============================================================
+bool Dijkstra::isUsedEdge(unsigned int n, unsigned int i) const {
+  const pair<unsigned int, unsigned int> &adj = adjacency[i];
+  unsigned int tgt = adj.first;
+
+  // the edge has been used to reach n from a settled node
+  return (nodeState[tgt] & SETTLED) && (tgt == src || !forbiddenNodes[tgt]) &&
+         fabs(nodeDistance[tgt] + (*weights)[edgePos[adj.second]] - nodeDistance[n]) < 1E-9;
+}
 //============================================================
 void Dijkstra::initDijkstra(const tlp::Graph *const forbidden, tlp::node srcTlp,
-                            const EdgeStaticProperty<double> &weights, const set<node> &fous) {
+                            const EdgeStaticProperty<double> &w, const set<node> &focus,
+                            double maxRadius) {
 
   assert(srcTlp.isValid());
-  src = ntlp2dik.get(srcTlp);
-
-  forbiddenNodes.setAll(false);
 
-  if (forbidden) {
-    for (auto n : forbidden->nodes()) {
-      node ndik = ntlp2dik.get(n);
-      forbiddenNodes[ndik] = true;
-    }
+  // reset the data of the previous computation
+  for (auto n : touchedNodes) {
+    nodeDistance[n] = DBL_MAX;
+    nodeState[n] = 0;
   }
 
-  usedEdges.setAll(false);
+  touchedNodes.clear();
+  resetResultEdges();
 
-  set<DijkstraElement *, LessDijkstraElement> dijkstraTable;
-  set<DijkstraElement *, LessDijkstraElement> focusTable;
+  if (forbidden != forbiddenGraph) {
+    forbiddenNodes.assign(forbiddenNodes.size(), false);
 
-  mapDik.setAll(0);
-  vector<bool> focus(graph.numberOfNodes(), false);
+    if (forbidden) {
+      for (auto n : forbidden->nodes()) {
+        unsigned int ndik = ntlp2dik.get(n.id);
 
-  for (auto n : fous)
-    focus[ntlp2dik.get(n)] = true;
+        if (ndik != UINT_MAX)
+          forbiddenNodes[ndik] = true;
+      }
+    }
+
+    forbiddenGraph = forbidden;
+  }
+
+  src = ntlp2dik.get(srcTlp.id);
+  weights = &w;
 
-  for (auto n : graph.nodes()) {
-    if (n != src) { // init all nodes to +inf
-      DijkstraElement *tmp = new DijkstraElement(DBL_MAX / 2. + 10., node(), n);
-      dijkstraTable.insert(tmp);
+  // the number of focus nodes whose distance is not yet known
+  unsigned int nbFocus = 0;
+  double maxFocusDist = 0;
 
-      if (focus[n])
-        focusTable.insert(tmp);
+  for (auto n : focus) {
+    unsigned int ndik = ntlp2dik.get(n.id);
 
-      mapDik[n] = tmp;
-    } else { // init starting node to 0
-      DijkstraElement *tmp = new DijkstraElement(0, n, n);
-      dijkstraTable.insert(tmp);
-      mapDik[n] = tmp;
+    if (!(nodeState[ndik] & FOCUS)) {
+      nodeState[ndik] = FOCUS;
+      touchedNodes.push_back(ndik);
+      ++nbFocus;
     }
   }
 
-  nodeDistance.setAll(DBL_MAX);
+  const Coord &srcCoord = nodeCoords[src];
+
+  if (!nodeState[src])
+    touchedNodes.push_back(src);
+
+  nodeState[src] |= REACHED;
   nodeDistance[src] = 0;
 
-  while (!dijkstraTable.empty()) {
-    // select the first element in the list the one with min value
-    set<DijkstraElement *, LessDijkstraElement>::iterator it = dijkstraTable.begin();
-    DijkstraElement &u = *(*it);
-    dijkstraTable.erase(it);
+  heap.clear();
+  heap.emplace_back(0, src);
+  greater<pair<double, unsigned int>> cmp;
 
-    if (!focusTable.empty()) {
-      set<DijkstraElement *, LessDijkstraElement>::reverse_iterator it = focusTable.rbegin();
-      double maxDist = (*it)->dist;
+  while (!heap.empty()) {
+    // select the node with the min distance
+    pop_heap(heap.begin(), heap.end(), cmp);
+    double uDist = heap.back().first;
+    unsigned int u = heap.back().second;
+    heap.pop_back();
 
-      if (u.dist > maxDist) {
-        break;
-      }
+    // skip stale entries
+    if ((nodeState[u] & SETTLED) || uDist > nodeDistance[u])
+      continue;
+
+    // the shortest paths to all the focus nodes are known
+    if (!focus.empty() && nbFocus == 0 && uDist > maxFocusDist)
+      break;
+
+    nodeState[u] |= SETTLED;
+
+    if (nodeState[u] & FOCUS) {
+      --nbFocus;
+      maxFocusDist = std::max(maxFocusDist, uDist);
     }
 
-    node n = u.n;
-    if (forbiddenNodes[n] && n != src)
+    if (forbiddenNodes[u] && u != src)
       continue;
 
-    for (auto e : graph.star(n)) {
-      node v = graph.opposite(e, n);
-      DijkstraElement &dEle = *mapDik[v];
-
-      auto eWeight = weights.getEdgeValue(edik2tlp[e]);
-      if (fabs((u.dist + eWeight) - dEle.dist) < 1E-9) // path of the same length
-        dEle.usedEdge.push_back(e);
-      else if ((u.dist + eWeight) < dEle.dist) {
-        // we find a node closer with that path
-        dEle.usedEdge.clear();
-        //**********************************************
-        dijkstraTable.erase(&dEle);
-
-        if (focus[dEle.n]) {
-          focusTable.erase(&dEle);
-        }
+    for (unsigned int i = adjOffsets[u]; i < adjOffsets[u + 1]; ++i) {
+      unsigned int v = adjacency[i].first;
+      double vDist = uDist + w[edgePos[adjacency[i].second]];
 
-        dEle.dist = u.dist + eWeight;
-        dEle.previous = n;
-        dEle.usedEdge.push_back(e);
-        dijkstraTable.insert(&dEle);
+      // we find a node closer with that path
+      if (vDist < nodeDistance[v] && fabs(vDist - nodeDistance[v]) >= 1E-9) {
+        if (!nodeState[v]) {
+          // early termination outside of the given radius
+          if (maxRadius > 0 && nodeCoords[v].dist(srcCoord) > maxRadius)
+            continue;
 
-        if (focus[dEle.n]) {
-          focusTable.insert(&dEle);
+          touchedNodes.push_back(v);
         }
+
+        nodeState[v] |= REACHED;
+        nodeDistance[v] = vDist;
+        heap.emplace_back(vDist, v);
+        push_heap(heap.begin(), heap.end(), cmp);
       }
     }
   }
-
-  for (auto n : graph.nodes()) {
-    DijkstraElement *dEle = mapDik[n];
-    nodeDistance[n] = dEle->dist;
-
-    for (size_t i = 0; i < dEle->usedEdge.size(); ++i) {
-      usedEdges[dEle->usedEdge[i]] = true;
-    }
-
-    delete dEle;
-  }
-
-  resultNodes.setAll(false);
-  resultEdges.setAll(false);
 }
 //=======================================================================
-void Dijkstra::searchPaths(node ntlp, EdgeStaticProperty<unsigned int> &depth) {
+void Dijkstra::searchPaths(node ntlp, EdgeDepths &depth) {
 
-  node n = ntlp2dik.get(ntlp);
+  unsigned int n = ntlp2dik.get(ntlp.id);
 
-  if (resultNodes[n])
+  if (nodeState[n] & RESULT)
     return;
 
-  resultNodes[n] = true;
+  if (!nodeState[n])
+    touchedNodes.push_back(n);
 
-  for (auto e : graph.star(n)) {
+  nodeState[n] |= RESULT;
+  stack.push_back(n);
 
-    if (!usedEdges[e] || resultEdges[e])
-      continue;
+  while (!stack.empty()) {
+    n = stack.back();
+    stack.pop_back();
 
-    node tgt = graph.opposite(e, n);
+    for (unsigned int i = adjOffsets[n]; i < adjOffsets[n + 1]; ++i) {
+      unsigned int e = adjacency[i].second;
 
-    if (nodeDistance[tgt] >= nodeDistance[n])
-      continue;
+      if (resultEdges[e] || !isUsedEdge(n, i))
+        continue;
+
+      unsigned int tgt = adjacency[i].first;
 
-    resultEdges[e] = true;
-    auto ePos = depth.getGraph()->edgePos(edik2tlp[e]);
-    depth[ePos] += 1;
+      if (nodeDistance[tgt] >= nodeDistance[n])
+        continue;
+
+      resultEdges[e] = true;
+      touchedEdges.push_back(e);
+      depth[edgePos[e]].fetch_add(1, std::memory_order_relaxed);
 
-    if (!resultNodes[tgt])
-      searchPaths(ndik2tlp[tgt], depth);
+      if (!(nodeState[tgt] & RESULT)) {
+        nodeState[tgt] |= RESULT;
+        stack.push_back(tgt);
+      }
+    }
   }
 }
 //=============================================================================
 void Dijkstra::searchPath(node ntlp, vector<node> &vNodes) {
 
-  node n = ntlp2dik.get(ntlp);
+  unsigned int n = ntlp2dik.get(ntlp.id);
   node tgte(ntlp);
-  resultEdges.setAll(false);
+  resetResultEdges();
   bool ok = true;
 
   while (ok) {
     vNodes.push_back(ndik2tlp[n]);
     ok = false;
 
-    for (auto e : graph.star(n)) {
+    for (unsigned int i = adjOffsets[n]; i < adjOffsets[n + 1]; ++i) {
+      unsigned int e = adjacency[i].second;
+
       // check if that edge does not belong to the shortest path edges
       // or if it has already been treated
-      if (!usedEdges[e] || resultEdges[e])
+      if (resultEdges[e] || !isUsedEdge(n, i))
         continue;
 
-      node tgt = graph.opposite(e, n);
+      unsigned int tgt = adjacency[i].first;
 
       if (nodeDistance[tgt] >= nodeDistance[n])
         continue;
 
       n = tgt;
       resultEdges[e] = ok = true;
+      touchedEdges.push_back(e);
       break;
     }
   }
 
   if (n != src)
-    cout << "A path does not exist between node " << src.id << " and node " << tgte.id << "!"
-         << endl;
+    cout << "A path does not exist between node " << ndik2tlp[src].id << " and node " << tgte.id
+         << "!" << endl;
 }
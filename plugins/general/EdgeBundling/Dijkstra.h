@@ -20,135 +20,91 @@
 #ifndef DIJKSTRA_H
 #define DIJKSTRA_H
 
+#include <atomic>
 #include <vector>
 #include <set>
 #include <climits>
+#include <cfloat>
 #include <tulip/Graph.h>
 #include <tulip/MutableContainer.h>
 #include <tulip/Vector.h>
 #include <tulip/LayoutProperty.h>
 #include <tulip/StaticProperty.h>
-#include <tulip/vectorgraph.h>
-#include <tulip/ParallelTools.h>
 
 using namespace std;
 
-// we need a lock to protect the allocation/free
-// of needed VectorGraph properties
-TLP_DECLARE_GLOBAL_LOCK(DijkstraProps);
+// the number of shortest paths going through each edge
+// it is concurrently incremented by the threads
+typedef std::vector<std::atomic<unsigned int>> EdgeDepths;
 
+/**
+ * A Dijkstra workspace on the grid graph loaded with loadGraph.
+ * All the needed per node/edge data are allocated once
+ * by the constructor and only the ones touched by a shortest paths
+ * computation are reset before the next one, so a workspace
+ * should be reused by a thread for all its computations.
+ */
 class Dijkstra {
 
 public:
   //============================================================
-  Dijkstra() {
-    TLP_GLOBALLY_LOCK_SECTION(DijkstraProps) {
-      graph.alloc(forbiddenNodes);
-      graph.alloc(usedEdges);
-      graph.alloc(nodeDistance);
-      graph.alloc(resultNodes);
-      graph.alloc(resultEdges);
-      graph.alloc(mapDik);
-    }
-    TLP_GLOBALLY_UNLOCK_SECTION(DijkstraProps);
-  }
-
-  ~Dijkstra() {
-    TLP_GLOBALLY_LOCK_SECTION(DijkstraProps) {
-      graph.free(forbiddenNodes);
-      graph.free(usedEdges);
-      graph.free(nodeDistance);
-      graph.free(resultNodes);
-      graph.free(resultEdges);
-      graph.free(mapDik);
-    }
-    TLP_GLOBALLY_UNLOCK_SECTION(DijkstraProps);
-  }
-
-  static void loadGraph(const tlp::Graph *src) {
-
-    graph.delAllNodes();
-
-    graph.reserveNodes(src->numberOfNodes());
-    graph.reserveEdges(src->numberOfEdges());
-
-    ndik2tlp.setAll(tlp::node());
-    edik2tlp.setAll(tlp::edge());
-    ntlp2dik.setAll(tlp::node());
-    etlp2dik.setAll(tlp::edge());
-
-    for (auto n : src->nodes()) {
-      tlp::node newNode = graph.addNode();
-      ntlp2dik.set(n, newNode);
-      ndik2tlp[newNode] = n;
-      graph.reserveAdj(newNode, src->deg(n));
-    }
-
-    for (auto e : src->edges()) {
-      auto eEnds = src->ends(e);
-      tlp::edge tmp = graph.addEdge(ntlp2dik.get(eEnds.first), ntlp2dik.get(eEnds.second));
-      etlp2dik.set(e, tmp);
-      edik2tlp[tmp] = e;
-    }
-  }
-
+  Dijkstra();
+
+  // load the grid graph, weights and depths are indexed
+  // by the positions of its edges in propGraph
+  static void loadGraph(const tlp::Graph *src, const tlp::Graph *propGraph,
+                        const tlp::LayoutProperty *layout);
+
+  // compute the shortest paths from src,
+  // if the focus set is not empty the computation stops as soon as
+  // the shortest paths to all the focus nodes are known,
+  // if maxRadius is greater than 0 the nodes whose distance to src
+  // is greater than maxRadius are not explored
   void initDijkstra(const tlp::Graph *const forbiddenNodes, tlp::node src,
                     const tlp::EdgeStaticProperty<double> &weights,
-                    const std::set<tlp::node> &focus);
+                    const std::set<tlp::node> &focus, double maxRadius = 0);
 
   //========================================================
-  void searchPaths(tlp::node n, tlp::EdgeStaticProperty<unsigned int> &depth);
+  void searchPaths(tlp::node n, EdgeDepths &depth);
   void searchPath(tlp::node n, std::vector<tlp::node> &vNodes);
   //=============================================================
 private:
-  struct DijkstraElement {
-    DijkstraElement(const double dist = DBL_MAX, const tlp::node previous = tlp::node(),
-                    const tlp::node n = tlp::node())
-        : dist(dist), previous(previous), n(n) {}
-    //=========================================================
-    bool operator==(const DijkstraElement &b) const {
-      return n == b.n;
-    }
-    bool operator!=(const DijkstraElement &b) const {
-      return n != b.n;
-    }
-    double dist;
-    tlp::node previous;
-    tlp::node n;
-    std::vector<tlp::edge> usedEdge;
-  };
-
-  struct LessDijkstraElement {
-    bool operator()(const DijkstraElement *const a, const DijkstraElement *const b) const {
-      if (fabs(a->dist - b->dist) > 1.E-9) {
-        return (a->dist < b->dist);
-      } else {
-        return (a->n.id < b->n.id);
-      }
-    }
+  enum NodeState : unsigned char {
+    REACHED = 0x01,
+    SETTLED = 0x02,
+    FOCUS = 0x04,
+    RESULT = 0x08
   };
 
-  tlp::node src;
-
-  tlp::NodeProperty<double> nodeDistance;
-  tlp::NodeProperty<bool> forbiddenNodes;
-  tlp::EdgeProperty<bool> usedEdges;
-  tlp::NodeProperty<bool> resultNodes;
-  tlp::EdgeProperty<bool> resultEdges;
-  tlp::NodeProperty<DijkstraElement *> mapDik;
-
-  static tlp::VectorGraph graph;
-  static tlp::NodeProperty<tlp::node> ndik2tlp;
-  static tlp::EdgeProperty<tlp::edge> edik2tlp;
-  static tlp::MutableContainer<tlp::node> ntlp2dik;
-  static tlp::MutableContainer<tlp::edge> etlp2dik;
-  static bool _initB;
-
-  static bool initG() {
-    graph.alloc(ndik2tlp);
-    graph.alloc(edik2tlp);
-    return true;
-  }
+  // return true if edge (the i-th adjacency of n)
+  // belongs to a shortest path ending at n
+  bool isUsedEdge(unsigned int n, unsigned int i) const;
+  void resetResultEdges();
+
+  unsigned int src;
+  const tlp::EdgeStaticProperty<double> *weights;
+  const tlp::Graph *forbiddenGraph;
+
+  std::vector<double> nodeDistance;
+  std::vector<unsigned char> nodeState;
+  std::vector<bool> forbiddenNodes;
+  std::vector<bool> resultEdges;
+  // the nodes and edges whose data have to be reset
+  std::vector<unsigned int> touchedNodes;
+  std::vector<unsigned int> touchedEdges;
+  // the priority queue, stale entries are skipped
+  std::vector<std::pair<double, unsigned int>> heap;
+  std::vector<unsigned int> stack;
+
+  // the grid graph stored as adjacency arrays,
+  // the adjacencies of node i are (opposite node, edge)
+  // in [adjOffsets[i], adjOffsets[i + 1][
+  static std::vector<unsigned int> adjOffsets;
+  static std::vector<std::pair<unsigned int, unsigned int>> adjacency;
+  static std::vector<tlp::Coord> nodeCoords;
+  static std::vector<tlp::node> ndik2tlp;
+  static std::vector<unsigned int> edgePos;
+  static tlp::MutableContainer<unsigned int> ntlp2dik;
 };
 
 #endif // DIJKSTRA_H
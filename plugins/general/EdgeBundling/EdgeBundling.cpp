@@ -36,6 +36,7 @@
 #include "BendsTools.h"
 #include "SphereUtils.h"
 
+#include <atomic>
 #include <sstream>
 
 using namespace std;
@@ -80,7 +81,13 @@ static const char *paramHelp[] = {
     "A value of 0 will use as much threads as processors on the host machine.",
 
     // edge_node_overlap
-    "If true, edges can be routed on original nodes."};
+    "If true, edges can be routed on original nodes.",
+
+    // search_radius
+    "If greater than 0, the search of the routing paths from a node is restricted to the "
+    "grid nodes whose distance to it is less than that value multiplied by the length of its "
+    "longest edge to route. Values like 2 or 3 speed up the bundling of large graphs "
+    "while keeping enough room for the edges to take detours."};
 
 //============================================
 EdgeBundling::EdgeBundling(const PluginContext *context) : Algorithm(context) {
@@ -94,6 +101,7 @@ EdgeBundling::EdgeBundling(const PluginContext *context) : Algorithm(context) {
   addInParameter<unsigned int>("iterations", paramHelp[7], "2");
   addInParameter<unsigned int>("max_thread", paramHelp[8], "0");
   addInParameter<bool>("edge_node_overlap", paramHelp[9], "false");
+  addInParameter<double>("search_radius", paramHelp[10], "0");
   addDependency("Voronoi diagram", "1.1");
 }
 //============================================
@@ -169,15 +177,23 @@ void EdgeBundling::fixEdgeType(EdgeStaticProperty<unsigned int> &ntype) {
 //============================================
 static void computeDik(Dijkstra &dijkstra, const Graph *const vertexCoverGraph,
                        const Graph *const oriGraph, const node n,
-                       const EdgeStaticProperty<double> &mWeights, unsigned int optimizatioLevel) {
+                       const EdgeStaticProperty<double> &mWeights, unsigned int optimizatioLevel,
+                       const LayoutProperty *layout, double searchRadius) {
   set<node> focus;
+  double maxRadius = 0;
+
+  if (optimizatioLevel > 0 || searchRadius > 0) {
+    const Coord &nPos = layout->getNodeValue(n);
+
+    for (auto ni : vertexCoverGraph->getInOutNodes(n)) {
+      if (optimizatioLevel > 0)
+        focus.insert(ni);
 
-  if (optimizatioLevel > 0) {
-    for (auto ni : vertexCoverGraph->getInOutNodes(n))
-      focus.insert(ni);
+      maxRadius = std::max(maxRadius, double(nPos.dist(layout->getNodeValue(ni))));
+    }
   }
 
-  dijkstra.initDijkstra(oriGraph, n, mWeights, focus);
+  dijkstra.initDijkstra(oriGraph, n, mWeights, focus, searchRadius * maxRadius);
 }
 //==========================================================================
 void EdgeBundling::computeDistances() {
@@ -215,6 +231,7 @@ bool EdgeBundling::run() {
   bool sphereLayout = false;
   bool keepGrid = false;
   double dist = 50.0;
+  double searchRadius = 0;
 
   SizeProperty *size = graph->getProperty<SizeProperty>("viewSize");
   layout = graph->getProperty<LayoutProperty>("viewLayout");
@@ -229,6 +246,7 @@ bool EdgeBundling::run() {
     dataSet->get("3D_layout", layout3D);
     dataSet->get("grid_graph", keepGrid);
     dataSet->get("sphere_layout", sphereLayout);
+    dataSet->get("search_radius", searchRadius);
     dataSet->get("layout", layout);
     dataSet->get("size", size);
   }
@@ -448,23 +466,27 @@ bool EdgeBundling::run() {
 
   //==========================================================
 
-  EdgeStaticProperty<unsigned int> depth(graph);
+  EdgeDepths depth(graph->numberOfEdges());
 
   // Load the grid graph into an optimized structure for graph traversal
-  Dijkstra::loadGraph(gridGraph);
+  Dijkstra::loadGraph(gridGraph, graph, layout);
+  // and allocate one Dijkstra workspace per thread
+  vector<Dijkstra> dijkstras(ThreadManager::getNumberOfThreads());
 
   // Routing edges into bundles
   for (unsigned int iteration = 0; iteration < MAX_ITER; iteration++) {
 
     if (iteration < MAX_ITER - 1) {
-      depth.setAll(0);
+      for (auto &d : depth)
+        d.store(0);
     }
 
     // used for optimizing the vertex cover problem
     vertexCoverGraph = oriGraph->addCloneSubGraph("vertexCoverGraph");
 
-    MutableContainer<bool> edgeTreated;
-    edgeTreated.setAll(false);
+    vector<std::atomic<bool>> edgeTreated(graph->numberOfEdges());
+    for (auto &treated : edgeTreated)
+      treated.store(false);
     NodeStaticProperty<double> distance(oriGraph);
     SortNodes::dist = &distance;
     computeDistances();
@@ -540,32 +562,19 @@ bool EdgeBundling::run() {
       if (iteration < MAX_ITER - 1) {
         TLP_PARALLEL_MAP_INDICES(nbThreads, [&](unsigned int j) {
           node n = toTreatByThreads[j];
-          Dijkstra dijkstra;
+          Dijkstra &dijkstra = dijkstras[ThreadManager::getThreadNumber()];
 
-          if (edgeNodeOverlap)
-            computeDik(dijkstra, vertexCoverGraph, nullptr, n, mWeights, optimizationLevel);
-          else
-            computeDik(dijkstra, vertexCoverGraph, oriGraph, n, mWeights, optimizationLevel);
+          computeDik(dijkstra, vertexCoverGraph, edgeNodeOverlap ? nullptr : oriGraph, n,
+                     mWeights, optimizationLevel, layout, searchRadius);
 
           // for each edge of n compute the shortest paths in the grid
           for (auto e : vertexCoverGraph->getInOutEdges(n)) {
             node n2 = graph->opposite(e, n);
 
-            if (optimizationLevel < 3 || forceEdgeTest) {
-              bool stop = false;
-              // when we are not using coloration edge can be treated two times
-              TLP_LOCK_SECTION(EDGETREATED) {
-                if (edgeTreated.get(e.id))
-                  stop = true;
-
-                edgeTreated.set(e.id, true);
-              }
-              TLP_UNLOCK_SECTION(EDGETREATED);
-
-              if (stop) {
-                continue;
-              }
-            }
+            // when we are not using coloration edge can be treated two times
+            if ((optimizationLevel < 3 || forceEdgeTest) &&
+                edgeTreated[graph->edgePos(e)].exchange(true))
+              continue;
 
             dijkstra.searchPaths(n2, depth);
           }
@@ -573,29 +582,17 @@ bool EdgeBundling::run() {
       } else {
         TLP_PARALLEL_MAP_INDICES(nbThreads, [&](unsigned int j) {
           node n = toTreatByThreads[j];
-          Dijkstra dijkstra;
+          Dijkstra &dijkstra = dijkstras[ThreadManager::getThreadNumber()];
 
-          if (edgeNodeOverlap)
-            computeDik(dijkstra, vertexCoverGraph, nullptr, n, mWeights, optimizationLevel);
-          else
-            computeDik(dijkstra, vertexCoverGraph, oriGraph, n, mWeights, optimizationLevel);
+          computeDik(dijkstra, vertexCoverGraph, edgeNodeOverlap ? nullptr : oriGraph, n,
+                     mWeights, optimizationLevel, layout, searchRadius);
 
           // for each edge of n compute the shortest paths in the grid
           for (auto e : vertexCoverGraph->getInOutEdges(n)) {
-            if (optimizationLevel < 3 || forceEdgeTest) {
-              bool stop = false;
-              // when we are not using colration edge can be treated two times
-              TLP_LOCK_SECTION(EDGETREATED) {
-                if (edgeTreated.get(e.id))
-                  stop = true;
-
-                edgeTreated.set(e.id, true);
-              }
-              TLP_UNLOCK_SECTION(EDGETREATED);
-
-              if (stop)
-                continue;
-            }
+            // when we are not using coloration edge can be treated two times
+            if ((optimizationLevel < 3 || forceEdgeTest) &&
+                edgeTreated[graph->edgePos(e)].exchange(true))
+              continue;
 
             {
               /// bends
@@ -638,7 +635,7 @@ bool EdgeBundling::run() {
           mWeights[ePos] = mWeightsInit[ePos];
         } else {
           // double avgdepth = weightFactor * depth.getEdgeValue(e) + 1.;
-          double avgdepth = depth.getEdgeValue(e);
+          double avgdepth = depth[ePos].load();
 
           if (avgdepth > 0)
             mWeights[ePos] = mWeightsInit[ePos] / (log(avgdepth) + 1);
@@ -17,12 +17,13 @@
  *
  */
 
-#include <tulip/MutableContainer.h>
+#include <unordered_map>
+
 #include <tulip/LayoutProperty.h>
 #include <tulip/SizeProperty.h>
 #include <tulip/DoubleProperty.h>
-#include <tulip/SimpleTest.h>
 #include <tulip/TulipException.h>
+#include <tulip/ParallelTools.h>
 
 #include "OctreeBundle.h"
 
@@ -36,24 +37,6 @@ void OctreeBundle::compute(Graph *g, double splitRatio, tlp::LayoutProperty *lay
   tmp.createOctree(g, layout, size);
 }
 //=====================================
-node OctreeBundle::splitEdge(node a, node b) {
-  const Coord &cA = layout->getNodeValue(a);
-  const Coord &cB = layout->getNodeValue(b);
-  Coord &&center = (cA + cB) / 2.0f;
-
-  MapVecNode::const_iterator itn = mapN.find(center);
-
-  if (itn != mapN.end()) {
-    return itn->second;
-  }
-
-  node n = graph->addNode();
-  resultNode.push_back(n);
-  layout->setNodeValue(n, center);
-  mapN[center] = n;
-  return n;
-}
-//=====================================
 bool OctreeBundle::isIn(const Coord &p, const Coord &a, const Coord &b, const Coord &c,
                         const Coord &) {
   if (p[0] < a[0])
@@ -78,7 +61,8 @@ bool OctreeBundle::isIn(const Coord &p, const Coord &a, const Coord &b, const Co
 }
 //=====================================
 void OctreeBundle::elmentSplitting(const Coord &a, const Coord &b, const Coord &c, const Coord &d,
-                                   const vector<node> &input, vector<node> &in, vector<node> &out) {
+                                   const vector<unsigned int> &input, vector<unsigned int> &in,
+                                   vector<unsigned int> &out) const {
   if (!((a[0] < b[0]) && (a[1] < b[1])))
     throw TulipException("Two nodes have the same position.\nTry to apply the \"Fast Overlap "
                          "Removal\" algorithm first.");
@@ -86,71 +70,23 @@ void OctreeBundle::elmentSplitting(const Coord &a, const Coord &b, const Coord &
   in.clear();
   out.clear();
 
-  for (auto n : input) {
-    const Coord &tmp = layout->getNodeValue(n);
-
-    if (isIn(tmp, a, b, c, d))
-      in.push_back(n);
+  for (auto i : input) {
+    if (isIn(coords[i], a, b, c, d))
+      in.push_back(i);
     else
-      out.push_back(n);
+      out.push_back(i);
   }
 }
 //=====================================
-node OctreeBundle::addNode(const tlp::Coord &pos) {
-  MapVecNode::const_iterator itn = mapN.find(pos);
-
-  if (itn == mapN.end()) {
-    node n = graph->addNode();
-    layout->setNodeValue(n, pos);
-    mapN[pos] = n;
-    return n;
-  }
-
-  return itn->second;
+bool OctreeBundle::isLeaf(const Coord fr[4], const Coord ba[4],
+                          const vector<unsigned int> &input) const {
+  return (input.size() == 1 && (fr[0] - ba[2]).norm() < (minSize / (splitRatio * 2.))) ||
+         (input.size() == 0 && (fr[0] - ba[2]).norm() < (minSize / (splitRatio)));
 }
-
-void OctreeBundle::recQuad(const Coord fr[4], const Coord ba[4], const vector<node> &input) {
-
-  node frN[4];
-  node baN[4];
-
-  for (int i = 0; i < 4; ++i) {
-    frN[i] = addNode(fr[i]);
-    baN[i] = addNode(ba[i]);
-  }
-
-  for (int i = 0; i < 4; ++i) {
-    graph->addEdge(frN[i], baN[i]);
-  }
-
-  for (int i = 0; i < 4; ++i) {
-    graph->addEdge(frN[i], frN[(i + 1) % 4]);
-    graph->addEdge(baN[i], baN[(i + 1) % 4]);
-  }
-
-  if (input.size() == 1 && (fr[0] - ba[2]).norm() < (minSize / (splitRatio * 2.))) {
-    node src = input[0];
-
-    for (int i = 0; i < 4; ++i) {
-      graph->addEdge(src, baN[i]);
-      graph->addEdge(src, frN[i]);
-    }
-
-    return;
-  }
-
-  if (input.size() == 0 && (fr[0] - ba[2]).norm() < (minSize / (splitRatio)))
-    return;
-
-  for (int i = 0; i < 4; ++i) {
-    unvalidEdges.push_back(pair<node, node>(frN[i], baN[i]));
-  }
-
-  for (int i = 0; i < 4; ++i) {
-    unvalidEdges.push_back(pair<node, node>(frN[i], frN[(i + 1) % 4]));
-    unvalidEdges.push_back(pair<node, node>(baN[i], baN[(i + 1) % 4]));
-  }
-
+//=====================================
+void OctreeBundle::splitCell(const Coord fr[4], const Coord ba[4], const vector<unsigned int> &input,
+                             Coord subFr[8][4], Coord subBa[8][4],
+                             vector<unsigned int> subInputs[8]) const {
   // create nodes
   /**
 
@@ -217,55 +153,86 @@ void OctreeBundle::recQuad(const Coord fr[4], const Coord ba[4], const vector<no
     backFace[i][(i + 3) % 4] = (ba[i] + ba[(i + 3) % 4]) / 2.f;
   }
 
-  vector<node> in, out, input2;
-  input2 = input;
+  vector<unsigned int> out, input2(input);
 
   for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      subFr[2 * i][j] = frontFace[i][j];
+      subBa[2 * i][j] = subFr[2 * i + 1][j] = middleFace[i][j];
+      subBa[2 * i + 1][j] = backFace[i][j];
+    }
+
     elmentSplitting(frontFace[i][0], frontFace[i][2], middleFace[i][0], middleFace[i][2], input2,
-                    in, out);
-    recQuad(frontFace[i], middleFace[i], in);
-    input2 = out;
+                    subInputs[2 * i], out);
+    input2.swap(out);
 
     if (i != 3) {
       elmentSplitting(middleFace[i][0], middleFace[i][2], backFace[i][0], backFace[i][2], input2,
-                      in, out);
-      input2 = out;
-      recQuad(middleFace[i], backFace[i], in);
+                      subInputs[2 * i + 1], out);
+      input2.swap(out);
     } else
-      recQuad(middleFace[i], backFace[i], out);
+      subInputs[2 * i + 1].swap(input2);
   }
+}
+//=====================================
+void OctreeBundle::recQuad(const Coord fr[4], const Coord ba[4], const vector<unsigned int> &input,
+                           vector<Coord> &points) const {
+  // the corners of each cell are nodes of the grid
+  for (int i = 0; i < 4; ++i) {
+    points.push_back(fr[i]);
+    points.push_back(ba[i]);
+  }
+
+  if (isLeaf(fr, ba, input))
+    return;
+
+  Coord subFr[8][4], subBa[8][4];
+  vector<unsigned int> subInputs[8];
+  splitCell(fr, ba, input, subFr, subBa, subInputs);
 
-  //
-  //    //split elements in each cell
-  //    vector<node> in, out, out2;
-  //    elmentSplitting(cA, cE, input, in, out);
-  //
-  //    ++iii;
-  //    recQuad(a,f,e,i, in);
-  //    //-----------
-  //    elmentSplitting(cF, cG, out, in, out2);
-  //    recQuad(f,b,g,e, in );
-  //    //-----------
-  //    elmentSplitting(cE, cC, out2, in, out);
-  //    recQuad(e,g,c,h, in);
-  //    //-----------
-  //    recQuad(i,e,h,d, out);
+  for (int i = 0; i < 8; ++i)
+    recQuad(subFr[i], subBa[i], subInputs[i], points);
 }
-//========================================================
-void OctreeBundle::createOctree(Graph *graph, tlp::LayoutProperty *lay, tlp::SizeProperty *siz) {
-  // create the border of the Quadtree
-  nbNodesInOriginalGraph = graph->numberOfNodes();
-  layout = graph->getProperty<LayoutProperty>("viewLayout");
-  size = graph->getProperty<SizeProperty>("viewSize");
-  rot = graph->getProperty<DoubleProperty>("viewRotation");
+//=====================================
+void OctreeBundle::splitCells(const Coord fr[4], const Coord ba[4],
+                              const vector<unsigned int> &input, unsigned int depth,
+                              vector<Cell> &cells) const {
+  cells.emplace_back();
+  Cell &cell = cells.back();
+
+  for (int i = 0; i < 4; ++i) {
+    cell.fr[i] = fr[i];
+    cell.ba[i] = ba[i];
+  }
+
+  // the cell will be split in a thread
+  if ((cell.split = (depth == 0))) {
+    cell.input = input;
+    return;
+  }
 
-  if (lay)
-    layout = lay;
+  // or its corners are immediately added
+  for (int i = 0; i < 4; ++i) {
+    cell.points.push_back(fr[i]);
+    cell.points.push_back(ba[i]);
+  }
 
-  if (siz)
-    size = siz;
+  if (isLeaf(fr, ba, input))
+    return;
 
-  this->graph = graph;
+  Coord subFr[8][4], subBa[8][4];
+  vector<unsigned int> subInputs[8];
+  splitCell(fr, ba, input, subFr, subBa, subInputs);
+
+  for (int i = 0; i < 8; ++i)
+    splitCells(subFr[i], subBa[i], subInputs[i], depth - 1, cells);
+}
+//========================================================
+void OctreeBundle::createOctree(Graph *graph, tlp::LayoutProperty *lay, tlp::SizeProperty *siz) {
+  // create the border of the Quadtree
+  LayoutProperty *layout = lay ? lay : graph->getProperty<LayoutProperty>("viewLayout");
+  SizeProperty *size = siz ? siz : graph->getProperty<SizeProperty>("viewSize");
+  DoubleProperty *rot = graph->getProperty<DoubleProperty>("viewRotation");
 
   BoundingBox bb = tlp::computeBoundingBox(graph, layout, size, rot);
 
@@ -312,20 +279,67 @@ void OctreeBundle::createOctree(Graph *graph, tlp::LayoutProperty *lay, tlp::Siz
   ba[2] = Coord(bb[1][0], bb[1][1], bb[1][2]);
   ba[3] = Coord(bb[0][0], bb[1][1], bb[1][2]);
 
-  recQuad(fr, ba, graph->nodes());
+  // the grid nodes at the same position are merged
+  typedef std::unordered_map<tlp::Coord, tlp::node> MapVecNode;
+  MapVecNode mapN;
+  auto addNode = [&](const Coord &pos) {
+    if (mapN.find(pos) == mapN.end()) {
+      node n = graph->addNode();
+      layout->setNodeValue(n, pos);
+      mapN[pos] = n;
+    }
+  };
+
+  // the elements to split are the graph nodes
+  // and the corners of the root cell
+  coords.reserve(graph->numberOfNodes() + 8);
 
-  for (size_t i = 0; i < unvalidEdges.size(); ++i) {
-    node src = unvalidEdges[i].first;
-    node tgt = unvalidEdges[i].second;
-    edge e;
+  for (auto n : graph->nodes())
+    coords.push_back(layout->getNodeValue(n));
 
-    if ((e = graph->existEdge(src, tgt)).isValid())
-      graph->delEdge(e, true);
+  for (int i = 0; i < 4; ++i) {
+    for (const Coord &corner : {fr[i], ba[i]}) {
+      if (mapN.find(corner) == mapN.end())
+        coords.push_back(corner);
 
-    if ((e = graph->existEdge(tgt, src)).isValid())
-      graph->delEdge(e, true);
+      addNode(corner);
+    }
   }
 
-  vector<edge> tmpE;
-  SimpleTest::makeSimple(graph, tmpE);
+  vector<unsigned int> input(coords.size());
+
+  for (unsigned int i = 0; i < input.size(); ++i)
+    input[i] = i;
+
+  // the upper levels of the octree are sequentially split
+  // in enough cells to feed the threads
+  unsigned int nbLevels = 1;
+
+  while ((1u << (3 * nbLevels)) < 4 * ThreadManager::getNumberOfThreads())
+    ++nbLevels;
+
+  vector<Cell> cells;
+  splitCells(fr, ba, input, nbLevels, cells);
+
+  // then each cell is independently split
+  TLP_PARALLEL_MAP_INDICES(cells.size(), [&](unsigned int i) {
+    Cell &cell = cells[i];
+
+    if (cell.split) {
+      try {
+        recQuad(cell.fr, cell.ba, cell.input, cell.points);
+      } catch (TulipException &e) {
+        cell.error = e.what();
+      }
+    }
+  });
+
+  // add the resulting grid nodes in the cells order
+  for (const Cell &cell : cells) {
+    if (!cell.error.empty())
+      throw TulipException(cell.error);
+
+    for (const Coord &p : cell.points)
+      addNode(p);
+  }
 }
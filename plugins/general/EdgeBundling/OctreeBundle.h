@@ -19,6 +19,8 @@
 
 #ifndef OCTREEBUNDLE_H
 #define OCTREEBUNDLE_H
+#include <string>
+#include <vector>
 #include <tulip/Vector.h>
 #include <tulip/DrawingTools.h>
 
@@ -36,25 +38,36 @@ protected:
 
 private:
   double minSize;
-  double nbNodesInOriginalGraph;
-  std::vector<tlp::node> resultNode;
-  tlp::LayoutProperty *layout;
-  tlp::SizeProperty *size;
-  tlp::DoubleProperty *rot;
-  tlp::Graph *graph;
   double splitRatio;
-  typedef std::unordered_map<tlp::Coord, tlp::node> MapVecNode;
-  MapVecNode mapN;
-  //=====================================
-  tlp::node splitEdge(tlp::node a, tlp::node b);
+  // the positions of the elements to split
+  std::vector<tlp::Coord> coords;
+  // a cell (given by its front and back faces) to split in a thread
+  // and the corners of the cells it contains
+  struct Cell {
+    tlp::Coord fr[4], ba[4];
+    std::vector<unsigned int> input;
+    std::vector<tlp::Coord> points;
+    std::string error;
+    bool split;
+  };
   //=====================================
   void elmentSplitting(const tlp::Coord &a, const tlp::Coord &b, const tlp::Coord &c,
-                       const tlp::Coord &d, const std::vector<tlp::node> &input,
-                       std::vector<tlp::node> &in, std::vector<tlp::node> &out);
+                       const tlp::Coord &d, const std::vector<unsigned int> &input,
+                       std::vector<unsigned int> &in, std::vector<unsigned int> &out) const;
+  //=====================================
+  bool isLeaf(const tlp::Coord fr[4], const tlp::Coord ba[4],
+              const std::vector<unsigned int> &input) const;
+  //=====================================
+  void splitCell(const tlp::Coord fr[4], const tlp::Coord ba[4],
+                 const std::vector<unsigned int> &input, tlp::Coord subFr[8][4],
+                 tlp::Coord subBa[8][4], std::vector<unsigned int> subInputs[8]) const;
+  //=====================================
+  void recQuad(const tlp::Coord fr[4], const tlp::Coord ba[4],
+               const std::vector<unsigned int> &input, std::vector<tlp::Coord> &points) const;
   //=====================================
-  void recQuad(const tlp::Coord fr[4], const tlp::Coord ba[4], const std::vector<tlp::node> &input);
-  tlp::node addNode(const tlp::Coord &pos);
-  std::vector<std::pair<tlp::node, tlp::node>> unvalidEdges;
+  void splitCells(const tlp::Coord fr[4], const tlp::Coord ba[4],
+                  const std::vector<unsigned int> &input, unsigned int depth,
+                  std::vector<Cell> &cells) const;
 };
 
 #endif // OCTREEBUNDLE_H
@@ -22,6 +22,7 @@
 #include <tulip/SizeProperty.h>
 #include <tulip/DoubleProperty.h>
 #include <tulip/TulipException.h>
+#include <tulip/ParallelTools.h>
 
 #include "QuadTree.h"
 using namespace tlp;
@@ -34,28 +35,6 @@ void QuadTreeBundle::compute(Graph *g, double splitRatio, tlp::LayoutProperty *l
   tmp.createQuadTree(g, layout, size);
 }
 //=====================================
-node QuadTreeBundle::splitEdge(node a, node b) {
-  const Coord &cA = layout->getNodeValue(a);
-  const Coord &cB = layout->getNodeValue(b);
-  Coord &&center = (cA + cB) / 2.0f;
-  center[2] = 0;
-  Vec2D tmp;
-  tmp[0] = center[0];
-  tmp[1] = center[1];
-
-  MapVecNode::const_iterator itn = mapN.find(tmp);
-
-  if (itn != mapN.end()) {
-    return itn->second;
-  }
-
-  node n = graph->addNode();
-  resultNode.push_back(n);
-  layout->setNodeValue(n, center);
-  mapN[tmp] = n;
-  return n;
-}
-//=====================================
 bool QuadTreeBundle::isIn(const Coord &p, const Coord &a, const Coord &b) {
   if (p[0] < a[0])
     return false;
@@ -72,8 +51,9 @@ bool QuadTreeBundle::isIn(const Coord &p, const Coord &a, const Coord &b) {
   return true;
 }
 //=====================================
-void QuadTreeBundle::elmentSplitting(const Coord &a, const Coord &b, const vector<node> &input,
-                                     vector<node> &in, vector<node> &out) {
+void QuadTreeBundle::elmentSplitting(const Coord &a, const Coord &b,
+                                     const vector<unsigned int> &input, vector<unsigned int> &in,
+                                     vector<unsigned int> &out) const {
   if (!((a[0] < b[0]) && (a[1] < b[1])))
     throw TulipException("2 nodes have the same position.\nTry to apply the \"Fast Overlap "
                          "Removal\" algorithm before.");
@@ -81,60 +61,17 @@ void QuadTreeBundle::elmentSplitting(const Coord &a, const Coord &b, const vecto
   in.clear();
   out.clear();
 
-  for (auto n : input) {
-    const Coord &tmp = layout->getNodeValue(n);
-
-    if (isIn(tmp, a, b))
-      in.push_back(n);
+  for (auto i : input) {
+    if (isIn(coords[i], a, b))
+      in.push_back(i);
     else
-      out.push_back(n);
+      out.push_back(i);
   }
 }
 //=====================================
-
-static int iii = 0;
-
-void QuadTreeBundle::recQuad(const node a, const node b, const node c, const node d,
-                             const vector<node> &input) {
-
-  const Coord &cA = layout->getNodeValue(a);
-  const Coord &cC = layout->getNodeValue(c);
-
-  //  if (input.size() == 0) { // && (cA - cC).norm() < (minSize/splitRatio)) {
-  //    //node n = graph->addNode();
-  //    //      resultNode.push_back(n);
-  //    //layout->setNodeValue(n, (cA + cC) / 2.0);
-  //    return;
-  //  }
-  //
-  //  if (input.size() == 1) { // && (cA - cC).norm() < (minSize/(splitRatio * 2.)) ) {
-  //    graph->addEdge(input[0], a);
-  //    graph->addEdge(input[0], b);
-  //    graph->addEdge(input[0], c);
-  //    graph->addEdge(input[0], d);
-  //    return;
-  //  }
-
-  if ((input.size() == 0) && (cA - cC).norm() < (minSize / splitRatio)) {
-    node n = graph->addNode();
-    layout->setNodeValue(n, (cA + cC) / 2.0f);
-    return;
-  }
-
-  if ((input.size() == 1) && (cA - cC).norm() < (minSize / (splitRatio * 2.f))) {
-    return;
-  }
-
-  node f = splitEdge(a, b);
-  node g = splitEdge(b, c);
-  node h = splitEdge(d, c);
-  node i = splitEdge(a, d);
-
-  const Coord &cF = layout->getNodeValue(f);
-  const Coord &cG = layout->getNodeValue(g);
-  const Coord &cI = layout->getNodeValue(i);
-
-  // create nodes
+void QuadTreeBundle::splitCell(const Coord &a, const Coord &c, const vector<unsigned int> &input,
+                               Coord subCells[4][2], vector<unsigned int> subInputs[4]) const {
+  // compute the sub cells
   /**
       a---------b          a----f----b
       |         |          |    |    |
@@ -144,74 +81,78 @@ void QuadTreeBundle::recQuad(const node a, const node b, const node c, const nod
       |         |          |    |    |
       d---------c          d----h----c
    */
-  node e = graph->addNode();
-  resultNode.push_back(e);
-  Coord &&cE = (cI + cG) / 2.0f;
-  cE[2] = 0;
-  layout->setNodeValue(e, cE);
+  Coord &&e = (a + c) / 2.0f;
+  Coord f(e[0], a[1], 0);
+  Coord g(c[0], e[1], 0);
+  Coord h(e[0], c[1], 0);
+  Coord i(a[0], e[1], 0);
+
+  subCells[0][0] = a;
+  subCells[0][1] = e;
+  subCells[1][0] = f;
+  subCells[1][1] = g;
+  subCells[2][0] = e;
+  subCells[2][1] = c;
+  subCells[3][0] = i;
+  subCells[3][1] = h;
 
-  Vec2D tmp;
-  tmp[0] = cE[0];
-  tmp[1] = cE[1];
-  mapN[tmp] = e;
+  // split elements in each cell
+  vector<unsigned int> out, out2;
+  elmentSplitting(a, e, input, subInputs[0], out);
+  elmentSplitting(f, g, out, subInputs[1], out2);
+  elmentSplitting(e, c, out2, subInputs[2], subInputs[3]);
+}
+//=====================================
+void QuadTreeBundle::recQuad(const Coord &a, const Coord &c, const vector<unsigned int> &input,
+                             vector<Coord> &points) const {
+  float norm = (a - c).norm();
 
-  /**
-      a---------b          a----f----b
-      |         |          |    |    |
-      |         |          |    |    |
-      |         |          i----e----g
-      |         |   =>     |    |    |
-      |         |          |    |    |
-      d---------c          d----h----c
-   */
+  // the center of an empty leaf cell is a node of the grid
+  if ((input.size() == 0) && norm < (minSize / splitRatio)) {
+    points.push_back((a + c) / 2.0f);
+    return;
+  }
+
+  if ((input.size() == 1) && norm < (minSize / (splitRatio * 2.f))) {
+    return;
+  }
 
-  //  graph->addEdge(a, f);
-  //  graph->addEdge(f, b);
-  //  graph->addEdge(b, g);
-  //  graph->addEdge(g, c);
-  //  graph->addEdge(c, h);
-  //  graph->addEdge(h, d);
-  //  graph->addEdge(d, i);
-  //  graph->addEdge(i, a);
-  //  graph->addEdge(i, e);
-  //  graph->addEdge(e, g);
-  //  graph->addEdge(f, e);
-  //  graph->addEdge(e, h);
+  Coord subCells[4][2];
+  vector<unsigned int> subInputs[4];
+  splitCell(a, c, input, subCells, subInputs);
 
-  // split elements in each cell
-  vector<node> in, out, out2;
-
-  elmentSplitting(cA, cE, input, in, out);
-
-  ++iii;
-  recQuad(a, f, e, i, in);
-  //-----------
-  elmentSplitting(cF, cG, out, in, out2);
-  recQuad(f, b, g, e, in);
-  //-----------
-  elmentSplitting(cE, cC, out2, in, out);
-  recQuad(e, g, c, h, in);
-  //-----------
-  recQuad(i, e, h, d, out);
+  for (unsigned int i = 0; i < 4; ++i)
+    recQuad(subCells[i][0], subCells[i][1], subInputs[i], points);
+}
+//=====================================
+void QuadTreeBundle::splitCells(const Coord &a, const Coord &c, const vector<unsigned int> &input,
+                                unsigned int depth, vector<Cell> &cells) const {
+  float norm = (a - c).norm();
+
+  if (depth == 0 || ((input.size() == 0) && norm < (minSize / splitRatio)) ||
+      ((input.size() == 1) && norm < (minSize / (splitRatio * 2.f)))) {
+    cells.emplace_back();
+    Cell &cell = cells.back();
+    cell.a = a;
+    cell.c = c;
+    cell.input = input;
+    return;
+  }
+
+  Coord subCells[4][2];
+  vector<unsigned int> subInputs[4];
+  splitCell(a, c, input, subCells, subInputs);
+
+  for (unsigned int i = 0; i < 4; ++i)
+    splitCells(subCells[i][0], subCells[i][1], subInputs[i], depth - 1, cells);
 }
 //========================================================
 void QuadTreeBundle::createQuadTree(Graph *graph, tlp::LayoutProperty *lay,
                                     tlp::SizeProperty *siz) {
   // create the border of the Quadtree
-  nbNodesInOriginalGraph = graph->numberOfNodes();
-
-  if (!lay)
-    layout = graph->getProperty<LayoutProperty>("viewLayout");
-  else
-    layout = lay;
-
-  if (!siz)
-    size = graph->getProperty<SizeProperty>("viewSize");
-  else
-    size = siz;
-
-  rot = graph->getProperty<DoubleProperty>("viewRotation");
-  this->graph = graph;
+  LayoutProperty *layout = lay ? lay : graph->getProperty<LayoutProperty>("viewLayout");
+  SizeProperty *size = siz ? siz : graph->getProperty<SizeProperty>("viewSize");
+  DoubleProperty *rot = graph->getProperty<DoubleProperty>("viewRotation");
 
   BoundingBox bb = tlp::computeBoundingBox(graph, layout, size, rot);
 
@@ -240,37 +181,85 @@ void QuadTreeBundle::createQuadTree(Graph *graph, tlp::LayoutProperty *lay,
     bb[0][0] = (bb[0][0] - center) * ratio + center;
   }
 
+  Coord cA(bb[0][0], bb[0][1], 0);
+  Coord cB(bb[1][0], bb[0][1], 0);
+  Coord cC(bb[1][0], bb[1][1], 0);
+  Coord cD(bb[0][0], bb[1][1], 0);
+
   node a = graph->addNode();
   node b = graph->addNode();
   node c = graph->addNode();
   node d = graph->addNode();
 
-  //  graph->addEdge(a, b);
-  //  graph->addEdge(b, c);
-  //  graph->addEdge(c, d);
-  //  graph->addEdge(d, a);
-
-  /*
-  resultNode.push_back(a);
-  resultNode.push_back(b);
-  resultNode.push_back(c);
-  resultNode.push_back(d);
-   */
   assert(bb[0][0] < bb[1][0]);
   assert(bb[0][1] < bb[1][1]);
 
-  layout->setNodeValue(a, Coord(bb[0][0], bb[0][1], 0));
-  layout->setNodeValue(c, Coord(bb[1][0], bb[1][1], 0));
-
-  Coord cB(bb[1][0], bb[0][1], 0);
-  Coord cD(bb[0][0], bb[1][1], 0);
-
+  layout->setNodeValue(a, cA);
+  layout->setNodeValue(c, cC);
   layout->setNodeValue(b, cB);
   layout->setNodeValue(d, cD);
 
-  recQuad(a, b, c, d, graph->nodes());
+  // the elements to split are the graph nodes (including the border ones)
+  // and, for the root cell only, its split points
+  Coord cE = (cA + cC) / 2.0f;
+  coords.reserve(graph->numberOfNodes() + 5);
+
+  for (auto n : graph->nodes())
+    coords.push_back(layout->getNodeValue(n));
+
+  coords.push_back(Coord(cE[0], cA[1], 0));
+  coords.push_back(Coord(cC[0], cE[1], 0));
+  coords.push_back(Coord(cE[0], cC[1], 0));
+  coords.push_back(Coord(cA[0], cE[1], 0));
+  coords.push_back(cE);
+
+  vector<unsigned int> input(coords.size());
+
+  for (unsigned int i = 0; i < input.size(); ++i)
+    input[i] = i;
+
+  // the upper levels of the quadtree are sequentially split
+  // in enough cells to feed the threads
+  unsigned int depth = 0;
+
+  while ((1u << (2 * (depth + 1))) < 4 * ThreadManager::getNumberOfThreads())
+    ++depth;
+
+  Coord subCells[4][2];
+  vector<unsigned int> subInputs[4];
+  vector<Cell> cells;
+  splitCell(cA, cC, input, subCells, subInputs);
+
+  for (unsigned int i = 0; i < 4; ++i)
+    splitCells(subCells[i][0], subCells[i][1], subInputs[i], depth, cells);
+
+  // then each cell is independently split
+  TLP_PARALLEL_MAP_INDICES(cells.size(), [&](unsigned int i) {
+    Cell &cell = cells[i];
+
+    try {
+      recQuad(cell.a, cell.c, cell.input, cell.points);
+    } catch (TulipException &e) {
+      cell.error = e.what();
+    }
+  });
+
+  // add the resulting grid nodes in the cells order
+  unsigned int nbPoints = 0;
+
+  for (const Cell &cell : cells) {
+    if (!cell.error.empty())
+      throw TulipException(cell.error);
+
+    nbPoints += cell.points.size();
+  }
+
+  vector<node> gridNodes;
+  graph->addNodes(nbPoints, gridNodes);
+  nbPoints = 0;
 
-  for (size_t i = 0; i < resultNode.size(); ++i) {
-    graph->delNode(resultNode[i], true);
+  for (const Cell &cell : cells) {
+    for (const Coord &p : cell.points)
+      layout->setNodeValue(gridNodes[nbPoints++], p);
   }
 }
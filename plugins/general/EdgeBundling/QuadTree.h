@@ -19,7 +19,7 @@
 
 #ifndef QUADTREE_H
 #define QUADTREE_H
-#include <unordered_map>
+#include <string>
 #include <vector>
 #include <tulip/Graph.h>
 #include <tulip/Vector.h>
@@ -38,24 +38,29 @@ protected:
 
 private:
   double minSize;
-  double nbNodesInOriginalGraph;
-  std::vector<tlp::node> resultNode;
-  tlp::LayoutProperty *layout;
-  tlp::SizeProperty *size;
-  tlp::DoubleProperty *rot;
-  tlp::Graph *graph;
   double splitRatio;
-  typedef tlp::Vec2d Vec2D;
-  typedef std::unordered_map<Vec2D, tlp::node> MapVecNode;
-  MapVecNode mapN;
-  //=====================================
-  tlp::node splitEdge(tlp::node a, tlp::node b);
+  // the positions of the elements to split
+  std::vector<tlp::Coord> coords;
+  // a cell (given by its min and max corners) to split in a thread
+  // and the centers of its resulting empty leaf cells
+  struct Cell {
+    tlp::Coord a, c;
+    std::vector<unsigned int> input;
+    std::vector<tlp::Coord> points;
+    std::string error;
+  };
   //=====================================
   void elmentSplitting(const tlp::Coord &a, const tlp::Coord &b,
-                       const std::vector<tlp::node> &input, std::vector<tlp::node> &in,
-                       std::vector<tlp::node> &out);
+                       const std::vector<unsigned int> &input, std::vector<unsigned int> &in,
+                       std::vector<unsigned int> &out) const;
+  //=====================================
+  void splitCell(const tlp::Coord &a, const tlp::Coord &c, const std::vector<unsigned int> &input,
+                 tlp::Coord subCells[4][2], std::vector<unsigned int> subInputs[4]) const;
+  //=====================================
+  void recQuad(const tlp::Coord &a, const tlp::Coord &c, const std::vector<unsigned int> &input,
+               std::vector<tlp::Coord> &points) const;
   //=====================================
-  void recQuad(const tlp::node a, const tlp::node b, const tlp::node c, const tlp::node d,
-               const std::vector<tlp::node> &input);
+  void splitCells(const tlp::Coord &a, const tlp::Coord &c, const std::vector<unsigned int> &input,
+                  unsigned int depth, std::vector<Cell> &cells) const;
 };
 #endif // QUADTREE_H
@@ -19,6 +19,7 @@
 #include <tulip/Color.h>
 #include <tulip/Coord.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlCircle.h>
 #include <tulip/GlGraphRenderingParameters.h>
@@ -65,6 +66,7 @@ public:
   ~Circle() override;
   void getIncludeBoundingBox(BoundingBox &boundingBox, node) override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
 };
 PLUGIN(Circle)
 Circle::Circle(const tlp::PluginContext *context) : Glyph(context) {}
@@ -84,6 +86,10 @@ void Circle::draw(node n, float lod) {
              Glyph::glGraphInputData->getElementBorderWidth()->getNodeValue(n), textureName, lod,
              true);
 }
+bool Circle::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addRegularPolygon(30, 0.f);
+  return true;
+}
 
 class EECircle : public EdgeExtremityGlyph {
 public:
@@ -100,6 +106,11 @@ public:
                edgeExtGlGraphInputData->getElementBorderWidth()->getEdgeValue(e), textureName, lod,
                false);
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addRegularPolygon(30, 0.f);
+    return true;
+  }
 };
 
 PLUGIN(EECircle)
@@ -19,6 +19,7 @@
 #include <tulip/Color.h>
 #include <tulip/Coord.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlBox.h>
 #include <tulip/GlGraphInputData.h>
@@ -44,6 +45,7 @@ public:
   Cube(const tlp::PluginContext *context = nullptr);
   ~Cube() override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
   Coord getAnchor(const Coord &vector) const override;
 
 protected:
@@ -63,6 +65,10 @@ void Cube::draw(node n, float lod) {
 Coord Cube::getAnchor(const Coord &vector) const {
   return GlBox::getAnchor(vector);
 }
+bool Cube::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addBox();
+  return true;
+}
 
 class EECube : public EdgeExtremityGlyph {
 public:
@@ -82,6 +88,11 @@ public:
                 lod);
     glDisable(GL_LIGHTING);
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addBox();
+    return true;
+  }
 };
 
 PLUGIN(EECube)
@@ -20,6 +20,7 @@
 #include <tulip/Size.h>
 #include <tulip/Coord.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlRegularPolygon.h>
 #include <tulip/GlGraphInputData.h>
@@ -65,6 +66,7 @@ public:
   ~Diamond() override;
   void getIncludeBoundingBox(BoundingBox &boundingBox, node) override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
   Coord getAnchor(const Coord &vector) const override;
 };
 PLUGIN(Diamond)
@@ -113,6 +115,10 @@ Coord Diamond::getAnchor(const Coord &vector) const {
 
   return anchor;
 }
+bool Diamond::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addRegularPolygon(4);
+  return true;
+}
 
 class EEDiamond : public EdgeExtremityGlyph {
 public:
@@ -131,6 +137,11 @@ public:
                 edgeExtGlGraphInputData->getElementBorderWidth()->getEdgeValue(e), textureName, lod,
                 false);
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addRegularPolygon(4);
+    return true;
+  }
 };
 
 PLUGIN(EEDiamond)
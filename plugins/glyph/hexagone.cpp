@@ -20,6 +20,7 @@
 #include <tulip/Coord.h>
 #include <tulip/Size.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlHexagon.h>
 #include <tulip/GlGraphInputData.h>
@@ -66,6 +67,7 @@ public:
   ~Hexagon() override;
   void getIncludeBoundingBox(BoundingBox &boundingBox, node) override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
 };
 PLUGIN(Hexagon)
 Hexagon::Hexagon(const tlp::PluginContext *context) : Glyph(context) {}
@@ -84,6 +86,10 @@ void Hexagon::draw(node n, float lod) {
               glGraphInputData->getElementBorderColor()->getNodeValue(n),
               glGraphInputData->getElementBorderWidth()->getNodeValue(n), textureName, lod, true);
 }
+bool Hexagon::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addRegularPolygon(6);
+  return true;
+}
 
 class EEHexagon : public EdgeExtremityGlyph {
 public:
@@ -102,6 +108,11 @@ public:
                 edgeExtGlGraphInputData->getElementBorderWidth()->getEdgeValue(e), textureName, lod,
                 false);
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addRegularPolygon(6);
+    return true;
+  }
 };
 PLUGIN(EEHexagon)
 
@@ -20,6 +20,7 @@
 #include <tulip/Coord.h>
 #include <tulip/Size.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlPentagon.h>
 #include <tulip/GlGraphInputData.h>
@@ -65,6 +66,7 @@ public:
   ~Pentagon() override;
   void getIncludeBoundingBox(BoundingBox &boundingBox, node) override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
 };
 PLUGIN(Pentagon)
 Pentagon::Pentagon(const tlp::PluginContext *context) : Glyph(context) {}
@@ -83,6 +85,10 @@ void Pentagon::draw(node n, float lod) {
                glGraphInputData->getElementBorderColor()->getNodeValue(n),
                glGraphInputData->getElementBorderWidth()->getNodeValue(n), textureName, lod, true);
 }
+bool Pentagon::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addRegularPolygon(5);
+  return true;
+}
 
 class EEPentagon : public EdgeExtremityGlyph {
 public:
@@ -101,6 +107,11 @@ public:
                  edgeExtGlGraphInputData->getElementBorderWidth()->getEdgeValue(e), textureName,
                  lod, false);
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addRegularPolygon(5);
+    return true;
+  }
 };
 PLUGIN(EEPentagon)
 
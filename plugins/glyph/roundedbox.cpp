@@ -21,6 +21,7 @@
 #include <tulip/Glyph.h>
 #include <tulip/GlPolygon.h>
 #include <tulip/GlShaderProgram.h>
+#include <tulip/GlPickingBuffer.h>
 #include <tulip/GlTextureManager.h>
 #include <tulip/GlGraphInputData.h>
 #include <tulip/GlTools.h>
@@ -327,7 +328,8 @@ void RoundedBox::draw(node n, float lod) {
   const string &texture = glGraphInputData->getElementTexture()->getNodeValue(n);
 
   if (roundedBoxShader == nullptr || !roundedBoxShader->isLinked() ||
-      !roundedBoxOutlineShader->isLinked() || GlShaderProgram::getCurrentActiveShader()) {
+      !roundedBoxOutlineShader->isLinked() || GlShaderProgram::getCurrentActiveShader() ||
+      GlPickingBuffer::isActive()) {
     if (roundedSquare == nullptr)
       initRoundedSquare();
 
@@ -23,6 +23,7 @@
 #include <tulip/Color.h>
 #include <tulip/Coord.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlTools.h>
 #include <tulip/GlGraphInputData.h>
@@ -60,6 +61,7 @@ public:
   ~Sphere() override;
   void getIncludeBoundingBox(BoundingBox &boundingBox, node) override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
 };
 
 PLUGIN(Sphere)
@@ -79,6 +81,10 @@ void Sphere::draw(node n, float) {
             glGraphInputData->getElementTexture()->getNodeValue(n),
             glGraphInputData->parameters->getTexturePath());
 }
+bool Sphere::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addSphere();
+  return true;
+}
 
 class EESphere : public EdgeExtremityGlyph {
   GLYPHINFORMATION("3D - Sphere extremity", "Bertrand Mathieu", "09/07/2002",
@@ -91,6 +97,11 @@ public:
     drawGlyph(glyphColor, edgeExtGlGraphInputData->getElementTexture()->getEdgeValue(e),
               edgeExtGlGraphInputData->parameters->getTexturePath());
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addSphere();
+    return true;
+  }
 };
 PLUGIN(EESphere)
 
@@ -20,6 +20,7 @@
 #include <tulip/Size.h>
 #include <tulip/Coord.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/EdgeExtremityGlyph.h>
 #include <tulip/GlRect.h>
 #include <tulip/GlGraphRenderingParameters.h>
@@ -63,6 +64,7 @@ public:
   Square(const tlp::PluginContext *context = nullptr);
   ~Square() override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
   Coord getAnchor(const Coord &vector) const override;
 };
 PLUGIN(Square)
@@ -86,6 +88,10 @@ Coord Square::getAnchor(const Coord &vector) const {
   else
     return v;
 }
+bool Square::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addRegularPolygon(4, float(M_PI) / 4.0f);
+  return true;
+}
 
 class EESquare : public EdgeExtremityGlyph {
 public:
@@ -99,6 +105,11 @@ public:
               edgeExtGlGraphInputData->parameters->getTexturePath(),
               edgeExtGlGraphInputData->getElementBorderWidth()->getEdgeValue(e), borderColor, lod);
   }
+
+  bool getGeometry(GlyphGeometry &geometry) const override {
+    geometry.addRegularPolygon(4, float(M_PI) / 4.0f);
+    return true;
+  }
 };
 PLUGIN(EESquare)
 
@@ -20,6 +20,7 @@
 #include <tulip/Coord.h>
 #include <tulip/Size.h>
 #include <tulip/Glyph.h>
+#include <tulip/GlyphGeometry.h>
 #include <tulip/GlTriangle.h>
 #include <tulip/GlGraphInputData.h>
 #include <tulip/GlGraphRenderingParameters.h>
@@ -38,6 +39,7 @@ public:
   ~Triangle() override;
   void getIncludeBoundingBox(BoundingBox &boundingBox, node) override;
   void draw(node n, float lod) override;
+  bool getGeometry(GlyphGeometry &geometry) const override;
 };
 
 //=====================================================
@@ -79,5 +81,10 @@ void Triangle::draw(node n, float lod) {
   triangle.draw(lod, nullptr);
 }
 //=====================================================
+bool Triangle::getGeometry(GlyphGeometry &geometry) const {
+  geometry.addRegularPolygon(3);
+  return true;
+}
+//=====================================================
 
 } // end of namespace tlp
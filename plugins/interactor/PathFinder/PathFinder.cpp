@@ -24,6 +24,7 @@
 #include <tulip/StringsListSelectionWidget.h>
 #include <tulip/NodeLinkDiagramComponent.h>
 #include <tulip/Graph.h>
+#include <tulip/DoubleProperty.h>
 #include <tulip/TlpQtTools.h>
 
 #include "PathFinderComponent.h"
@@ -47,7 +48,8 @@ PathFinder::PathFinder(const tlp::PluginContext *)
     : GLInteractorComposite(QIcon(":/pathfinder.png"), "Select the path(s) between two nodes"),
       weightMetric(NO_METRIC), selectAllPaths(false), edgeOrientation(DEFAULT_ORIENTATION),
       pathsTypes(DEFAULT_PATHS_TYPE), toleranceActivated(DEFAULT_TOLERANCE_ACTIVATION),
-      tolerance(DEFAULT_TOLERANCE), _configurationWidget(nullptr), highlightersListWidget(nullptr),
+      tolerance(DEFAULT_TOLERANCE), landmarksIndexActivated(DEFAULT_LANDMARKS_INDEX_ACTIVATION),
+      _configurationWidget(nullptr), highlightersListWidget(nullptr),
       configureHighlighterBtn(nullptr) {
 
   edgeOrientationLabels[PathAlgorithm::Directed] = "Consider edges as directed";
@@ -105,6 +107,7 @@ void PathFinder::construct() {
 
   _configurationWidget->toleranceChecked(toleranceActivated);
   _configurationWidget->setToleranceSpinValue(tolerance);
+  _configurationWidget->landmarksIndexChecked(landmarksIndexActivated);
 
   highlightersListWidget = new StringsListSelectionWidget(
       _configurationWidget, StringsListSelectionWidget::SIMPLE_LIST, 0);
@@ -140,6 +143,9 @@ void PathFinder::construct() {
   connect(_configurationWidget, SIGNAL(activateTolerance(bool)), this,
           SLOT(activateTolerance(bool)));
   connect(_configurationWidget, SIGNAL(setTolerance(int)), this, SLOT(setTolerance(int)));
+  connect(_configurationWidget, SIGNAL(activateLandmarksIndex(bool)), this,
+          SLOT(activateLandmarksIndex(bool)));
+  connect(_configurationWidget, SIGNAL(saveLandmarksIndex()), this, SLOT(saveLandmarksIndex()));
 }
 
 QWidget *PathFinder::configurationWidget() const {
@@ -150,6 +156,17 @@ void PathFinder::setWeightMetric(const QString &metric) {
   weightMetric = QStringToTlpString(metric);
 }
 
+DoubleProperty *PathFinder::getWeightMetric(Graph *graph) const {
+  if (weightMetric.compare(NO_METRIC) != 0 && graph->existProperty(weightMetric)) {
+    PropertyInterface *prop = graph->getProperty(weightMetric);
+
+    if (prop && prop->getTypename().compare("double") == 0)
+      return static_cast<DoubleProperty *>(prop);
+  }
+
+  return nullptr;
+}
+
 void PathFinder::setEdgeOrientation(const QString &metric) {
   string cmp(QStringToTlpString(metric));
 
@@ -175,6 +192,7 @@ void PathFinder::setPathsType(const QString &pathType) {
 
   bool disabled(pathsTypes != PathAlgorithm::AllPaths);
   _configurationWidget->toleranceDisabled(disabled);
+  _configurationWidget->landmarksIndexDisabled(pathsTypes != PathAlgorithm::OneShortest);
 }
 
 double PathFinder::getTolerance() {
@@ -192,6 +210,18 @@ void PathFinder::activateTolerance(bool activated) {
   toleranceActivated = activated;
 }
 
+void PathFinder::activateLandmarksIndex(bool activated) {
+  landmarksIndexActivated = activated;
+}
+
+void PathFinder::saveLandmarksIndex() {
+  if (view() == nullptr)
+    return;
+
+  Graph *graph = view()->graph();
+  PathAlgorithm::storeLandmarksIndex(graph, getWeightMetric(graph), edgeOrientation);
+}
+
 vector<string> PathFinder::getActiveHighlighters() {
   return highlightersListWidget->getSelectedStringsList();
 }
@@ -30,6 +30,7 @@
 #define DEFAULT_PATHS_TYPE PathAlgorithm::OneShortest
 #define DEFAULT_TOLERANCE 100
 #define DEFAULT_TOLERANCE_ACTIVATION false
+#define DEFAULT_LANDMARKS_INDEX_ACTIVATION false
 
 class QPushButton;
 
@@ -40,6 +41,7 @@ class PathFinderConfigurationWidget;
 
 class StringsListSelectionWidget;
 class BooleanProperty;
+class DoubleProperty;
 
 /*@{*/
 /** \file
@@ -72,6 +74,12 @@ public:
     return weightMetric;
   }
 
+  /**
+   * @return The property of the graph used to get the weight values over the edges,
+   * nullptr if there is none.
+   */
+  tlp::DoubleProperty *getWeightMetric(tlp::Graph *graph) const;
+
   /**
    * @return true if the user chose not to select only one path
    */
@@ -100,6 +108,13 @@ public:
    */
   double getTolerance();
 
+  /**
+   * @return true if the user chose to use a landmarks index when looking for one shortest path
+   */
+  inline bool isLandmarksIndexActivated() const {
+    return landmarksIndexActivated;
+  }
+
   /**
    * @return The active path highlighters
    */
@@ -124,6 +139,8 @@ public slots:
   void setWeightMetric(const QString &metric);
   void setTolerance(int i);
   void activateTolerance(bool activated);
+  void activateLandmarksIndex(bool activated);
+  void saveLandmarksIndex();
   void configureHighlighterButtonPressed();
 
 private:
@@ -135,6 +152,7 @@ private:
   PathAlgorithm::PathType pathsTypes;
   bool toleranceActivated;
   double tolerance;
+  bool landmarksIndexActivated;
 
   // Used for GUI interaction.
   std::map<PathAlgorithm::EdgeOrientation, std::string> edgeOrientationLabels;
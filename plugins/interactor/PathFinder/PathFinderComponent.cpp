@@ -135,19 +135,10 @@ void PathFinderComponent::selectPath(GlMainWidget *glMainWidget, Graph *graph) {
 
   if (src.isValid() && tgt.isValid()) { // We only select a path if source and target are valid
     Observable::holdObservers();
-    DoubleProperty *weights = nullptr;
-    string weightsMetricName = parent->getWeightMetricName();
-
-    if (weightsMetricName.compare(NO_METRIC) != 0 && graph->existProperty(weightsMetricName)) {
-      PropertyInterface *prop = graph->getProperty(weightsMetricName);
-
-      if (prop && prop->getTypename().compare("double") == 0)
-        weights = graph->getProperty<DoubleProperty>(weightsMetricName);
-    }
-
-    bool pathFound =
-        PathAlgorithm::computePath(graph, parent->getPathsType(), parent->getEdgeOrientation(), src,
-                                   tgt, selection, weights, parent->getTolerance());
+    DoubleProperty *weights = parent->getWeightMetric(graph);
+    bool pathFound = PathAlgorithm::computePath(
+        graph, parent->getPathsType(), parent->getEdgeOrientation(), src, tgt, selection, weights,
+        parent->getTolerance(), parent->isLandmarksIndexActivated());
     Observable::unholdObservers();
 
     if (!pathFound) {
@@ -35,6 +35,9 @@ PathFinderConfigurationWidget::PathFinderConfigurationWidget(QWidget *parent)
           SIGNAL(setPathsType(const QString &)));
   connect(_ui->toleranceCheck, SIGNAL(clicked(bool)), this, SIGNAL(activateTolerance(bool)));
   connect(_ui->toleranceSpin, SIGNAL(valueChanged(int)), this, SIGNAL(setTolerance(int)));
+  connect(_ui->landmarksIndexCheck, SIGNAL(clicked(bool)), this,
+          SIGNAL(activateLandmarksIndex(bool)));
+  connect(_ui->landmarksIndexSaveButton, SIGNAL(clicked()), this, SIGNAL(saveLandmarksIndex()));
 }
 
 PathFinderConfigurationWidget::~PathFinderConfigurationWidget() {
@@ -91,3 +94,12 @@ void PathFinderConfigurationWidget::toleranceDisabled(const bool disabled) {
   _ui->toleranceLabel->setDisabled(disabled);
   _ui->tolerancePercentLabel->setDisabled(disabled);
 }
+
+void PathFinderConfigurationWidget::landmarksIndexChecked(const bool checked) {
+  _ui->landmarksIndexCheck->setChecked(checked);
+}
+
+void PathFinderConfigurationWidget::landmarksIndexDisabled(const bool disabled) {
+  _ui->landmarksIndexCheck->setDisabled(disabled);
+  _ui->landmarksIndexSaveButton->setDisabled(disabled);
+}
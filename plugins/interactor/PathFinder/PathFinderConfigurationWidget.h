@@ -52,6 +52,8 @@ public:
   void highlightersLabelDisabled(const bool disable);
   void addbottomWidget(QWidget *w);
   void toleranceDisabled(const bool disabled);
+  void landmarksIndexChecked(const bool checked);
+  void landmarksIndexDisabled(const bool disabled);
 
 signals:
   void setWeightMetric(const QString &);
@@ -59,6 +61,8 @@ signals:
   void setPathsType(const QString &);
   void activateTolerance(bool);
   void setTolerance(int);
+  void activateLandmarksIndex(bool);
+  void saveLandmarksIndex();
 };
 } // namespace tlp
 #endif /* PATHFINDERCONFIGURATIONWIDGET_H_ */
@@ -25,6 +25,7 @@
 #include <tulip/Graph.h>
 #include <tulip/GraphParallelTools.h>
 #include <tulip/GraphTools.h>
+#include <tulip/LandmarksIndex.h>
 
 #include "DFS/DFS.h"
 
@@ -46,7 +47,8 @@ double computePathLength(BooleanProperty *result, EdgeStaticProperty<double> &we
 
 bool PathAlgorithm::computePath(Graph *graph, PathType pathType, EdgeOrientation edgesOrientation,
                                 node src, node tgt, BooleanProperty *result,
-                                DoubleProperty *weights, double tolerance) {
+                                DoubleProperty *weights, double tolerance,
+                                bool useLandmarksIndex) {
 #ifndef NDEBUG
   assert(graph);
   assert(result);
@@ -87,6 +89,23 @@ bool PathAlgorithm::computePath(Graph *graph, PathType pathType, EdgeOrientation
       spt = ShortestPathType::OneReversedPath;
     }
   }
+  if (pathType == OneShortest && useLandmarksIndex) {
+    // a reversed path is the reverse of a directed path from tgt to src
+    const LandmarksIndex &index =
+        LandmarksIndex::get(graph, weights, edgesOrientation != Undirected);
+    graph->push();
+
+    if (edgesOrientation == Reversed)
+      retVal = index.searchPath(tgt, src, result);
+    else
+      retVal = index.searchPath(src, tgt, result);
+
+    if (!retVal)
+      graph->pop();
+
+    return retVal;
+  }
+
   graph->push();
   retVal = selectShortestPaths(graph, src, tgt, spt, weights, result);
   if (pathType == AllPaths && retVal) {
@@ -125,3 +144,12 @@ bool PathAlgorithm::computePath(Graph *graph, PathType pathType, EdgeOrientation
     graph->pop();
   return retVal;
 }
+
+void PathAlgorithm::storeLandmarksIndex(Graph *graph, DoubleProperty *weights,
+                                        EdgeOrientation edgesOrientation) {
+  const LandmarksIndex &index =
+      LandmarksIndex::get(graph, weights, edgesOrientation != Undirected);
+  // in its own undo step, the index can be big
+  graph->push();
+  index.store();
+}
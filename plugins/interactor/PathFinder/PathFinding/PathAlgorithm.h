@@ -57,15 +57,32 @@ public:
    * property.
    * @param weights The edges weights
    * @param tolerance (only when all paths are selected) The length tolerance factor.
+   * @param useLandmarksIndex (only when one shortest path is selected) Indicates if the path is
+   * searched using the landmarks index of the graph, which is built at the first search.
    * @return
    *
    * @see PathType
    * @see EdgeOrientation
    * @see DFS
+   * @see LandmarksIndex
    */
   static bool computePath(tlp::Graph *graph, PathType pathType, EdgeOrientation edgesOrientation,
                           tlp::node src, tlp::node tgt, tlp::BooleanProperty *result,
-                          tlp::DoubleProperty *weights = nullptr, double tolerance = DBL_MAX);
+                          tlp::DoubleProperty *weights = nullptr, double tolerance = DBL_MAX,
+                          bool useLandmarksIndex = false);
+
+  /**
+   * Stores the landmarks index of a graph in its attributes, so it is saved with the graph.
+   * The index is built if needed. The storage can be undone on its own.
+   *
+   * @param graph The graph.
+   * @param weights The edges weights
+   * @param edgesOrientation The orientation of the edges.
+   *
+   * @see LandmarksIndex::store
+   */
+  static void storeLandmarksIndex(tlp::Graph *graph, tlp::DoubleProperty *weights,
+                                  EdgeOrientation edgesOrientation);
 };
 } // namespace tlp
 #endif /* PATHALGORITHM_H_ */
@@ -0,0 +1,207 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <algorithm>
+#include <atomic>
+
+#include <tulip/ConnectedTest.h>
+#include <tulip/ParallelTools.h>
+#include <tulip/PluginLister.h>
+#include <tulip/SimplePluginProgress.h>
+#include <tulip/StaticProperty.h>
+#include <tulip/TlpTools.h>
+
+#include "ComponentsLayout.h"
+
+using namespace std;
+using namespace tlp;
+
+// the layout algorithms which only update their result property
+// and can then be run concurrently on distinct graphs
+static const char *threadSafeAlgorithms[] = {"GEM (Frick)", "Random layout"};
+
+struct ComponentLayout {
+  Graph *graph;
+  LayoutProperty *layout;
+  DataSet dataSet;
+  SimplePluginProgress progress;
+  LayoutAlgorithm *algorithm;
+  vector<edge> edges;
+  bool ok;
+
+  ComponentLayout() : graph(nullptr), layout(nullptr), algorithm(nullptr), edges(), ok(true) {}
+
+  ~ComponentLayout() {
+    delete algorithm;
+    delete graph;
+  }
+};
+
+bool layoutConnectedComponents(Graph *graph, const vector<vector<node>> &components,
+                               const string &algorithm, SizeProperty *size,
+                               DoubleProperty *rotation, LayoutProperty *result,
+                               string &errorMsg) {
+  if (!PluginLister::pluginExists(algorithm)) {
+    errorMsg = algorithm + " - No algorithm available with this name";
+    return false;
+  }
+
+  bool concurrent = find_if(begin(threadSafeAlgorithms), end(threadSafeAlgorithms),
+                            [&](const char *name) { return algorithm == name; }) !=
+                    end(threadSafeAlgorithms);
+  unsigned int nbComponents = components.size();
+  // the largest components are laid out first
+  vector<unsigned int> order(nbComponents);
+
+  for (unsigned int i = 0; i < nbComponents; ++i)
+    order[i] = i;
+
+  stable_sort(order.begin(), order.end(), [&](unsigned int i, unsigned int j) {
+    return components[i].size() > components[j].size();
+  });
+
+  NodeStaticProperty<node> ccNode(graph);
+  vector<ComponentLayout> ccLayouts(nbComponents);
+
+  // the copy of a component and the creation of its algorithm
+  // update the observation graph, so they are never done concurrently
+  auto prepare = [&](unsigned int i) {
+    const vector<node> &nodes = components[order[i]];
+    ComponentLayout &ccLayout = ccLayouts[i];
+
+    // no need to copy a single node component
+    if (nodes.size() == 1) {
+      result->setNodeValue(nodes[0], Coord(0, 0, 0));
+      return true;
+    }
+
+    ccLayout.graph = tlp::newGraph();
+    vector<node> ccNodes;
+    ccLayout.graph->addNodes(nodes.size(), ccNodes);
+    SizeProperty *ccSize = ccLayout.graph->getProperty<SizeProperty>("viewSize");
+    DoubleProperty *ccRotation = ccLayout.graph->getProperty<DoubleProperty>("viewRotation");
+
+    for (unsigned int j = 0; j < nodes.size(); ++j) {
+      node n = nodes[j];
+      ccNode[n] = ccNodes[j];
+
+      if (size)
+        ccSize->setNodeValue(ccNodes[j], size->getNodeValue(n));
+
+      if (rotation)
+        ccRotation->setNodeValue(ccNodes[j], rotation->getNodeValue(n));
+    }
+
+    for (auto n : nodes) {
+      for (auto e : graph->getOutEdges(n)) {
+        ccLayout.edges.push_back(e);
+        ccLayout.graph->addEdge(ccNode[n], ccNode[graph->target(e)]);
+      }
+    }
+
+    ccLayout.layout = ccLayout.graph->getProperty<LayoutProperty>("viewLayout");
+    ccLayout.dataSet.set("result", ccLayout.layout);
+    AlgorithmContext context(ccLayout.graph, &ccLayout.dataSet, &ccLayout.progress);
+    ccLayout.algorithm = PluginLister::getPluginObject<LayoutAlgorithm>(algorithm, &context);
+
+    if (ccLayout.algorithm == nullptr || !ccLayout.algorithm->check(errorMsg))
+      return false;
+
+    // the cached result of the connectivity test
+    // is only read by the algorithms run concurrently
+    if (concurrent)
+      ConnectedTest::isConnected(ccLayout.graph);
+
+    return true;
+  };
+
+  auto layOut = [&](unsigned int i) {
+    ComponentLayout &ccLayout = ccLayouts[i];
+
+    if (ccLayout.algorithm) {
+      // each component is laid out with its own random sequence
+      // whatever the thread laying it out
+      tlp::initRandomSequence();
+      ccLayout.ok = ccLayout.algorithm->run();
+    }
+  };
+
+  auto copyBack = [&](unsigned int i) {
+    ComponentLayout &ccLayout = ccLayouts[i];
+
+    if (ccLayout.graph == nullptr)
+      return true;
+
+    if (!ccLayout.ok) {
+      errorMsg = ccLayout.progress.getError();
+      return false;
+    }
+
+    for (auto n : components[order[i]])
+      result->setNodeValue(n, ccLayout.layout->getNodeValue(ccNode[n]));
+
+    const vector<edge> &ccEdges = ccLayout.graph->edges();
+
+    for (unsigned int j = 0; j < ccEdges.size(); ++j)
+      result->setEdgeValue(ccLayout.edges[j], ccLayout.layout->getEdgeValue(ccEdges[j]));
+
+    // the copy is no longer needed
+    delete ccLayout.algorithm;
+    ccLayout.algorithm = nullptr;
+    delete ccLayout.graph;
+    ccLayout.graph = nullptr;
+    return true;
+  };
+
+  if (!concurrent) {
+    // the other algorithms are run one after the other,
+    // each copy being deleted before the next one is created
+    for (unsigned int i = 0; i < nbComponents; ++i) {
+      if (!prepare(i))
+        return false;
+
+      layOut(i);
+
+      if (!copyBack(i))
+        return false;
+    }
+
+    return true;
+  }
+
+  for (unsigned int i = 0; i < nbComponents; ++i) {
+    if (!prepare(i))
+      return false;
+  }
+
+  // each thread picks the next component to lay out
+  atomic<unsigned int> next(0);
+  TLP_PARALLEL_MAP_INDICES(ThreadManager::getNumberOfThreads(), [&](unsigned int) {
+    unsigned int i;
+
+    while ((i = next++) < nbComponents)
+      layOut(i);
+  });
+
+  for (unsigned int i = 0; i < nbComponents; ++i) {
+    if (!copyBack(i))
+      return false;
+  }
+
+  return true;
+}
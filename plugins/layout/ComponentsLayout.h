@@ -0,0 +1,44 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#ifndef COMPONENTSLAYOUT_H
+#define COMPONENTSLAYOUT_H
+
+#include <string>
+#include <vector>
+
+#include <tulip/DoubleProperty.h>
+#include <tulip/LayoutProperty.h>
+#include <tulip/SizeProperty.h>
+
+/**
+ * Applies the layout algorithm named algorithm on each of the given
+ * connected components of graph and stores the resulting coordinates in result.
+ * Each component is copied in an independent graph, along with its node sizes and rotations,
+ * then laid out with its own random sequence, the largest components first.
+ * The components are laid out concurrently when the algorithm is known to be thread safe,
+ * one after the other otherwise.
+ * Returns false and sets errorMsg if the algorithm fails on one of the components.
+ */
+bool layoutConnectedComponents(tlp::Graph *graph,
+                               const std::vector<std::vector<tlp::node>> &components,
+                               const std::string &algorithm, tlp::SizeProperty *size,
+                               tlp::DoubleProperty *rotation, tlp::LayoutProperty *result,
+                               std::string &errorMsg);
+
+#endif
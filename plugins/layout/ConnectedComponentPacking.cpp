@@ -21,10 +21,12 @@
 #include <tulip/DoubleProperty.h>
 #include <tulip/DrawingTools.h>
 #include <tulip/StringCollection.h>
+#include <tulip/ParallelTools.h>
 
 #include "ConnectedComponentPacking.h"
 #include "rectanglePackingFonctions.h"
 #include "DatasetTools.h"
+#include "ComponentsLayout.h"
 
 using namespace std;
 using namespace tlp;
@@ -42,7 +44,13 @@ static const char *paramHelp[] = {
     "Input rotation of nodes around the z-axis.",
 
     // complexity
-    "Complexity of the algorithm.<br> n is the number of connected components in the graph."};
+    "Complexity of the algorithm.<br> n is the number of connected components in the graph.",
+
+    // component layout
+    "The name of a layout algorithm to apply on each connected component before packing them. "
+    "The components are laid out concurrently, the largest ones first, "
+    "when the algorithm is thread safe (GEM (Frick) or Random layout). "
+    "If empty, the input layout is packed."};
 
 //====================================================================
 ConnectedComponentPacking::ConnectedComponentPacking(const tlp::PluginContext *context)
@@ -53,6 +61,7 @@ ConnectedComponentPacking::ConnectedComponentPacking(const tlp::PluginContext *c
   addInParameter<StringCollection>(
       "complexity", paramHelp[2], COMPLEXITY, true,
       "auto <br> n5 <br> n4logn <br> n4 <br> n3logn <br> n3 <br> n2logn <br> n2 <br> nlogn <br> n");
+  addInParameter<string>("component layout", paramHelp[3], "", false);
 }
 //====================================================================
 bool ConnectedComponentPacking::run() {
@@ -61,6 +70,7 @@ bool ConnectedComponentPacking::run() {
   SizeProperty *size = nullptr;
   DoubleProperty *rotation = nullptr;
   string complexity("auto");
+  string componentLayout;
 
   if (dataSet != nullptr) {
     dataSet->get("coordinates", layout);
@@ -70,6 +80,8 @@ bool ConnectedComponentPacking::run() {
 
     if (dataSet->get("complexity", complexityCol))
       complexity = complexityCol.getCurrentString();
+
+    dataSet->get("component layout", componentLayout);
   }
 
   if (layout == nullptr)
@@ -88,25 +100,33 @@ bool ConnectedComponentPacking::run() {
   std::vector<std::vector<node>> ccNodes;
   ConnectedTest::computeConnectedComponents(graph, ccNodes);
 
+  if (!componentLayout.empty()) {
+    string errorMsg;
+
+    if (!layoutConnectedComponents(graph, ccNodes, componentLayout, size, rotation, result,
+                                   errorMsg)) {
+      if (pluginProgress)
+        pluginProgress->setError(errorMsg);
+
+      return false;
+    }
+
+    layout = result;
+  }
+
   vector<Rectangle<float>> rectangles;
   rectangles.resize(ccNodes.size());
   std::vector<std::vector<edge>> ccEdges;
   ccEdges.resize(ccNodes.size());
 
-  for (unsigned int i = 0; i < ccNodes.size(); ++i) {
+  TLP_PARALLEL_MAP_INDICES(ccNodes.size(), [&](unsigned int i) {
     std::vector<edge> &edges = ccEdges[i];
-    MutableContainer<bool> visited;
-    visited.setAll(false);
     const std::vector<node> &nodes = ccNodes[i];
-    unsigned int nbNodes = nodes.size();
-
-    for (unsigned int j = 0; j < nbNodes; ++j) {
-      for (auto e : graph->getInOutEdges(nodes[j])) {
-        if (!visited.get(e.id)) {
-          visited.set(e.id, true);
-          edges.push_back(e);
-        }
-      }
+
+    // each edge of the component is an out edge of one of its nodes
+    for (auto n : nodes) {
+      for (auto e : graph->getOutEdges(n))
+        edges.push_back(e);
     }
 
     BoundingBox tmp = tlp::computeBoundingBox(nodes, edges, layout, size, rotation);
@@ -116,7 +136,7 @@ bool ConnectedComponentPacking::run() {
     tmpRec[0][0] = tmp[0][0] + spacing;
     tmpRec[0][1] = tmp[0][1] + spacing;
     assert(tmpRec.isValid());
-  }
+  });
 
   if (complexity == "auto") {
     if (rectangles.size() < 25) {
@@ -143,12 +163,14 @@ bool ConnectedComponentPacking::run() {
   if (!RectanglePackingLimitRectangles(rectangles, complexity.c_str(), pluginProgress))
     return pluginProgress ? pluginProgress->state() != TLP_CANCEL : false;
 
-  for (auto n : graph->nodes()) {
-    result->setNodeValue(n, layout->getNodeValue(n));
-  }
+  if (layout != result) {
+    for (auto n : graph->nodes()) {
+      result->setNodeValue(n, layout->getNodeValue(n));
+    }
 
-  for (auto e : graph->edges()) {
-    result->setEdgeValue(e, layout->getEdgeValue(e));
+    for (auto e : graph->edges()) {
+      result->setEdgeValue(e, layout->getEdgeValue(e));
+    }
   }
 
   for (unsigned int i = 0; i < ccNodes.size(); ++i) {
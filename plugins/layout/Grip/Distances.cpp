@@ -18,39 +18,121 @@
  */
 #include "Distances.h"
 
-#include <tulip/MutableContainer.h>
+#include <climits>
+
+#include <tulip/ParallelTools.h>
 
 using namespace tlp;
 using namespace std;
 
-unsigned int getDist(Graph *g, node n1, node n2) {
-  vector<node> nextNodes;
-  std::unordered_map<node, unsigned int> nodeDepth;
-  MutableContainer<bool> alreadyTreated;
-  bool found = false;
-  alreadyTreated.setAll(false);
-  nextNodes.push_back(n1);
-  nodeDepth[n1] = 0;
-  alreadyTreated.set(n1.id, true);
+GripDistances::GripDistances(Graph *g, const vector<node> &ordering)
+    : graph(g), ordering(ordering), first(0), slotSize(0) {
+  unsigned int nbNodes = g->numberOfNodes();
+  rank.resize(nbNodes);
+
+  for (unsigned int i = 0; i < ordering.size(); ++i)
+    rank[g->nodePos(ordering[i])] = i;
+
+  // store the adjacency of the nodes in flat arrays
+  // to avoid the use of graph iterators during the bfs
+  const vector<node> &nodes = g->nodes();
+  adjOffsets.resize(nbNodes + 1);
+  adjacency.reserve(2 * g->numberOfEdges());
+
+  for (unsigned int i = 0; i < nbNodes; ++i) {
+    adjOffsets[i] = adjacency.size();
+
+    for (auto v : g->getInOutNodes(nodes[i]))
+      adjacency.push_back(g->nodePos(v));
+  }
+
+  adjOffsets[nbNodes] = adjacency.size();
+
+  bfsData.resize(ThreadManager::getNumberOfThreads());
+}
+//========================================
+void GripDistances::compute(unsigned int first, unsigned int last, unsigned int nbTargets,
+                            unsigned int nbNeighbors) {
+  this->first = first;
+  // each node needs at least one neighbor to be placed
+  slotSize = std::max(nbNeighbors, 1u);
+  unsigned int nbSources = last + 1 - first;
+  nbFound.assign(nbSources, 0);
+  targets.resize(size_t(nbSources) * slotSize);
+  dists.resize(size_t(nbSources) * slotSize);
+
+  TLP_PARALLEL_MAP_INDICES(nbSources, [&](unsigned int i) {
+    BfsData &data = bfsData[ThreadManager::getThreadNumber()];
+
+    if (data.depth.empty())
+      data.depth.assign(rank.size(), UINT_MAX);
 
-  for (unsigned int i = 0; !found && i < nextNodes.size(); ++i) {
-    node current = nextNodes[i];
+    vector<unsigned int> &depth = data.depth;
+    vector<unsigned int> &queue = data.queue;
+    unsigned int src = graph->nodePos(ordering[first + i]);
+    unsigned int *slotTargets = &targets[size_t(i) * slotSize];
+    unsigned int *slotDists = &dists[size_t(i) * slotSize];
+    unsigned int found = 0;
 
-    for (auto v : g->getInOutNodes(current)) {
+    queue.clear();
+    queue.push_back(src);
+    depth[src] = 0;
 
-      if (alreadyTreated.get(v.id))
-        continue;
+    for (unsigned int j = 0; found < slotSize && j < queue.size(); ++j) {
+      unsigned int current = queue[j];
+      unsigned int nextDepth = depth[current] + 1;
 
-      alreadyTreated.set(v.id, true);
-      nextNodes.push_back(v);
-      nodeDepth[v] = nodeDepth[current] + 1;
+      for (unsigned int k = adjOffsets[current]; k < adjOffsets[current + 1]; ++k) {
+        unsigned int v = adjacency[k];
 
-      if (v == n2) {
-        found = true;
-        break;
+        if (depth[v] != UINT_MAX)
+          continue;
+
+        depth[v] = nextDepth;
+        queue.push_back(v);
+
+        if (rank[v] < nbTargets) {
+          slotTargets[found] = v;
+          slotDists[found] = nextDepth;
+
+          if (++found == slotSize)
+            break;
+        }
       }
     }
+
+    nbFound[i] = found;
+
+    // only reset the visited nodes
+    for (auto v : queue)
+      depth[v] = UINT_MAX;
+  });
+}
+//========================================
+void GripDistances::getNearest(unsigned int i, vector<node> &neighbors,
+                               vector<unsigned int> &neighbors_dist) const {
+  const vector<node> &nodes = graph->nodes();
+  unsigned int slot = i - first;
+  unsigned int nb = nbFound[slot];
+  const unsigned int *slotTargets = &targets[size_t(slot) * slotSize];
+  const unsigned int *slotDists = &dists[size_t(slot) * slotSize];
+
+  neighbors.resize(nb);
+  neighbors_dist.assign(slotDists, slotDists + nb);
+
+  for (unsigned int j = 0; j < nb; ++j)
+    neighbors[j] = nodes[slotTargets[j]];
+}
+//========================================
+unsigned int GripDistances::getDist(node n1, node n2) const {
+  unsigned int slot = rank[graph->nodePos(n1)] - first;
+  unsigned int pos = graph->nodePos(n2);
+  const unsigned int *slotTargets = &targets[size_t(slot) * slotSize];
+
+  for (unsigned int j = 0; j < nbFound[slot]; ++j) {
+    if (slotTargets[j] == pos)
+      return dists[size_t(slot) * slotSize + j];
   }
 
-  return nodeDepth[n2];
+  return 0;
 }
@@ -19,8 +19,65 @@
 #ifndef DISTANCES_H
 #define DISTANCES_H
 
+#include <vector>
+
 #include <tulip/TulipPluginHeaders.h>
 
-unsigned int getDist(tlp::Graph *, tlp::node, tlp::node);
+/**
+ * This class is used by the GRIP layout to compute the graph distances
+ * between the nodes of a MIS filtration level and their nearest nodes
+ * in the previous levels.
+ * The adjacency of the graph is stored once in flat arrays,
+ * then the truncated BFS of the nodes of a level are computed in parallel
+ * and their results are stored in fixed size slots of flat arrays.
+ */
+class GripDistances {
+public:
+  GripDistances(tlp::Graph *g, const std::vector<tlp::node> &ordering);
+
+  /**
+   * computes, for each node of ordering[first..last],
+   * its nbNeighbors nearest nodes among ordering[0..nbTargets[
+   */
+  void compute(unsigned int first, unsigned int last, unsigned int nbTargets,
+               unsigned int nbNeighbors);
+
+  /**
+   * fills neighbors and neighbors_dist with the result of
+   * the last computation for the node of rank i in the ordering
+   */
+  void getNearest(unsigned int i, std::vector<tlp::node> &neighbors,
+                  std::vector<unsigned int> &neighbors_dist) const;
+
+  /**
+   * returns the graph distance between n1 and n2
+   * as found by the last computation,
+   * n1 being one of its sources and n2 one of its targets
+   */
+  unsigned int getDist(tlp::node n1, tlp::node n2) const;
+
+private:
+  tlp::Graph *graph;
+  const std::vector<tlp::node> &ordering;
+  // rank in ordering of each node, indexed by node position
+  std::vector<unsigned int> rank;
+  // adjacency of each node, indexed by node position
+  std::vector<unsigned int> adjOffsets;
+  std::vector<unsigned int> adjacency;
+
+  // results of the last computation
+  unsigned int first;
+  unsigned int slotSize;
+  std::vector<unsigned int> nbFound;
+  std::vector<unsigned int> targets;
+  std::vector<unsigned int> dists;
+
+  // per thread bfs data
+  struct BfsData {
+    std::vector<unsigned int> depth;
+    std::vector<unsigned int> queue;
+  };
+  std::vector<BfsData> bfsData;
+};
 
 #endif
@@ -31,8 +31,8 @@ static const char *paramHelp[] = {
 
 //======================================================
 Grip::Grip(const tlp::PluginContext *context)
-    : LayoutAlgorithm(context), misf(nullptr), edgeLength(0), level(0), currentGraph(nullptr),
-      _dim(0) {
+    : LayoutAlgorithm(context), misf(nullptr), distances(nullptr), edgeLength(0), level(0),
+      currentGraph(nullptr), _dim(0) {
   addInParameter<bool>("3D layout", paramHelp[0], "false");
   addDependency("Connected Component Packing", "1.0");
 }
@@ -95,6 +95,8 @@ void Grip::computeCurrentGraphLayout() {
     MISFiltering filtering(currentGraph);
     misf = &filtering;
     computeOrdering();
+    GripDistances dist(currentGraph, misf->ordering);
+    distances = &dist;
     init();
     firstNodesPlacement();
     placement();
@@ -158,9 +160,10 @@ void Grip::firstNodesPlacement() {
   node n2 = misf->ordering[1];
   node n3 = misf->ordering[2];
 
-  float d12 = getDist(currentGraph, n1, n2);
-  float d13 = getDist(currentGraph, n1, n3);
-  float d23 = getDist(currentGraph, n2, n3);
+  distances->compute(0, 2, 3, 2);
+  float d12 = distances->getDist(n1, n2);
+  float d13 = distances->getDist(n1, n3);
+  float d23 = distances->getDist(n2, n3);
 
   result->setNodeValue(n1, Coord(0, 0, 0));
   result->setNodeValue(n2, Coord(d12, 0, 0));
@@ -239,10 +242,14 @@ void Grip::seeLayout(unsigned int end) {
 //======================================================
 void Grip::initialPlacement(unsigned int start, unsigned int end) {
   // cerr << __PRETTY_FUNCTION__ << endl;
+  // the nearest nodes are searched among the nodes of the previous levels
+  unsigned int nbTargets =
+      level + 1u < misf->index.size() ? misf->index[level + 1] : misf->ordering.size();
+  distances->compute(start, end, nbTargets, levelToNbNeighbors[level + 1]);
+
   for (unsigned int i = start; i <= end; ++i) {
     node currNode = misf->ordering[i];
-    misf->getNearest(currNode, neighbors[currNode], neighbors_dist[currNode], level,
-                     levelToNbNeighbors[level + 1]);
+    distances->getNearest(i, neighbors[currNode], neighbors_dist[currNode]);
   }
 
   for (unsigned int i = start; i <= end; ++i) {
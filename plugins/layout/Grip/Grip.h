@@ -22,6 +22,7 @@
 #include <tulip/LayoutProperty.h>
 #include <unordered_map>
 #include "MISFiltering.h"
+#include "Distances.h"
 
 /*@{*/
 /** \file
@@ -79,6 +80,7 @@ private:
   float sched(int, int, int, int, int);
 
   MISFiltering *misf;
+  GripDistances *distances;
   float edgeLength;
   int level;
   std::unordered_map<tlp::node, std::vector<unsigned int>> neighbors_dist;
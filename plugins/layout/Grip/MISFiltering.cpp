@@ -17,7 +17,6 @@
  *
  */
 #include "MISFiltering.h"
-#include "Distances.h"
 #include <ctime>
 #include <cmath>
 #include <tulip/TlpTools.h>
@@ -186,49 +185,3 @@ void MISFiltering::updateVectors() {
   }
 }
 //========================================
-void MISFiltering::getNearest(node n, vector<node> &neighbors, vector<unsigned int> &neighbors_dist,
-                              unsigned int level, unsigned int nbNeighbors) {
-  vector<node> nextNodes;
-  MutableContainer<bool> alreadyTreated;
-  MutableContainer<bool> toTreat;
-  std::unordered_map<node, unsigned int> nodeDepth;
-  bool found = false;
-  unsigned nbFound = 0;
-
-  neighbors_dist.clear();
-  neighbors.clear();
-  nodeDepth[n] = 0;
-  alreadyTreated.setAll(false);
-  toTreat.setAll(false);
-  nextNodes.push_back(n);
-  alreadyTreated.set(n.id, true);
-
-  for (unsigned int i = 0; i < index[level + 1]; ++i)
-    toTreat.set(ordering[i].id, true);
-
-  for (unsigned int i = 0; !found && i < nextNodes.size(); ++i) {
-    node current = nextNodes[i];
-
-    for (auto v : g_copy->getInOutNodes(current)) {
-
-      if (alreadyTreated.get(v.id))
-        continue;
-
-      alreadyTreated.set(v.id, true);
-      nodeDepth[v] = nodeDepth[current] + 1;
-      nextNodes.push_back(v);
-
-      if (toTreat.get(v.id)) {
-        neighbors.push_back(v);
-        neighbors_dist.push_back(nodeDepth[v]);
-        ++nbFound;
-      }
-
-      if (nbFound == nbNeighbors) {
-        found = true;
-        break;
-      }
-    }
-  }
-}
-//========================================
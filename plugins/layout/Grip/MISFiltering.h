@@ -32,8 +32,6 @@ public:
   ~MISFiltering();
 
   void computeFiltering();
-  void getNearest(tlp::node, std::vector<tlp::node> &, std::vector<unsigned int> &, unsigned int,
-                  unsigned int = 3);
 
   std::vector<tlp::node> ordering;
   std::vector<unsigned int> index;
@@ -40,6 +40,7 @@
 #include <tulip/TulipViewSettings.h>
 
 #include "DatasetTools.h"
+#include "ComponentsLayout.h"
 
 using namespace std;
 using namespace tlp;
@@ -58,7 +59,13 @@ static const char *paramHelp[] = {
     "The polyomino packing tries to find a place where the next polyomino will fit by following a "
     "square."
     "If there is no place where the polyomino fits, the square gets bigger and every place gets "
-    "tried again."};
+    "tried again.",
+
+    // component layout
+    "The name of a layout algorithm to apply on each connected component before packing them. "
+    "The components are laid out concurrently, the largest ones first, "
+    "when the algorithm is thread safe (GEM (Frick) or Random layout). "
+    "If empty, the input layout is packed."};
 
 struct Polyomino {
   std::vector<node> *ccNodes;    // the connected nodes associated to that polyomino
@@ -127,6 +134,7 @@ PolyominoPacking::PolyominoPacking(const PluginContext *context) : LayoutAlgorit
   addInParameter<DoubleProperty>("rotation", paramHelp[1], "viewRotation");
   addInParameter<unsigned int>("margin", paramHelp[2], "1");
   addInParameter<unsigned int>("increment", paramHelp[3], "1");
+  addInParameter<string>("component layout", paramHelp[4], "", false);
 }
 
 PolyominoPacking::~PolyominoPacking() {}
@@ -138,6 +146,7 @@ bool PolyominoPacking::run() {
   DoubleProperty *rotation = nullptr;
   margin = 1;
   bndIncrement = 1;
+  string componentLayout;
 
   if (dataSet != nullptr) {
     dataSet->get("coordinates", layout);
@@ -145,6 +154,7 @@ bool PolyominoPacking::run() {
     dataSet->get("rotation", rotation);
     dataSet->get("margin", margin);
     dataSet->get("increment", bndIncrement);
+    dataSet->get("component layout", componentLayout);
   }
 
   if (pluginProgress) {
@@ -154,6 +164,23 @@ bool PolyominoPacking::run() {
   vector<vector<node>> connectedComponents;
   tlp::ConnectedTest::computeConnectedComponents(graph, connectedComponents);
 
+  if (!componentLayout.empty()) {
+    if (pluginProgress)
+      pluginProgress->setComment("Laying out connected components ...");
+
+    string errorMsg;
+
+    if (!layoutConnectedComponents(graph, connectedComponents, componentLayout, size, rotation,
+                                   result, errorMsg)) {
+      if (pluginProgress)
+        pluginProgress->setError(errorMsg);
+
+      return false;
+    }
+
+    layout = result;
+  }
+
   if (connectedComponents.size() <= 1) {
     for (auto n : graph->nodes()) {
       result->setNodeValue(n, layout->getNodeValue(n));
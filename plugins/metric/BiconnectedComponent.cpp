@@ -17,12 +17,22 @@
  *
  */
 
-#include <stack>
+#include <algorithm>
+#include <atomic>
+#include <climits>
 
 #include <tulip/DoubleProperty.h>
+#include <tulip/ParallelTools.h>
+#include <tulip/StaticProperty.h>
 
 using namespace std;
 using namespace tlp;
+
+static const char *paramHelp[] = {
+    // parallel
+    "If true, the components are computed in parallel by the Tarjan-Vishkin algorithm "
+    "instead of the sequential depth first search. The components are the same "
+    "but they are numbered in the order of their smallest edge."};
 //=============================================================================================
 // This is the original dfs recursive implementation
 // I don't remove it because it corresponds to the original algorithm
@@ -64,67 +74,65 @@ using namespace tlp;
 // simple structure to implement
 // the dfs biconnected component loop
 struct dfsBicoTestStruct {
-  node v;
-  node opp;
-  Iterator<edge> *ite;
+  unsigned int v;
+  unsigned int opp;
+  AdjacencyRange<edge> inOutEdges;
+  AdjacencyRange<edge>::iterator ite;
 
-  dfsBicoTestStruct(node n, node o, Iterator<edge> *it) : v(n), opp(o), ite(it) {}
+  dfsBicoTestStruct(const Graph &graph, node n, unsigned int v, unsigned int o)
+      : v(v), opp(o), inOutEdges(graph.inOutEdges(n)), ite(inOutEdges.begin()) {}
 };
 // dfs biconnected component loop
-static void bicoTestAndLabeling(const Graph &graph, node v, MutableContainer<int> &compnum,
-                                MutableContainer<int> &dfsnum, MutableContainer<int> &lowpt,
-                                MutableContainer<node> &father, stack<node> &current, int &count1,
-                                int &count2) {
-  Iterator<edge> *it = graph.getInOutEdges(v);
-  stack<dfsBicoTestStruct> dfsLevels;
-  dfsBicoTestStruct dfsParams(v, node(), it);
-  dfsLevels.push(dfsParams);
-  lowpt.set(v.id, dfsnum.get(v.id));
+// the nodes are identified by their positions in graph.nodes()
+static void bicoTestAndLabeling(const Graph &graph, unsigned int v,
+                                EdgeStaticProperty<double> &compnum,
+                                NodeStaticProperty<int> &dfsnum, NodeStaticProperty<int> &lowpt,
+                                NodeStaticProperty<unsigned int> &father,
+                                vector<unsigned int> &current, int &count1, int &count2) {
+  const vector<node> &nodes = graph.nodes();
+  // as its capacity is the maximum depth of the dfs,
+  // the levels are never moved and their iterators remain valid
+  vector<dfsBicoTestStruct> dfsLevels;
+  dfsLevels.reserve(nodes.size());
+  dfsLevels.emplace_back(graph, nodes[v], v, UINT_MAX);
+  lowpt[v] = dfsnum[v];
 
   while (!dfsLevels.empty()) {
-    dfsParams = dfsLevels.top();
+    dfsBicoTestStruct &dfsParams = dfsLevels.back();
     v = dfsParams.v;
-    it = dfsParams.ite;
-
-    if (it->hasNext()) {
-      edge e = it->next();
-      node w = graph.opposite(e, v);
-
-      if (dfsnum.get(w.id) == -1) {
-        dfsnum.set(w.id, ++count1);
-        current.push(w);
-        father.set(w.id, v);
-        dfsParams.v = w;
-        dfsParams.opp = v;
-        dfsParams.ite = graph.getInOutEdges(w);
-        dfsLevels.push(dfsParams);
-        lowpt.set(w.id, dfsnum.get(w.id));
+
+    if (dfsParams.ite != dfsParams.inOutEdges.end()) {
+      edge e = *dfsParams.ite;
+      ++dfsParams.ite;
+      node wNode = graph.opposite(e, nodes[v]);
+      unsigned int w = graph.nodePos(wNode);
+
+      if (dfsnum[w] == -1) {
+        dfsnum[w] = ++count1;
+        current.push_back(w);
+        father[w] = v;
+        dfsLevels.emplace_back(graph, wNode, w, v);
+        lowpt[w] = dfsnum[w];
       } else
-        lowpt.set(v.id, std::min(lowpt.get(v.id), dfsnum.get(w.id)));
+        lowpt[v] = std::min(lowpt[v], dfsnum[w]);
     } else {
-      delete it;
-      dfsLevels.pop();
-      node opp = dfsParams.opp;
+      unsigned int opp = dfsParams.opp;
+      dfsLevels.pop_back();
 
-      if (opp.isValid())
-        lowpt.set(opp.id, std::min(lowpt.get(opp.id), lowpt.get(v.id)));
+      if (opp != UINT_MAX)
+        lowpt[opp] = std::min(lowpt[opp], lowpt[v]);
 
-      if (father.get(v.id).isValid() && (lowpt.get(v.id) == dfsnum.get(father.get(v.id).id))) {
-        node w;
+      if (father[v] != UINT_MAX && (lowpt[v] == dfsnum[father[v]])) {
+        unsigned int w;
 
         do {
-          w = current.top();
-          current.pop();
-          it = graph.getInOutEdges(w);
-
-          while (it->hasNext()) {
-            edge e = it->next();
+          w = current.back();
+          current.pop_back();
 
-            if (dfsnum.get(w.id) > dfsnum.get(graph.opposite(e, w).id))
-              compnum.set(e.id, count2);
+          for (auto e : graph.inOutEdges(nodes[w])) {
+            if (dfsnum[w] > dfsnum[graph.nodePos(graph.opposite(e, nodes[w]))])
+              compnum.setEdgeValue(e, count2);
           }
-
-          delete it;
         } while (w != v);
 
         count2++;
@@ -134,29 +142,26 @@ static void bicoTestAndLabeling(const Graph &graph, node v, MutableContainer<int
 }
 
 //=============================================================================================
-int biconnectedComponents(const Graph &graph, MutableContainer<int> &compnum) {
-  stack<node> current;
-  MutableContainer<int> dfsnum;
+static int biconnectedComponents(const Graph &graph, EdgeStaticProperty<double> &compnum) {
+  vector<unsigned int> current;
+  NodeStaticProperty<int> dfsnum(&graph);
   dfsnum.setAll(-1);
-  MutableContainer<int> lowpt;
+  NodeStaticProperty<int> lowpt(&graph);
   lowpt.setAll(0);
-  MutableContainer<node> father;
-  father.setAll(node());
+  NodeStaticProperty<unsigned int> father(&graph);
+  father.setAll(UINT_MAX);
   int count1 = 0;
   int count2 = 0;
   int num_isolated = 0;
-  node v;
-  Iterator<node> *it = graph.getNodes();
-
-  while (it->hasNext()) {
-    v = it->next();
+  const vector<node> &nodes = graph.nodes();
 
-    if (dfsnum.get(v.id) == -1) {
-      dfsnum.set(v.id, ++count1);
+  for (unsigned int v = 0; v < nodes.size(); ++v) {
+    if (dfsnum[v] == -1) {
+      dfsnum[v] = ++count1;
       bool is_isolated = true;
 
-      for (auto e : graph.getInOutEdges(v)) {
-        if (graph.opposite(e, v) != v) {
+      for (auto e : graph.inOutEdges(nodes[v])) {
+        if (graph.opposite(e, nodes[v]) != nodes[v]) {
           is_isolated = false;
           break;
         }
@@ -165,23 +170,284 @@ int biconnectedComponents(const Graph &graph, MutableContainer<int> &compnum) {
       if (is_isolated) {
         num_isolated++;
       } else {
-        current.push(v);
+        current.push_back(v);
         bicoTestAndLabeling(graph, v, compnum, dfsnum, lowpt, father, current, count1, count2);
-        current.pop();
+        current.pop_back();
       }
     }
   }
 
-  delete it;
   return (count2 + num_isolated);
 }
 //=============================================================================================
+// lock-free union-find, the root of a set is its smallest element
+static unsigned int findRoot(vector<atomic<unsigned int>> &parent, unsigned int i) {
+  for (;;) {
+    unsigned int p = parent[i].load(memory_order_relaxed);
+
+    if (p == i)
+      return i;
+
+    unsigned int gp = parent[p].load(memory_order_relaxed);
+
+    // path halving, it does not matter if another thread
+    // has already changed the parent of i
+    if (gp != p)
+      parent[i].compare_exchange_weak(p, gp, memory_order_relaxed);
+
+    i = gp;
+  }
+}
+
+// returns true if the sets of i and j were disjoint
+static bool unite(vector<atomic<unsigned int>> &parent, unsigned int i, unsigned int j) {
+  for (;;) {
+    i = findRoot(parent, i);
+    j = findRoot(parent, j);
+
+    if (i == j)
+      return false;
+
+    if (i < j)
+      std::swap(i, j);
+
+    unsigned int expected = i;
+
+    if (parent[i].compare_exchange_strong(expected, j, memory_order_relaxed))
+      return true;
+  }
+}
+
+//=============================================================================================
+// parallel Tarjan-Vishkin algorithm: a spanning forest is built with a union-find,
+// numbered in preorder, then the tree edges, identified by their child node,
+// are gathered in the connected components of an auxiliary graph:
+// - two tree edges are linked by a non tree edge joining their child nodes,
+//   when none of its ends is an ancestor of the other,
+// - the tree edges (v, p) and (p, p(p)) are linked when a non tree edge
+//   leaves the subtree of v out of the subtree of p.
+// A non tree edge belongs to the component of the tree edge of its end of greatest
+// preorder number. The components are numbered in the order of their smallest edge
+// and their number is returned.
+static int parallelBiconnectedComponents(const Graph &graph,
+                                         EdgeStaticProperty<double> &compnum) {
+  const vector<edge> &edges = graph.edges();
+  unsigned int nbNodes = graph.numberOfNodes();
+  unsigned int nbEdges = edges.size();
+
+  if (nbEdges == 0)
+    return 0;
+
+  vector<unsigned int> sources(nbEdges), targets(nbEdges);
+  vector<atomic<unsigned int>> sets(nbNodes);
+  TLP_PARALLEL_MAP_INDICES(nbNodes,
+                           [&](unsigned int i) { sets[i].store(i, memory_order_relaxed); });
+  TLP_PARALLEL_MAP_INDICES(nbEdges, [&](unsigned int i) {
+    const pair<node, node> &eEnds = graph.ends(edges[i]);
+    sources[i] = graph.nodePos(eEnds.first);
+    targets[i] = graph.nodePos(eEnds.second);
+  });
+  // the spanning forest, made of the edges joining two distinct trees,
+  // vector<bool> can not be written concurrently
+  vector<char> treeFlags(nbEdges, 0);
+  TLP_PARALLEL_MAP_INDICES(nbEdges, [&](unsigned int i) {
+    if (sources[i] != targets[i] && unite(sets, sources[i], targets[i]))
+      treeFlags[i] = 1;
+  });
+
+  // the tree neighbours of the nodes, those of the node at position pos
+  // are in [begins[pos], begins[pos + 1])
+  vector<unsigned int> begins(nbNodes + 1, 0);
+
+  for (unsigned int i = 0; i < nbEdges; ++i) {
+    if (treeFlags[i]) {
+      ++begins[sources[i] + 1];
+      ++begins[targets[i] + 1];
+    }
+  }
+
+  for (unsigned int i = 0; i < nbNodes; ++i)
+    begins[i + 1] += begins[i];
+
+  vector<unsigned int> neighbourEdges(begins[nbNodes]);
+  {
+    vector<unsigned int> ends(begins.begin(), begins.end() - 1);
+
+    for (unsigned int i = 0; i < nbEdges; ++i) {
+      if (treeFlags[i]) {
+        neighbourEdges[ends[sources[i]]++] = i;
+        neighbourEdges[ends[targets[i]]++] = i;
+      }
+    }
+  }
+
+  // the breadth first search levels of the trees, each rooted at its smallest node,
+  // the children of levels[l][i] are levels[l + 1][firstChildren[l][i] .. firstChildren[l][i + 1][
+  vector<unsigned int> parents(nbNodes, UINT_MAX), parentEdges(nbNodes, UINT_MAX);
+  vector<vector<unsigned int>> levels(1), firstChildren;
+
+  for (unsigned int i = 0; i < nbNodes; ++i) {
+    if (findRoot(sets, i) == i) {
+      parents[i] = i;
+      levels[0].push_back(i);
+    }
+  }
+
+  while (!levels.back().empty()) {
+    const vector<unsigned int> &level = levels.back();
+    firstChildren.emplace_back(level.size() + 1, 0);
+    vector<unsigned int> &first = firstChildren.back();
+    TLP_PARALLEL_MAP_INDICES(level.size(), [&](unsigned int i) {
+      unsigned int v = level[i];
+      first[i + 1] = begins[v + 1] - begins[v] - (parents[v] == v ? 0 : 1);
+    });
+
+    for (unsigned int i = 0; i < level.size(); ++i)
+      first[i + 1] += first[i];
+
+    vector<unsigned int> next(first.back());
+    TLP_PARALLEL_MAP_INDICES(level.size(), [&](unsigned int i) {
+      unsigned int v = level[i];
+      unsigned int j = first[i];
+
+      for (unsigned int k = begins[v]; k < begins[v + 1]; ++k) {
+        unsigned int e = neighbourEdges[k];
+
+        if (e != parentEdges[v]) {
+          unsigned int w = sources[e] == v ? targets[e] : sources[e];
+          parents[w] = v;
+          parentEdges[w] = e;
+          next[j++] = w;
+        }
+      }
+    });
+    levels.push_back(std::move(next));
+  }
+
+  levels.pop_back();
+
+  // the sizes of the subtrees, from the deepest level
+  vector<unsigned int> sizes(nbNodes, 1);
+
+  for (unsigned int l = levels.size() - 1; l-- > 0;) {
+    const vector<unsigned int> &children = levels[l + 1];
+    const vector<unsigned int> &first = firstChildren[l];
+    TLP_PARALLEL_MAP_INDICES(levels[l].size(), [&](unsigned int i) {
+      unsigned int v = levels[l][i];
+
+      for (unsigned int j = first[i]; j < first[i + 1]; ++j)
+        sizes[v] += sizes[children[j]];
+    });
+  }
+
+  // the preorder numbers, from the roots
+  vector<unsigned int> pre(nbNodes);
+  unsigned int nbPre = 0;
+
+  for (unsigned int v : levels[0]) {
+    pre[v] = nbPre;
+    nbPre += sizes[v];
+  }
+
+  for (unsigned int l = 0; l + 1 < levels.size(); ++l) {
+    const vector<unsigned int> &children = levels[l + 1];
+    const vector<unsigned int> &first = firstChildren[l];
+    TLP_PARALLEL_MAP_INDICES(levels[l].size(), [&](unsigned int i) {
+      unsigned int next = pre[levels[l][i]] + 1;
+
+      for (unsigned int j = first[i]; j < first[i + 1]; ++j) {
+        pre[children[j]] = next;
+        next += sizes[children[j]];
+      }
+    });
+  }
+
+  auto isAncestor = [&](unsigned int u, unsigned int w) {
+    return pre[u] <= pre[w] && pre[w] < pre[u] + sizes[u];
+  };
+
+  // the lowest and highest preorder numbers
+  // reached by a non tree edge from a subtree
+  vector<unsigned int> lows(nbNodes), highs(nbNodes);
+  TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int v) { lows[v] = highs[v] = pre[v]; });
+  vector<vector<unsigned int>> nonTreeEdges(nbNodes);
+
+  for (unsigned int i = 0; i < nbEdges; ++i) {
+    if (!treeFlags[i] && sources[i] != targets[i]) {
+      nonTreeEdges[sources[i]].push_back(i);
+      nonTreeEdges[targets[i]].push_back(i);
+    }
+  }
+
+  TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int v) {
+    for (unsigned int e : nonTreeEdges[v]) {
+      unsigned int w = sources[e] == v ? targets[e] : sources[e];
+      lows[v] = std::min(lows[v], pre[w]);
+      highs[v] = std::max(highs[v], pre[w]);
+    }
+  });
+
+  for (unsigned int l = levels.size() - 1; l-- > 0;) {
+    const vector<unsigned int> &children = levels[l + 1];
+    const vector<unsigned int> &first = firstChildren[l];
+    TLP_PARALLEL_MAP_INDICES(levels[l].size(), [&](unsigned int i) {
+      unsigned int v = levels[l][i];
+
+      for (unsigned int j = first[i]; j < first[i + 1]; ++j) {
+        lows[v] = std::min(lows[v], lows[children[j]]);
+        highs[v] = std::max(highs[v], highs[children[j]]);
+      }
+    });
+  }
+
+  // the components of the tree edges, each identified by its child node
+  TLP_PARALLEL_MAP_INDICES(nbNodes,
+                           [&](unsigned int i) { sets[i].store(i, memory_order_relaxed); });
+  TLP_PARALLEL_MAP_INDICES(nbEdges, [&](unsigned int i) {
+    unsigned int u = sources[i], w = targets[i];
+
+    if (!treeFlags[i] && u != w && !isAncestor(u, w) && !isAncestor(w, u))
+      unite(sets, u, w);
+  });
+  TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int v) {
+    unsigned int p = parents[v];
+
+    if (p != v && parents[p] != p &&
+        (lows[v] < pre[p] || highs[v] >= pre[p] + sizes[p]))
+      unite(sets, v, p);
+  });
+
+  // the components are numbered in the order of their smallest edge,
+  // the loops do not belong to any component
+  vector<unsigned int> numbers(nbNodes, UINT_MAX);
+  int nbComponents = 0;
+
+  for (unsigned int i = 0; i < nbEdges; ++i) {
+    unsigned int u = sources[i], w = targets[i];
+
+    if (u == w)
+      continue;
+
+    unsigned int root = findRoot(sets, pre[u] < pre[w] ? w : u);
+
+    if (numbers[root] == UINT_MAX)
+      numbers[root] = nbComponents++;
+
+    compnum[i] = numbers[root];
+  }
+
+  return nbComponents;
+}
+//=============================================================================================
 
 /** \addtogroup metric */
 
 /** This plugin is an implementation of a biconnected component decomposition algorithm. It assigns
  *  the same value to all the edges in the same component.
  *
+ *  \note When the "parallel" parameter is true, the Tarjan-Vishkin algorithm is used
+ *  and the components are numbered in the order of their smallest edge.
+ *
  */
 class BiconnectedComponent : public DoubleAlgorithm {
 public:
@@ -190,21 +456,30 @@ public:
                     "It assigns the same value to all the edges in the same component.",
                     "1.0", "Component")
   BiconnectedComponent(const tlp::PluginContext *context) : DoubleAlgorithm(context) {
+    addInParameter<bool>("parallel", paramHelp[0], "false", false);
     addOutParameter<unsigned int>("#biconnected components",
                                   "Number of biconnected components found");
   }
   bool run() override {
-    MutableContainer<int> compo;
+    bool parallel = false;
+
+    if (dataSet != nullptr)
+      dataSet->get("parallel", parallel);
+
+    EdgeStaticProperty<double> compo(graph);
     compo.setAll(-1);
-    biconnectedComponents(*graph, compo);
+
+    if (parallel)
+      parallelBiconnectedComponents(*graph, compo);
+    else
+      biconnectedComponents(*graph, compo);
+
     result->setAllEdgeValue(-1);
+    compo.copyToProperty(result);
 
-    int maxVal = -1;
-    for (auto e : graph->edges()) {
-      int val = compo.get(e.id);
-      result->setEdgeValue(e, val);
-      maxVal = std::max(val, maxVal);
-    }
+    double maxVal = -1;
+    for (unsigned int i = 0; i < compo.size(); ++i)
+      maxVal = std::max(compo[i], maxVal);
 
     if (dataSet != nullptr)
       dataSet->set("#biconnected components", uint(maxVal + 1));
@@ -100,28 +100,44 @@ struct PageRank : public DoubleAlgorithm {
     NodeStaticProperty<double> deg(graph);
     tlp::degree(graph, deg, directed ? DIRECTED : UNDIRECTED, weight, false);
 
-    auto getNodes = getNodesIterator(directed ? DIRECTED : UNDIRECTED);
-    auto getEdges = getEdgesIterator(directed ? DIRECTED : UNDIRECTED);
+    // the topology is read in the cached snapshot of the graph,
+    // whose i-th node is the i-th node of the graph
+    shared_ptr<const GraphSnapshot> snapshot = graphSnapshot();
+    const VectorGraph &vGraph = snapshot->getVectorGraph();
+
+    // the weights of the edges, indexed by the edges of the snapshot
+    EdgeStaticProperty<double> w(graph);
+
+    if (weight)
+      TLP_PARALLEL_MAP_EDGES_AND_INDICES(
+          graph, [&](const edge e, unsigned int i) { w[i] = weight->getEdgeDoubleValue(e); });
+    else
+      w.setAll(1);
 
     for (unsigned int k = 0; k < kMax + 1; ++k) {
-      if (!weight) {
-        TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
-          double n_sum = 0;
-          for (auto nin : getNodes(graph, n))
-            n_sum += pr.getNodeValue(nin) / deg.getNodeValue(nin);
-          next_pr[i] = one_minus_d + d * n_sum;
-        });
-      } else {
-        TLP_PARALLEL_MAP_NODES_AND_INDICES(graph, [&](const node n, unsigned int i) {
-          double n_sum = 0;
-          for (auto e : getEdges(graph, n)) {
-            node nin = graph->opposite(e, n);
-            if (deg.getNodeValue(nin) > 0)
-              n_sum += weight->getEdgeDoubleValue(e) * pr.getNodeValue(nin) / deg.getNodeValue(nin);
+      TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int i) {
+        node n(i);
+        const vector<edge> &star = vGraph.star(n);
+        double n_sum = 0;
+
+        for (unsigned int j = 0; j < star.size(); ++j) {
+          edge e = star[j];
+
+          if (directed) {
+            // only the out edges are considered,
+            // a loop appears twice in a row in the star of its node
+            if (vGraph.source(e) != n || (j > 0 && star[j - 1] == e))
+              continue;
           }
-          next_pr[i] = one_minus_d + d * n_sum;
-        });
-      }
+
+          unsigned int nin = vGraph.opposite(e, n).id;
+
+          if (deg[nin] > 0)
+            n_sum += w[e.id] * pr[nin] / deg[nin];
+        }
+
+        next_pr[i] = one_minus_d + d * n_sum;
+      });
 
       // swap pr and next_pr
       pr.swap(next_pr);
@@ -1,76 +1,334 @@
-/**
- *
- * This file is part of Tulip (http://tulip.labri.fr)
- *
- * Authors: David Auber and the Tulip development Team
- * from LaBRI, University of Bordeaux
- *
- * Tulip is free software; you can redistribute it and/or modify
- * it under the terms of the GNU Lesser General Public License
- * as published by the Free Software Foundation, either version 3
- * of the License, or (at your option) any later version.
- *
- * Tulip is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
- * See the GNU General Public License for more details.
- *
- */
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
 #include "StrongComponent.h"
 
+#include <tulip/ParallelTools.h>
+#include <tulip/StaticProperty.h>
+
 PLUGIN(StrongComponent)
 
 using namespace std;
 using namespace tlp;
 
-unsigned StrongComponent::attachNumerotation(tlp::node n,
-                                             std::unordered_map<tlp::node, bool> &visited,
-                                             std::unordered_map<tlp::node, bool> &finished,
-                                             std::unordered_map<tlp::node, unsigned> &minAttach,
-                                             unsigned &id, std::stack<tlp::node> &renum,
-                                             unsigned &curComponent) {
-  if (visited[n])
-    return minAttach[n];
-
-  visited[n] = true;
-  unsigned myId = id;
-  id++;
-  minAttach[n] = myId;
-  renum.push(n);
-  unsigned res = myId;
-
-  for (auto tmpN : graph->getOutNodes(n)) {
-
-    if (!finished[tmpN]) {
-      unsigned tmp =
-          attachNumerotation(tmpN, visited, finished, minAttach, id, renum, curComponent);
-
-      if (res > tmp)
-        res = tmp;
+static const char *paramHelp[] = {
+    // parallel
+    "If true, the components are computed in parallel by a coloring algorithm "
+    "instead of the sequential Tarjan algorithm. The components are the same "
+    "but they are numbered in the order of their smallest node."};
+
+// structure below is used to implement the dfs loop
+struct dfsStrongComponentStruct {
+  unsigned int pos;
+  // the dfs number of the node
+  unsigned int id;
+  // the smallest attach number reachable from the node
+  unsigned int minAttach;
+  // the index of the next edge to walk through
+  // in the adjacency of the node in the root graph
+  unsigned int edgeIndex;
+
+  dfsStrongComponentStruct(unsigned int pos, unsigned int id)
+      : pos(pos), id(id), minAttach(id), edgeIndex(0) {}
+};
+
+// iterative version of the Tarjan algorithm,
+// the components are numbered in the order of their completion.
+// Returns the number of components.
+static unsigned int strongComponents(const Graph *graph, NodeStaticProperty<double> &components) {
+  const vector<node> &nodes = graph->nodes();
+  unsigned int nbNodes = nodes.size();
+  NodeStaticProperty<bool> visited(graph);
+  visited.setAll(false);
+  NodeStaticProperty<bool> finished(graph);
+  finished.setAll(false);
+  NodeStaticProperty<unsigned int> minAttach(graph);
+  vector<unsigned int> renum;
+  vector<dfsStrongComponentStruct> dfsLevels;
+  bool isRoot = graph == graph->getRoot();
+  unsigned id = 1;
+  unsigned curComponent = 0;
+
+  for (unsigned int i = 0; i < nbNodes; ++i) {
+    if (visited[i])
+      continue;
+
+    visited[i] = true;
+    minAttach[i] = id;
+    renum.push_back(i);
+    dfsLevels.emplace_back(i, id++);
+
+    while (!dfsLevels.empty()) {
+      dfsStrongComponentStruct &dfsParams = dfsLevels.back();
+      node n = nodes[dfsParams.pos];
+      const vector<edge> &adj = graph->allEdges(n);
+
+      if (dfsParams.edgeIndex < adj.size()) {
+        edge e = adj[dfsParams.edgeIndex++];
+        const pair<node, node> &eEnds = graph->ends(e);
+
+        // only the out edges of the graph are followed
+        if (eEnds.first != n || (!isRoot && !graph->isElement(e)))
+          continue;
+
+        unsigned int pos = graph->nodePos(eEnds.second);
+
+        if (finished[pos])
+          continue;
+
+        if (visited[pos])
+          dfsParams.minAttach = std::min(dfsParams.minAttach, minAttach[pos]);
+        else {
+          visited[pos] = true;
+          minAttach[pos] = id;
+          renum.push_back(pos);
+          // dfsParams is no longer valid
+          dfsLevels.emplace_back(pos, id++);
+        }
+
+        continue;
+      }
+
+      unsigned int pos = dfsParams.pos;
+      unsigned int res = minAttach[pos] = dfsParams.minAttach;
+
+      if (res == dfsParams.id) {
+        unsigned int tmp;
+
+        do {
+          tmp = renum.back();
+          renum.pop_back();
+          finished[tmp] = true;
+          minAttach[tmp] = res;
+          components[tmp] = curComponent;
+        } while (tmp != pos);
+
+        curComponent++;
+      }
+
+      dfsLevels.pop_back();
+
+      if (!dfsLevels.empty())
+        dfsLevels.back().minAttach = std::min(dfsLevels.back().minAttach, res);
     }
   }
 
-  minAttach[n] = res;
+  return curComponent;
+}
+
+// the positions of the out (or in) neighbours of the nodes,
+// those of the node at position pos are in [begins[pos], begins[pos + 1])
+struct NeighboursPositions {
+  vector<unsigned int> begins, positions;
+
+  NeighboursPositions(const Graph *graph, bool out) : begins(graph->numberOfNodes() + 1, 0) {
+    const vector<node> &nodes = graph->nodes();
+    unsigned int nbNodes = nodes.size();
+    TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int i) {
+      begins[i + 1] = out ? graph->outdeg(nodes[i]) : graph->indeg(nodes[i]);
+    });
+
+    for (unsigned int i = 0; i < nbNodes; ++i)
+      begins[i + 1] += begins[i];
+
+    positions.resize(begins[nbNodes]);
+    TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int i) {
+      unsigned int j = begins[i];
+
+      for (auto n : out ? graph->outNodes(nodes[i]) : graph->inNodes(nodes[i]))
+        positions[j++] = graph->nodePos(n);
+    });
+  }
+};
+
+static bool atomicMax(atomic<unsigned int> &val, unsigned int newVal) {
+  unsigned int cur = val.load(memory_order_relaxed);
+
+  while (cur < newVal) {
+    if (val.compare_exchange_weak(cur, newVal, memory_order_relaxed))
+      return true;
+  }
+
+  return false;
+}
+
+static bool claim(atomic<unsigned int> &val, unsigned int newVal) {
+  unsigned int expected = UINT_MAX;
+  return val.compare_exchange_strong(expected, newVal, memory_order_relaxed);
+}
+
+// the positions to visit at the next level of a parallel breadth first search,
+// a position being added only once during the whole search
+struct NextFrontier {
+  vector<unsigned int> positions;
+  atomic<unsigned int> size;
+
+  NextFrontier(unsigned int nbNodes) : positions(nbNodes), size(0) {}
+
+  void add(unsigned int pos) {
+    positions[size++] = pos;
+  }
+};
+
+// parallel breadth first search from the positions of frontier,
+// visit(pos, next) adds to next the positions to visit after pos
+template <typename VISIT>
+static void parallelBfs(vector<unsigned int> &frontier, unsigned int nbNodes,
+                        const VISIT &visit) {
+  // the small frontiers (long paths) are visited sequentially
+  static const unsigned int MIN_PARALLEL_SIZE = 1024;
+  NextFrontier next(nbNodes);
+
+  while (!frontier.empty()) {
+    next.size = 0;
+
+    if (frontier.size() < MIN_PARALLEL_SIZE) {
+      for (unsigned int pos : frontier)
+        visit(pos, next);
+    } else
+      TLP_PARALLEL_MAP_INDICES(frontier.size(),
+                               [&](unsigned int i) { visit(frontier[i], next); });
+
+    frontier.assign(next.positions.begin(), next.positions.begin() + next.size);
+  }
+}
+
+// parallel computation of the strongly connected components, the nodes
+// without active predecessor or successor are first removed as components
+// by themselves (trimming), then the greatest position of the nodes reaching
+// each node is propagated (coloring): the nodes keeping their own color are
+// the roots of the components, made of the nodes of the same color reaching them.
+// Returns the number of components, numbered in the order of their smallest node.
+static unsigned int parallelStrongComponents(const Graph *graph,
+                                             NodeStaticProperty<double> &components) {
+  unsigned int nbNodes = graph->numberOfNodes();
+  NeighboursPositions outNeighbours(graph, true), inNeighbours(graph, false);
+  // the root of the component of each node, UINT_MAX while it is not found
+  vector<atomic<unsigned int>> roots(nbNodes);
+  vector<atomic<unsigned int>> colors(nbNodes);
+  // the numbers of active predecessors and successors, for the trimming
+  vector<atomic<unsigned int>> nbIn(nbNodes), nbOut(nbNodes);
+  vector<unsigned int> active(nbNodes), frontier;
+  TLP_PARALLEL_MAP_INDICES(nbNodes, [&](unsigned int i) {
+    roots[i].store(UINT_MAX, memory_order_relaxed);
+    active[i] = i;
+  });
+
+  auto countActive = [&](const NeighboursPositions &neighbours, unsigned int pos) {
+    unsigned int nb = 0;
+
+    for (unsigned int i = neighbours.begins[pos]; i < neighbours.begins[pos + 1]; ++i) {
+      unsigned int opp = neighbours.positions[i];
 
-  if (res == myId) {
-    while (renum.top() != n) {
-      node tmp = renum.top();
-      renum.pop();
-      finished[tmp] = true;
-      minAttach[tmp] = res;
-      result->setNodeValue(tmp, curComponent);
+      if (opp != pos && roots[opp].load(memory_order_relaxed) == UINT_MAX)
+        ++nb;
     }
 
-    finished[n] = true;
-    result->setNodeValue(n, curComponent);
-    curComponent++;
-    renum.pop();
+    return nb;
+  };
+  // a trimmed node is no longer an active neighbour
+  auto untie = [&](const NeighboursPositions &neighbours, vector<atomic<unsigned int>> &nbActive,
+                   unsigned int pos, NextFrontier &next) {
+    for (unsigned int i = neighbours.begins[pos]; i < neighbours.begins[pos + 1]; ++i) {
+      unsigned int opp = neighbours.positions[i];
+
+      if (opp != pos && roots[opp].load(memory_order_relaxed) == UINT_MAX &&
+          --nbActive[opp] == 0 && claim(roots[opp], opp))
+        next.add(opp);
+    }
+  };
+
+  auto removeFound = [&]() {
+    active.erase(remove_if(active.begin(), active.end(),
+                           [&](unsigned int pos) { return roots[pos] != UINT_MAX; }),
+                 active.end());
+  };
+
+  while (!active.empty()) {
+    // trimming
+    TLP_PARALLEL_MAP_VECTOR(active, [&](unsigned int pos) {
+      nbIn[pos].store(countActive(inNeighbours, pos), memory_order_relaxed);
+      nbOut[pos].store(countActive(outNeighbours, pos), memory_order_relaxed);
+    });
+    frontier.clear();
+
+    for (unsigned int pos : active) {
+      if (nbIn[pos] == 0 || nbOut[pos] == 0) {
+        roots[pos] = pos;
+        frontier.push_back(pos);
+      }
+    }
+
+    parallelBfs(frontier, nbNodes, [&](unsigned int pos, NextFrontier &next) {
+      untie(outNeighbours, nbIn, pos, next);
+      untie(inNeighbours, nbOut, pos, next);
+    });
+    removeFound();
+
+    if (active.empty())
+      break;
+
+    // coloring
+    TLP_PARALLEL_MAP_VECTOR(active, [&](unsigned int pos) { colors[pos] = pos; });
+    atomic<bool> changed;
+
+    do {
+      changed = false;
+      TLP_PARALLEL_MAP_VECTOR(active, [&](unsigned int pos) {
+        unsigned int color = colors[pos].load(memory_order_relaxed);
+
+        for (unsigned int i = outNeighbours.begins[pos]; i < outNeighbours.begins[pos + 1];
+             ++i) {
+          unsigned int opp = outNeighbours.positions[i];
+
+          if (roots[opp].load(memory_order_relaxed) == UINT_MAX && atomicMax(colors[opp], color))
+            changed = true;
+        }
+      });
+    } while (changed);
+
+    // the components of the roots
+    frontier.clear();
+
+    for (unsigned int pos : active) {
+      if (colors[pos] == pos) {
+        roots[pos] = pos;
+        frontier.push_back(pos);
+      }
+    }
+
+    parallelBfs(frontier, nbNodes, [&](unsigned int pos, NextFrontier &next) {
+      unsigned int color = colors[pos].load(memory_order_relaxed);
+
+      for (unsigned int i = inNeighbours.begins[pos]; i < inNeighbours.begins[pos + 1]; ++i) {
+        unsigned int opp = inNeighbours.positions[i];
+
+        if (colors[opp].load(memory_order_relaxed) == color && claim(roots[opp], color))
+          next.add(opp);
+      }
+    });
+    removeFound();
   }
 
-  return res;
+  // the components are numbered in the order of their smallest node
+  vector<unsigned int> numbers(nbNodes, UINT_MAX);
+  unsigned int nbComponents = 0;
+
+  for (unsigned int pos = 0; pos < nbNodes; ++pos) {
+    unsigned int root = roots[pos];
+
+    if (numbers[root] == UINT_MAX)
+      numbers[root] = nbComponents++;
+
+    components[pos] = numbers[root];
+  }
+
+  return nbComponents;
 }
 
 StrongComponent::StrongComponent(const tlp::PluginContext *context) : DoubleAlgorithm(context) {
+  addInParameter<bool>("parallel", paramHelp[0], "false", false);
   addOutParameter<unsigned>("#strongly connected components",
                             "Number of strongly components found");
 }
@@ -78,24 +336,22 @@ StrongComponent::StrongComponent(const tlp::PluginContext *context) : DoubleAlgo
 StrongComponent::~StrongComponent() {}
 
 bool StrongComponent::run() {
-  std::unordered_map<node, bool> visited(graph->numberOfNodes());
-  std::unordered_map<node, bool> finished(graph->numberOfNodes());
-  stack<node> renum;
-  std::unordered_map<node, unsigned> cachedValues(graph->numberOfNodes());
-  unsigned id = 1;
-  unsigned curComponent = 0;
+  bool parallel = false;
 
-  for (auto itn : graph->nodes()) {
-    if (!visited[itn]) {
-      attachNumerotation(itn, visited, finished, cachedValues, id, renum, curComponent);
-    }
-  }
+  if (dataSet != nullptr)
+    dataSet->get("parallel", parallel);
+
+  NodeStaticProperty<double> components(graph);
+  unsigned int curComponent =
+      parallel ? parallelStrongComponents(graph, components) : strongComponents(graph, components);
+  components.copyToProperty(result);
 
   for (auto ite : graph->edges()) {
     auto eEnds = graph->ends(ite);
+    double value = components.getNodeValue(eEnds.first);
 
-    if (result->getNodeValue(eEnds.first) == result->getNodeValue(eEnds.second))
-      result->setEdgeValue(ite, result->getNodeValue(eEnds.first));
+    if (value == components.getNodeValue(eEnds.second))
+      result->setEdgeValue(ite, value);
     else
       result->setEdgeValue(ite, curComponent);
   }
@@ -20,8 +20,6 @@
 #ifndef _STRONGCOMPONENT_H
 #define _STRONGCOMPONENT_H
 
-#include <stack>
-#include <unordered_map>
 #include <tulip/DoubleProperty.h>
 
 /** This plugin is an implementation of a strongly connected components decomposition.
@@ -31,6 +29,10 @@
  *  strongly connected component they have the same value else they have a
  *  different value.
  *
+ *  \note When the "parallel" parameter is true, the components are computed in parallel
+ *  by trimming and coloring the nodes, then numbered in the order of their smallest node,
+ *  so that the result does not depend on the number of threads.
+ *
  */
 class StrongComponent : public tlp::DoubleAlgorithm {
 public:
@@ -39,12 +41,6 @@ public:
   StrongComponent(const tlp::PluginContext *context);
   ~StrongComponent() override;
   bool run() override;
-
-private:
-  unsigned attachNumerotation(tlp::node, std::unordered_map<tlp::node, bool> &,
-                              std::unordered_map<tlp::node, bool> &,
-                              std::unordered_map<tlp::node, unsigned> &, unsigned &,
-                              std::stack<tlp::node> &, unsigned &);
 };
 
 #endif
@@ -0,0 +1,211 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+// tulip_render renders graph files in PNG images
+// without any window system (see tlp::GlHeadlessRenderer)
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <tulip/TlpTools.h>
+#include <tulip/Graph.h>
+#include <tulip/PluginLibraryLoader.h>
+#include <tulip/PluginLoaderTxt.h>
+#include <tulip/GlyphManager.h>
+#include <tulip/EdgeExtremityGlyphManager.h>
+#include <tulip/GlHeadlessRenderer.h>
+#include <tulip/GlGraphComposite.h>
+#include <tulip/GlGraphRenderingParameters.h>
+#include <tulip/Camera.h>
+
+using namespace std;
+using namespace tlp;
+
+static void usage(const char *program) {
+  cerr << "Usage: " << program << " [options] graph_file..." << endl
+       << "Render each graph file in <output_dir>/<graph_file_name>.png" << endl
+       << "Options:" << endl
+       << "  -W, --width <pixels>        width of the images (default 1024)" << endl
+       << "  -H, --height <pixels>       height of the images (default 1024)" << endl
+       << "  -o, --output <dir>          the directory of the images (default .)" << endl
+       << "  -s, --samples <n>           samples per pixel for antialiasing (default 4)" << endl
+       << "  -v, --views <n>             render n views rotating around the graph;" << endl
+       << "                              the images are named <graph_file_name>_<i>.png" << endl
+       << "  -b, --background <r,g,b>    background color (default 255,255,255)" << endl
+       << "  -t, --threads <n>           number of PNG encoding threads (default 2)" << endl
+       << "  --no-labels                 do not render the labels" << endl
+       << "  --verbose                   display the plugins loading" << endl;
+}
+
+static bool toUnsigned(const char *str, unsigned int &value) {
+  char *end;
+  long v = strtol(str, &end, 10);
+
+  if (*end != '\0' || v < 0)
+    return false;
+
+  value = static_cast<unsigned int>(v);
+  return true;
+}
+
+static string baseName(const string &file) {
+  size_t start = file.find_last_of("/\\");
+  start = (start == string::npos) ? 0 : start + 1;
+  size_t end = file.find('.', start);
+  return file.substr(start, end == string::npos ? string::npos : end - start);
+}
+
+int main(int argc, char **argv) {
+  unsigned int width = 1024, height = 1024, samples = 4, views = 1, nbThreads = 2;
+  string outputDir(".");
+  Color background(255, 255, 255);
+  bool labels = true, verbose = false;
+  vector<string> files;
+
+  for (int i = 1; i < argc; ++i) {
+    string arg(argv[i]);
+    bool hasValue = i + 1 < argc;
+    bool ok = true;
+
+    if (arg == "--help") {
+      usage(argv[0]);
+      return EXIT_SUCCESS;
+    } else if (arg == "--no-labels")
+      labels = false;
+    else if (arg == "--verbose")
+      verbose = true;
+    else if (arg == "-W" || arg == "--width")
+      ok = hasValue && toUnsigned(argv[++i], width) && width > 0;
+    else if (arg == "-H" || arg == "--height")
+      ok = hasValue && toUnsigned(argv[++i], height) && height > 0;
+    else if (arg == "-s" || arg == "--samples")
+      ok = hasValue && toUnsigned(argv[++i], samples);
+    else if (arg == "-v" || arg == "--views")
+      ok = hasValue && toUnsigned(argv[++i], views) && views > 0;
+    else if (arg == "-t" || arg == "--threads")
+      ok = hasValue && toUnsigned(argv[++i], nbThreads) && nbThreads > 0;
+    else if (arg == "-o" || arg == "--output") {
+      ok = hasValue;
+
+      if (ok)
+        outputDir = argv[++i];
+    } else if (arg == "-b" || arg == "--background") {
+      unsigned int r, g, b;
+      char c1, c2;
+      ok = hasValue;
+
+      if (ok) {
+        istringstream iss(argv[++i]);
+        ok = (iss >> r >> c1 >> g >> c2 >> b) && c1 == ',' && c2 == ',' && r < 256 && g < 256 &&
+             b < 256;
+
+        if (ok)
+          background = Color(r, g, b);
+      }
+    } else if (!arg.empty() && arg[0] == '-')
+      ok = false;
+    else
+      files.push_back(arg);
+
+    if (!ok) {
+      cerr << "Invalid option or value: " << arg << endl;
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (files.empty()) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  initTulipLib();
+  PluginLoaderTxt loader;
+  PluginLibraryLoader::loadPlugins(verbose ? &loader : nullptr);
+  GlyphManager::loadGlyphPlugins();
+  EdgeExtremityGlyphManager::loadGlyphPlugins();
+
+  GlHeadlessRenderer renderer(nbThreads);
+
+  if (!renderer.init(width, height, samples)) {
+    cerr << "Unable to initialize the rendering: " << renderer.getErrorMessage() << endl;
+    return EXIT_FAILURE;
+  }
+
+  renderer.setBackgroundColor(background);
+
+  int status = EXIT_SUCCESS;
+  Graph *previousGraph = nullptr;
+
+  for (const string &file : files) {
+    // the graphs are loaded in the rendering thread, as the observation
+    // mechanism is not thread safe, while the previous images
+    // are read back and encoded
+    Graph *graph = loadGraph(file);
+
+    if (graph == nullptr) {
+      cerr << "Unable to load " << file << endl;
+      status = EXIT_FAILURE;
+      continue;
+    }
+
+    renderer.setGraph(graph);
+    delete previousGraph;
+    previousGraph = graph;
+
+    GlGraphRenderingParameters *parameters =
+        renderer.getGraphComposite()->getRenderingParametersPointer();
+    parameters->setViewNodeLabel(labels);
+    parameters->setViewEdgeLabel(labels);
+
+    string name = outputDir + "/" + baseName(file);
+
+    for (unsigned int i = 0; i < views; ++i) {
+      string imageFile = name;
+
+      if (views > 1) {
+        ostringstream oss;
+        oss << '_' << i;
+        imageFile += oss.str();
+      }
+
+      imageFile += ".png";
+
+      // the views rotate around the vertical axis
+      if (i > 0)
+        renderer.getCamera().rotate(float(2 * M_PI / views), 0, 1, 0);
+
+      renderer.renderScene(
+          [imageFile](const vector<unsigned char> &rgba, unsigned int w, unsigned int h) {
+            if (!GlHeadlessRenderer::savePNG(imageFile, rgba, w, h))
+              cerr << "Unable to write " << imageFile << endl;
+          },
+          i == 0);
+    }
+  }
+
+  renderer.flush();
+  renderer.setGraph(nullptr);
+  delete previousGraph;
+
+  return status;
+}
@@ -0,0 +1,79 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <tulip/Graph.h>
+
+using namespace std;
+using namespace tlp;
+
+// the walk through the adjacency of the nodes
+// of a subgraph using the ranges or the iterators
+int main(int argc, char **argv) {
+  unsigned int nbNodes = argc > 1 ? stoul(argv[1]) : 100000;
+  unsigned int nbEdges = argc > 2 ? stoul(argv[2]) : 10 * nbNodes;
+  const unsigned int NB_WALKS = 10;
+
+  Graph *graph = newGraph();
+  mt19937 gen(42);
+  vector<node> nodes;
+  graph->addNodes(nbNodes, nodes);
+  uniform_int_distribution<unsigned int> dist(0, nbNodes - 1);
+
+  for (unsigned int i = 0; i < nbEdges; ++i)
+    graph->addEdge(nodes[dist(gen)], nodes[dist(gen)]);
+
+  Graph *sg = graph->addCloneSubGraph();
+  unsigned long long rangeSum = 0, iteratorSum = 0;
+
+  auto start = chrono::steady_clock::now();
+
+  for (unsigned int i = 0; i < NB_WALKS; ++i) {
+    for (auto n : sg->nodes()) {
+      for (auto m : sg->inOutNodes(n))
+        rangeSum += m.id;
+    }
+  }
+
+  auto middle = chrono::steady_clock::now();
+
+  for (unsigned int i = 0; i < NB_WALKS; ++i) {
+    for (auto n : sg->nodes()) {
+      for (auto m : sg->getInOutNodes(n))
+        iteratorSum += m.id;
+    }
+  }
+
+  auto end = chrono::steady_clock::now();
+  delete graph;
+
+  if (rangeSum != iteratorSum) {
+    cerr << "the ranges and the iterators give different nodes" << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << nbNodes << " nodes, " << nbEdges << " edges, " << NB_WALKS
+       << " in/out nodes walks: ranges "
+       << chrono::duration<double, milli>(middle - start).count() << " ms, iterators "
+       << chrono::duration<double, milli>(end - middle).count() << " ms" << endl;
+  return EXIT_SUCCESS;
+}
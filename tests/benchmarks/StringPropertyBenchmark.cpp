@@ -0,0 +1,91 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <chrono>
+#include <iostream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <tulip/Graph.h>
+#include <tulip/StringProperty.h>
+
+using namespace std;
+using namespace tlp;
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HAS_MALLINFO2
+#endif
+
+static size_t allocatedMemory() {
+#ifdef HAS_MALLINFO2
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+// the memory used by a categorical property whose values are set one at
+// a time (as the importers do) and the time of the search of the nodes
+// having a given value, with or without the interning of the values
+int main(int argc, char **argv) {
+  unsigned int nbNodes = argc > 1 ? stoul(argv[1]) : 1000000;
+  unsigned int nbCategories = argc > 2 ? stoul(argv[2]) : 50;
+  // values which do not fit in the small string buffer of std::string
+  vector<string> categories;
+
+  for (unsigned int i = 0; i < nbCategories; ++i)
+    categories.push_back("a rather long category name #" + to_string(i));
+
+  Graph *graph = newGraph();
+  graph->addNodes(nbNodes);
+  const InterningMode modes[] = {NEVER_INTERNED, AUTO_INTERNED};
+  const char *modeNames[] = {"not interned", "interned"};
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    size_t before = allocatedMemory();
+    auto start = chrono::steady_clock::now();
+    StringProperty *category = new StringProperty(graph);
+    category->setInterningMode(modes[i]);
+
+    for (auto n : graph->nodes())
+      category->setNodeValue(n, categories[n.id % nbCategories]);
+
+    auto middle = chrono::steady_clock::now();
+    size_t memory = allocatedMemory() - before;
+    unsigned int nbFound = iteratorCount(category->getNodesEqualTo(categories[0]));
+    auto end = chrono::steady_clock::now();
+
+    cout << modeNames[i] << ": set "
+         << chrono::duration<double, milli>(middle - start).count() << " ms, search "
+         << chrono::duration<double, milli>(end - middle).count() << " ms (" << nbFound
+         << " nodes)";
+#ifdef HAS_MALLINFO2
+    cout << ", " << memory / 1024 << " KB";
+#else
+    (void)memory;
+#endif
+    cout << endl;
+    delete category;
+  }
+
+  delete graph;
+  return EXIT_SUCCESS;
+}
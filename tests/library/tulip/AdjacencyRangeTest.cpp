@@ -0,0 +1,171 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <random>
+
+#include <tulip/ConnectedTest.h>
+#include <tulip/GraphMeasure.h>
+#include <tulip/GraphTools.h>
+
+#include "AdjacencyRangeTest.h"
+
+using namespace std;
+using namespace tlp;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AdjacencyRangeTest);
+
+void AdjacencyRangeTest::setUp() {
+  graph = newGraph();
+  // a random multigraph with loops
+  mt19937 gen(42);
+  vector<node> nodes;
+  graph->addNodes(200, nodes);
+  uniform_int_distribution<unsigned int> dist(0, nodes.size() - 1);
+
+  for (unsigned int i = 0; i < 1000; ++i)
+    graph->addEdge(nodes[dist(gen)], nodes[dist(gen)]);
+
+  for (unsigned int i = 0; i < 20; ++i) {
+    node n = nodes[dist(gen)];
+    graph->addEdge(n, n);
+  }
+}
+
+void AdjacencyRangeTest::tearDown() {
+  delete graph;
+}
+
+template <typename ELT, typename RANGE>
+static void checkRange(Iterator<ELT> *it, RANGE range) {
+  vector<ELT> expected = iteratorVector(it);
+  vector<ELT> elts;
+
+  for (auto elt : range)
+    elts.push_back(elt);
+
+  CPPUNIT_ASSERT(expected == elts);
+  CPPUNIT_ASSERT_EQUAL(expected.empty(), range.empty());
+}
+
+void AdjacencyRangeTest::checkRanges(Graph *g) {
+  for (auto n : g->nodes()) {
+    checkRange(g->getInNodes(n), g->inNodes(n));
+    checkRange(g->getOutNodes(n), g->outNodes(n));
+    checkRange(g->getInOutNodes(n), g->inOutNodes(n));
+    checkRange(g->getInEdges(n), g->inEdges(n));
+    checkRange(g->getOutEdges(n), g->outEdges(n));
+    checkRange(g->getInOutEdges(n), g->inOutEdges(n));
+    CPPUNIT_ASSERT_EQUAL(g->indeg(n), iteratorCount(g->getInEdges(n)));
+    CPPUNIT_ASSERT_EQUAL(g->outdeg(n), iteratorCount(g->getOutEdges(n)));
+  }
+}
+
+void AdjacencyRangeTest::testRootGraph() {
+  checkRanges(graph);
+
+  // a loop whose two occurrences are not contiguous
+  // in the adjacency of its node
+  node n = graph->addNode();
+  edge loop = graph->addEdge(n, n);
+  edge e = graph->addEdge(n, graph->getOneNode());
+  vector<edge> order = {loop, e, loop};
+  graph->setEdgeOrder(n, order);
+  vector<edge> edges;
+
+  for (auto oe : graph->outEdges(n))
+    edges.push_back(oe);
+
+  CPPUNIT_ASSERT_EQUAL(size_t(2), edges.size());
+  CPPUNIT_ASSERT_EQUAL(loop, edges[0]);
+  CPPUNIT_ASSERT_EQUAL(e, edges[1]);
+  checkRanges(graph);
+}
+
+void AdjacencyRangeTest::testSubGraph() {
+  Graph *sg = graph->addSubGraph();
+  const vector<node> &nodes = graph->nodes();
+  const vector<edge> &edges = graph->edges();
+
+  for (unsigned int i = 0; i < nodes.size(); i += 2)
+    sg->addNode(nodes[i]);
+
+  for (unsigned int i = 0; i < edges.size(); i += 3) {
+    const pair<node, node> &ends = graph->ends(edges[i]);
+
+    if (sg->isElement(ends.first) && sg->isElement(ends.second))
+      sg->addEdge(edges[i]);
+  }
+
+  checkRanges(sg);
+  // through a sub subgraph
+  checkRanges(sg->addCloneSubGraph());
+}
+
+void AdjacencyRangeTest::testAlgorithms() {
+  Graph *sg = graph->addSubGraph();
+  const vector<node> &nodes = graph->nodes();
+
+  for (unsigned int i = 0; i < 50; ++i)
+    sg->addNode(nodes[i]);
+
+  for (auto e : graph->edges()) {
+    const pair<node, node> &ends = graph->ends(e);
+
+    if (sg->isElement(ends.first) && sg->isElement(ends.second))
+      sg->addEdge(e);
+  }
+
+  vector<vector<node>> components;
+  ConnectedTest::computeConnectedComponents(sg, components);
+  unsigned int nbNodes = 0;
+
+  for (const vector<node> &component : components)
+    nbNodes += component.size();
+
+  CPPUNIT_ASSERT_EQUAL(sg->numberOfNodes(), nbNodes);
+  CPPUNIT_ASSERT_EQUAL(unsigned(components.size()),
+                       ConnectedTest::numberOfConnectedComponents(sg));
+
+  // the nodes visited by a dfs or a bfs
+  // are those of the component of their root
+  vector<node> visited;
+  dfs(sg, components[0][0], visited);
+  CPPUNIT_ASSERT_EQUAL(components[0].size(), visited.size());
+  visited.clear();
+  bfs(sg, components[0][0], visited);
+  CPPUNIT_ASSERT(components[0] == visited);
+
+  NodeStaticProperty<unsigned int> distance(sg);
+  maxDistance(sg, 0, distance, UNDIRECTED);
+
+  for (auto n : sg->nodes()) {
+    unsigned int d = distance.getNodeValue(n);
+
+    if (d == 0)
+      continue;
+
+    // a node at distance d has a neighbour at distance d - 1 (if reachable)
+    bool found = (d == UINT_MAX);
+
+    for (auto m : sg->inOutNodes(n))
+      found = found || distance.getNodeValue(m) == d - 1;
+
+    CPPUNIT_ASSERT(found);
+  }
+}
@@ -0,0 +1,48 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef ADJACENCY_RANGE_TEST_H
+#define ADJACENCY_RANGE_TEST_H
+
+#include <tulip/Graph.h>
+
+#include "CppUnitIncludes.h"
+
+class AdjacencyRangeTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(AdjacencyRangeTest);
+  CPPUNIT_TEST(testRootGraph);
+  CPPUNIT_TEST(testSubGraph);
+  CPPUNIT_TEST(testAlgorithms);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() override;
+  void tearDown() override;
+  void testRootGraph();
+  void testSubGraph();
+  void testAlgorithms();
+
+private:
+  // check that the ranges give the same elements as the iterators
+  void checkRanges(tlp::Graph *g);
+
+  tlp::Graph *graph;
+};
+
+#endif // ADJACENCY_RANGE_TEST_H
@@ -0,0 +1,185 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <cstdlib>
+
+#include "DijkstraTest.h"
+
+#include <tulip/BooleanProperty.h>
+#include <tulip/Dijkstra.h>
+#include <tulip/Graph.h>
+#include <tulip/GraphTools.h>
+
+using namespace std;
+using namespace tlp;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DijkstraTest);
+
+void DijkstraTest::setUp() {
+  graph = tlp::newGraph();
+}
+
+void DijkstraTest::tearDown() {
+  delete graph;
+}
+
+// a random graph with positive weights
+static void buildRandomGraph(Graph *graph, EdgeStaticProperty<double> &weights,
+                             unsigned int nbNodes, unsigned int nbEdges) {
+  graph->addNodes(nbNodes);
+  const vector<node> &nodes = graph->nodes();
+
+  for (unsigned int i = 0; i < nbEdges; ++i)
+    graph->addEdge(nodes[rand() % nbNodes], nodes[rand() % nbNodes]);
+
+  weights = EdgeStaticProperty<double>(graph);
+
+  for (unsigned int i = 0; i < nbEdges; ++i)
+    weights[i] = 1 + rand() % 10;
+}
+
+void DijkstraTest::testDistances() {
+  //  n0 -1-> n1 -1-> n2
+  //   \______3_____/^
+  //  n3 unreachable
+  node n0 = graph->addNode();
+  node n1 = graph->addNode();
+  node n2 = graph->addNode();
+  node n3 = graph->addNode();
+  edge e0 = graph->addEdge(n0, n1);
+  edge e1 = graph->addEdge(n1, n2);
+  edge e2 = graph->addEdge(n0, n2);
+  EdgeStaticProperty<double> weights(graph);
+  weights.setEdgeValue(e0, 1);
+  weights.setEdgeValue(e1, 1);
+  weights.setEdgeValue(e2, 2);
+
+  NodeStaticProperty<double> distances(graph);
+  stack<node> queue;
+  MutableContainer<int> nbPaths;
+  unordered_map<node, list<node>> ancestors;
+  computeDijkstra(graph, n0, weights, distances, DIRECTED, ancestors, &queue, &nbPaths);
+  CPPUNIT_ASSERT_EQUAL(0., distances.getNodeValue(n0));
+  CPPUNIT_ASSERT_EQUAL(1., distances.getNodeValue(n1));
+  CPPUNIT_ASSERT_EQUAL(2., distances.getNodeValue(n2));
+  CPPUNIT_ASSERT(distances.getNodeValue(n3) > DBL_MAX / 4);
+  // two shortest paths to n2
+  CPPUNIT_ASSERT_EQUAL(2, nbPaths.get(n2.id));
+  CPPUNIT_ASSERT_EQUAL(size_t(2), ancestors[n2].size());
+  // the nodes are treated by increasing distance, the unreachable ones at last
+  CPPUNIT_ASSERT_EQUAL(n3, queue.top());
+  queue.pop();
+  CPPUNIT_ASSERT_EQUAL(n2, queue.top());
+
+  // the reverse direction
+  computeDijkstra(graph, n2, weights, distances, INV_DIRECTED, ancestors);
+  CPPUNIT_ASSERT_EQUAL(2., distances.getNodeValue(n0));
+  CPPUNIT_ASSERT_EQUAL(1., distances.getNodeValue(n1));
+}
+
+void DijkstraTest::testDeltaStepping() {
+  EdgeStaticProperty<double> weights(graph);
+  buildRandomGraph(graph, weights, 1000, 3000);
+  NodeStaticProperty<double> dijkstraDistances(graph);
+  NodeStaticProperty<double> distances(graph);
+  const vector<node> &nodes = graph->nodes();
+
+  for (EDGE_TYPE direction : {UNDIRECTED, DIRECTED}) {
+    Dijkstra dijkstra(graph, nodes[0], weights, dijkstraDistances, direction);
+
+    // the default width of the buckets, narrow and wide ones
+    for (double delta : {0., 0.5, 100.}) {
+      computeDeltaSteppingDistances(graph, nodes[0], weights, distances, direction, delta);
+
+      for (unsigned int i = 0; i < nodes.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(dijkstraDistances[i], distances[i]);
+    }
+  }
+
+  // some null weights, or only null ones
+  for (unsigned int i = 0; i < weights.size(); i += 3)
+    weights[i] = 0;
+
+  for (bool allNull : {false, true}) {
+    if (allNull)
+      weights.setAll(0);
+
+    computeDeltaSteppingDistances(graph, nodes[0], weights, distances, DIRECTED);
+
+    // the same distances as Dijkstra but with a null weight
+    // replaced by a very small one
+    EdgeStaticProperty<double> smallWeights(graph);
+
+    for (unsigned int i = 0; i < weights.size(); ++i)
+      smallWeights[i] = weights[i] ? weights[i] : 1E-9;
+
+    Dijkstra dijkstra(graph, nodes[0], smallWeights, dijkstraDistances, DIRECTED);
+
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(dijkstraDistances[i], distances[i], 1E-5);
+  }
+}
+
+void DijkstraTest::testSearchPath() {
+  EdgeStaticProperty<double> weights(graph);
+  buildRandomGraph(graph, weights, 1000, 2000);
+  NodeStaticProperty<double> distances(graph);
+  const vector<node> &nodes = graph->nodes();
+  BooleanProperty selection(graph);
+
+  for (unsigned int i = 1; i < 50; ++i) {
+    Dijkstra dijkstra(graph, nodes[0], weights, distances, DIRECTED);
+    selection.setAllNodeValue(false);
+    selection.setAllEdgeValue(false);
+    bool found = Dijkstra::searchPath(graph, nodes[0], nodes[i], weights, DIRECTED, &selection);
+    CPPUNIT_ASSERT_EQUAL(distances[i] < DBL_MAX / 4, found);
+
+    if (!found) {
+      CPPUNIT_ASSERT(!selection.getNodeValue(nodes[0]));
+      continue;
+    }
+
+    // the selected path goes from nodes[0] to nodes[i] and is a shortest one
+    double length = 0;
+    node n = nodes[0];
+
+    while (n != nodes[i]) {
+      edge next;
+
+      for (auto e : graph->getOutEdges(n)) {
+        if (selection.getEdgeValue(e)) {
+          next = e;
+          break;
+        }
+      }
+
+      CPPUNIT_ASSERT(next.isValid());
+      length += weights.getEdgeValue(next);
+      selection.setEdgeValue(next, false);
+      n = graph->target(next);
+      CPPUNIT_ASSERT(selection.getNodeValue(n));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(distances[i], length);
+  }
+
+  // the path from a node to itself
+  selection.setAllNodeValue(false);
+  CPPUNIT_ASSERT(Dijkstra::searchPath(graph, nodes[0], nodes[0], weights, DIRECTED, &selection));
+  CPPUNIT_ASSERT(selection.getNodeValue(nodes[0]));
+}
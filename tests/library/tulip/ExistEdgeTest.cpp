@@ -19,6 +19,7 @@
 
 #include <string>
 #include <iostream>
+#include <tulip/GraphStorage.h>
 
 #include "ExistEdgeTest.h"
 
@@ -58,3 +59,123 @@ void ExistEdgeTest::testExistEdge() {
   CPPUNIT_ASSERT(graph->existEdge(n2, n1, false).isValid() == false);
   CPPUNIT_ASSERT(graph->existEdge(n1, n2, false).isValid() == false);
 }
+
+void ExistEdgeTest::testExistEdgeOnHub() {
+  // the edges of the nodes whose degree is greater than
+  // GraphStorage::EDGES_INDEX_MIN_DEGREE are indexed
+  const unsigned int NB_LEAVES = 600;
+  node hub = graph->addNode();
+  vector<node> leaves;
+  graph->addNodes(NB_LEAVES, leaves);
+  vector<edge> hubEdges;
+
+  for (unsigned int i = 0; i < NB_LEAVES; ++i) {
+    node leaf = leaves[i];
+    hubEdges.push_back(i % 2 ? graph->addEdge(leaf, hub) : graph->addEdge(hub, leaf));
+  }
+
+  // the index is built with a first search
+  for (unsigned int i = 0; i < NB_LEAVES; ++i) {
+    node leaf = leaves[i];
+    node src = i % 2 ? leaf : hub;
+    node tgt = i % 2 ? hub : leaf;
+    CPPUNIT_ASSERT_EQUAL(hubEdges[i], graph->existEdge(src, tgt));
+    CPPUNIT_ASSERT(!graph->existEdge(tgt, src).isValid());
+    CPPUNIT_ASSERT_EQUAL(hubEdges[i], graph->existEdge(tgt, src, false));
+  }
+
+  CPPUNIT_ASSERT(!graph->existEdge(hub, n0, false).isValid());
+
+  // the index is updated when edges are added
+  edge loop = graph->addEdge(hub, hub);
+  edge e = graph->addEdge(hub, leaves[0]);
+  CPPUNIT_ASSERT_EQUAL(loop, graph->existEdge(hub, hub));
+  CPPUNIT_ASSERT_EQUAL(size_t(1), graph->getEdges(hub, hub).size());
+  vector<edge> edges = graph->getEdges(hub, leaves[0]);
+  CPPUNIT_ASSERT_EQUAL(size_t(2), edges.size());
+  CPPUNIT_ASSERT_EQUAL(hubEdges[0], edges[0]);
+  CPPUNIT_ASSERT_EQUAL(e, edges[1]);
+  CPPUNIT_ASSERT_EQUAL(hubEdges[0], graph->existEdge(leaves[0], hub, false));
+
+  // or deleted
+  graph->delEdge(hubEdges[0]);
+  CPPUNIT_ASSERT_EQUAL(e, graph->existEdge(hub, leaves[0]));
+  graph->delEdge(loop);
+  CPPUNIT_ASSERT(!graph->existEdge(hub, hub).isValid());
+  graph->delNode(leaves[2]);
+  CPPUNIT_ASSERT(!graph->existEdge(hub, leaves[2]).isValid());
+
+  // when their ends change
+  graph->reverse(hubEdges[4]);
+  CPPUNIT_ASSERT(!graph->existEdge(hub, leaves[4]).isValid());
+  CPPUNIT_ASSERT_EQUAL(hubEdges[4], graph->existEdge(leaves[4], hub));
+  graph->setEnds(hubEdges[6], n1, hub);
+  CPPUNIT_ASSERT(!graph->existEdge(hub, leaves[6], false).isValid());
+  CPPUNIT_ASSERT_EQUAL(hubEdges[6], graph->existEdge(n1, hub));
+
+  // the edges of a subgraph are found in the index of the root graph
+  Graph *sg = graph->addSubGraph();
+  sg->addNode(hub);
+
+  for (unsigned int i = 8; i < NB_LEAVES; i += 2) {
+    sg->addNode(leaves[i]);
+    sg->addEdge(hubEdges[i]);
+  }
+
+  sg->addNode(leaves[1]);
+  CPPUNIT_ASSERT_EQUAL(hubEdges[8], sg->existEdge(hub, leaves[8]));
+  CPPUNIT_ASSERT(!sg->existEdge(leaves[1], hub).isValid());
+
+  // the batched version gives the same results
+  vector<pair<node, node>> ends;
+
+  for (unsigned int i = 0; i < NB_LEAVES; ++i) {
+    ends.push_back(make_pair(hub, leaves[i]));
+    ends.push_back(make_pair(leaves[i], hub));
+  }
+
+  for (bool directed : {true, false}) {
+    edges = graph->existEdges(ends, directed);
+    CPPUNIT_ASSERT_EQUAL(ends.size(), edges.size());
+
+    for (unsigned int i = 0; i < ends.size(); ++i)
+      CPPUNIT_ASSERT_EQUAL(graph->existEdge(ends[i].first, ends[i].second, directed), edges[i]);
+
+    edges = sg->existEdges(ends, directed);
+
+    for (unsigned int i = 0; i < ends.size(); ++i)
+      CPPUNIT_ASSERT_EQUAL(sg->existEdge(ends[i].first, ends[i].second, directed), edges[i]);
+  }
+}
+
+void ExistEdgeTest::testMultiEdgesOrder() {
+  node a = graph->addNode();
+  node b = graph->addNode();
+  edge ab1 = graph->addEdge(a, b);
+  edge ba = graph->addEdge(b, a);
+  edge ab2 = graph->addEdge(a, b);
+  // the adjacency orders differ from the ids order
+  graph->setEdgeOrder(a, {ab2, ba, ab1});
+  graph->setEdgeOrder(b, {ba, ab2, ab1});
+  vector<edge> abEdges = {ab1, ab2};
+  vector<edge> allEdges = {ab1, ba, ab2};
+
+  // the edges are found by scanning an adjacency (low degrees),
+  // then in the indexes of the ends (high degrees)
+  for (unsigned int i = 0; i < 2; ++i) {
+    CPPUNIT_ASSERT(graph->getEdges(a, b) == abEdges);
+    CPPUNIT_ASSERT(graph->getEdges(a, b, false) == allEdges);
+    CPPUNIT_ASSERT(graph->getEdges(b, a, false) == allEdges);
+    CPPUNIT_ASSERT_EQUAL(ab1, graph->existEdge(a, b));
+    CPPUNIT_ASSERT_EQUAL(ba, graph->existEdge(b, a));
+    CPPUNIT_ASSERT_EQUAL(ab1, graph->existEdge(b, a, false));
+
+    vector<node> leaves;
+    graph->addNodes(GraphStorage::EDGES_INDEX_MIN_DEGREE, leaves);
+
+    for (auto leaf : leaves) {
+      graph->addEdge(a, leaf);
+      graph->addEdge(leaf, b);
+    }
+  }
+}
@@ -27,12 +27,16 @@
 class ExistEdgeTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ExistEdgeTest);
   CPPUNIT_TEST(testExistEdge);
+  CPPUNIT_TEST(testExistEdgeOnHub);
+  CPPUNIT_TEST(testMultiEdgesOrder);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void setUp() override;
   void tearDown() override;
   void testExistEdge();
+  void testExistEdgeOnHub();
+  void testMultiEdgesOrder();
 
 private:
   tlp::Graph *graph;
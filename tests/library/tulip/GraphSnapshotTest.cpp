@@ -0,0 +1,156 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include "GraphSnapshotTest.h"
+
+#include <tulip/BooleanProperty.h>
+#include <tulip/DoubleProperty.h>
+#include <tulip/GraphSnapshot.h>
+
+using namespace std;
+using namespace tlp;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(GraphSnapshotTest);
+
+void GraphSnapshotTest::setUp() {
+  graph = tlp::newGraph();
+  vector<node> nodes;
+  graph->addNodes(100, nodes);
+
+  for (unsigned int i = 0; i < 100; ++i) {
+    graph->addEdge(nodes[i], nodes[(i + 1) % 100]);
+    graph->addEdge(nodes[i], nodes[(i * 7) % 100]);
+  }
+
+  // a loop
+  graph->addEdge(nodes[5], nodes[5]);
+}
+
+void GraphSnapshotTest::tearDown() {
+  delete graph;
+}
+
+void GraphSnapshotTest::checkSnapshot(Graph *g) {
+  shared_ptr<const GraphSnapshot> snapshot = GraphSnapshot::get(g);
+  const VectorGraph &vGraph = snapshot->getVectorGraph();
+  CPPUNIT_ASSERT_EQUAL(g, const_cast<Graph *>(snapshot->getGraph()));
+  CPPUNIT_ASSERT_EQUAL(g->numberOfNodes(), vGraph.numberOfNodes());
+  CPPUNIT_ASSERT_EQUAL(g->numberOfEdges(), vGraph.numberOfEdges());
+
+  for (unsigned int i = 0; i < g->numberOfNodes(); ++i) {
+    node n = g->nodes()[i];
+    CPPUNIT_ASSERT_EQUAL(n, snapshot->getGraphNode(node(i)));
+    CPPUNIT_ASSERT_EQUAL(node(i), snapshot->getNode(n));
+    CPPUNIT_ASSERT_EQUAL(g->deg(n), vGraph.deg(node(i)));
+    CPPUNIT_ASSERT_EQUAL(g->outdeg(n), vGraph.outdeg(node(i)));
+  }
+
+  for (unsigned int i = 0; i < g->numberOfEdges(); ++i) {
+    edge e = g->edges()[i];
+    CPPUNIT_ASSERT_EQUAL(e, snapshot->getGraphEdge(edge(i)));
+    CPPUNIT_ASSERT_EQUAL(edge(i), snapshot->getEdge(e));
+    CPPUNIT_ASSERT_EQUAL(g->source(e), snapshot->getGraphNode(vGraph.source(edge(i))));
+    CPPUNIT_ASSERT_EQUAL(g->target(e), snapshot->getGraphNode(vGraph.target(edge(i))));
+  }
+}
+
+void GraphSnapshotTest::testTopology() {
+  checkSnapshot(graph);
+
+  // a subgraph
+  BooleanProperty selection(graph);
+
+  for (auto n : graph->nodes())
+    selection.setNodeValue(n, n.id % 3 != 0);
+
+  for (auto e : graph->edges())
+    selection.setEdgeValue(e, selection.getNodeValue(graph->source(e)) &&
+                                  selection.getNodeValue(graph->target(e)));
+
+  checkSnapshot(graph->addSubGraph(&selection));
+}
+
+void GraphSnapshotTest::testInvalidation() {
+  shared_ptr<const GraphSnapshot> snapshot = GraphSnapshot::get(graph);
+  unsigned int nbBuilds = GraphSnapshot::getNumberOfBuilds();
+
+  // unchanged topology
+  graph->getProperty<DoubleProperty>("viewMetric")->setAllNodeValue(1);
+  CPPUNIT_ASSERT(snapshot == GraphSnapshot::get(graph));
+  CPPUNIT_ASSERT_EQUAL(nbBuilds, GraphSnapshot::getNumberOfBuilds());
+
+  graph->addEdge(graph->nodes()[3], graph->nodes()[50]);
+  checkSnapshot(graph);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 1, GraphSnapshot::getNumberOfBuilds());
+
+  graph->reverse(graph->edges()[10]);
+  checkSnapshot(graph);
+  graph->setEnds(graph->edges()[20], graph->nodes()[1], graph->nodes()[2]);
+  checkSnapshot(graph);
+  graph->delNode(graph->nodes()[7]);
+  checkSnapshot(graph);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 4, GraphSnapshot::getNumberOfBuilds());
+
+  // the listeners are notified even while the observers are held
+  Observable::holdObservers();
+  graph->addNode();
+  checkSnapshot(graph);
+  Observable::unholdObservers();
+  checkSnapshot(graph);
+
+  GraphSnapshot::invalidate(graph);
+  nbBuilds = GraphSnapshot::getNumberOfBuilds();
+  checkSnapshot(graph);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 1, GraphSnapshot::getNumberOfBuilds());
+
+  // the change of the order of the elements is not notified
+  // but changes the topology version of the graph
+  vector<node> nodes(graph->nodes());
+  graph->delNode(nodes[0]);
+  graph->addNode();
+  checkSnapshot(graph);
+  nbBuilds = GraphSnapshot::getNumberOfBuilds();
+  graph->sortElts();
+  checkSnapshot(graph);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 1, GraphSnapshot::getNumberOfBuilds());
+}
+
+void GraphSnapshotTest::testCache() {
+  unsigned int cacheSize = GraphSnapshot::getCacheSize();
+  GraphSnapshot::setCacheSize(2);
+  Graph *sg1 = graph->addCloneSubGraph();
+  Graph *sg2 = graph->addCloneSubGraph();
+  shared_ptr<const GraphSnapshot> snapshot = GraphSnapshot::get(graph);
+  GraphSnapshot::get(sg1);
+  unsigned int nbBuilds = GraphSnapshot::getNumberOfBuilds();
+  CPPUNIT_ASSERT(snapshot == GraphSnapshot::get(graph));
+
+  // the snapshot of sg1 is the least recently used one
+  GraphSnapshot::get(sg2);
+  CPPUNIT_ASSERT(snapshot == GraphSnapshot::get(graph));
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 1, GraphSnapshot::getNumberOfBuilds());
+  GraphSnapshot::get(sg1);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 2, GraphSnapshot::getNumberOfBuilds());
+
+  // a snapshot removed from the cache is kept while it is referenced
+  GraphSnapshot::setCacheSize(0);
+  CPPUNIT_ASSERT_EQUAL(graph->numberOfNodes(), snapshot->getVectorGraph().numberOfNodes());
+  CPPUNIT_ASSERT(snapshot != GraphSnapshot::get(graph));
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 3, GraphSnapshot::getNumberOfBuilds());
+  GraphSnapshot::setCacheSize(cacheSize);
+}
@@ -0,0 +1,48 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef GRAPH_SNAPSHOT_TEST_H
+#define GRAPH_SNAPSHOT_TEST_H
+
+#include <tulip/Graph.h>
+
+#include "CppUnitIncludes.h"
+
+class GraphSnapshotTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(GraphSnapshotTest);
+  CPPUNIT_TEST(testTopology);
+  CPPUNIT_TEST(testInvalidation);
+  CPPUNIT_TEST(testCache);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() override;
+  void tearDown() override;
+  void testTopology();
+  void testInvalidation();
+  void testCache();
+
+private:
+  // check that the snapshot has the topology of g
+  void checkSnapshot(tlp::Graph *g);
+
+  tlp::Graph *graph;
+};
+
+#endif // GRAPH_SNAPSHOT_TEST_H
@@ -0,0 +1,150 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#include <cmath>
+
+#include <tulip/IncrementalLayout.h>
+
+#include "IncrementalLayoutTest.h"
+
+using namespace tlp;
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IncrementalLayoutTest);
+
+const unsigned int GRID_SIZE = 10;
+// the maximum displacement of a node by an update with the default
+// number of iterations (10) and edge length (1): (10 + 9 + ... + 1) / 20
+const float MAX_MOVE = 2.75f + 1e-3f;
+
+void IncrementalLayoutTest::setUp() {
+  graph = newGraph();
+  layout = graph->getProperty<LayoutProperty>("viewLayout");
+  graph->addNodes(GRID_SIZE * GRID_SIZE, nodes);
+
+  // a grid graph with unit length edges
+  for (unsigned int i = 0; i < GRID_SIZE; ++i) {
+    for (unsigned int j = 0; j < GRID_SIZE; ++j) {
+      node n = nodes[i * GRID_SIZE + j];
+      layout->setNodeValue(n, Coord(i, j, 0));
+
+      if (i + 1 < GRID_SIZE)
+        graph->addEdge(n, nodes[(i + 1) * GRID_SIZE + j]);
+
+      if (j + 1 < GRID_SIZE)
+        graph->addEdge(n, nodes[i * GRID_SIZE + j + 1]);
+    }
+  }
+}
+
+void IncrementalLayoutTest::tearDown() {
+  delete graph;
+}
+
+void IncrementalLayoutTest::testPlaceAddedNodes() {
+  IncrementalLayout incLayout(graph, layout);
+  CPPUNIT_ASSERT(!incLayout.hasPendingUpdates());
+
+  node n1 = graph->addNode();
+  node n2 = graph->addNode();
+  graph->addEdge(nodes[0], n1);
+  graph->addEdge(n1, n2);
+  CPPUNIT_ASSERT(incLayout.hasPendingUpdates());
+
+  incLayout.update();
+  CPPUNIT_ASSERT(!incLayout.hasPendingUpdates());
+
+  // the added nodes are placed near the corner of the grid
+  CPPUNIT_ASSERT(layout->getNodeValue(n1).dist(layout->getNodeValue(nodes[0])) < 2);
+  CPPUNIT_ASSERT(layout->getNodeValue(n2).dist(layout->getNodeValue(n1)) < 2);
+  CPPUNIT_ASSERT(layout->getNodeValue(n1) != layout->getNodeValue(n2));
+}
+
+void IncrementalLayoutTest::testPlaceAddedComponent() {
+  IncrementalLayout incLayout(graph, layout);
+
+  node n1 = graph->addNode();
+  node n2 = graph->addNode();
+  graph->addEdge(n1, n2);
+  incLayout.update();
+
+  // the first node of the component is randomly placed in a square, centered on the origin,
+  // whose area is proportional to the number of placed nodes; then the relaxation moves
+  // the nodes by less than MAX_MOVE
+  float bound = sqrt(float(GRID_SIZE * GRID_SIZE + 1)) + 1 + MAX_MOVE;
+  const Coord &c1 = layout->getNodeValue(n1);
+  const Coord &c2 = layout->getNodeValue(n2);
+
+  for (const Coord &c : {c1, c2}) {
+    CPPUNIT_ASSERT(fabs(c[0]) <= bound && fabs(c[1]) <= bound);
+    CPPUNIT_ASSERT_EQUAL(0.f, c[2]);
+  }
+
+  CPPUNIT_ASSERT(c1 != c2);
+  CPPUNIT_ASSERT(c1.dist(c2) < 2);
+}
+
+void IncrementalLayoutTest::testLocalRelaxation() {
+  IncrementalLayout incLayout(graph, layout);
+  incLayout.setNeighborhoodDepth(2);
+
+  node n = graph->addNode();
+  graph->addEdge(nodes[0], n);
+  incLayout.update();
+
+  // the nodes far from the added one do not move
+  for (unsigned int i = 3; i < GRID_SIZE; ++i) {
+    for (unsigned int j = 3; j < GRID_SIZE; ++j)
+      CPPUNIT_ASSERT_EQUAL(Coord(i, j, 0), layout->getNodeValue(nodes[i * GRID_SIZE + j]));
+  }
+
+  // a node moved from outside is taken into account by the next update
+  node corner = nodes[GRID_SIZE * GRID_SIZE - 1];
+  Coord cornerPos(-100, -100, 0);
+  layout->setNodeValue(corner, cornerPos);
+  node n2 = graph->addNode();
+  graph->addEdge(corner, n2);
+  incLayout.update();
+  CPPUNIT_ASSERT(layout->getNodeValue(n2).dist(cornerPos) < 2);
+  CPPUNIT_ASSERT(layout->getNodeValue(corner).dist(cornerPos) <= MAX_MOVE);
+
+  // the ends of the added edge and the nodes at distance at most 2 from them
+  // are relaxed: the neighbors of the corner are attracted by it
+  for (unsigned int i : {GRID_SIZE - 2, GRID_SIZE - 1}) {
+    unsigned int j = 2 * GRID_SIZE - 3 - i;
+    float dist = layout->getNodeValue(nodes[i * GRID_SIZE + j]).dist(Coord(i, j, 0));
+    CPPUNIT_ASSERT(dist > 0 && dist <= MAX_MOVE);
+  }
+
+  // the nodes at distance 3 from the corner are not
+  for (unsigned int i = GRID_SIZE - 4; i < GRID_SIZE; ++i) {
+    unsigned int j = 2 * GRID_SIZE - 5 - i;
+    CPPUNIT_ASSERT_EQUAL(Coord(i, j, 0), layout->getNodeValue(nodes[i * GRID_SIZE + j]));
+  }
+}
+
+void IncrementalLayoutTest::testGraphDeletion() {
+  IncrementalLayout *incLayout = new IncrementalLayout(graph, layout);
+  graph->addNode();
+  delete graph;
+  graph = nullptr;
+  CPPUNIT_ASSERT(!incLayout->hasPendingUpdates());
+  incLayout->update();
+  delete incLayout;
+}
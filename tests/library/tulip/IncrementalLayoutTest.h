@@ -0,0 +1,50 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef INCREMENTALLAYOUTTEST_H_
+#define INCREMENTALLAYOUTTEST_H_
+
+#include <tulip/Graph.h>
+#include <tulip/LayoutProperty.h>
+
+#include "CppUnitIncludes.h"
+
+class IncrementalLayoutTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(IncrementalLayoutTest);
+  CPPUNIT_TEST(testPlaceAddedNodes);
+  CPPUNIT_TEST(testPlaceAddedComponent);
+  CPPUNIT_TEST(testLocalRelaxation);
+  CPPUNIT_TEST(testGraphDeletion);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() override;
+  void tearDown() override;
+  void testPlaceAddedNodes();
+  void testPlaceAddedComponent();
+  void testLocalRelaxation();
+  void testGraphDeletion();
+
+private:
+  tlp::Graph *graph;
+  tlp::LayoutProperty *layout;
+  std::vector<tlp::node> nodes;
+};
+
+#endif /* INCREMENTALLAYOUTTEST_H_ */
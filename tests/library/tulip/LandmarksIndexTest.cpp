@@ -0,0 +1,188 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <cstdlib>
+
+#include "LandmarksIndexTest.h"
+
+#include <tulip/BooleanProperty.h>
+#include <tulip/DoubleProperty.h>
+#include <tulip/Graph.h>
+#include <tulip/GraphTools.h>
+#include <tulip/LandmarksIndex.h>
+#include <tulip/TlpTools.h>
+
+using namespace std;
+using namespace tlp;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LandmarksIndexTest);
+
+void LandmarksIndexTest::setUp() {
+  graph = tlp::newGraph();
+}
+
+void LandmarksIndexTest::tearDown() {
+  delete graph;
+}
+
+// a random graph with positive weights, some nodes being unreachable
+static void buildRandomGraph(Graph *graph, DoubleProperty *weights, unsigned int nbNodes,
+                             unsigned int nbEdges) {
+  graph->addNodes(nbNodes);
+  const vector<node> &nodes = graph->nodes();
+
+  for (unsigned int i = 0; i < nbEdges; ++i) {
+    edge e = graph->addEdge(nodes[rand() % nbNodes], nodes[rand() % nbNodes]);
+    weights->setEdgeValue(e, 0.5 + rand() % 10);
+  }
+}
+
+// the length of the selected path, -1 if it is not a path from src to tgt
+static double pathLength(Graph *graph, BooleanProperty *selection, DoubleProperty *weights,
+                         node src, node tgt, bool directed) {
+  double length = 0;
+  node n = src;
+
+  while (n != tgt) {
+    edge next;
+
+    for (auto e : graph->adjacentEdges(n, directed ? DIRECTED : UNDIRECTED)) {
+      if (selection->getEdgeValue(e)) {
+        next = e;
+        break;
+      }
+    }
+
+    if (!next.isValid())
+      return -1;
+
+    selection->setEdgeValue(next, false);
+    length += weights->getEdgeValue(next);
+    n = graph->opposite(next, n);
+  }
+
+  return length;
+}
+
+// checks that the paths found with the index are shortest paths
+static void checkPaths(Graph *graph, DoubleProperty *weights, bool directed) {
+  const LandmarksIndex &index = LandmarksIndex::get(graph, weights, directed, 4);
+  BooleanProperty selection(graph);
+  const vector<node> &nodes = graph->nodes();
+  EdgeStaticProperty<double> eWeights(graph);
+  eWeights.copyFromProperty(weights);
+
+  for (unsigned int i = 0; i < 20; ++i) {
+    node src = nodes[rand() % nodes.size()];
+    NodeStaticProperty<double> distances(graph);
+    computeDeltaSteppingDistances(graph, src, eWeights, distances,
+                                  directed ? DIRECTED : UNDIRECTED);
+
+    for (unsigned int j = 0; j < 20; ++j) {
+      node tgt = nodes[rand() % nodes.size()];
+      selection.setAllNodeValue(false);
+      selection.setAllEdgeValue(false);
+      bool found = index.searchPath(src, tgt, &selection);
+      double distance = distances.getNodeValue(tgt);
+      CPPUNIT_ASSERT_EQUAL(distance < DBL_MAX / 4, found);
+
+      if (found)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(
+            distance, pathLength(graph, &selection, weights, src, tgt, directed), 1e-9);
+    }
+  }
+}
+
+void LandmarksIndexTest::testSearchPath() {
+  DoubleProperty *weights = graph->getProperty<DoubleProperty>("weights");
+  buildRandomGraph(graph, weights, 1000, 1500);
+
+  checkPaths(graph, weights, false);
+  checkPaths(graph, weights, true);
+  CPPUNIT_ASSERT_EQUAL(size_t(4), LandmarksIndex::get(graph, weights, true).getLandmarks().size());
+
+  // the index of a graph without nodes
+  Graph *empty = tlp::newGraph();
+  CPPUNIT_ASSERT(LandmarksIndex::get(empty, nullptr, false).getLandmarks().empty());
+  delete empty;
+}
+
+void LandmarksIndexTest::testInvalidation() {
+  DoubleProperty *weights = graph->getProperty<DoubleProperty>("weights");
+  buildRandomGraph(graph, weights, 100, 300);
+
+  LandmarksIndex::get(graph, weights, false);
+  unsigned int nbBuilds = LandmarksIndex::getNumberOfBuilds();
+  LandmarksIndex::get(graph, weights, false);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds, LandmarksIndex::getNumberOfBuilds());
+
+  // another direction or other weights need another index
+  LandmarksIndex::get(graph, weights, true);
+  LandmarksIndex::get(graph, nullptr, false);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 2, LandmarksIndex::getNumberOfBuilds());
+
+  // the change of a weight invalidates the indices using the weights
+  weights->setEdgeValue(graph->edges()[0], 100);
+  LandmarksIndex::get(graph, nullptr, false);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 2, LandmarksIndex::getNumberOfBuilds());
+  checkPaths(graph, weights, false);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 3, LandmarksIndex::getNumberOfBuilds());
+
+  // the change of the topology invalidates all the indices of the graph
+  graph->addEdge(graph->nodes()[0], graph->nodes()[1]);
+  LandmarksIndex::get(graph, nullptr, false);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 4, LandmarksIndex::getNumberOfBuilds());
+  checkPaths(graph, weights, true);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds + 5, LandmarksIndex::getNumberOfBuilds());
+}
+
+void LandmarksIndexTest::testPersistence() {
+  DoubleProperty *weights = graph->getProperty<DoubleProperty>("weights");
+  buildRandomGraph(graph, weights, 500, 1000);
+  // weights which cannot be saved exactly in a tlp file
+  for (auto e : graph->edges())
+    weights->setEdgeValue(e, weights->getEdgeValue(e) / 3);
+
+  const LandmarksIndex &index = LandmarksIndex::get(graph, weights, true);
+  vector<node> landmarks = index.getLandmarks();
+  index.store();
+
+  for (const string &fileName : {"landmarks_index.tlp", "landmarks_index.tlpb"}) {
+    CPPUNIT_ASSERT(tlp::saveGraph(graph, fileName));
+    Graph *loaded = tlp::loadGraph(fileName);
+    CPPUNIT_ASSERT(loaded != nullptr);
+    DoubleProperty *loadedWeights = loaded->getProperty<DoubleProperty>("weights");
+
+    // the index is restored, not built
+    unsigned int nbBuilds = LandmarksIndex::getNumberOfBuilds();
+    CPPUNIT_ASSERT(LandmarksIndex::get(loaded, loadedWeights, true).getLandmarks() == landmarks);
+    CPPUNIT_ASSERT_EQUAL(nbBuilds, LandmarksIndex::getNumberOfBuilds());
+    checkPaths(loaded, loadedWeights, true);
+
+    // the stored index cannot be used for other weights
+    LandmarksIndex::get(loaded, nullptr, true);
+    CPPUNIT_ASSERT_EQUAL(nbBuilds + 1, LandmarksIndex::getNumberOfBuilds());
+
+    // nor once the weights have changed
+    LandmarksIndex::invalidate(loaded);
+    loadedWeights->setEdgeValue(loaded->edges()[0], 1000);
+    LandmarksIndex::get(loaded, loadedWeights, true);
+    CPPUNIT_ASSERT_EQUAL(nbBuilds + 2, LandmarksIndex::getNumberOfBuilds());
+    delete loaded;
+  }
+}
@@ -0,0 +1,46 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#ifndef LANDMARKS_INDEX_TEST_H
+#define LANDMARKS_INDEX_TEST_H
+
+#include "CppUnitIncludes.h"
+
+namespace tlp {
+class Graph;
+}
+
+class LandmarksIndexTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(LandmarksIndexTest);
+  CPPUNIT_TEST(testSearchPath);
+  CPPUNIT_TEST(testInvalidation);
+  CPPUNIT_TEST(testPersistence);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  tlp::Graph *graph;
+
+public:
+  void setUp() override;
+  void tearDown() override;
+  void testSearchPath();
+  void testInvalidation();
+  void testPersistence();
+};
+
+#endif // LANDMARKS_INDEX_TEST_H
@@ -0,0 +1,172 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <thread>
+
+#include "MemoryPoolTest.h"
+
+#include <tulip/memorypool.h>
+
+using namespace std;
+using namespace tlp;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MemoryPoolTest);
+
+namespace {
+struct PooledObject : public MemoryPool<PooledObject> {
+  unsigned int data[8];
+};
+
+// each test uses its own type to get its own pool
+struct ReuseObject : public MemoryPool<ReuseObject> {
+  unsigned int data[4];
+};
+
+struct TrimObject : public MemoryPool<TrimObject> {
+  unsigned int data[4];
+};
+
+struct StatObject : public MemoryPool<StatObject> {
+  unsigned int data[4];
+};
+
+// in each round, each thread allocates objects
+// which are then deleted by the next one
+template <typename T>
+void crossThreadStress(unsigned int nbThreads, unsigned int nbRounds, unsigned int nbObjects) {
+  vector<vector<T *>> objects(nbThreads, vector<T *>(nbObjects));
+
+  for (unsigned int round = 0; round < nbRounds; ++round) {
+    vector<thread> threads;
+
+    for (unsigned int i = 0; i < nbThreads; ++i)
+      threads.emplace_back([&, i]() {
+        for (unsigned int j = 0; j < nbObjects; ++j) {
+          objects[i][j] = new T();
+          objects[i][j]->data[0] = j;
+        }
+      });
+
+    for (thread &t : threads)
+      t.join();
+
+    threads.clear();
+
+    for (unsigned int i = 0; i < nbThreads; ++i)
+      threads.emplace_back([&, i]() {
+        for (T *object : objects[(i + 1) % nbThreads])
+          delete object;
+      });
+
+    for (thread &t : threads)
+      t.join();
+  }
+}
+} // namespace
+
+void MemoryPoolTest::testReuse() {
+  ReuseObject *object = new ReuseObject();
+  delete object;
+  // the last freed object is the first reused
+  ReuseObject *object2 = new ReuseObject();
+  CPPUNIT_ASSERT_EQUAL(object, object2);
+
+  vector<ReuseObject *> objects;
+
+  for (unsigned int i = 0; i < 10 * BUFFOBJ; ++i) {
+    objects.push_back(new ReuseObject());
+    objects.back()->data[0] = i;
+  }
+
+  for (unsigned int i = 0; i < objects.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(i, objects[i]->data[0]);
+    delete objects[i];
+  }
+
+  delete object2;
+  MemoryPoolStatistics stats = MemoryPool<ReuseObject>::getStatistics();
+  CPPUNIT_ASSERT_EQUAL(size_t(0), stats.nbObjectsInUse);
+  // the surplus of the thread cache has been moved to the depot
+  CPPUNIT_ASSERT(stats.nbObjectsHeld <= MemoryPool<ReuseObject>::getMaxDepotSize() + 2 * BUFFOBJ);
+}
+
+void MemoryPoolTest::testTrim() {
+  vector<TrimObject *> objects;
+
+  for (unsigned int i = 0; i < 100 * BUFFOBJ; ++i)
+    objects.push_back(new TrimObject());
+
+  for (TrimObject *object : objects)
+    delete object;
+
+  CPPUNIT_ASSERT(MemoryPool<TrimObject>::getStatistics().nbObjectsHeld > 0);
+  CPPUNIT_ASSERT(MemoryPool<TrimObject>::trim() > 0);
+  MemoryPoolStatistics stats = MemoryPool<TrimObject>::getStatistics();
+  CPPUNIT_ASSERT_EQUAL(size_t(0), stats.nbObjectsHeld);
+  CPPUNIT_ASSERT_EQUAL(size_t(0), stats.nbObjectsInUse);
+
+  // a smaller depot
+  MemoryPool<TrimObject>::setMaxDepotSize(2 * BUFFOBJ);
+  objects.clear();
+
+  for (unsigned int i = 0; i < 100 * BUFFOBJ; ++i)
+    objects.push_back(new TrimObject());
+
+  for (TrimObject *object : objects)
+    delete object;
+
+  CPPUNIT_ASSERT(MemoryPool<TrimObject>::getStatistics().nbObjectsHeld <= 4 * BUFFOBJ);
+  MemoryPool<TrimObject>::releaseThreadCache();
+  CPPUNIT_ASSERT(MemoryPool<TrimObject>::getStatistics().nbObjectsHeld <= 2 * BUFFOBJ);
+  MemoryPools::trim();
+  CPPUNIT_ASSERT_EQUAL(size_t(0), MemoryPool<TrimObject>::getStatistics().nbObjectsHeld);
+}
+
+void MemoryPoolTest::testCrossThreadFrees() {
+  unsigned int nbThreads = max(2u, min(8u, thread::hardware_concurrency()));
+  const unsigned int nbRounds = 20;
+  const unsigned int nbObjects = 10000;
+
+  crossThreadStress<PooledObject>(nbThreads, nbRounds, nbObjects);
+
+  // all the objects have been deleted, and the memory held is bounded
+  // by the depot and the caches of the ended threads
+  MemoryPoolStatistics stats = MemoryPool<PooledObject>::getStatistics();
+  CPPUNIT_ASSERT_EQUAL(size_t(0), stats.nbObjectsInUse);
+  CPPUNIT_ASSERT(stats.nbObjectsHeld <= MemoryPool<PooledObject>::getMaxDepotSize());
+
+  MemoryPool<PooledObject>::trim();
+  CPPUNIT_ASSERT_EQUAL(size_t(0), MemoryPool<PooledObject>::getStatistics().nbObjectsHeld);
+}
+
+void MemoryPoolTest::testStatistics() {
+  StatObject *object = new StatObject();
+  bool found = false;
+
+  for (const MemoryPoolStatistics &stats : MemoryPools::getStatistics()) {
+    if (stats.typeName.find("StatObject") != string::npos) {
+      found = true;
+      CPPUNIT_ASSERT_EQUAL(sizeof(StatObject), stats.objectSize);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), stats.nbObjectsInUse);
+      CPPUNIT_ASSERT_EQUAL(size_t(BUFFOBJ - 1), stats.nbObjectsHeld);
+    }
+  }
+
+  CPPUNIT_ASSERT(found);
+  delete object;
+}
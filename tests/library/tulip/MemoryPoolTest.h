@@ -0,0 +1,40 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef MEMORY_POOL_TEST_H
+#define MEMORY_POOL_TEST_H
+
+#include "CppUnitIncludes.h"
+
+class MemoryPoolTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MemoryPoolTest);
+  CPPUNIT_TEST(testReuse);
+  CPPUNIT_TEST(testTrim);
+  CPPUNIT_TEST(testCrossThreadFrees);
+  CPPUNIT_TEST(testStatistics);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testReuse();
+  void testTrim();
+  void testCrossThreadFrees();
+  void testStatistics();
+};
+
+#endif // MEMORY_POOL_TEST_H
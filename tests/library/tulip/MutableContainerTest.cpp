@@ -256,3 +256,106 @@ void MutableContainerTest::testSetGet() {
     CPPUNIT_ASSERT(!isNotDefault);
   }
 }
+//==========================================================
+void MutableContainerTest::testInterning() {
+  // only the strings can be interned
+  mutDouble->setInterningMode(ALWAYS_INTERNED);
+  CPPUNIT_ASSERT(!mutDouble->isInterned());
+
+  mutString->setAll("David");
+  mutString->set(10, "Sophie");
+  mutString->set(20, "Sophie");
+  mutString->set(1000000, "Sophie");
+  mutString->set(30, "Patrick");
+  CPPUNIT_ASSERT_EQUAL(MutableContainer<string>::HASH, mutString->state);
+
+  mutString->setInterningMode(ALWAYS_INTERNED);
+  CPPUNIT_ASSERT(mutString->isInterned());
+  CPPUNIT_ASSERT_EQUAL(2u, mutString->pool->size());
+  // the elements having the same value share it
+  CPPUNIT_ASSERT_EQUAL(&mutString->get(10), &mutString->get(1000000));
+  CPPUNIT_ASSERT_EQUAL(string("Patrick"), mutString->get(30));
+  CPPUNIT_ASSERT_EQUAL(string("David"), mutString->get(40));
+
+  // the values no longer used are removed from the pool
+  mutString->set(30, "Sophie");
+  mutString->set(1000000, "David");
+  CPPUNIT_ASSERT_EQUAL(1u, mutString->pool->size());
+  CPPUNIT_ASSERT_EQUAL(string("Sophie"), mutString->get(30));
+  CPPUNIT_ASSERT_EQUAL(string("David"), mutString->get(1000000));
+
+  for (unsigned int i = 0; i < NBTEST; ++i)
+    mutString->set(i, i % 3 ? "Sophie" : "Patrick");
+
+  CPPUNIT_ASSERT_EQUAL(2u, mutString->pool->size());
+
+  unsigned int nb = 0;
+
+  for (unsigned int i : mutString->findAll("Patrick")) {
+    CPPUNIT_ASSERT_EQUAL(0u, i % 3);
+    ++nb;
+  }
+
+  CPPUNIT_ASSERT_EQUAL((NBTEST + 2) / 3, nb);
+  CPPUNIT_ASSERT_EQUAL(0u, iteratorCount(mutString->findAll("Jean")));
+  // the default value is not interned
+  CPPUNIT_ASSERT_EQUAL(NBTEST, iteratorCount(mutString->findAll("David", false)));
+
+  // back to the not interned values
+  mutString->setInterningMode(NEVER_INTERNED);
+  CPPUNIT_ASSERT(!mutString->isInterned());
+  CPPUNIT_ASSERT(&mutString->get(1) != &mutString->get(2));
+
+  for (unsigned int i = 0; i < NBTEST; ++i)
+    CPPUNIT_ASSERT_EQUAL(string(i % 3 ? "Sophie" : "Patrick"), mutString->get(i));
+
+  mutString->setInterningMode(ALWAYS_INTERNED);
+  mutString->setAll("Jean");
+  CPPUNIT_ASSERT(mutString->isInterned());
+  CPPUNIT_ASSERT_EQUAL(0u, mutString->pool->size());
+  CPPUNIT_ASSERT_EQUAL(string("Jean"), mutString->get(1));
+
+  // the values are first interned, setting a value
+  // never changes the way they are stored
+  mutString->setInterningMode(NEVER_INTERNED);
+  mutString->setInterningMode(AUTO_INTERNED);
+  CPPUNIT_ASSERT(mutString->isInterned());
+  mutString->set(0, "0");
+  const string &first = mutString->get(0);
+
+  for (unsigned int i = 1; i < 10 * NBTEST; ++i)
+    mutString->set(i, to_string(i % 10));
+
+  CPPUNIT_ASSERT(mutString->isInterned());
+  CPPUNIT_ASSERT_EQUAL(10u, mutString->pool->size());
+  mutString->setInterningMode(AUTO_INTERNED);
+  CPPUNIT_ASSERT(mutString->isInterned());
+
+  // and are no longer interned when most of them are distinct
+  for (unsigned int i = 0; i < 30 * NBTEST; ++i)
+    mutString->set(10 * NBTEST + i, to_string(i));
+
+  CPPUNIT_ASSERT(mutString->isInterned());
+  CPPUNIT_ASSERT_EQUAL(string("0"), first);
+  mutString->setInterningMode(AUTO_INTERNED);
+  CPPUNIT_ASSERT(!mutString->isInterned());
+
+  for (unsigned int i = 0; i < 10 * NBTEST; ++i)
+    CPPUNIT_ASSERT_EQUAL(to_string(i % 10), mutString->get(i));
+
+  for (unsigned int i = 0; i < 30 * NBTEST; ++i)
+    CPPUNIT_ASSERT_EQUAL(to_string(i), mutString->get(10 * NBTEST + i));
+
+  // the values set after setAll are stored
+  // as the replaced ones should have been
+  mutString->setAll("");
+  CPPUNIT_ASSERT(!mutString->isInterned());
+
+  for (unsigned int i = 0; i < 10 * NBTEST; ++i)
+    mutString->set(i, to_string(i % 10));
+
+  mutString->setAll("");
+  CPPUNIT_ASSERT(mutString->isInterned());
+  mutString->set(1, "1");
+  CPPUNIT_ASSERT_EQUAL(1u, mutString->pool->size());
+}
@@ -33,6 +33,7 @@ class MutableContainerTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testSetGet);
   CPPUNIT_TEST(testFindAll);
   CPPUNIT_TEST(testCompression);
+  CPPUNIT_TEST(testInterning);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -48,6 +49,7 @@ public:
   void testSetGet();
   void testFindAll();
   void testCompression();
+  void testInterning();
 };
 } // namespace tlp
 #endif
@@ -0,0 +1,174 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include <algorithm>
+#include <random>
+
+#include <tulip/PackedRTree.h>
+
+#include "PackedRTreeTest.h"
+
+using namespace std;
+using namespace tlp;
+
+// enough elements to use the parallel sort and queries
+const unsigned int NB_BOXES = 20000;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PackedRTreeTest);
+
+static Rectangle<float> randomBox(mt19937 &gen) {
+  uniform_real_distribution<float> pos(-1000.f, 1000.f), size(0.f, 20.f);
+  float x = pos(gen), y = pos(gen);
+  return Rectangle<float>(x, y, x + size(gen), y + size(gen));
+}
+
+// the elements whose box intersects box, sorted
+static vector<unsigned int> bruteForce(const vector<Rectangle<float>> &boxes,
+                                       const Rectangle<float> &box) {
+  vector<unsigned int> result;
+
+  for (unsigned int i = 0; i < boxes.size(); ++i) {
+    if (boxes[i].intersect(box))
+      result.push_back(i);
+  }
+
+  return result;
+}
+
+void PackedRTreeTest::setUp() {
+  mt19937 gen(12345);
+  boxes.clear();
+  ids.clear();
+
+  for (unsigned int i = 0; i < NB_BOXES; ++i) {
+    boxes.push_back(randomBox(gen));
+    ids.push_back(i);
+  }
+}
+
+void PackedRTreeTest::testEmpty() {
+  PackedRTree<unsigned int> tree;
+  tree.build(vector<Rectangle<float>>(), vector<unsigned int>());
+  CPPUNIT_ASSERT(tree.empty());
+  vector<unsigned int> result;
+  tree.getElements(Rectangle<float>(-1.f, -1.f, 1.f, 1.f), result);
+  tree.getElementsWithRatio(Rectangle<float>(-1.f, -1.f, 1.f, 1.f), result);
+  tree.getElements(result);
+  CPPUNIT_ASSERT(result.empty());
+}
+
+void PackedRTreeTest::testGetElements() {
+  PackedRTree<unsigned int> tree;
+  tree.build(boxes, ids);
+  CPPUNIT_ASSERT_EQUAL(NB_BOXES, tree.size());
+
+  vector<unsigned int> result;
+  tree.getElements(result);
+  sort(result.begin(), result.end());
+  CPPUNIT_ASSERT(result == ids);
+
+  const Rectangle<float> &bb = tree.getBoundingBox();
+  for (const auto &box : boxes)
+    CPPUNIT_ASSERT(bb.isInside(box));
+
+  mt19937 gen(6789);
+  uniform_real_distribution<float> pos(-1100.f, 1100.f), size(0.f, 500.f);
+
+  for (unsigned int i = 0; i < 50; ++i) {
+    float x = pos(gen), y = pos(gen);
+    Rectangle<float> box(x, y, x + size(gen), y + size(gen));
+    result.clear();
+    tree.getElements(box, result);
+    sort(result.begin(), result.end());
+    CPPUNIT_ASSERT(result == bruteForce(boxes, box));
+  }
+}
+
+void PackedRTreeTest::testGetElementsWithRatio() {
+  PackedRTree<unsigned int> tree;
+  tree.build(boxes, ids);
+  Rectangle<float> box(-500.f, -500.f, 500.f, 500.f);
+  vector<unsigned int> all, reduced;
+  tree.getElements(box, all);
+  // with a huge ratio all the elements are big enough
+  tree.getElementsWithRatio(box, reduced, 1e10f);
+  CPPUNIT_ASSERT(reduced == all);
+  // with a small one only a subset of them is returned
+  reduced.clear();
+  tree.getElementsWithRatio(box, reduced, 10.f);
+  CPPUNIT_ASSERT(!reduced.empty());
+  CPPUNIT_ASSERT(reduced.size() < all.size());
+  sort(all.begin(), all.end());
+
+  for (auto id : reduced) {
+    CPPUNIT_ASSERT(boxes[id].intersect(box));
+    CPPUNIT_ASSERT(binary_search(all.begin(), all.end(), id));
+  }
+}
+
+void PackedRTreeTest::testUpdate() {
+  PackedRTree<unsigned int> tree;
+  tree.build(boxes, ids);
+  mt19937 gen(4321);
+
+  // move some elements, some of them far away from the others
+  for (unsigned int i = 0; i < NB_BOXES; i += 97) {
+    boxes[i] = randomBox(gen);
+
+    if (i % 3 == 0)
+      boxes[i].translate(Vec2f(5000.f, -3000.f));
+
+    tree.update(i, boxes[i]);
+  }
+
+  const Rectangle<float> &bb = tree.getBoundingBox();
+  for (const auto &box : boxes)
+    CPPUNIT_ASSERT(bb.isInside(box));
+
+  Rectangle<float> queries[] = {Rectangle<float>(-200.f, -300.f, 100.f, 50.f),
+                                Rectangle<float>(3900.f, -4100.f, 6100.f, -1900.f),
+                                Rectangle<float>(-10000.f, -10000.f, 10000.f, 10000.f)};
+
+  for (const auto &box : queries) {
+    vector<unsigned int> result;
+    tree.getElements(box, result);
+    sort(result.begin(), result.end());
+    CPPUNIT_ASSERT(result == bruteForce(boxes, box));
+  }
+}
+
+void PackedRTreeTest::testThreadsIndependence() {
+  unsigned int nbThreads = ThreadManager::getNumberOfThreads();
+  Rectangle<float> box(-300.f, -600.f, 700.f, 200.f);
+  vector<unsigned int> result1, result2;
+
+  ThreadManager::setNumberOfThreads(1);
+  PackedRTree<unsigned int> tree1;
+  tree1.build(boxes, ids);
+  tree1.getElementsWithRatio(box, result1, 5.f);
+  tree1.getElements(box, result1);
+
+  ThreadManager::setNumberOfThreads(4);
+  PackedRTree<unsigned int> tree2;
+  tree2.build(boxes, ids);
+  tree2.getElementsWithRatio(box, result2, 5.f);
+  tree2.getElements(box, result2);
+
+  ThreadManager::setNumberOfThreads(nbThreads);
+  CPPUNIT_ASSERT(result1 == result2);
+}
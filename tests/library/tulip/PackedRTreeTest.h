@@ -0,0 +1,50 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#ifndef PACKED_RTREE_TEST_H
+#define PACKED_RTREE_TEST_H
+
+#include <vector>
+
+#include <tulip/Rectangle.h>
+
+#include "CppUnitIncludes.h"
+
+class PackedRTreeTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PackedRTreeTest);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testGetElements);
+  CPPUNIT_TEST(testGetElementsWithRatio);
+  CPPUNIT_TEST(testUpdate);
+  CPPUNIT_TEST(testThreadsIndependence);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() override;
+  void testEmpty();
+  void testGetElements();
+  void testGetElementsWithRatio();
+  void testUpdate();
+  void testThreadsIndependence();
+
+private:
+  std::vector<tlp::Rectangle<float>> boxes;
+  std::vector<unsigned int> ids;
+};
+
+#endif // PACKED_RTREE_TEST_H
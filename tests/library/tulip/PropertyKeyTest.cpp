@@ -0,0 +1,134 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+#include "PropertyKeyTest.h"
+
+#include <tulip/DoubleProperty.h>
+#include <tulip/LayoutProperty.h>
+#include <tulip/StringProperty.h>
+
+using namespace std;
+using namespace tlp;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PropertyKeyTest);
+
+void PropertyKeyTest::setUp() {
+  graph = tlp::newGraph();
+}
+
+void PropertyKeyTest::tearDown() {
+  delete graph;
+}
+
+void PropertyKeyTest::testKeys() {
+  PropertyKey key1("propertyKeyTest");
+  PropertyKey key2(string("propertyKey") + "Test");
+  PropertyKey key3("propertyKeyTest2");
+  CPPUNIT_ASSERT(key1 == key2);
+  CPPUNIT_ASSERT_EQUAL(key1.getId(), key2.getId());
+  CPPUNIT_ASSERT(key1 != key3);
+  CPPUNIT_ASSERT_EQUAL(string("propertyKeyTest"), key1.getName());
+  CPPUNIT_ASSERT_EQUAL(string("propertyKeyTest2"), key3.getName());
+  CPPUNIT_ASSERT(key3.getId() < PropertyKey::getNumberOfKeys());
+}
+
+void PropertyKeyTest::testLookup() {
+  PropertyKey metricKey("metric");
+  PropertyKey unknownKey("propertyKeyTestUnknown");
+  CPPUNIT_ASSERT(graph->findProperty(metricKey) == nullptr);
+
+  DoubleProperty *metric = graph->getProperty<DoubleProperty>("metric");
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric),
+                       graph->findProperty(metricKey));
+  CPPUNIT_ASSERT_EQUAL(metric, graph->getProperty<DoubleProperty>(metricKey));
+  CPPUNIT_ASSERT(graph->findProperty(unknownKey) == nullptr);
+
+  // a key registered after the property
+  CPPUNIT_ASSERT(graph->findProperty(PropertyKey("propertyKeyTestNew")) == nullptr);
+  StringProperty *label = graph->getProperty<StringProperty>(PropertyKey("propertyKeyTestNew"));
+  CPPUNIT_ASSERT(graph->existLocalProperty("propertyKeyTestNew"));
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(label),
+                       graph->findProperty(PropertyKey("propertyKeyTestNew")));
+
+  // renaming and deletion
+  metric->rename("renamedMetric");
+  CPPUNIT_ASSERT(graph->findProperty(metricKey) == nullptr);
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric),
+                       graph->findProperty(PropertyKey("renamedMetric")));
+  graph->delLocalProperty("renamedMetric");
+  CPPUNIT_ASSERT(graph->findProperty(PropertyKey("renamedMetric")) == nullptr);
+
+  // the properties are still iterated in the order of their names
+  graph->getProperty<DoubleProperty>("b");
+  graph->getProperty<DoubleProperty>("a");
+  graph->getProperty<DoubleProperty>("c");
+  string previous;
+
+  for (const string &name : graph->getLocalProperties()) {
+    CPPUNIT_ASSERT(previous < name);
+    previous = name;
+  }
+}
+
+void PropertyKeyTest::testInheritance() {
+  PropertyKey metricKey("metric");
+  Graph *sg1 = graph->addSubGraph();
+  Graph *sg2 = sg1->addSubGraph();
+
+  // an inherited property
+  DoubleProperty *metric = graph->getProperty<DoubleProperty>("metric");
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric), sg2->findProperty(metricKey));
+
+  // hidden by a local one
+  DoubleProperty *localMetric = sg1->getLocalProperty<DoubleProperty>("metric");
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric), graph->findProperty(metricKey));
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(localMetric),
+                       sg1->findProperty(metricKey));
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(localMetric),
+                       sg2->findProperty(metricKey));
+
+  // a subgraph added afterwards
+  Graph *sg3 = sg1->addSubGraph();
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(localMetric),
+                       sg3->findProperty(metricKey));
+
+  // visible again when the local one is deleted
+  sg1->delLocalProperty("metric");
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric), sg1->findProperty(metricKey));
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric), sg2->findProperty(metricKey));
+  CPPUNIT_ASSERT_EQUAL(static_cast<PropertyInterface *>(metric), sg3->findProperty(metricKey));
+
+  graph->delLocalProperty("metric");
+  CPPUNIT_ASSERT(sg2->findProperty(metricKey) == nullptr);
+
+  // an inherited view property looked up by name or by key
+  LayoutProperty *viewLayout = sg2->getProperty<LayoutProperty>("viewLayout");
+  CPPUNIT_ASSERT(viewLayout != nullptr);
+  CPPUNIT_ASSERT_EQUAL(viewLayout, sg2->getProperty<LayoutProperty>(PropertyKey("viewLayout")));
+
+  // undo/redo
+  graph->push();
+  graph->delLocalProperty("viewLayout");
+  CPPUNIT_ASSERT(sg2->findProperty(PropertyKey("viewLayout")) == nullptr);
+  graph->pop();
+  PropertyInterface *layout = graph->getProperty("viewLayout");
+  CPPUNIT_ASSERT(layout != nullptr);
+  CPPUNIT_ASSERT_EQUAL(layout, sg2->findProperty(PropertyKey("viewLayout")));
+  graph->unpop();
+  CPPUNIT_ASSERT(sg2->findProperty(PropertyKey("viewLayout")) == nullptr);
+}
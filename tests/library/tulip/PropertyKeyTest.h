@@ -0,0 +1,45 @@
+/**
+ *
+ * This file is part of Tulip (http://tulip.labri.fr)
+ *
+ * Authors: David Auber and the Tulip development Team
+ * from LaBRI, University of Bordeaux
+ *
+ * Tulip is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * Tulip is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ */
+
+#ifndef PROPERTY_KEY_TEST_H
+#define PROPERTY_KEY_TEST_H
+
+#include <tulip/Graph.h>
+
+#include "CppUnitIncludes.h"
+
+class PropertyKeyTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PropertyKeyTest);
+  CPPUNIT_TEST(testKeys);
+  CPPUNIT_TEST(testLookup);
+  CPPUNIT_TEST(testInheritance);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() override;
+  void tearDown() override;
+  void testKeys();
+  void testLookup();
+  void testInheritance();
+
+private:
+  tlp::Graph *graph;
+};
+
+#endif // PROPERTY_KEY_TEST_H
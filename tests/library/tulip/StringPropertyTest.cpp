@@ -78,3 +78,60 @@ void StringPropertyTest::complexVectorTest() {
     CPPUNIT_ASSERT_EQUAL(tmp[i], value[i]);
   }
 }
+
+void StringPropertyTest::internedValuesTest() {
+  StringProperty *type = graph->getProperty<StringProperty>("type");
+  const char *types[] = {"person", "company", "place", "event"};
+  graph->addNodes(10000);
+  // the values are first interned
+  CPPUNIT_ASSERT(type->nodeValuesInterned());
+  CPPUNIT_ASSERT(type->edgeValuesInterned());
+
+  // few distinct values, they stay interned
+  for (auto n : graph->nodes())
+    type->setNodeValue(n, types[n.id % 4]);
+
+  CPPUNIT_ASSERT(type->nodeValuesInterned());
+  type->setInterningMode(AUTO_INTERNED);
+  CPPUNIT_ASSERT(type->nodeValuesInterned());
+
+  for (auto n : graph->nodes())
+    CPPUNIT_ASSERT_EQUAL(string(types[n.id % 4]), type->getNodeValue(n));
+
+  unsigned int nb = 0;
+
+  for (auto n : type->getNodesEqualTo("place")) {
+    CPPUNIT_ASSERT_EQUAL(2u, n.id % 4);
+    ++nb;
+  }
+
+  CPPUNIT_ASSERT_EQUAL(2500u, nb);
+  CPPUNIT_ASSERT_EQUAL(0u, iteratorCount(type->getNodesEqualTo("vehicle")));
+
+  // a copy is not affected by the changes of the original values
+  StringProperty copy(graph);
+  copy = *type;
+  type->setNodeValue(node(2), "vehicle");
+  CPPUNIT_ASSERT_EQUAL(string("place"), copy.getNodeValue(node(2)));
+  CPPUNIT_ASSERT_EQUAL(2499u, iteratorCount(type->getNodesEqualTo("place")));
+  CPPUNIT_ASSERT_EQUAL(2500u, iteratorCount(copy.getNodesEqualTo("place")));
+
+  // the labels are mostly distinct, they are no longer interned when checked
+  StringProperty *label = graph->getProperty<StringProperty>("label");
+
+  for (auto n : graph->nodes())
+    label->setNodeValue(n, to_string(n.id));
+
+  CPPUNIT_ASSERT(label->nodeValuesInterned());
+  label->setInterningMode(AUTO_INTERNED);
+  CPPUNIT_ASSERT(!label->nodeValuesInterned());
+  CPPUNIT_ASSERT(label->edgeValuesInterned());
+
+  for (auto n : graph->nodes())
+    CPPUNIT_ASSERT_EQUAL(to_string(n.id), label->getNodeValue(n));
+
+  type->setInterningMode(NEVER_INTERNED);
+  CPPUNIT_ASSERT(!type->nodeValuesInterned());
+  CPPUNIT_ASSERT_EQUAL(string("vehicle"), type->getNodeValue(node(2)));
+  CPPUNIT_ASSERT_EQUAL(string("event"), type->getNodeValue(node(3)));
+}
@@ -30,6 +30,7 @@ class StringPropertyTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(StringPropertyTest);
   CPPUNIT_TEST(simpleVectorTest);
   CPPUNIT_TEST(complexVectorTest);
+  CPPUNIT_TEST(internedValuesTest);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -41,6 +42,7 @@ public:
 
   void simpleVectorTest();
   void complexVectorTest();
+  void internedValuesTest();
 };
 
 #endif // STRINGPROPERTYTEST_H
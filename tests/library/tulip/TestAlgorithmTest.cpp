@@ -258,6 +258,42 @@ void TestAlgorithmTest::testConnected() {
   CPPUNIT_ASSERT_EQUAL(2u, ConnectedTest::numberOfConnectedComponents(graph));
 }
 //==========================================================
+void TestAlgorithmTest::testConnectedComponents() {
+  node n[7];
+
+  for (int i = 0; i < 7; ++i)
+    n[i] = graph->addNode();
+
+  graph->addEdge(n[5], n[0]);
+  graph->addEdge(n[0], n[3]);
+  graph->addEdge(n[3], n[6]);
+  graph->addEdge(n[4], n[2]);
+  graph->addEdge(n[4], n[4]);
+
+  vector<vector<node>> components;
+  ConnectedTest::computeConnectedComponents(graph, components);
+  // the components are ordered as their first node,
+  // and their nodes as in a bfs traversal from it
+  CPPUNIT_ASSERT_EQUAL(size_t(3), components.size());
+  CPPUNIT_ASSERT(components[0] == vector<node>({n[0], n[5], n[3], n[6]}));
+  CPPUNIT_ASSERT(components[1] == vector<node>({n[1]}));
+  CPPUNIT_ASSERT(components[2] == vector<node>({n[2], n[4]}));
+  CPPUNIT_ASSERT_EQUAL(3u, ConnectedTest::numberOfConnectedComponents(graph));
+
+  // no stack overflow on a long path
+  graph->clear();
+  graph->addNodes(1000000);
+  const vector<node> &nodes = graph->nodes();
+
+  for (unsigned int i = 1; i < nodes.size(); ++i)
+    graph->addEdge(nodes[i - 1], nodes[i]);
+
+  CPPUNIT_ASSERT(ConnectedTest::isConnected(graph));
+  CPPUNIT_ASSERT(!BiconnectedTest::isBiconnected(graph));
+  graph->addEdge(nodes.back(), nodes.front());
+  CPPUNIT_ASSERT(BiconnectedTest::isBiconnected(graph));
+}
+//==========================================================
 const std::string GRAPHPATH = "./DATA/graphs/";
 
 void TestAlgorithmTest::testBiconnected() {
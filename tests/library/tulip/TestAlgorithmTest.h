@@ -32,6 +32,7 @@ class TestAlgorithmTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testTree);
   CPPUNIT_TEST(testAcyclic);
   CPPUNIT_TEST(testConnected);
+  CPPUNIT_TEST(testConnectedComponents);
   CPPUNIT_TEST(testBiconnected);
   CPPUNIT_TEST(testTriconnected);
   CPPUNIT_TEST_SUITE_END();
@@ -47,6 +48,7 @@ public:
   void testTree();
   void testAcyclic();
   void testConnected();
+  void testConnectedComponents();
   void testBiconnected();
   void testTriconnected();
 };
@@ -24,6 +24,11 @@
 #include <tulip/Color.h>
 #include <tulip/Coord.h>
 #include <tulip/Size.h>
+#include <tulip/DoubleProperty.h>
+#include <tulip/ColorProperty.h>
+#include <tulip/LayoutProperty.h>
+#include <tulip/StringProperty.h>
+#include <tulip/SimplePluginProgress.h>
 
 #include <string>
 
@@ -37,6 +42,24 @@ static Graph *tlp_loadGraph(const std::string &filename) {
   return sg;
 }
 
+static Graph *tlp_importData(const std::string &data, std::string &error) {
+  DataSet dataSet;
+  dataSet.set("file::data", data);
+  SimplePluginProgress progress;
+  Graph *graph = tlp::importGraph("TLP Import", dataSet, &progress);
+  error = progress.getError();
+  return graph;
+}
+
+// the size of the blocks read by the TLP parser
+static const size_t BLOCK_SIZE = 1 << 20;
+
+// pads the beginning of data with spaces, so the char at pos ends up
+// at offset chars from the end of the first block
+static std::string tlp_padData(const std::string &data, size_t pos, size_t offset) {
+  return data.substr(0, pos) + std::string(BLOCK_SIZE - offset - pos, ' ') + data.substr(pos);
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION(TlpImportExportTest);
 
 //==========================================================
@@ -253,3 +276,122 @@ void TlpImportExportTest::testExportAttributes() {
 
   delete graph;
 }
+//==========================================================
+void TlpImportExportTest::testImportBlockBoundary() {
+  string error;
+  string data("(tlp \"2.3\"\n(nodes 0..1234)\n"
+              "(property 0 string \"name\"\n(node 0 \"ab\\\"cd\\\\ef\\ngh\")\n))\n");
+  size_t range = data.find("0..1234");
+  size_t str = data.find("\"ab");
+
+  // a token then a string crossing the end of the first block at each of their chars
+  for (size_t offset = 1; offset <= 7; ++offset) {
+    Graph *graph = tlp_importData(tlp_padData(data, range, offset), error);
+    CPPUNIT_ASSERT_MESSAGE(error, graph != nullptr);
+    CPPUNIT_ASSERT_EQUAL(1235u, graph->numberOfNodes());
+    delete graph;
+  }
+
+  for (size_t offset = 1; offset <= 16; ++offset) {
+    Graph *graph = tlp_importData(tlp_padData(data, str, offset), error);
+    CPPUNIT_ASSERT_MESSAGE(error, graph != nullptr);
+    CPPUNIT_ASSERT_EQUAL(string("ab\"cd\\ef\ngh"),
+                         graph->getProperty<StringProperty>("name")->getNodeValue(node(0)));
+    delete graph;
+  }
+
+  // a string longer than a block
+  string longStr(3 * BLOCK_SIZE, 'a');
+  longStr[BLOCK_SIZE] = '\n';
+  data = "(tlp \"2.3\"\n(nodes 0 1)\n(property 0 string \"name\"\n(node 0 \"" + longStr +
+         "\")\n(node 1 \"b\")\n))\n";
+  Graph *graph = tlp_importData(data, error);
+  CPPUNIT_ASSERT_MESSAGE(error, graph != nullptr);
+  StringProperty *name = graph->getProperty<StringProperty>("name");
+  CPPUNIT_ASSERT(name->getNodeValue(node(0)) == longStr);
+  CPPUNIT_ASSERT_EQUAL(string("b"), name->getNodeValue(node(1)));
+  delete graph;
+}
+//==========================================================
+void TlpImportExportTest::testImportNewLines() {
+  string error;
+  // "\r\n" is a new line, a single '\r' is ignored
+  string data("(tlp \"2.3\"\r\n; comment\r\n(nodes 0..\r2)\r\n(edge 0 0 \r1)\r\r\n"
+              "(property 0 string \"name\"\r\n(node 0 \"a\rb\")\r\n(node 1 \"c\r\nd\")\r\n"
+              ")\r\n)\r\n");
+  Graph *graph = tlp_importData(data, error);
+  CPPUNIT_ASSERT_MESSAGE(error, graph != nullptr);
+  CPPUNIT_ASSERT_EQUAL(3u, graph->numberOfNodes());
+  CPPUNIT_ASSERT_EQUAL(1u, graph->numberOfEdges());
+  CPPUNIT_ASSERT_EQUAL(node(1), graph->target(edge(0)));
+  StringProperty *name = graph->getProperty<StringProperty>("name");
+  CPPUNIT_ASSERT_EQUAL(string("ab"), name->getNodeValue(node(0)));
+  // as in the previous versions of the parser, "\r\n" in a string gives '\r'
+  CPPUNIT_ASSERT_EQUAL(string("c\rd"), name->getNodeValue(node(1)));
+  delete graph;
+
+  // the lines are counted once when "\r\n" crosses the end of a block
+  data = "(tlp \"2.3\"\r\n(nodes 0 1)\r\n(property 0 double \"weight\"\r\n"
+         "(node 0 \"1\")\r\n(node 1 \"a\")\r\n)\r\n)\r\n";
+  size_t crlf = data.find("\r\n(node 0");
+
+  for (size_t offset = 1; offset <= 2; ++offset) {
+    graph = tlp_importData(tlp_padData(data, crlf, offset), error);
+    CPPUNIT_ASSERT(graph == nullptr);
+    CPPUNIT_ASSERT_MESSAGE(error, error.find("at line 5") != string::npos);
+  }
+}
+//==========================================================
+void TlpImportExportTest::testImportEscapes() {
+  string error;
+  string data("(tlp \"2.3\"\n(nodes 0 1)\n(property 0 string \"name\"\n"
+              "(node 0 \"a\\nb\\\"c\\\\d\te\")\n(node 1 \"\\\\\")\n))\n");
+  Graph *graph = tlp_importData(data, error);
+  CPPUNIT_ASSERT_MESSAGE(error, graph != nullptr);
+  StringProperty *name = graph->getProperty<StringProperty>("name");
+  // a tab is replaced by 4 spaces
+  CPPUNIT_ASSERT_EQUAL(string("a\nb\"c\\d    e"), name->getNodeValue(node(0)));
+  CPPUNIT_ASSERT_EQUAL(string("\\"), name->getNodeValue(node(1)));
+  delete graph;
+}
+//==========================================================
+void TlpImportExportTest::testImportValuesNotInExportFormat() {
+  string error;
+  // the values converted by batches, mixed with ones needing the string conversion
+  string data("(tlp \"2.3\"\n(nodes 0..2)\n"
+              "(property 0 color \"color\"\n(default \"(0,0,0,255)\" \"(0,0,0,255)\")\n"
+              "(node 0 \"(1,2,3,4)\")\n(node 1 \"( 5, 6, 7, 8 )\")\n(node 2 \"(9,10,11,12)\")\n)\n"
+              "(property 0 layout \"layout\"\n(node 0 \"(1, 2, 3)\")\n(node 1 \"(4,5,6)\")\n)\n"
+              "(property 0 double \"weight\"\n(node 0 \" 1.5\")\n(node 1 \"2.5\")\n))\n");
+  Graph *graph = tlp_importData(data, error);
+  CPPUNIT_ASSERT_MESSAGE(error, graph != nullptr);
+  ColorProperty *color = graph->getProperty<ColorProperty>("color");
+  CPPUNIT_ASSERT_EQUAL(Color(1, 2, 3, 4), color->getNodeValue(node(0)));
+  CPPUNIT_ASSERT_EQUAL(Color(5, 6, 7, 8), color->getNodeValue(node(1)));
+  CPPUNIT_ASSERT_EQUAL(Color(9, 10, 11, 12), color->getNodeValue(node(2)));
+  LayoutProperty *layout = graph->getProperty<LayoutProperty>("layout");
+  CPPUNIT_ASSERT_EQUAL(Coord(1, 2, 3), layout->getNodeValue(node(0)));
+  CPPUNIT_ASSERT_EQUAL(Coord(4, 5, 6), layout->getNodeValue(node(1)));
+  DoubleProperty *weight = graph->getProperty<DoubleProperty>("weight");
+  CPPUNIT_ASSERT_EQUAL(1.5, weight->getNodeValue(node(0)));
+  CPPUNIT_ASSERT_EQUAL(2.5, weight->getNodeValue(node(1)));
+  delete graph;
+}
+//==========================================================
+void TlpImportExportTest::testImportInvalidValue() {
+  string error;
+  // the values are converted at the end of the property,
+  // the error must give the line of the invalid one
+  string data("(tlp \"2.3\"\n(nodes 0..2)\n(property 0 double \"weight\"\n"
+              "(node 0 \"1\")\n(node 1 \"one\")\n(node 2 \"2\")\n)\n)\n");
+  Graph *graph = tlp_importData(data, error);
+  CPPUNIT_ASSERT(graph == nullptr);
+  CPPUNIT_ASSERT_MESSAGE(error, error.find("at line 5") != string::npos);
+  CPPUNIT_ASSERT_MESSAGE(error, error.find("invalid value 'one' for node 1") != string::npos);
+
+  // the same without the batches (the values before 2.2 need a specific conversion)
+  data.replace(data.find("2.3"), 3, "2.0");
+  graph = tlp_importData(data, error);
+  CPPUNIT_ASSERT(graph == nullptr);
+  CPPUNIT_ASSERT_MESSAGE(error, error.find("at line 5") != string::npos);
+}
@@ -32,6 +32,11 @@ class TlpImportExportTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testExport);
   CPPUNIT_TEST(testExportCluster);
   CPPUNIT_TEST(testExportAttributes);
+  CPPUNIT_TEST(testImportBlockBoundary);
+  CPPUNIT_TEST(testImportNewLines);
+  CPPUNIT_TEST(testImportEscapes);
+  CPPUNIT_TEST(testImportValuesNotInExportFormat);
+  CPPUNIT_TEST(testImportInvalidValue);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -41,6 +46,11 @@ public:
   void testExport();
   void testExportCluster();
   void testExportAttributes();
+  void testImportBlockBoundary();
+  void testImportNewLines();
+  void testImportEscapes();
+  void testImportValuesNotInExportFormat();
+  void testImportInvalidValue();
 };
 
 #endif
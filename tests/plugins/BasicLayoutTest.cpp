@@ -23,6 +23,8 @@
 #include <tulip/SizeProperty.h>
 #include <tulip/BooleanProperty.h>
 #include <tulip/DoubleProperty.h>
+#include <tulip/ParallelTools.h>
+#include <tulip/TlpTools.h>
 
 using namespace std;
 using namespace tlp;
@@ -83,6 +85,37 @@ void BasicLayoutTest::testConnectedComponentPacking() {
   CPPUNIT_ASSERT(result);
 }
 //==========================================================
+void BasicLayoutTest::testConnectedComponentPackingComponentLayout() {
+  DataSet ds;
+  ds.set("file::filename", string("data/unconnected.tlp"));
+  Graph *g = importGraph("TLP Import", ds, nullptr, graph);
+  CPPUNIT_ASSERT(g == graph);
+  // the result must only depend on the seed of the random sequence,
+  // not on the number of threads laying out the components
+  // with a thread safe or a sequential component layout
+  unsigned int nbThreads = ThreadManager::getNumberOfThreads();
+
+  for (const char *componentLayout : {"GEM (Frick)", "Circular"}) {
+    LayoutProperty layout1(graph), layout2(graph);
+    DataSet params;
+    params.set("component layout", string(componentLayout));
+    string errorMsg;
+    tlp::setSeedOfRandomSequence(12345);
+    ThreadManager::setNumberOfThreads(1);
+    CPPUNIT_ASSERT(
+        graph->applyPropertyAlgorithm("Connected Component Packing", &layout1, errorMsg, &params));
+    tlp::setSeedOfRandomSequence(12345);
+    ThreadManager::setNumberOfThreads(4);
+    CPPUNIT_ASSERT(
+        graph->applyPropertyAlgorithm("Connected Component Packing", &layout2, errorMsg, &params));
+    ThreadManager::setNumberOfThreads(nbThreads);
+    tlp::setSeedOfRandomSequence();
+
+    for (auto n : graph->nodes())
+      CPPUNIT_ASSERT_EQUAL(layout1.getNodeValue(n), layout2.getNodeValue(n));
+  }
+}
+//==========================================================
 void BasicLayoutTest::testDendrogram() {
   initializeGraph("Planar Graph");
   DataSet ds;
@@ -31,6 +31,7 @@ class BasicLayoutTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCircular);
   CPPUNIT_TEST(testConeTreeExtended);
   CPPUNIT_TEST(testConnectedComponentPacking);
+  CPPUNIT_TEST(testConnectedComponentPackingComponentLayout);
   CPPUNIT_TEST(testDendrogram);
   CPPUNIT_TEST(testGEMLayout);
   CPPUNIT_TEST(testHierarchicalGraph);
@@ -62,6 +63,7 @@ public:
   void testCircular();
   void testConeTreeExtended();
   void testConnectedComponentPacking();
+  void testConnectedComponentPackingComponentLayout();
   void testDendrogram();
   void testGEMLayout();
   void testHierarchicalGraph();
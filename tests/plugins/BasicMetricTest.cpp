@@ -19,6 +19,8 @@
 #include "BasicMetricTest.h"
 #include <tulip/Graph.h>
 #include <tulip/DoubleProperty.h>
+#include <tulip/GraphSnapshot.h>
+#include <tulip/TlpTools.h>
 
 using namespace std;
 using namespace tlp;
@@ -47,6 +49,48 @@ bool BasicMetricTest::computeProperty(const std::string &algorithm, const std::s
   return result;
 }
 
+// adds a random graph with loops and multiple edges
+static void addRandomGraph(Graph *graph, unsigned int nbNodes, unsigned int nbEdges) {
+  vector<node> nodes;
+  graph->addNodes(nbNodes, nodes);
+  vector<pair<node, node>> ends;
+
+  for (unsigned int i = 0; i < nbEdges; ++i)
+    ends.emplace_back(nodes[randomUnsignedInteger(nbNodes - 1)],
+                      nodes[randomUnsignedInteger(nbNodes - 1)]);
+
+  graph->addEdges(ends);
+}
+
+// checks that the two numberings define the same partition
+static void checkSamePartition(const vector<double> &values, const vector<double> &otherValues) {
+  CPPUNIT_ASSERT_EQUAL(values.size(), otherValues.size());
+  map<double, double> toOther, fromOther;
+
+  for (unsigned int i = 0; i < values.size(); ++i) {
+    auto it = toOther.insert(make_pair(values[i], otherValues[i])).first;
+    CPPUNIT_ASSERT_EQUAL(it->second, otherValues[i]);
+    it = fromOther.insert(make_pair(otherValues[i], values[i])).first;
+    CPPUNIT_ASSERT_EQUAL(it->second, values[i]);
+  }
+}
+
+// checks that the components are numbered in the order of their first element
+static void checkFirstElementOrder(const vector<double> &values) {
+  double nextNumber = 0;
+
+  for (double value : values) {
+    // the loops of the biconnected components have no component
+    if (value < 0)
+      continue;
+
+    CPPUNIT_ASSERT(value <= nextNumber);
+
+    if (value == nextNumber)
+      ++nextNumber;
+  }
+}
+
 void BasicMetricTest::setUp() {
   graph = tlp::newGraph();
 }
@@ -70,6 +114,42 @@ void BasicMetricTest::testBiconnectedComponent() {
   CPPUNIT_ASSERT(result);
 }
 //==========================================================
+void BasicMetricTest::testParallelBiconnectedComponent() {
+  // from sparse graphs, with many cut nodes, to denser ones
+  const unsigned int nbNodes = 5000;
+  const unsigned int nbEdges[] = {10, 2500, 4500, 5000, 6000, 20000};
+  setSeedOfRandomSequence(12345);
+
+  for (unsigned int nb : nbEdges) {
+    Graph *g = graph->addSubGraph();
+    addRandomGraph(g, nbNodes, nb);
+    vector<double> values[2];
+    unsigned int nbComponents[2];
+
+    for (unsigned int i = 0; i < 2; ++i) {
+      DoubleProperty components(g);
+      DataSet ds;
+      ds.set("parallel", i == 1);
+      string errorMsg;
+      CPPUNIT_ASSERT(
+          g->applyPropertyAlgorithm("Biconnected Component", &components, errorMsg, &ds));
+      CPPUNIT_ASSERT(ds.get("#biconnected components", nbComponents[i]));
+
+      for (auto e : g->edges()) {
+        values[i].push_back(components.getEdgeValue(e));
+        // the loops do not belong to any component
+        CPPUNIT_ASSERT_EQUAL(g->source(e) == g->target(e), values[i].back() < 0);
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(nbComponents[0], nbComponents[1]);
+    checkSamePartition(values[0], values[1]);
+    checkFirstElementOrder(values[1]);
+  }
+
+  setSeedOfRandomSequence();
+}
+//==========================================================
 void BasicMetricTest::testClusterMetric() {
   bool result = computeProperty<DoubleProperty>("Cluster");
   CPPUNIT_ASSERT(result);
@@ -122,6 +202,22 @@ void BasicMetricTest::testNodeMetric() {
   CPPUNIT_ASSERT(result);
 }
 //==========================================================
+void BasicMetricTest::testPageRank() {
+  DoubleProperty pr1(graph), pr2(graph);
+  bool result = computeProperty<DoubleProperty>("Page Rank", "Planar Graph", &pr1);
+  CPPUNIT_ASSERT(result);
+
+  // the snapshot of the unchanged graph is reused by the next run
+  unsigned int nbBuilds = GraphSnapshot::getNumberOfBuilds();
+  string errorMsg;
+  result = graph->applyPropertyAlgorithm("Page Rank", &pr2, errorMsg);
+  CPPUNIT_ASSERT(result);
+  CPPUNIT_ASSERT_EQUAL(nbBuilds, GraphSnapshot::getNumberOfBuilds());
+
+  for (auto n : graph->nodes())
+    CPPUNIT_ASSERT_EQUAL(pr1.getNodeValue(n), pr2.getNodeValue(n));
+}
+//==========================================================
 void BasicMetricTest::testPathLengthMetric() {
   bool result = computeProperty<DoubleProperty>("Path Length");
   CPPUNIT_ASSERT(result == false);
@@ -150,3 +246,73 @@ void BasicMetricTest::testStrongComponent() {
   CPPUNIT_ASSERT(result);
 }
 //==========================================================
+void BasicMetricTest::testParallelStrongComponent() {
+  // from graphs with many trivial components, to graphs with a giant one
+  const unsigned int nbNodes = 5000;
+  const unsigned int nbEdges[] = {10, 2500, 5000, 6000, 20000};
+  setSeedOfRandomSequence(12345);
+
+  for (unsigned int nb : nbEdges) {
+    Graph *g = graph->addSubGraph();
+    addRandomGraph(g, nbNodes, nb);
+    vector<double> values[2];
+    unsigned int nbComponents[2];
+
+    for (unsigned int i = 0; i < 2; ++i) {
+      DoubleProperty components(g);
+      DataSet ds;
+      ds.set("parallel", i == 1);
+      string errorMsg;
+      CPPUNIT_ASSERT(g->applyPropertyAlgorithm("Strongly Connected Component", &components,
+                                               errorMsg, &ds));
+      CPPUNIT_ASSERT(ds.get("#strongly connected components", nbComponents[i]));
+
+      for (auto n : g->nodes())
+        values[i].push_back(components.getNodeValue(n));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(nbComponents[0], nbComponents[1]);
+    checkSamePartition(values[0], values[1]);
+    checkFirstElementOrder(values[1]);
+  }
+
+  setSeedOfRandomSequence();
+}
+//==========================================================
+void BasicMetricTest::testStrongComponentLongPath() {
+  // a long path ending with a long cycle, far too deep for a recursive dfs
+  const unsigned int nbNodes = 500000;
+  vector<node> nodes;
+  graph->addNodes(2 * nbNodes, nodes);
+  vector<pair<node, node>> ends;
+
+  for (unsigned int i = 0; i < 2 * nbNodes - 1; ++i)
+    ends.emplace_back(nodes[i], nodes[i + 1]);
+
+  ends.emplace_back(nodes[2 * nbNodes - 1], nodes[nbNodes]);
+  graph->addEdges(ends);
+
+  // with the sequential and the parallel algorithms
+  for (bool parallel : {false, true}) {
+    DoubleProperty components(graph);
+    DataSet ds;
+    ds.set("parallel", parallel);
+    string errorMsg;
+    bool result = graph->applyPropertyAlgorithm("Strongly Connected Component", &components,
+                                                errorMsg, &ds);
+    CPPUNIT_ASSERT(result);
+    unsigned int nbComponents = 0;
+    CPPUNIT_ASSERT(ds.get("#strongly connected components", nbComponents));
+    // each node of the path and the cycle
+    CPPUNIT_ASSERT_EQUAL(nbNodes + 1, nbComponents);
+
+    double cycle = components.getNodeValue(nodes[nbNodes]);
+
+    for (unsigned int i = nbNodes; i < 2 * nbNodes; ++i)
+      CPPUNIT_ASSERT_EQUAL(cycle, components.getNodeValue(nodes[i]));
+
+    CPPUNIT_ASSERT(components.getNodeValue(nodes[0]) != components.getNodeValue(nodes[1]));
+    CPPUNIT_ASSERT(components.getNodeValue(nodes[nbNodes - 1]) != cycle);
+  }
+}
+//==========================================================
@@ -30,6 +30,7 @@ class BasicMetricTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testArityMetric);
   CPPUNIT_TEST(testBetweennessCentrality);
   CPPUNIT_TEST(testBiconnectedComponent);
+  CPPUNIT_TEST(testParallelBiconnectedComponent);
   CPPUNIT_TEST(testClusterMetric);
   CPPUNIT_TEST(testConnectedComponent);
   CPPUNIT_TEST(testDagLevelMetric);
@@ -38,11 +39,14 @@ class BasicMetricTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testIdMetric);
   CPPUNIT_TEST(testLeafMetric);
   CPPUNIT_TEST(testNodeMetric);
+  CPPUNIT_TEST(testPageRank);
   CPPUNIT_TEST(testPathLengthMetric);
   CPPUNIT_TEST(testRandomMetric);
   CPPUNIT_TEST(testStrahlerMetric);
   CPPUNIT_TEST(testStrengthMetric);
   CPPUNIT_TEST(testStrongComponent);
+  CPPUNIT_TEST(testStrongComponentLongPath);
+  CPPUNIT_TEST(testParallelStrongComponent);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -58,6 +62,7 @@ public:
   void testArityMetric();
   void testBetweennessCentrality();
   void testBiconnectedComponent();
+  void testParallelBiconnectedComponent();
   void testClusterMetric();
   void testConnectedComponent();
   void testDagLevelMetric();
@@ -66,11 +71,14 @@ public:
   void testIdMetric();
   void testLeafMetric();
   void testNodeMetric();
+  void testPageRank();
   void testPathLengthMetric();
   void testRandomMetric();
   void testStrahlerMetric();
   void testStrengthMetric();
   void testStrongComponent();
+  void testStrongComponentLongPath();
+  void testParallelStrongComponent();
 };
 
 #endif // BASICMETRICTEST_H